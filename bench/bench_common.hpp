@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+#include "cgp/02_numarray/numarray/numarray.hpp"
+
+// Helpers shared by the benchmark drivers
+namespace cgp_bench
+{
+	// Best wall-clock time in milliseconds of repeat calls to f() (after a first call warming up the caches and the thread pool)
+	template <typename F> double best_time_ms(F const& f, int repeat = 5)
+	{
+		f();
+		double best = 1e30;
+		for (int k = 0; k < repeat; ++k) {
+			auto const t0 = std::chrono::steady_clock::now();
+			f();
+			auto const t1 = std::chrono::steady_clock::now();
+			best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+		}
+		return best;
+	}
+
+	// Bitwise equality of two numarrays of trivially copyable values
+	template <typename T> bool same_values(cgp::numarray<T> const& a, cgp::numarray<T> const& b)
+	{
+		return a.size() == b.size() && (a.size() == 0 || std::memcmp(a.data.data(), b.data.data(), a.size() * sizeof(T)) == 0);
+	}
+
+	// Path of a file in the temporary directory
+	inline std::string temporary_file(std::string const& name)
+	{
+		return (std::filesystem::temp_directory_path() / ("cgp_bench_" + name)).string();
+	}
+
+	// Write an obj file of a height field on a N x N grid with positions, uv and normals ("v/vt/vn" faces)
+	//  The cells are alternatively written as a quad (triangulated by the loader) and as two triangles.
+	inline void write_grid_obj(std::string const& filename, int N)
+	{
+		FILE* file = std::fopen(filename.c_str(), "w");
+		std::fprintf(file, "# grid %dx%d\n", N, N);
+		for (int j = 0; j < N; ++j)
+			for (int i = 0; i < N; ++i) {
+				float const u = i / (N - 1.0f), v = j / (N - 1.0f);
+				std::fprintf(file, "v %f %f %f\n", u, v, 0.1f * std::sin(10 * u) * std::cos(7 * v));
+			}
+		for (int j = 0; j < N; ++j)
+			for (int i = 0; i < N; ++i)
+				std::fprintf(file, "vt %f %f\n", i / (N - 1.0f), j / (N - 1.0f));
+		for (int j = 0; j < N; ++j)
+			for (int i = 0; i < N; ++i)
+				std::fprintf(file, "vn %f %f %f\n", 0.0f, 0.0f, 1.0f);
+		for (int j = 0; j < N - 1; ++j)
+			for (int i = 0; i < N - 1; ++i) {
+				int const a = 1 + i + N * j, b = a + 1, c = a + 1 + N, d = a + N;
+				if ((i + j) % 2)
+					std::fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, c, c, c, d, d, d);
+				else
+					std::fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d\nf %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, c, c, c, a, a, a, c, c, c, d, d, d);
+			}
+		std::fclose(file);
+	}
+}
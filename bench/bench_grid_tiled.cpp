@@ -0,0 +1,164 @@
+// Linear (grid_3D) and brick-tiled (grid_3D_tiled) storage of a 3D field: marching cube, 7-point Laplacian, storage-order sweep and z-column walk
+//  Usage: bench_grid_tiled [grid resolution N (default 256)]
+//  Each access pattern computes the same result on both layouts (checked below).
+#include "bench_common.hpp"
+
+#include "cgp/04_grid_container/grid/grid.hpp"
+#include "cgp/12_shape/implicit/marching_cube/marching_cube.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <vector>
+
+using namespace cgp;
+
+// Positions of the corners of each triangle, sorted: independent of the order of the triangles and of the sharing of the vertices
+static std::vector<std::array<float, 9>> sorted_triangles(mesh const& m)
+{
+	std::vector<std::array<float, 9>> triangles(m.connectivity.size());
+	for (size_t k = 0; k < m.connectivity.size(); ++k)
+		for (int j = 0; j < 3; ++j)
+			for (int c = 0; c < 3; ++c)
+				triangles[k][3 * j + c] = m.position[m.connectivity[k][j]][c];
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+// 7-point Laplacian on the linear grid, with the indices clamped to the border: rows of contiguous elements read through raw pointers
+static void laplacian_linear(grid_3D<float> const& f, grid_3D<float>& out)
+{
+	int3 const& N = f.dimension;
+	out.resize(N);
+	int64_t const Nxy = int64_t(N.x) * N.y;
+	for (int z = 0; z < N.z; ++z) {
+		for (int y = 0; y < N.y; ++y) {
+			float const* c = &f.at_unsafe(0, y, z);
+			float const* ym = c - (y > 0 ? N.x : 0);
+			float const* yp = c + (y < N.y - 1 ? N.x : 0);
+			float const* zm = c - (z > 0 ? Nxy : 0);
+			float const* zp = c + (z < N.z - 1 ? Nxy : 0);
+			float* o = &out.at_unsafe(0, y, z);
+			o[0] = c[1] + c[0] + yp[0] + ym[0] + zp[0] + zm[0] - 6 * c[0];
+			for (int x = 1; x < N.x - 1; ++x)
+				o[x] = c[x + 1] + c[x - 1] + yp[x] + ym[x] + zp[x] + zm[x] - 6 * c[x];
+			int const x = N.x - 1;
+			o[x] = c[x] + c[x - 1] + yp[x] + ym[x] + zp[x] + zm[x] - 6 * c[x];
+		}
+	}
+}
+
+// Sum of all the values in storage order: buffer of the linear grid, for_each on the tiled grid
+static double sum_linear(grid_3D<float> const& f)
+{
+	double s = 0;
+	for (float const value : f.data)
+		s += value;
+	return s;
+}
+static double sum_tiled(grid_3D_tiled<float> const& f)
+{
+	double s = 0;
+	f.for_each([&s](int, int, int, float const& value) { s += value; });
+	return s;
+}
+
+// Sum of the values along each z column (z innermost): stride Nx*Ny on the linear grid, neighbor_step on the tiled grid (B*B inside a brick)
+static void column_sum_linear(grid_3D<float> const& f, std::vector<float>& column)
+{
+	int3 const& N = f.dimension;
+	for (int y = 0; y < N.y; ++y)
+		for (int x = 0; x < N.x; ++x) {
+			float s = 0;
+			for (int z = 0; z < N.z; ++z)
+				s += f.at_unsafe(x, y, z);
+			column[x + size_t(N.x) * y] = s;
+		}
+}
+static void column_sum_tiled(grid_3D_tiled<float> const& f, std::vector<float>& column)
+{
+	int3 const& N = f.dimension;
+	for (int y = 0; y < N.y; ++y)
+		for (int x = 0; x < N.x; ++x) {
+			float s = 0;
+			int64_t offset = f.index_to_offset(x, y, 0);
+			for (int z = 0; z < N.z; ++z) {
+				s += f.data.at(offset);
+				offset += f.neighbor_step(x, y, z).z;
+			}
+			column[x + size_t(N.x) * y] = s;
+		}
+}
+
+int main(int argc, char** argv)
+{
+	int const N = argc > 1 ? std::atoi(argv[1]) : 256;
+
+	// Bumpy sphere
+	spatial_domain_grid_3D const domain = spatial_domain_grid_3D::from_center_length({ 0,0,0 }, { 2,2,2 }, { N,N,N });
+	grid_3D<float> field;
+	field.resize(N, N, N);
+	for (int z = 0; z < N; ++z)
+		for (int y = 0; y < N; ++y)
+			for (int x = 0; x < N; ++x) {
+				vec3 const p = domain.position({ x,y,z });
+				field(x, y, z) = norm(p) - 0.7f + 0.05f * std::sin(15 * p.x) * std::sin(13 * p.y) * std::sin(17 * p.z);
+			}
+	using tiled_grid = grid_3D_tiled<float>;
+	tiled_grid const tiled(field);
+	std::printf("field: %d^3 samples, bricks of %d^3\n", N, tiled_grid::brick_size);
+
+	// Marching cube: cells visited row by row on the linear grid, brick by brick on the tiled one
+	{
+		mesh m_linear, m_tiled;
+		double const t_linear = cgp_bench::best_time_ms([&]() { m_linear = marching_cube(field, domain, 0.0f); }, 3);
+		double const t_tiled = cgp_bench::best_time_ms([&]() { m_tiled = marching_cube(tiled, domain, 0.0f); }, 3);
+		bool const same = sorted_triangles(m_linear) == sorted_triangles(m_tiled);
+		std::printf("marching cube, linear               : %8.1f ms  %zu triangles\n", t_linear, m_linear.connectivity.size());
+		std::printf("marching cube, tiled                : %8.1f ms  identical: %d\n", t_tiled, same);
+
+		minmax_block_pyramid const pyramid(field);
+		double const t_linear_pyramid = cgp_bench::best_time_ms([&]() { m_linear = marching_cube(field, domain, 0.0f, &pyramid); }, 3);
+		double const t_tiled_pyramid = cgp_bench::best_time_ms([&]() { m_tiled = marching_cube(tiled, domain, 0.0f, &pyramid); }, 3);
+		bool const same_pyramid = sorted_triangles(m_linear) == sorted_triangles(m_tiled);
+		std::printf("marching cube + pyramid, linear     : %8.1f ms\n", t_linear_pyramid);
+		std::printf("marching cube + pyramid, tiled      : %8.1f ms  identical: %d\n", t_tiled_pyramid, same_pyramid);
+	}
+
+	// 7-point Laplacian with clamped borders: rows of the linear grid, halo buffer of each brick for the tiled grid
+	{
+		grid_3D<float> lap_linear;
+		tiled_grid lap_tiled;
+		double const t_linear = cgp_bench::best_time_ms([&]() { laplacian_linear(field, lap_linear); }, 5);
+		double const t_tiled = cgp_bench::best_time_ms([&]() {
+			tiled.apply_stencil(lap_tiled, [](float const* p) {
+				return p[1] + p[-1] + p[tiled_grid::halo_stride_y] + p[-tiled_grid::halo_stride_y] + p[tiled_grid::halo_stride_z] + p[-tiled_grid::halo_stride_z] - 6 * p[0]; });
+		}, 5);
+		bool const same = cgp_bench::same_values(lap_tiled.to_grid().data, lap_linear.data);
+		std::printf("7-point Laplacian, linear           : %8.1f ms\n", t_linear);
+		std::printf("7-point Laplacian, tiled            : %8.1f ms  identical: %d\n", t_tiled, same);
+	}
+
+	// Sum of all the values in storage order
+	{
+		// The sums are stored in a volatile variable: otherwise the compiler may accumulate directly in its memory (instead of a register)
+		volatile double result = 0;
+		double const t_linear = cgp_bench::best_time_ms([&]() { result = sum_linear(field); }, 5);
+		double const s_linear = result;
+		double const t_tiled = cgp_bench::best_time_ms([&]() { result = sum_tiled(tiled); }, 5);
+		double const s_tiled = result;
+		std::printf("storage-order sum, linear           : %8.1f ms\n", t_linear);
+		std::printf("storage-order sum, tiled (for_each) : %8.1f ms  relative difference: %.1e\n", t_tiled, std::abs(s_tiled - s_linear) / std::abs(s_linear));
+	}
+
+	// Walk along the z columns
+	{
+		std::vector<float> column_linear(size_t(N) * N), column_tiled(size_t(N) * N);
+		double const t_linear = cgp_bench::best_time_ms([&]() { column_sum_linear(field, column_linear); }, 5);
+		double const t_tiled = cgp_bench::best_time_ms([&]() { column_sum_tiled(tiled, column_tiled); }, 5);
+		bool const same = column_linear == column_tiled;
+		std::printf("z-column walk, linear               : %8.1f ms\n", t_linear);
+		std::printf("z-column walk, tiled (neighbor_step): %8.1f ms  identical: %d\n", t_tiled, same);
+	}
+
+	return 0;
+}
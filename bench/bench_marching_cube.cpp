@@ -0,0 +1,69 @@
+// Marching cube on a dense field: slabs of cells extracted in parallel, reuse of the slab buffers, and indexed mesh extraction
+//  Usage: bench_marching_cube [grid resolution N (default 256)] [max thread count (default 8)]
+//  The triangle soup extracted with several threads must be bitwise identical to the serial one.
+#include "bench_common.hpp"
+
+#include "cgp/12_shape/implicit/marching_cube/marching_cube.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace cgp;
+
+int main(int argc, char** argv)
+{
+	int const N = argc > 1 ? std::atoi(argv[1]) : 256;
+	int const max_thread = argc > 2 ? std::atoi(argv[2]) : 8;
+
+	// Bumpy sphere
+	spatial_domain_grid_3D const domain = spatial_domain_grid_3D::from_center_length({ 0,0,0 }, { 2,2,2 }, { N,N,N });
+	grid_3D<float> field;
+	field.resize(N, N, N);
+	for (int z = 0; z < N; ++z)
+		for (int y = 0; y < N; ++y)
+			for (int x = 0; x < N; ++x) {
+				vec3 const p = domain.position({ x,y,z });
+				field(x, y, z) = norm(p) - 0.7f + 0.05f * std::sin(15 * p.x) * std::sin(13 * p.y) * std::sin(17 * p.z);
+			}
+	std::printf("field: %d^3 samples\n", N);
+
+	std::vector<vec3> reference;
+	size_t N_reference = 0;
+	for (int thread_count = 1; thread_count <= max_thread; thread_count *= 2) {
+		std::vector<vec3> position;
+		std::vector<marching_cube_relative_coordinates> relative;
+		size_t N_position = 0;
+		double const t = cgp_bench::best_time_ms([&]() { N_position = marching_cube(position, field.data.data, domain, 0.0f, &relative, thread_count); }, 3);
+		if (thread_count == 1) {
+			reference = position;
+			N_reference = N_position;
+		}
+		bool const same = N_position == N_reference && std::memcmp(position.data(), reference.data(), N_position * sizeof(vec3)) == 0;
+		std::printf("triangle soup, %d thread(s)         : %8.1f ms  %zu triangles  identical: %d\n", thread_count, t, N_position / 3, same);
+	}
+
+	// Repeated extraction (ex. animated field): the slab buffers are allocated at each call, or kept in a workspace
+	{
+		std::vector<vec3> position;
+		std::vector<marching_cube_relative_coordinates> relative;
+		marching_cube_workspace workspace;
+		double const t_allocate = cgp_bench::best_time_ms([&]() { marching_cube(position, field.data.data, domain, 0.0f, &relative, max_thread); }, 10);
+		double const t_workspace = cgp_bench::best_time_ms([&]() { marching_cube(position, field.data.data, domain, 0.0f, &relative, max_thread, nullptr, &workspace); }, 10);
+		std::printf("%d threads, slab buffers allocated  : %8.1f ms\n", max_thread, t_allocate);
+		std::printf("%d threads, reused workspace        : %8.1f ms\n", max_thread, t_workspace);
+	}
+
+	// Empty regions skipped with the min/max pyramid
+	{
+		std::vector<vec3> position;
+		minmax_block_pyramid const pyramid(field);
+		size_t N_position = 0;
+		double const t = cgp_bench::best_time_ms([&]() { N_position = marching_cube(position, field.data.data, domain, 0.0f, nullptr, 1, &pyramid); }, 3);
+		std::printf("triangle soup, min/max pyramid      : %8.1f ms  %zu triangles\n", t, N_position / 3);
+	}
+
+	mesh m;
+	double const t_indexed = cgp_bench::best_time_ms([&]() { m = marching_cube(field, domain, 0.0f); }, 3);
+	std::printf("indexed mesh                        : %8.1f ms  %d vertices, %d triangles\n", t_indexed, int(m.position.size()), int(m.connectivity.size()));
+	return 0;
+}
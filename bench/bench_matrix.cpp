@@ -0,0 +1,97 @@
+// Fixed size matrix/vector operations unrolled at compile time, against loops over a matrix size only known at runtime
+//  Usage: bench_matrix [number of elements (default 1M)]
+#include "bench_common.hpp"
+
+#include "cgp/06_mat/mat.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace cgp;
+
+// The operations can be evaluated at compile time
+static_assert(det(mat3(2,0,0, 0,3,0, 0,0,4)) == 24.0f, "constexpr det(mat3)");
+static_assert(get<1, 1>(inverse(mat2(2,0, 0,4))) == 0.25f, "constexpr inverse(mat2)");
+
+// Reference: product of n x n row-major matrices with loops on a runtime size
+static void reference_product(float const* a, float const* b, float* c, int n)
+{
+	for (int i = 0; i < n; ++i)
+		for (int j = 0; j < n; ++j) {
+			float s = 0.0f;
+			for (int k = 0; k < n; ++k)
+				s += a[i * n + k] * b[k * n + j];
+			c[i * n + j] = s;
+		}
+}
+
+int main(int argc, char** argv)
+{
+	int const N = argc > 1 ? std::atoi(argv[1]) : (1 << 20);
+	volatile int runtime_size = 3; // the compiler cannot unroll the loops of the reference on this size
+
+	std::vector<mat3> A(N);
+	std::vector<vec3> v(N);
+	std::vector<matrix_stack<float, 5, 5>> G(N / 8);
+	for (int k = 0; k < N; ++k) {
+		float const s = 1 + (k % 17) * 0.01f;
+		A[k] = mat3(s, 0.1f, 0.2f, 0.3f, s, 0.1f, 0.2f, 0.1f, s + 1);
+		v[k] = vec3(s, 1, 2);
+	}
+	for (auto& g : G)
+		g = matrix_stack<float, 5, 5>::build_identity() * 1.01f;
+
+	float accumulated = 0.0f;
+	int const n3 = runtime_size;
+	double const t_reference = cgp_bench::best_time_ms([&]() {
+		for (int k = 1; k < N; ++k) {
+			mat3 C;
+			reference_product(&get<0, 0>(A[k]), &get<0, 0>(A[k - 1]), &get<0, 0>(C), n3);
+			accumulated += get<0, 1>(C);
+		}
+	});
+	double const t_product = cgp_bench::best_time_ms([&]() {
+		for (int k = 1; k < N; ++k)
+			accumulated += get<0, 1>(A[k] * A[k - 1]);
+	});
+	double const t_vector = cgp_bench::best_time_ms([&]() {
+		for (int k = 0; k < N; ++k)
+			accumulated += (A[k] * v[k]).z;
+	});
+	double const t_inverse = cgp_bench::best_time_ms([&]() {
+		for (int k = 0; k < N; ++k)
+			accumulated += get<2, 2>(inverse(A[k]));
+	});
+	double const t_vec3 = cgp_bench::best_time_ms([&]() {
+		for (int k = 1; k < N; ++k)
+			accumulated += dot(v[k] + 2.0f * v[k - 1], v[k]);
+	});
+	int const n5 = runtime_size + 2;
+	double const t_reference5 = cgp_bench::best_time_ms([&]() {
+		for (size_t k = 1; k < G.size(); ++k) {
+			matrix_stack<float, 5, 5> C;
+			reference_product(&G[k](0, 0), &G[k - 1](0, 0), &C(0, 0), n5);
+			accumulated += trace(C);
+		}
+	});
+	double const t_product5 = cgp_bench::best_time_ms([&]() {
+		for (size_t k = 1; k < G.size(); ++k)
+			accumulated += trace(G[k] * G[k - 1]);
+	});
+	double const t_det4 = cgp_bench::best_time_ms([&]() {
+		for (int k = 0; k < N; ++k)
+			accumulated += det(mat4(A[k]));
+	});
+
+	std::printf("%d elements\n", N);
+	std::printf("mat3*mat3, runtime size loops : %7.1f ms\n", t_reference);
+	std::printf("mat3*mat3                     : %7.1f ms\n", t_product);
+	std::printf("mat3*vec3                     : %7.1f ms\n", t_vector);
+	std::printf("inverse(mat3)                 : %7.1f ms\n", t_inverse);
+	std::printf("vec3 a+2b, dot                : %7.1f ms\n", t_vec3);
+	std::printf("5x5, runtime size loops       : %7.1f ms  (%d elements)\n", t_reference5, int(G.size()));
+	std::printf("5x5 product                   : %7.1f ms\n", t_product5);
+	std::printf("det(mat4(mat3))               : %7.1f ms\n", t_det4);
+	std::printf("(check %g)\n", accumulated);
+	return 0;
+}
@@ -0,0 +1,102 @@
+// Adjacency of a triangle mesh: one-ring built with one std::set per vertex, against the CSR adjacency built with counting sorts
+//  Usage: bench_mesh_adjacency [grid resolution N (default 1000)] - the mesh has N x N vertices and 2 (N-1)^2 triangles
+//  Reports the time, the number of heap allocations and the peak of heap memory of each call. The CSR one-ring must equal the std::set one.
+#include "bench_common.hpp"
+
+#include "cgp/11_mesh/mesh.hpp"
+
+#include <cstdlib>
+#include <new>
+#include <set>
+
+using namespace cgp;
+
+// Counting of the heap allocations of the driver
+namespace
+{
+	size_t allocation_count = 0;
+	size_t allocated_bytes = 0;
+	size_t peak_bytes = 0;
+}
+void* operator new(size_t size)
+{
+	allocation_count++;
+	allocated_bytes += size;
+	peak_bytes = std::max(peak_bytes, allocated_bytes);
+	size_t* block = static_cast<size_t*>(std::malloc(size + 16));
+	if (block == nullptr)
+		throw std::bad_alloc();
+	block[0] = size;
+	return block + 2;
+}
+void operator delete(void* pointer) noexcept
+{
+	if (pointer == nullptr)
+		return;
+	size_t* block = static_cast<size_t*>(pointer) - 2;
+	allocated_bytes -= block[0];
+	std::free(block);
+}
+void operator delete(void* pointer, size_t) noexcept { operator delete(pointer); }
+
+// Reference: one std::set of neighbors per vertex
+static numarray<numarray<int>> reference_one_ring(numarray<uint3> const& connectivity, int N_vertex)
+{
+	numarray<std::set<int>> one_ring;
+	one_ring.resize(N_vertex);
+	for (uint3 const& t : connectivity) {
+		one_ring.at(t.x).insert(int(t.y)); one_ring.at(t.x).insert(int(t.z));
+		one_ring.at(t.y).insert(int(t.x)); one_ring.at(t.y).insert(int(t.z));
+		one_ring.at(t.z).insert(int(t.x)); one_ring.at(t.z).insert(int(t.y));
+	}
+	numarray<numarray<int>> result;
+	result.resize(N_vertex);
+	for (int k = 0; k < N_vertex; ++k)
+		for (int i : one_ring.at(k))
+			result.at(k).push_back(i);
+	return result;
+}
+
+// Time, allocations and peak memory of f()
+template <typename F> void run(char const* name, F const& f)
+{
+	size_t const base = allocated_bytes;
+	allocation_count = 0;
+	peak_bytes = base;
+	double const t = cgp_bench::best_time_ms(f, 1);
+	// The allocations and peak are measured over the warm-up call and the timed call
+	std::printf("%-37s %8.1f ms  %9zu allocations  peak %7.1f MB\n", name, t, allocation_count / 2, (peak_bytes - base) / 1048576.0);
+}
+
+int main(int argc, char** argv)
+{
+	int const N = argc > 1 ? std::atoi(argv[1]) : 1000;
+	numarray<uint3> connectivity;
+	for (int u = 0; u < N - 1; ++u) {
+		for (int v = 0; v < N - 1; ++v) {
+			unsigned int const i = u * N + v;
+			connectivity.push_back(uint3{ i, i + 1, i + 1 + N });
+			connectivity.push_back(uint3{ i, i + 1 + N, i + N });
+		}
+	}
+	std::printf("grid mesh: %d vertices, %d triangles\n", N * N, int(connectivity.size()));
+
+	run("one-ring, one std::set per vertex", [&]() { reference_one_ring(connectivity, N * N); });
+	run("connectivity_one_ring (via CSR)", [&]() { connectivity_one_ring(connectivity); });
+	run("vertex_to_vertex_adjacency", [&]() { vertex_to_vertex_adjacency(connectivity); });
+	run("vertex_to_face_adjacency", [&]() { vertex_to_face_adjacency(connectivity); });
+	run("edge_to_face_adjacency", [&]() { numarray<int2> edges; edge_to_face_adjacency(connectivity, edges); });
+
+	numarray<numarray<int>> const reference = reference_one_ring(connectivity, N * N);
+	csr_adjacency const one_ring = vertex_to_vertex_adjacency(connectivity);
+	bool same = int(one_ring.size()) == N * N;
+	for (int k = 0; same && k < N * N; ++k) {
+		numarray_view<int const> const neighbors = one_ring.neighbors(k);
+		same = neighbors.size() == reference.at(k).size();
+		for (int j = 0; same && j < neighbors.size(); ++j)
+			same = neighbors.at(j) == reference.at(k).at(j);
+	}
+	std::printf("CSR one-ring identical to the std::set one: %d (%.1f MB in two buffers)\n", same,
+		(one_ring.offset.size() * sizeof(int64_t) + one_ring.index.size() * sizeof(int)) / 1048576.0);
+	return 0;
+}
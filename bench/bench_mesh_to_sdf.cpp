@@ -0,0 +1,62 @@
+// Signed distance field of triangle meshes: computation time, and error against the analytic distance of the shape
+//  Usage: bench_mesh_to_sdf [grid resolution N (default 128)] [mesh resolution R (default 400)]
+//  The error is measured separately in the narrow band (exact distance) and in the far field (fast sweeping).
+#include "bench_common.hpp"
+
+#include "cgp/11_mesh/primitive/primitive.hpp"
+#include "cgp/12_shape/implicit/implicit.hpp"
+
+#include <cstdlib>
+
+using namespace cgp;
+
+// Time of mesh_to_sdf, and error of the field against the analytic signed distance
+template <typename DISTANCE>
+static void compare(char const* name, mesh const& m, spatial_domain_grid_3D const& domain, DISTANCE const& distance)
+{
+	grid_3D<float> sdf;
+	double const t = cgp_bench::best_time_ms([&]() { mesh_to_sdf(sdf, m, domain); }, 1);
+
+	float const voxel = domain.voxel_length().x;
+	mesh_to_sdf_parameters const parameters;
+	float error_band = 0.0f, error_far = 0.0f;
+	int wrong_sign = 0;
+	int3 const& N = domain.samples;
+	for (int z = 0; z < N.z; ++z)
+		for (int y = 0; y < N.y; ++y)
+			for (int x = 0; x < N.x; ++x) {
+				float const d = distance(domain.position({ x,y,z }));
+				float const value = sdf(x, y, z);
+				// Sign errors are only counted away from the discretized surface
+				if ((value < 0) != (d < 0) && std::abs(d) > 1e-2f * voxel)
+					wrong_sign++;
+				if (std::abs(d) < parameters.narrow_band * voxel)
+					error_band = std::max(error_band, std::abs(value - d));
+				else
+					error_far = std::max(error_far, std::abs(value - d));
+			}
+	std::printf("%-8s %8d triangles: %8.1f ms  band error %.2g, far error %.2g voxels, %d wrong signs\n",
+		name, int(m.connectivity.size()), t, error_band, error_far / voxel, wrong_sign);
+}
+
+int main(int argc, char** argv)
+{
+	int const N = argc > 1 ? std::atoi(argv[1]) : 128;
+	int const R = argc > 2 ? std::atoi(argv[2]) : 400;
+	spatial_domain_grid_3D const domain = spatial_domain_grid_3D::from_center_length({ 0,0,0 }, { 3,3,3 }, { N,N,N });
+	std::printf("grid: %d^3 samples, voxel %g\n", N, domain.voxel_length().x);
+
+	compare("sphere", mesh_primitive_sphere(1.0f, { 0,0,0 }, 2 * R, R), domain,
+		[](vec3 const& p) { return norm(p) - 1.0f; });
+
+	compare("torus", mesh_primitive_torus(1.0f, 0.3f, { 0,0,0 }, { 0,0,1 }, 4 * R, R), domain,
+		[](vec3 const& p) { return norm(vec2{ norm(vec2{ p.x,p.y }) - 1.0f, p.z }) - 0.3f; });
+
+	// The cube has split vertices along its edges (one per face)
+	compare("cube", mesh_primitive_cube({ 0,0,0 }, 1.5f), domain,
+		[](vec3 const& p) {
+			vec3 const q = abs(p) - vec3{ 0.75f,0.75f,0.75f };
+			return norm(vec3{ std::max(q.x,0.0f), std::max(q.y,0.0f), std::max(q.z,0.0f) }) + std::min(std::max(q.x, std::max(q.y, q.z)), 0.0f);
+		});
+	return 0;
+}
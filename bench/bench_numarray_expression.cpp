@@ -0,0 +1,54 @@
+// Element-wise numarray arithmetic: fused expressions, against one temporary numarray per operator (previous behavior), and a hand written loop
+//  The hand written loop uses at(): operator[] checks the bounds unless cgp_NO_DEBUG is defined (see numarray.hpp).
+//  Usage: bench_numarray_expression [number of floats (default 8M)]
+#include "bench_common.hpp"
+
+#include "cgp/02_numarray/numarray.hpp"
+
+#include <cstdlib>
+
+using namespace cgp;
+
+int main(int argc, char** argv)
+{
+	int const M = argc > 1 ? std::atoi(argv[1]) : (1 << 23);
+	numarray<float> x(M), y(M), z(M), z_temporary(M), z_loop(M);
+	for (int k = 0; k < M; ++k) {
+		x[k] = float(k % 1000);
+		y[k] = 1.0f + float(k % 7);
+	}
+	double const bytes = 3.0 * M * sizeof(float); // read x, y and write z
+
+	// z = x + 2y - xy
+	double const t_fused = cgp_bench::best_time_ms([&]() { z = x + 2.0f * y - x * y; }, 10);
+	double const t_temporary = cgp_bench::best_time_ms([&]() {
+		numarray<float> const a = evaluate(2.0f * y);
+		numarray<float> const b = evaluate(x + a);
+		numarray<float> const c = evaluate(x * y);
+		z_temporary = evaluate(b - c);
+	}, 10);
+	double const t_loop = cgp_bench::best_time_ms([&]() {
+		for (int k = 0; k < M; ++k)
+			z_loop.at(k) = x.at(k) + 2.0f * y.at(k) - x.at(k) * y.at(k);
+	}, 10);
+	bool const same = cgp_bench::same_values(z, z_temporary) && cgp_bench::same_values(z, z_loop);
+	std::printf("z = x + 2y - xy on %d floats\n", M);
+	std::printf("  fused expression  : %7.2f ms  %6.2f GB/s\n", t_fused, bytes / t_fused * 1e-6);
+	std::printf("  temporary arrays  : %7.2f ms  %6.2f GB/s\n", t_temporary, bytes / t_temporary * 1e-6);
+	std::printf("  hand written loop : %7.2f ms  %6.2f GB/s  same values: %d\n", t_loop, bytes / t_loop * 1e-6, same);
+
+	// Verlet-like update of vec3 positions, assigned to one of the operands
+	int const N = M / 8;
+	numarray<vec3> p(N), v(N), a(N);
+	for (int k = 0; k < N; ++k) {
+		p[k] = { float(k % 100), 0.0f, 1.0f };
+		v[k] = { 1.0f, 2.0f, 3.0f };
+		a[k] = { 0.0f, -9.8f, 0.0f };
+	}
+	float const dt = 0.01f;
+	double const bytes_vec3 = 4.0 * N * sizeof(vec3); // read p, v, a and write p
+	double const t_vec3 = cgp_bench::best_time_ms([&]() { p = p + dt * v + 0.5f * dt * dt * a; }, 10);
+	std::printf("p = p + dt v + dt^2/2 a on %d vec3\n", N);
+	std::printf("  fused expression  : %7.2f ms  %6.2f GB/s\n", t_vec3, bytes_vec3 / t_vec3 * 1e-6);
+	return 0;
+}
@@ -0,0 +1,76 @@
+// Loading of obj files: single-pass parser on the memory mapped file, against a line-by-line stream parser
+//  Usage: bench_obj_load [grid resolution N (default 700)] - the generated file stores N^2 vertices with uv and normals
+#include "bench_common.hpp"
+
+#include "cgp/03_files/files.hpp"
+#include "cgp/20_format_parser/mesh_loader/mesh_loader.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+using namespace cgp;
+
+// Reference: the file is read once per attribute (positions, uv, normals, faces), each line being parsed with a std::istringstream
+static loader::obj_content reference_read(std::string const& filename)
+{
+	loader::obj_content content;
+	for (int pass = 0; pass < 4; ++pass) {
+		std::ifstream stream(filename);
+		std::string line, key;
+		while (std::getline(stream, line)) {
+			std::istringstream tokens(line);
+			tokens >> key;
+			if (pass == 0 && key == "v") {
+				vec3 p; tokens >> p.x >> p.y >> p.z;
+				content.position.push_back(p);
+			}
+			else if (pass == 1 && key == "vt") {
+				vec2 uv; tokens >> uv.x >> uv.y;
+				content.texture_uv.push_back(uv);
+			}
+			else if (pass == 2 && key == "vn") {
+				vec3 n; tokens >> n.x >> n.y >> n.z;
+				content.normal.push_back(n);
+			}
+			else if (pass == 3 && key == "f") {
+				numarray<int3> polygon;
+				std::string corner;
+				while (tokens >> corner) {
+					int3 idx;
+					std::sscanf(corner.c_str(), "%d/%d/%d", &idx.x, &idx.y, &idx.z);
+					polygon.push_back(idx - int3{ 1,1,1 });
+				}
+				for (int k = 1; k + 1 < polygon.size(); ++k)
+					content.triangle.push_back(numarray_stack<int3, 3>{ polygon[0], polygon[k], polygon[k + 1] });
+			}
+		}
+	}
+	return content;
+}
+
+int main(int argc, char** argv)
+{
+	int const N = argc > 1 ? std::atoi(argv[1]) : 700;
+	std::string const filename = cgp_bench::temporary_file("load.obj");
+	cgp_bench::write_grid_obj(filename, N);
+	double const size_MB = file_get_size(filename) / 1e6;
+	std::printf("obj file: %.1f MB, %d vertices\n", size_MB, N * N);
+
+	loader::obj_content reference, content;
+	double const t_reference = cgp_bench::best_time_ms([&]() { reference = reference_read(filename); }, 1);
+	double const t_parse = cgp_bench::best_time_ms([&]() { content = loader::obj_read_content(filename, 1); });
+	mesh m;
+	mesh_load_file_obj_parameters parameters;
+	parameters.thread_count = 1;
+	double const t_load = cgp_bench::best_time_ms([&]() { m = mesh_load_file_obj(filename, parameters); });
+
+	bool const same = cgp_bench::same_values(reference.position, content.position) && cgp_bench::same_values(reference.texture_uv, content.texture_uv)
+		&& cgp_bench::same_values(reference.normal, content.normal) && cgp_bench::same_values(reference.triangle, content.triangle);
+	std::printf("stream parser (4 passes)       : %8.1f ms  %7.1f MB/s\n", t_reference, size_MB / t_reference * 1e3);
+	std::printf("obj_read_content (1 thread)    : %8.1f ms  %7.1f MB/s  same content: %d\n", t_parse, size_MB / t_parse * 1e3, same);
+	std::printf("mesh_load_file_obj (1 thread)  : %8.1f ms  %7.1f MB/s  %d vertices, %d triangles\n", t_load, size_MB / t_load * 1e3, int(m.position.size()), int(m.connectivity.size()));
+
+	std::filesystem::remove(filename);
+	return 0;
+}
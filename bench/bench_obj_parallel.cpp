@@ -0,0 +1,39 @@
+// Parallel reading of obj files: chunks of lines parsed on the thread pool, for an increasing number of threads
+//  Usage: bench_obj_parallel [grid resolution N (default 700)] [max thread count (default: hardware concurrency)]
+//  The content read with several threads must be bitwise identical to the serial read.
+#include "bench_common.hpp"
+
+#include "cgp/01_base/parallel/parallel.hpp"
+#include "cgp/03_files/files.hpp"
+#include "cgp/20_format_parser/mesh_loader/mesh_loader.hpp"
+
+#include <cstdlib>
+#include <thread>
+
+using namespace cgp;
+
+int main(int argc, char** argv)
+{
+	int const N = argc > 1 ? std::atoi(argv[1]) : 700;
+	int const max_thread = argc > 2 ? std::atoi(argv[2]) : std::max(1, int(std::thread::hardware_concurrency()));
+	std::string const filename = cgp_bench::temporary_file("parallel.obj");
+	cgp_bench::write_grid_obj(filename, N);
+	double const size_MB = file_get_size(filename) / 1e6;
+	std::printf("obj file: %.1f MB, %d vertices, %d hardware threads\n", size_MB, N * N, int(std::thread::hardware_concurrency()));
+
+	loader::obj_content serial;
+	double const t_serial = cgp_bench::best_time_ms([&]() { serial = loader::obj_read_content(filename, 1); });
+	std::printf("obj_read_content  1 thread(s): %8.1f ms  %7.1f MB/s\n", t_serial, size_MB / t_serial * 1e3);
+
+	for (int thread_count = 2; thread_count <= max_thread; thread_count *= 2) {
+		loader::obj_content content;
+		double const t = cgp_bench::best_time_ms([&]() { content = loader::obj_read_content(filename, thread_count); });
+		bool const same = cgp_bench::same_values(serial.position, content.position) && cgp_bench::same_values(serial.texture_uv, content.texture_uv)
+			&& cgp_bench::same_values(serial.normal, content.normal) && cgp_bench::same_values(serial.triangle, content.triangle);
+		std::printf("obj_read_content %2d thread(s): %8.1f ms  %7.1f MB/s  (used %d, speedup x%.2f)  same content: %d\n",
+			thread_count, t, size_MB / t * 1e3, loader::obj_thread_count(thread_count, file_get_size(filename)), t_serial / t, same);
+	}
+
+	std::filesystem::remove(filename);
+	return 0;
+}
@@ -0,0 +1,82 @@
+// Saving of obj files: buffered to_chars writer against a std::ofstream writer flushing every line
+//  Usage: bench_obj_save [sphere resolution N (default 1000)] - the mesh has N x N vertices with uv and normals
+//  The saved mesh is reloaded and its triangle corners must be bitwise identical to the original ones (the loader renumbers the vertices).
+#include "bench_common.hpp"
+
+#include "cgp/03_files/files.hpp"
+#include "cgp/11_mesh/primitive/primitive.hpp"
+#include "cgp/20_format_parser/mesh_loader/mesh_loader.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+using namespace cgp;
+
+// Reference: one stream insertion per value, std::endl after each line, and faces built from temporary strings
+static void reference_save(std::string const& filename, mesh const& m)
+{
+	std::ofstream stream(filename, std::ofstream::out);
+	for (int k = 0; k < m.position.size(); ++k)
+		stream << "v " << m.position[k].x << " " << m.position[k].y << " " << m.position[k].z << std::endl;
+	for (int k = 0; k < m.uv.size(); ++k)
+		stream << "vt " << m.uv[k].x << " " << m.uv[k].y << std::endl;
+	for (int k = 0; k < m.normal.size(); ++k)
+		stream << "vn " << m.normal[k].x << " " << m.normal[k].y << " " << m.normal[k].z << std::endl;
+	for (int k = 0; k < m.connectivity.size(); ++k) {
+		std::string const u0 = str(m.connectivity[k][0] + 1);
+		std::string const u1 = str(m.connectivity[k][1] + 1);
+		std::string const u2 = str(m.connectivity[k][2] + 1);
+		stream << "f " << u0 + "/" + u0 + "/" + u0 << " " << u1 + "/" + u1 + "/" + u1 << " " << u2 + "/" + u2 + "/" + u2 << std::endl;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int const N = argc > 1 ? std::atoi(argv[1]) : 1000;
+	mesh const m = mesh_primitive_sphere(1.0f, { 0,0,0 }, N, N);
+	std::printf("mesh: %d vertices, %d triangles\n", int(m.position.size()), int(m.connectivity.size()));
+
+	std::string const filename_reference = cgp_bench::temporary_file("save_reference.obj");
+	std::string const filename = cgp_bench::temporary_file("save.obj");
+	std::string const filename_soup = cgp_bench::temporary_file("save_soup.obj");
+
+	double const t_reference = cgp_bench::best_time_ms([&]() { reference_save(filename_reference, m); }, 1);
+	double const size_reference = file_get_size(filename_reference) / 1e6;
+	std::printf("ofstream writer      : %8.1f ms  %7.1f MB/s\n", t_reference, size_reference / t_reference * 1e3);
+
+	for (int thread_count : { 1, 4 }) {
+		mesh_save_file_obj_parameters parameters;
+		parameters.thread_count = thread_count;
+		double const t = cgp_bench::best_time_ms([&]() { mesh_save_file_obj(filename, m, parameters); }, 3);
+		double const size = file_get_size(filename) / 1e6;
+		std::printf("mesh_save_file_obj %d : %8.1f ms  %7.1f MB/s (%.1f MB)\n", thread_count, t, size / t * 1e3, size);
+	}
+
+	mesh const reloaded = mesh_load_file_obj(filename);
+	bool exact = reloaded.connectivity.size() == m.connectivity.size();
+	for (size_t k = 0; exact && k < m.connectivity.size(); ++k) {
+		for (int j = 0; j < 3; ++j) {
+			unsigned int const a = m.connectivity[k][j], b = reloaded.connectivity[k][j];
+			exact = exact && std::memcmp(&m.position[a], &reloaded.position[b], sizeof(vec3)) == 0
+				&& std::memcmp(&m.uv[a], &reloaded.uv[b], sizeof(vec2)) == 0 && std::memcmp(&m.normal[a], &reloaded.normal[b], sizeof(vec3)) == 0;
+		}
+	}
+	std::printf("reloaded triangle corners bitwise identical: %d\n", exact);
+
+	numarray<vec3> soup, soup_normal;
+	for (uint3 const& tri : m.connectivity) {
+		for (int j = 0; j < 3; ++j) {
+			soup.push_back(m.position[tri[j]]);
+			soup_normal.push_back(m.normal[tri[j]]);
+		}
+	}
+	double const t_soup = cgp_bench::best_time_ms([&]() { mesh_save_file_obj(filename_soup, soup, soup_normal); }, 3);
+	double const size_soup = file_get_size(filename_soup) / 1e6;
+	std::printf("triangle soup        : %8.1f ms  %7.1f MB/s (%d vertices)\n", t_soup, size_soup / t_soup * 1e3, int(soup.size()));
+
+	std::filesystem::remove(filename_reference);
+	std::filesystem::remove(filename);
+	std::filesystem::remove(filename_soup);
+	return 0;
+}
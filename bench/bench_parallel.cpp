@@ -0,0 +1,78 @@
+// Parallel reductions and element-wise evaluation of numarray on the thread pool, and mat4 kernels
+//  Usage: bench_parallel [number of floats (default 16M)] [max thread count (default 8)]
+//  The results of the reductions must be identical for any number of threads.
+#include "bench_common.hpp"
+
+#include "cgp/01_base/parallel/parallel.hpp"
+#include "cgp/02_numarray/numarray.hpp"
+#include "cgp/06_mat/mat.hpp"
+
+#include <cstdlib>
+#include <thread>
+
+using namespace cgp;
+
+// Time per operation in ns of op(k) applied to the K elements of the arrays
+template <typename F> double time_per_operation_ns(int K, F const& op)
+{
+	int const repeat = 200;
+	return cgp_bench::best_time_ms([&]() {
+		for (int r = 0; r < repeat; ++r)
+			for (int k = 0; k < K; ++k)
+				op(k);
+	}) * 1e6 / (double(repeat) * K);
+}
+
+int main(int argc, char** argv)
+{
+	int const N = argc > 1 ? std::atoi(argv[1]) : (1 << 24);
+	int const max_thread = argc > 2 ? std::atoi(argv[2]) : 8;
+	std::printf("%d floats, %d hardware threads\n", N, int(std::thread::hardware_concurrency()));
+
+	numarray<float> x(N), y(N), z(N);
+	for (int k = 0; k < N; ++k) {
+		x[k] = std::sin(0.001f * k);
+		y[k] = 1.0f + (k % 13) * 0.1f;
+	}
+
+	// Serial reference: plain loop on the calling thread
+	float sum_serial = 0.0f;
+	double const t_serial = cgp_bench::best_time_ms([&]() {
+		float s = 0.0f;
+		for (int k = 0; k < N; ++k)
+			s += x.at(k);
+		sum_serial = s;
+	});
+	std::printf("serial loop sum          : %7.2f ms  (sum %.6g)\n", t_serial, sum_serial);
+
+	float sum_reference = 0.0f;
+	for (int thread_count = 1; thread_count <= max_thread; thread_count *= 2) {
+		set_parallel_thread_count(thread_count);
+		float s = 0.0f, m = 0.0f;
+		double const t_sum = cgp_bench::best_time_ms([&]() { s = sum(x); });
+		double const t_max = cgp_bench::best_time_ms([&]() { m = max(x); });
+		double const t_expression = cgp_bench::best_time_ms([&]() { z = x * y + x; });
+		if (thread_count == 1)
+			sum_reference = s;
+		std::printf("%2d thread(s): sum %7.2f ms, max %7.2f ms, z = x*y+x %7.2f ms  (sum %.6g, identical: %d, max %g)\n",
+			thread_count, t_sum, t_max, t_expression, s, s == sum_reference, m);
+	}
+	set_parallel_thread_count(0);
+
+	// mat4 kernels on arrays of matrices (kept in cache)
+	int const K = 1024;
+	numarray<mat4> a(K), b(K), c(K);
+	numarray<vec4> v(K), w(K);
+	for (int k = 0; k < K; ++k) {
+		a[k] = mat4::build_rotation_from_axis_angle(normalize(vec3{ 1.0f, float(k % 5), 2.0f }), 0.01f * k);
+		a[k](0, 3) = 0.1f * k;
+		b[k] = transpose(a[k]);
+		v[k] = { 1.0f, float(k), 2.0f, 1.0f };
+	}
+	std::printf("mat4*mat4 : %6.1f ns\n", time_per_operation_ns(K, [&](int k) { c.at(k) = a.at(k) * b.at(k); }));
+	std::printf("mat4*vec4 : %6.1f ns\n", time_per_operation_ns(K, [&](int k) { w.at(k) = a.at(k) * v.at(k); }));
+	std::printf("transpose : %6.1f ns\n", time_per_operation_ns(K, [&](int k) { c.at(k) = transpose(a.at(k)); }));
+	std::printf("inverse   : %6.1f ns\n", time_per_operation_ns(K, [&](int k) { c.at(k) = inverse(a.at(k)); }));
+	std::printf("(check %g %g)\n", c[7](0, 3), w[7].x);
+	return 0;
+}
@@ -0,0 +1,65 @@
+// Interpolation and matrix conversion of a set of rotations (ex. the joints of a skeleton): per rotation calls against the batched functions
+//  Usage: bench_rotation_batch [number of joints (default 4096)] [number of frames (default 2000)]
+//  The batched results are compared to the per rotation ones.
+#include "bench_common.hpp"
+
+#include "cgp/09_geometric_transformation/geometric_transformation.hpp"
+
+#include <cstdlib>
+
+using namespace cgp;
+
+static float max_difference(numarray<rotation_transform> const& a, numarray<rotation_transform> const& b)
+{
+	float d = 0.0f;
+	for (int k = 0; k < a.size(); ++k)
+		d = std::max(d, norm(a[k].data - b[k].data));
+	return d;
+}
+static float max_difference(numarray<mat3> const& a, numarray<mat3> const& b)
+{
+	float d = 0.0f;
+	for (int k = 0; k < a.size(); ++k)
+		d = std::max(d, norm(a[k] - b[k]));
+	return d;
+}
+
+int main(int argc, char** argv)
+{
+	int const N = argc > 1 ? std::atoi(argv[1]) : 4096;
+	int const frame = argc > 2 ? std::atoi(argv[2]) : 2000;
+
+	numarray<rotation_transform> A(N), B(N), C(N), C_batch(N);
+	numarray<mat3> M(N), M_batch(N);
+	for (int k = 0; k < N; ++k) {
+		float const u = float(k) / N;
+		A[k] = rotation_axis_angle(normalize(vec3(1, u, 2 * u - 1)), 6 * u);
+		B[k] = rotation_axis_angle(normalize(vec3(u, 1, 0.5f)), 3 * u + 0.2f);
+	}
+
+	// Number of joints processed per ms over all the frames (with a varying interpolation coefficient)
+	auto joints_per_ms = [&](auto const& f) {
+		return double(N) * frame / cgp_bench::best_time_ms([&]() {
+			for (int r = 0; r < frame; ++r)
+				f(float(r) / frame);
+		}, 3);
+	};
+
+	double const scalar_nlerp = joints_per_ms([&](float alpha) { for (int k = 0; k < N; ++k) C[k] = rotation_transform::nlerp(A[k], B[k], alpha); });
+	double const batch_nlerp = joints_per_ms([&](float alpha) { nlerp(A, B, alpha, C_batch); });
+	float const error_nlerp = max_difference(C, C_batch);
+
+	double const scalar_slerp = joints_per_ms([&](float alpha) { for (int k = 0; k < N; ++k) C[k] = rotation_transform::slerp(A[k], B[k], alpha); });
+	double const batch_slerp = joints_per_ms([&](float alpha) { slerp(A, B, alpha, C_batch); });
+	float const error_slerp = max_difference(C, C_batch);
+
+	double const scalar_matrix = joints_per_ms([&](float) { for (int k = 0; k < N; ++k) M[k] = A[k].matrix(); });
+	double const batch_matrix = joints_per_ms([&](float) { convert_rotation_to_matrix(A, M_batch); });
+	float const error_matrix = max_difference(M, M_batch);
+
+	std::printf("%d joints x %d frames (joints/ms)\n", N, frame);
+	std::printf("nlerp  : per rotation %8.0f, batched %8.0f  max difference %g\n", scalar_nlerp, batch_nlerp, error_nlerp);
+	std::printf("slerp  : per rotation %8.0f, batched %8.0f  max difference %g\n", scalar_slerp, batch_slerp, error_slerp);
+	std::printf("matrix : per rotation %8.0f, batched %8.0f  max difference %g\n", scalar_matrix, batch_matrix, error_matrix);
+	return 0;
+}
@@ -0,0 +1,69 @@
+// Rotation of points: quaternion products q (p,0) conj(q), against the expanded form of rotation_transform * vec3, and the bulk transform_points
+//  Usage: bench_rotation_points [number of points (default 4M)]
+#include "bench_common.hpp"
+
+#include "cgp/09_geometric_transformation/geometric_transformation.hpp"
+
+#include <cstdlib>
+
+using namespace cgp;
+
+// Reference: rotation through two quaternion products
+static vec3 rotate_quaternion_product(rotation_transform const& r, vec3 const& p)
+{
+	quaternion const qp(p.x, p.y, p.z, 0.0f);
+	return (r.data * qp * conjugate(r.data)).xyz();
+}
+
+int main(int argc, char** argv)
+{
+	int const N = argc > 1 ? std::atoi(argv[1]) : (1 << 22);
+	numarray<vec3> p(N), p0(N), p_reference(N);
+	numarray<rotation_transform> R(1024);
+	for (int k = 0; k < N; ++k)
+		p0[k] = vec3(std::cos(0.1f * k), 0.001f * k, std::sin(0.3f * k));
+	for (int k = 0; k < 1024; ++k)
+		R[k] = rotation_axis_angle(normalize(vec3(1, k * 0.01f, 2)), 0.01f * k);
+	rotation_transform const r = R[77];
+
+	// Max distance between the rotated points and the reference, relative to the size of the points
+	auto max_difference = [&]() {
+		float d = 0.0f;
+		for (int k = 0; k < N; ++k)
+			d = std::max(d, norm(p.at(k) - p_reference.at(k)) / std::max(1.0f, norm(p0.at(k))));
+		return d;
+	};
+
+	// Single points with 1024 distinct rotations
+	double const t_single_reference = cgp_bench::best_time_ms([&]() {
+		for (int k = 0; k < N; ++k)
+			p_reference.at(k) = rotate_quaternion_product(R.at(k & 1023), p0.at(k));
+	}, 3);
+	double const t_single = cgp_bench::best_time_ms([&]() {
+		for (int k = 0; k < N; ++k)
+			p.at(k) = R.at(k & 1023) * p0.at(k);
+	}, 3);
+	float const difference_single = max_difference();
+
+	// All the points with the same rotation
+	double const t_bulk_reference = cgp_bench::best_time_ms([&]() {
+		for (int k = 0; k < N; ++k)
+			p_reference.at(k) = rotate_quaternion_product(r, p0.at(k));
+	}, 3);
+	double const t_bulk_loop = cgp_bench::best_time_ms([&]() {
+		for (int k = 0; k < N; ++k)
+			p.at(k) = r * p0.at(k);
+	}, 3);
+	double const t_copy = cgp_bench::best_time_ms([&]() { p = p0; }, 3);
+	double const t_bulk = cgp_bench::best_time_ms([&]() {
+		p = p0;
+		transform_points(r, p);
+	}, 3);
+	float const difference_bulk = max_difference();
+
+	std::printf("%d points\n", N);
+	std::printf("1024 distinct rotations: quaternion products %7.1f ms, R*p %7.1f ms  max difference %g\n", t_single_reference, t_single, difference_single);
+	std::printf("one rotation           : quaternion products %7.1f ms, R*p %7.1f ms, transform_points %7.1f ms (including a copy of %.1f ms)  max difference %g\n",
+		t_bulk_reference, t_bulk_loop, t_bulk, t_copy, difference_bulk);
+	return 0;
+}
@@ -0,0 +1,64 @@
+// Evaluation of an SDF expression on a grid: per-voxel scalar calls, batched evaluation, and batched evaluation with interval pruning
+//  Usage: bench_sdf_evaluate [grid resolution N (default 256)]
+//  The batched field must match the scalar one, and the pruned field must give the same marching cube mesh.
+#include "bench_common.hpp"
+
+#include "cgp/12_shape/implicit/implicit.hpp"
+
+#include <cstdlib>
+
+using namespace cgp;
+
+// Per-voxel evaluation through the scalar operator() of the expression
+static void evaluate_scalar(grid_3D<float>& field, sdf_expression const& sdf, spatial_domain_grid_3D const& domain)
+{
+	int3 const& N = domain.samples;
+	field.resize(N.x, N.y, N.z);
+	for (int z = 0; z < N.z; ++z)
+		for (int y = 0; y < N.y; ++y)
+			for (int x = 0; x < N.x; ++x)
+				field(x, y, z) = sdf(domain.position({ x,y,z }));
+}
+
+static void compare(sdf_expression const& sdf, spatial_domain_grid_3D const& domain)
+{
+	grid_3D<float> reference, batched, pruned;
+	double const t_scalar = cgp_bench::best_time_ms([&]() { evaluate_scalar(reference, sdf, domain); }, 1);
+
+	sdf_evaluate_parameters parameters;
+	parameters.thread_count = 1;
+	parameters.pruning = false;
+	double const t_batched = cgp_bench::best_time_ms([&]() { sdf_evaluate(batched, sdf, domain, parameters); }, 1);
+	parameters.pruning = true;
+	double const t_pruned = cgp_bench::best_time_ms([&]() { sdf_evaluate(pruned, sdf, domain, parameters); }, 1);
+
+	float max_difference = 0.0f;
+	for (int k = 0; k < reference.data.size(); ++k)
+		max_difference = std::max(max_difference, std::abs(reference.data[k] - batched.data[k]));
+
+	mesh const mesh_reference = marching_cube(reference, domain, 0.0f);
+	mesh const mesh_pruned = marching_cube(pruned, domain, 0.0f);
+	bool const same_mesh = cgp_bench::same_values(mesh_reference.position, mesh_pruned.position) && cgp_bench::same_values(mesh_reference.connectivity, mesh_pruned.connectivity);
+
+	std::printf("  scalar per voxel  : %8.1f ms\n", t_scalar);
+	std::printf("  batched           : %8.1f ms  max difference %g\n", t_batched, max_difference);
+	std::printf("  batched + pruning : %8.1f ms  identical mesh: %d (%d triangles)\n", t_pruned, same_mesh, int(mesh_pruned.connectivity.size()));
+}
+
+int main(int argc, char** argv)
+{
+	int const N = argc > 1 ? std::atoi(argv[1]) : 256;
+	spatial_domain_grid_3D const domain = spatial_domain_grid_3D::from_center_length({ 0,0,0 }, { 3,3,3 }, { N,N,N });
+	std::printf("grid: %d^3 samples, 1 thread\n", N);
+
+	sdf_expression csg = sdf_smooth_union(
+		sdf_difference(sdf_box({ 0,0,0 }, { 0.6f,0.6f,0.6f }), sdf_sphere({ 0,0,0 }, 0.75f)),
+		sdf_rotation(sdf_translation(sdf_torus(0.9f, 0.15f), { 0,0,0.2f }), rotation_transform::from_axis_angle({ 1,0,0 }, 0.4f)), 0.1f);
+	csg = sdf_union(csg, sdf_capsule({ -1,-1,-1 }, { 1,-1,1 }, 0.1f));
+	std::printf("CSG of 5 primitives\n");
+	compare(csg, domain);
+
+	std::printf("noise displaced sphere\n");
+	compare(sdf_noise_displacement(sdf_sphere({ 0,0,0 }, 0.8f), 0.1f, 2.0f), domain);
+	return 0;
+}
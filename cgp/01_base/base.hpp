@@ -4,6 +4,9 @@
 #include "error/error.hpp"
 #include "basic_types/basic_types.hpp"
 #include "stl/stl.hpp"
+#include "memory/aligned_allocator.hpp"
+#include "memory/frame_arena.hpp"
+#include "parallel/parallel.hpp"
 #include "types/types.hpp"
 #include "string/string.hpp"
 
@@ -111,8 +111,8 @@ std::string type_str(unsigned long long);
 
 template <typename T> struct cgp_trait{};
 template <> struct cgp_trait<float> {
-    static float one() { return 1.0f; }
-    static float zero() { return 0.0f; }
+    static constexpr float one() { return 1.0f; }
+    static constexpr float zero() { return 0.0f; }
 };
 
 
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace cgp
+{
+
+// Allocator for std::vector returning memory aligned on Alignment bytes
+//  Default alignment (64 bytes) matches a cache line and the widest SIMD registers, so that contiguous arrays of float
+//  can be processed with aligned full-width loads.
+template <typename T, size_t Alignment = 64>
+struct aligned_allocator
+{
+    static_assert(Alignment >= alignof(T) && (Alignment & (Alignment-1)) == 0, "Alignment must be a power of 2 compatible with the type");
+
+    using value_type = T;
+    template <typename U> struct rebind { using other = aligned_allocator<U, Alignment>; };
+
+    aligned_allocator() = default;
+    template <typename U> aligned_allocator(aligned_allocator<U, Alignment> const&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n*sizeof(T), std::align_val_t(Alignment))); }
+    void deallocate(T* p, size_t) { ::operator delete(p, std::align_val_t(Alignment)); }
+};
+
+template <typename T, typename U, size_t Alignment>
+bool operator==(aligned_allocator<T, Alignment> const&, aligned_allocator<U, Alignment> const&) { return true; }
+template <typename T, typename U, size_t Alignment>
+bool operator!=(aligned_allocator<T, Alignment> const&, aligned_allocator<U, Alignment> const&) { return false; }
+
+// std::vector with aligned storage
+template <typename T> using aligned_vector = std::vector<T, aligned_allocator<T>>;
+
+}
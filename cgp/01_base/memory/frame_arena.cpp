@@ -0,0 +1,67 @@
+#include "frame_arena.hpp"
+
+#include "../error/error.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+namespace cgp
+{
+    frame_arena& frame_arena::global()
+    {
+        static frame_arena arena;
+        return arena;
+    }
+
+    void* frame_arena::allocate(size_t size, size_t alignment)
+    {
+        current_frame.allocation++;
+        current_frame.size += size;
+        live_allocation++;
+
+        if (block == nullptr) {
+            capacity = initial_capacity;
+            block.reset(new char[capacity]);
+            offset = 0;
+            current_frame.heap_allocation++;
+        }
+
+        uintptr_t const base = reinterpret_cast<uintptr_t>(block.get());
+        size_t const aligned_offset = ((base + offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+        if (aligned_offset + size <= capacity) {
+            offset = aligned_offset + size;
+            return block.get() + aligned_offset;
+        }
+
+        // The block is full: the memory is taken on the heap until the next reset
+        overflow.emplace_back(new char[size + alignment]);
+        current_frame.heap_allocation++;
+        uintptr_t const p = reinterpret_cast<uintptr_t>(overflow.back().get());
+        return reinterpret_cast<void*>((p + alignment - 1) & ~(uintptr_t(alignment) - 1));
+    }
+
+    void frame_arena::deallocate(void*, size_t)
+    {
+        live_allocation--;
+    }
+
+    void frame_arena::reset()
+    {
+        if (live_allocation != 0)
+            warning_cgp("frame_arena reset while data allocated during the frame are still in use", std::to_string(live_allocation) + " allocation(s) not released");
+
+        last_frame = current_frame;
+        current_frame = statistics_structure();
+        offset = 0;
+        live_allocation = 0;
+
+        // Enlarge the block to hold all the data of the last frame in a single block
+        if (!overflow.empty()) {
+            capacity = std::max(2 * capacity, last_frame.size + last_frame.allocation * alignof(std::max_align_t));
+            block.reset(new char[capacity]);
+            overflow.clear();
+            current_frame.heap_allocation++;
+        }
+    }
+}
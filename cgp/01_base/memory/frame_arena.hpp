@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace cgp
+{
+
+// Bump allocator for temporary data that only lives during one frame
+//  Allocations are served by advancing an offset in a memory block, and all of them are released at once by reset(),
+//  called once per frame by the animation loop. Deallocating an individual array does not release its memory.
+//  When a frame needs more memory than the block, extra blocks are taken on the heap, and the block is enlarged at the
+//  next reset so that the following frames are served without any heap allocation.
+//  The arena is not thread-safe: it is meant for the temporaries of the main (display) thread.
+struct frame_arena
+{
+    // Allocation counters of a frame
+    struct statistics_structure {
+        int allocation = 0;      // allocations served by the arena (heap allocations avoided)
+        int heap_allocation = 0; // heap allocations done by the arena itself (growth of its storage)
+        size_t size = 0;         // total size requested in bytes
+    };
+
+    void* allocate(size_t size, size_t alignment);
+    void deallocate(void* p, size_t size);
+
+    // Release all the allocations of the frame. Arrays allocated during the frame must not be used anymore.
+    void reset();
+
+    // Statistics of the last completed frame, and of the current one
+    statistics_structure last_frame;
+    statistics_structure current_frame;
+
+    // Initial size of the memory block in bytes
+    size_t initial_capacity = size_t(1) << 20;
+
+    // Arena used by frame_allocator
+    static frame_arena& global();
+
+private:
+    std::unique_ptr<char[]> block;
+    size_t capacity = 0;
+    size_t offset = 0;
+    std::vector<std::unique_ptr<char[]>> overflow;
+    int live_allocation = 0;
+};
+
+// Allocator for containers using the frame arena (numarray<T, frame_allocator<T>>, std::vector<T, frame_allocator<T>>)
+//  The container must be destroyed before the end of the frame.
+template <typename T>
+struct frame_allocator
+{
+    using value_type = T;
+
+    frame_allocator() = default;
+    template <typename U> frame_allocator(frame_allocator<U> const&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(frame_arena::global().allocate(n*sizeof(T), alignof(T))); }
+    void deallocate(T* p, size_t n) { frame_arena::global().deallocate(p, n*sizeof(T)); }
+};
+
+template <typename T, typename U> bool operator==(frame_allocator<T> const&, frame_allocator<U> const&) { return true; }
+template <typename T, typename U> bool operator!=(frame_allocator<T> const&, frame_allocator<U> const&) { return false; }
+
+}
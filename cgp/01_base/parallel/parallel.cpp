@@ -0,0 +1,166 @@
+#include "parallel.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cgp
+{
+
+namespace
+{
+    std::atomic<int> global_thread_count(0);
+
+    // True on the threads running a task of the pool (nested parallel loops run serially)
+    thread_local bool inside_parallel_task = false;
+
+    // Pool of worker threads waiting for jobs. A job is a set of N_task tasks taken in order by the threads with an atomic counter.
+    //  The worker k (k>=1) takes part to a job if k < job_thread_count, the calling thread being the worker 0.
+    struct thread_pool
+    {
+        std::mutex job_mutex;   // Locked during a job: a single job at a time
+        std::mutex mutex;       // Protects the state below
+        std::condition_variable wake_up;
+        std::condition_variable job_done;
+        std::vector<std::thread> workers;
+        bool stop = false;
+
+        std::function<void(int64_t, int)> const* task = nullptr;
+        int64_t N_task = 0;
+        int job_thread_count = 0;
+        uint64_t job_id = 0;
+        int running = 0;        // Number of workers that haven't finished the current job
+        std::exception_ptr error;
+        std::atomic<int64_t> next_task{ 0 };
+
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            wake_up.notify_all();
+            for (std::thread& t : workers)
+                t.join();
+        }
+
+        void run_tasks(int worker)
+        {
+            for (int64_t k = next_task++; k < N_task; k = next_task++) {
+                try {
+                    (*task)(k, worker);
+                }
+                catch (...) {
+                    // Keep the first exception (rethrown by the calling thread), and skip the remaining tasks
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error)
+                        error = std::current_exception();
+                    next_task = N_task;
+                }
+            }
+        }
+
+        void worker_loop(int worker, uint64_t last_job)
+        {
+            inside_parallel_task = true;
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake_up.wait(lock, [&]() { return stop || job_id != last_job; });
+                if (stop)
+                    return;
+                last_job = job_id;
+                bool const participate = worker < job_thread_count;
+
+                lock.unlock();
+                if (participate)
+                    run_tasks(worker);
+                lock.lock();
+
+                if (--running == 0)
+                    job_done.notify_one();
+            }
+        }
+
+        void run(int64_t N_task_arg, std::function<void(int64_t, int)> const& task_arg, int thread_count)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                while (int(workers.size()) < thread_count - 1)
+                    workers.emplace_back(&thread_pool::worker_loop, this, int(workers.size()) + 1, job_id);
+
+                task = &task_arg;
+                N_task = N_task_arg;
+                job_thread_count = thread_count;
+                next_task = 0;
+                error = nullptr;
+                running = int(workers.size());
+                ++job_id;
+            }
+            wake_up.notify_all();
+
+            inside_parallel_task = true;
+            run_tasks(0);
+            inside_parallel_task = false;
+
+            std::unique_lock<std::mutex> lock(mutex);
+            job_done.wait(lock, [&]() { return running == 0; });
+            task = nullptr;
+            if (error)
+                std::rethrow_exception(error);
+        }
+    };
+
+    thread_pool& get_thread_pool()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+}
+
+void set_parallel_thread_count(int thread_count)
+{
+    assert_cgp(thread_count >= 0, "The number of threads must be positive (or 0 for all the hardware threads)");
+    global_thread_count = thread_count;
+}
+
+int parallel_thread_count(int thread_count)
+{
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    currently_unused(thread_count);
+    return 1;
+#else
+    if (thread_count <= 0)
+        thread_count = global_thread_count;
+    if (thread_count <= 0)
+        thread_count = std::max(1, int(std::thread::hardware_concurrency()));
+    return thread_count;
+#endif
+}
+
+namespace detail
+{
+    void parallel_run(int64_t N_task, std::function<void(int64_t, int)> const& task, int thread_count)
+    {
+        int const N_thread = int(std::min(int64_t(thread_count), N_task));
+        if (N_thread <= 1 || inside_parallel_task) {
+            for (int64_t k = 0; k < N_task; ++k)
+                task(k, 0);
+            return;
+        }
+
+        thread_pool& pool = get_thread_pool();
+        std::unique_lock<std::mutex> job_lock(pool.job_mutex, std::try_to_lock);
+        if (job_lock.owns_lock() == false) {
+            // The pool is used by another thread
+            for (int64_t k = 0; k < N_task; ++k)
+                task(k, 0);
+            return;
+        }
+        pool.run(N_task, task, N_thread);
+    }
+}
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "../error/error.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace cgp
+{
+
+// Parallel loops on a pool of threads
+//
+// - parallel_for(N, f): calls f(begin, end) on consecutive chunks [begin,end[ of [0,N[
+// - parallel_reduce(N, reduce_chunk, combine): reduction of [0,N[ computed chunk by chunk
+// - parallel_for_task(N_task, f): calls f(task, worker) on independent tasks distributed dynamically between the threads
+//
+// The threads are created once and reused by the following calls (the calling thread takes part to the work).
+// The chunks only depend on N and the grain size, not on the number of threads: the results (including floating point rounding
+//   of the reductions) are identical whatever the number of threads.
+// A parallel loop called from a task of another parallel loop (or while another thread is using the pool) runs on the calling thread.
+
+// Global number of threads used by the parallel loops (0: all the hardware threads - default value, 1: run on the calling thread only)
+void set_parallel_thread_count(int thread_count);
+// Number of threads to use for a requested thread_count: thread_count if it is > 0, otherwise the global number of threads.
+//  Always 1 when threads are not available (Emscripten build without pthreads).
+int parallel_thread_count(int thread_count = 0);
+
+// Size of the chunks of parallel_for and parallel_reduce: arrays smaller than this size are processed directly on the calling thread
+constexpr int64_t parallel_grain = 1 << 16;
+
+template <typename F> void parallel_for(int64_t N, F const& f, int64_t grain = parallel_grain);
+template <typename Reduce, typename Combine> auto parallel_reduce(int64_t N, Reduce const& reduce_chunk, Combine const& combine, int64_t grain = parallel_grain);
+template <typename F> void parallel_for_task(int64_t N_task, F const& f, int thread_count = 0);
+
+namespace detail
+{
+    // Run task(k, worker) for all k in [0,N_task[ on thread_count threads (worker in [0,thread_count[ identifies the thread)
+    void parallel_run(int64_t N_task, std::function<void(int64_t, int)> const& task, int thread_count);
+}
+
+}
+
+
+
+namespace cgp
+{
+
+// Call f(begin, end) on the chunks [k*grain, min((k+1)*grain, N)[. Arrays with N <= grain are processed by a single call f(0,N) on the calling thread.
+template <typename F> void parallel_for(int64_t N, F const& f, int64_t grain)
+{
+    if (N <= 0)
+        return;
+    if (N <= grain) {
+        f(int64_t(0), N);
+        return;
+    }
+    int64_t const N_chunk = (N + grain - 1) / grain;
+    detail::parallel_run(N_chunk, [&](int64_t k, int) { f(k * grain, std::min(N, (k + 1) * grain)); }, parallel_thread_count());
+}
+
+// Reduction of [0,N[ (N>0): value_k = reduce_chunk(begin, end) is computed on each chunk, and the values are combined in the order of the chunks:
+//   combine(...combine(combine(value_0, value_1), value_2)..., value_last)
+// Arrays with N <= grain return reduce_chunk(0,N) computed on the calling thread.
+template <typename Reduce, typename Combine> auto parallel_reduce(int64_t N, Reduce const& reduce_chunk, Combine const& combine, int64_t grain)
+{
+    using T = decltype(reduce_chunk(int64_t(0), N));
+    assert_cgp(N > 0, "Cannot compute a reduction on an empty range");
+    if (N <= grain)
+        return reduce_chunk(int64_t(0), N);
+
+    int64_t const N_chunk = (N + grain - 1) / grain;
+    std::unique_ptr<T[]> value(new T[N_chunk]); // (not a std::vector, that would pack T=bool in bits shared between threads)
+    detail::parallel_run(N_chunk, [&](int64_t k, int) { value[k] = reduce_chunk(k * grain, std::min(N, (k + 1) * grain)); }, parallel_thread_count());
+
+    T result = value[0];
+    for (int64_t k = 1; k < N_chunk; ++k)
+        result = combine(result, value[k]);
+    return result;
+}
+
+// Call f(task, worker) for all task in [0,N_task[. The tasks are distributed dynamically between parallel_thread_count(thread_count) threads,
+//  worker in [0, parallel_thread_count(thread_count)[ identifies the thread running the task (ex. to use per-thread scratch buffers).
+template <typename F> void parallel_for_task(int64_t N_task, F const& f, int thread_count)
+{
+    detail::parallel_run(N_task, [&](int64_t k, int worker) { f(k, worker); }, parallel_thread_count(thread_count));
+}
+
+}
@@ -2,3 +2,5 @@
 
 #include "numarray_stack/numarray_stack.hpp"
 #include "numarray/numarray.hpp"
+#include "numarray_soa/numarray_soa.hpp"
+#include "numarray_view/numarray_view.hpp"
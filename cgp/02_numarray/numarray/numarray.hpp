@@ -1,7 +1,10 @@
 #pragma once
 
 #include "cgp/01_base/base.hpp"
+#include "numarray_fwd.hpp"
+#include "numarray_expression.hpp"
 
+#include <cstdint>
 #include <vector>
 #include <iostream>
 
@@ -16,136 +19,130 @@ namespace cgp
  *
  * The numarray structure is a wrapper around an std::vector with additional convenient functionalities
  * - Overloaded operators + - * / as well as common outputs
+ *   (operators return expressions evaluated in a single loop on assignment - see numarray_expression.hpp)
  * - Strict bound checking with operator [] and () (unless cgp_NO_DEBUG is defined)
  *
  * Numarray follows the main syntax than std::vector
  * Elements in a numarray are stored contiguously in memory (use std::vector internally)
+ * The allocator of the std::vector can be changed with the second template parameter (std::allocator by default)
+ * Sizes and indices are 64 bits integers (int64_t): numarrays with more than 2^31 elements are supported
  *
  **/
-template <typename T>
+template <typename T, typename Allocator>
 struct numarray
 {
     /** Internal data stored as std::vector */
-    std::vector<T> data;
+    std::vector<T, Allocator> data;
 
     // Constructors
     numarray();                             // Empty numarray - no elements 
-    numarray(int size);                     // numarray with a given size 
+    numarray(int64_t size);                 // numarray with a given size 
     numarray(std::initializer_list<T> arg); // Inline initialization using { } 
-    numarray(std::vector<T> const& arg);    // Direct initialization from std::vector 
+    numarray(std::vector<T, Allocator> const& arg);    // Direct initialization from std::vector 
+
+    /** Evaluation of an element-wise expression (such as a+2.0f*b) in a single loop, without temporary numarray */
+    template <typename E, typename = std::enable_if_t<is_numarray_expression_of_shape<E, size_t>::value>> numarray(E const& expression);
+    template <typename E, typename = std::enable_if_t<is_numarray_expression_of_shape<E, size_t>::value>> numarray& operator=(E const& expression);
 
     /** Similar to matlab linespace 
     * Linear interpolation between p1 and p2 along N variable */
-    static numarray<T> linespace(T const& p1, T const& p2, int N);
+    static numarray linespace(T const& p1, T const& p2, int N);
 
     /** Container size similar to vector.size() */
-    int size() const;
+    int64_t size() const;
     /** Resize container to a new size (similar to vector.resize()) */
-    numarray<T>& resize(int size);
+    numarray& resize(int64_t size);
     /** Resize container to a new size, and clear it initialy to delete previous values */
-    numarray<T>& resize_clear(int size);
+    numarray& resize_clear(int64_t size);
     /** Add an element at the end of the container (similar to vector.push_back()) */
-    numarray<T>& push_back(T const& value);
+    numarray& push_back(T const& value);
     /** Add an numarray of elements at the end of the container */
-    numarray<T>& push_back(numarray<T> const& value);
+    numarray& push_back(numarray const& value);
     /** Remove all elements of the container, new size is 0 (similar to vector.clear()) */
-    numarray<T>& clear();
+    numarray& clear();
     /** Fill the container with the same element (from index 0 to size-1) */
-    numarray<T>& fill(T const& value);
+    numarray& fill(T const& value);
 
 
     /** Element access
      * Allows numarray[i], numarray(i), and numarray.at(i)
      * Bound checking is performed unless cgp_NO_DEBUG is defined. */
-    T const& operator[](int index) const;
-    T& operator[](int index);
-    T const& operator()(int index) const;
-    T& operator()(int index);
+    T const& operator[](int64_t index) const;
+    T& operator[](int64_t index);
+    T const& operator()(int64_t index) const;
+    T& operator()(int64_t index);
 
     /** Direct access to the value - doesn't check index bounds*/
-    inline T const& at(int index) const { return data[index]; }
-    inline T& at(int index)             { return data[index]; }
+    inline T const& at(int64_t index) const { return data[index]; }
+    inline T& at(int64_t index)             { return data[index]; }
 
     /** Iterators
      * Iterators on numarray are compatible with STL syntax
      * allows "forall" loops (for(auto& e : numarray) {...}) */
-    typename std::vector<T>::iterator begin();
-    typename std::vector<T>::iterator end();
-    typename std::vector<T>::const_iterator begin() const;
-    typename std::vector<T>::const_iterator end() const;
-    typename std::vector<T>::const_iterator cbegin() const;
-    typename std::vector<T>::const_iterator cend() const;
+    typename std::vector<T, Allocator>::iterator begin();
+    typename std::vector<T, Allocator>::iterator end();
+    typename std::vector<T, Allocator>::const_iterator begin() const;
+    typename std::vector<T, Allocator>::const_iterator end() const;
+    typename std::vector<T, Allocator>::const_iterator cbegin() const;
+    typename std::vector<T, Allocator>::const_iterator cend() const;
 
     /** Direct access to the value - doesn't check index bounds*/
     // Depreciated function - use at() instead
-    T const& at_unsafe(int index) const;
-    T& at_unsafe(int index);
+    T const& at_unsafe(int64_t index) const;
+    T& at_unsafe(int64_t index);
 };
 
-template <typename T> std::string type_str(numarray<T> const&);
+/** numarray storing its elements in the frame arena (see frame_arena.hpp)
+ * Temporary arrays computed at every frame avoid heap allocations. They must be destroyed before the end of the frame. */
+template <typename T> using numarray_frame = numarray<T, frame_allocator<T>>;
+
+template <typename T, typename Allocator> std::string type_str(numarray<T, Allocator> const&);
 
 /** Display all elements of the numarray.*/
-template <typename T> std::ostream& operator<<(std::ostream& s, numarray<T> const& v);
+template <typename T, typename Allocator> std::ostream& operator<<(std::ostream& s, numarray<T, Allocator> const& v);
 
 /** Convert all elements of the numarray to a string.
  * \param numarray: the input numarray
  * \param separator: the separator between each element 
  * \param begin/end: character added in the beginning/end of the display
  */
-template <typename T> std::string str(numarray<T> const& v, std::string const& separator=" ", std::string const& begin="", std::string const& end="");
+template <typename T, typename Allocator> std::string str(numarray<T, Allocator> const& v, std::string const& separator=" ", std::string const& begin="", std::string const& end="");
 
-template <typename T> int size_in_memory(numarray<T> const& v);
-template <typename T> auto const* ptr(numarray<T> const& v);
+template <typename T, typename Allocator> int size_in_memory(numarray<T, Allocator> const& v);
+template <typename T, typename Allocator> auto const* ptr(numarray<T, Allocator> const& v);
 
 /** Equality check
  * Check equality (element by element) between two numarrays.
  * numarrays with different size are always considered as not equal.
  * Only approximated equality is performed for comprison with float (absolute value between floats) */
-template <typename T> bool is_equal(numarray<T> const& a, numarray<T> const& b);
+template <typename T, typename Allocator> bool is_equal(numarray<T, Allocator> const& a, numarray<T, Allocator> const& b);
 /** Allows to check value equality between different type (float and int for instance). */
-template <typename T1, typename T2> bool is_equal(numarray<T1> const& a, numarray<T2> const& b);
+template <typename T1, typename T2, typename A1, typename A2> bool is_equal(numarray<T1, A1> const& a, numarray<T2, A2> const& b);
 
 
-template <typename T> T max(numarray<T> const& v);
-template <typename T> T min(numarray<T> const& v);
+template <typename T, typename Allocator> T max(numarray<T, Allocator> const& v);
+template <typename T, typename Allocator> T min(numarray<T, Allocator> const& v);
 
 
 /** Compute average value of all elements of the numarray.*/
-template <typename T> T average(numarray<T> const& a);
-template <typename T> T sum(numarray<T> const& a);
+template <typename T, typename Allocator> T average(numarray<T, Allocator> const& a);
+template <typename T, typename Allocator> T sum(numarray<T, Allocator> const& a);
 
 
 /** Math operators
- * Common mathematical operations between numarrays, and scalar or element values. */
-template <typename T> numarray<T>  operator-(numarray<T> const& a);
-
-template <typename T> numarray<T>& operator+=(numarray<T>& a, numarray<T> const& b);
-template <typename T> numarray<T>  operator+(numarray<T> const& a, numarray<T> const& b);
-
-template <typename T> numarray<T>& operator-=(numarray<T>& a, numarray<T> const& b);
-template <typename T> numarray<T>  operator-(numarray<T> const& a, numarray<T> const& b);
-
-template <typename T> numarray<T>& operator*=(numarray<T>& a, numarray<T> const& b);
-template <typename T> numarray<T>  operator*(numarray<T> const& a, numarray<T> const& b);
-template <typename T> numarray<T>& operator*=(numarray<T>& a, float b);
-template <typename T> numarray<T>  operator*(numarray<T> const& a, float b);
-template <typename T> numarray<T>  operator*(float a, numarray<T> const& b);
-
-template <typename T> numarray<T>& operator/=(numarray<T>& a, numarray<T> const& b);
-template <typename T> numarray<T>& operator/=(numarray<T>& a, float b);
-template <typename T> numarray<T>  operator/(numarray<T> const& a, numarray<T> const& b);
-template <typename T> numarray<T>  operator/(numarray<T> const& a, float b);
+ * Common mathematical operations between numarrays, and scalar or element values are defined in numarray_expression.hpp
+ * (a+b, a-b, a*b, a/b, -a, a*float, a+element, a+=b, etc.) */
 
 // Allow componentwise operations
-template <typename T> numarray<T>  sub(numarray<T> const& a, T const& b);
-template <typename T> numarray<T>  add(numarray<T> const& a, T const& b);
-template <typename T> numarray<T>  mul(numarray<T> const& a, T const& b);
-template <typename T> numarray<T>  div(numarray<T> const& a, T const& b);
+template <typename T, typename Allocator> numarray<T, Allocator>  sub(numarray<T, Allocator> const& a, T const& b);
+template <typename T, typename Allocator> numarray<T, Allocator>  add(numarray<T, Allocator> const& a, T const& b);
+template <typename T, typename Allocator> numarray<T, Allocator>  mul(numarray<T, Allocator> const& a, T const& b);
+template <typename T, typename Allocator> numarray<T, Allocator>  div(numarray<T, Allocator> const& a, T const& b);
 
-template <typename T> numarray<T>  sub(T const& a, numarray<T> const& b);
-template <typename T> numarray<T>  add(T const& a, numarray<T> const& b);
-template <typename T> numarray<T>  mul(T const& a, numarray<T> const& b);
-template <typename T> numarray<T>  div(T const& a, numarray<T> const& b);
+template <typename T, typename Allocator> numarray<T, Allocator>  sub(T const& a, numarray<T, Allocator> const& b);
+template <typename T, typename Allocator> numarray<T, Allocator>  add(T const& a, numarray<T, Allocator> const& b);
+template <typename T, typename Allocator> numarray<T, Allocator>  mul(T const& a, numarray<T, Allocator> const& b);
+template <typename T, typename Allocator> numarray<T, Allocator>  div(T const& a, numarray<T, Allocator> const& b);
 
 }
 
@@ -158,80 +155,96 @@ template <typename T> numarray<T>  div(T const& a, numarray<T> const& b);
 namespace cgp
 {
 
-template <typename T>
-numarray<T>::numarray()
+template <typename T, typename Allocator>
+numarray<T, Allocator>::numarray()
     :data()
 {}
 
-template <typename T>
-numarray<T>::numarray(int size)
+template <typename T, typename Allocator>
+numarray<T, Allocator>::numarray(int64_t size)
     :data(size)
 {}
 
-template <typename T>
-numarray<T>::numarray(std::initializer_list<T> arg)
+template <typename T, typename Allocator>
+numarray<T, Allocator>::numarray(std::initializer_list<T> arg)
     :data(arg)
 {}
 
-template <typename T>
-numarray<T>::numarray(const std::vector<T>& arg)
+template <typename T, typename Allocator>
+numarray<T, Allocator>::numarray(const std::vector<T, Allocator>& arg)
     :data(arg)
 {}
 
-template <typename T>
-int numarray<T>::size() const
+template <typename T, typename Allocator>
+template <typename E, typename>
+numarray<T, Allocator>::numarray(E const& expression)
+    :data(size_t(expression.size()))
+{
+    evaluate_in(data.data(), expression, data.size());
+}
+
+template <typename T, typename Allocator>
+template <typename E, typename>
+numarray<T, Allocator>& numarray<T, Allocator>::operator=(E const& expression)
+{
+    evaluate_in(data, expression);
+    return *this;
+}
+
+template <typename T, typename Allocator>
+int64_t numarray<T, Allocator>::size() const
 {
     return data.size();
 }
 
-template <typename T>
-numarray<T>& numarray<T>::resize(int size)
+template <typename T, typename Allocator>
+numarray<T, Allocator>& numarray<T, Allocator>::resize(int64_t size)
 {
     assert_cgp_no_msg(size>=0);
     data.resize(size);
     return *this;
 }
 
-template <typename T>
-numarray<T>& numarray<T>::resize_clear(int size)
+template <typename T, typename Allocator>
+numarray<T, Allocator>& numarray<T, Allocator>::resize_clear(int64_t size)
 {
     clear();
     resize(size);
     return *this;
 }
 
-template <typename T>
-numarray<T>& numarray<T>::push_back(T const& value)
+template <typename T, typename Allocator>
+numarray<T, Allocator>& numarray<T, Allocator>::push_back(T const& value)
 {
     data.push_back(value);
     return *this;
 }
 
-template <typename T>
-numarray<T>& numarray<T>::push_back(numarray<T> const& value)
+template <typename T, typename Allocator>
+numarray<T, Allocator>& numarray<T, Allocator>::push_back(numarray<T, Allocator> const& value)
 {
     for(T const& element : value)
         data.push_back(element);
     return *this;
 }
 
-template <typename T>
-numarray<T>& numarray<T>::clear()
+template <typename T, typename Allocator>
+numarray<T, Allocator>& numarray<T, Allocator>::clear()
 {
     data.clear();
     return *this;
 }
 
-template <typename T>
-numarray<T>& numarray<T>::fill(T const& value)
+template <typename T, typename Allocator>
+numarray<T, Allocator>& numarray<T, Allocator>::fill(T const& value)
 {
-    int const N = size();
-    for (int k = 0; k < N; ++k)
+    int64_t const N = size();
+    for (int64_t k = 0; k < N; ++k)
         data[k] = value;
     return *this;
 }
 
-template <typename T> std::string type_str(numarray<T> const&)
+template <typename T, typename Allocator> std::string type_str(numarray<T, Allocator> const&)
 {
     using cgp::type_str;
     return "numarray<" + type_str(T()) + ">";
@@ -239,11 +252,11 @@ template <typename T> std::string type_str(numarray<T> const&)
 
 
 #ifndef cgp_NO_DEBUG
-template <typename T>
-void check_index_bounds(int index, numarray<T> const& data)
+template <typename T, typename Allocator>
+void check_index_bounds(int64_t index, numarray<T, Allocator> const& data)
 {
 
-    int const N = data.size();
+    int64_t const N = data.size();
     if (index < 0 || index >= N)
     {
         std::string msg = "\n";
@@ -295,33 +308,33 @@ void check_index_bounds(int index, numarray<T> const& data)
     }
 }
 #else
-template <typename T> void check_index_bounds(int , numarray<T> const& ) {}
+template <typename T, typename Allocator> void check_index_bounds(int64_t , numarray<T, Allocator> const& ) {}
 #endif
 
 
-template <typename T>
-T const& numarray<T>::operator[](int index) const
+template <typename T, typename Allocator>
+T const& numarray<T, Allocator>::operator[](int64_t index) const
 {
     check_index_bounds(index, *this);
     return data[index];
 }
 
-template <typename T>
-T& numarray<T>::operator[](int index)
+template <typename T, typename Allocator>
+T& numarray<T, Allocator>::operator[](int64_t index)
 {
     check_index_bounds(index, *this);
     return data[index];
 }
 
-template <typename T>
-T const& numarray<T>::operator()(int index) const
+template <typename T, typename Allocator>
+T const& numarray<T, Allocator>::operator()(int64_t index) const
 {
     check_index_bounds(index, *this);
     return data[index];
 }
 
-template <typename T>
-T& numarray<T>::operator()(int index)
+template <typename T, typename Allocator>
+T& numarray<T, Allocator>::operator()(int64_t index)
 {
     check_index_bounds(index, *this);
     return data[index];
@@ -330,14 +343,14 @@ T& numarray<T>::operator()(int index)
 
 
 
-template <typename T>
-T const& numarray<T>::at_unsafe(int index) const
+template <typename T, typename Allocator>
+T const& numarray<T, Allocator>::at_unsafe(int64_t index) const
 {
     return data[index];
 }
 
-template <typename T>
-T& numarray<T>::at_unsafe(int index)
+template <typename T, typename Allocator>
+T& numarray<T, Allocator>::at_unsafe(int64_t index)
 {
     return data[index];
 }
@@ -345,284 +358,160 @@ T& numarray<T>::at_unsafe(int index)
 
 
 
-template <typename T>
-typename std::vector<T>::iterator numarray<T>::begin()
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator numarray<T, Allocator>::begin()
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::iterator numarray<T>::end()
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator numarray<T, Allocator>::end()
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator numarray<T>::begin() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator numarray<T, Allocator>::begin() const
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator numarray<T>::end() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator numarray<T, Allocator>::end() const
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator numarray<T>::cbegin() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator numarray<T, Allocator>::cbegin() const
 {
     return data.cbegin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator numarray<T>::cend() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator numarray<T, Allocator>::cend() const
 {
     return data.cend();
 }
 
 
-template <typename T> std::ostream& operator<<(std::ostream& s, numarray<T> const& v)
+template <typename T, typename Allocator> std::ostream& operator<<(std::ostream& s, numarray<T, Allocator> const& v)
 {
     std::string const s_out = str(v);
     s << s_out;
     return s;
 }
-template <typename T> std::string str(numarray<T> const& v, std::string const& separator, std::string const& begin, std::string const& end)
+template <typename T, typename Allocator> std::string str(numarray<T, Allocator> const& v, std::string const& separator, std::string const& begin, std::string const& end)
 {
     return cgp::detail::str_container(v, separator, begin, end);
 }
 
-template <typename T> int size_in_memory(numarray<T> const& v)
+template <typename T, typename Allocator> int size_in_memory(numarray<T, Allocator> const& v)
 {
     int s = 0;
-    int const N = v.size();
-    for (int k = 0; k < N; ++k)
+    int64_t const N = v.size();
+    for (int64_t k = 0; k < N; ++k)
         s += cgp::size_in_memory(v[k]);
     return s;
 }
 
-template <typename T> T average(numarray<T> const& a)
+// The reductions of large numarrays (more than parallel_grain elements) are computed in parallel by chunks (see parallel_reduce)
+template <typename T, typename Allocator> T average(numarray<T, Allocator> const& a)
 {
-    int const N = a.size();
+    int64_t const N = a.size();
     assert_cgp(N>0, "Cannot compute average on empty numarray");
 
-    T value = {}; // assume value start at zero
-    for(int k=0; k<N; ++k)
-        value += a[k];
+    T value = sum(a);
     value /= float(N);
 
     return value;
 }
-template <typename T> T sum(numarray<T> const& a) {
-    int const N = a.size();
+template <typename T, typename Allocator> T sum(numarray<T, Allocator> const& a) {
+    int64_t const N = a.size();
     assert_cgp(N>0, "Cannot compute sum on empty numarray");
 
-    T value = {}; // assume value start at zero
-    for(int k=0; k<N; ++k)
-        value += a[k];
-
-    return value;
+    return parallel_reduce(N,
+        [&a](int64_t begin, int64_t end) {
+            T value = {}; // assume value start at zero
+            for (int64_t k = begin; k < end; ++k)
+                value += a.at_unsafe(k);
+            return value;
+        },
+        [](T value, T const& b) { value += b; return value; });
 }
 
 
-template <typename T> T max(numarray<T> const& v)
+template <typename T, typename Allocator> T max(numarray<T, Allocator> const& v)
 {
-    int const N = v.size();
+    int64_t const N = v.size();
     assert_cgp(N>0, "Cannot get max on empty numarray");
 
-    T current_max = v[0];
-    for (int k = 1; k < N; ++k) {
-        T const& element = v[k];
-        if(element>current_max) 
-            current_max = element;
-    }
-        
-    return current_max;
-}
-template <typename T> T min(numarray<T> const& v)
-{
-    int const N = v.size();
+    return parallel_reduce(N,
+        [&v](int64_t begin, int64_t end) {
+            T current_max = v.at_unsafe(begin);
+            for (int64_t k = begin + 1; k < end; ++k) {
+                T const& element = v.at_unsafe(k);
+                if (element > current_max)
+                    current_max = element;
+            }
+            return current_max;
+        },
+        [](T const& a, T const& b) { return b > a ? b : a; });
+}
+template <typename T, typename Allocator> T min(numarray<T, Allocator> const& v)
+{
+    int64_t const N = v.size();
     assert_cgp(N>0, "Cannot get max on empty numarray");
 
-    T current_min = v[0];
-    for (int k = 1; k < N; ++k) {
-        T const& element = v[k];
-        if(element<current_min) 
-            current_min = element;
-    }
-        
-    return current_min;
-}
-
-
-template <typename T>
-numarray<T>& operator+=(numarray<T>& a, numarray<T> const& b)
-{
-    assert_cgp(a.size()>0 && b.size()>0, "Size must be >0");
-    assert_cgp(a.size()==b.size(), "Size do not agree");
-
-    const int N = a.size();
-    for(int k=0; k<N; ++k)
-        a[k] += b[k];
-    return a;
-}
-
-
-
-template <typename T>
-numarray<T>  operator+(numarray<T> const& a, numarray<T> const& b)
-{
-    numarray<T> res = a;
-    res += b;
-    return res;
-}
-
-template <typename T>
-numarray<T>  operator+(numarray<T> const& a, T const& b)
-{
-    numarray<T> res = a;
-    res += b;
-    return res;
-}
-
-template <typename T>
-numarray<T>  operator+(T const& a, numarray<T> const& b)
-{
-    int const N = b.size();
-    numarray<T> res(N);
-    for(int k=0; k<N; ++k)
-        res[k] = a+b[k];
-    return res;
-}
-
-template <typename T> numarray<T>  operator-(numarray<T> const& a)
-{
-    int const N = a.size();
-    numarray<T> b(N);
-    for(int k=0; k<N; ++k)
-        b[k] = -a[k];
-    return b;
-}
-
-
-template <typename T> numarray<T>& operator-=(numarray<T>& a, numarray<T> const& b)
-{
-    assert_cgp(a.size()>0 && b.size()>0, "Size must be >0");
-    assert_cgp(a.size()==b.size(), "Size do not agree");
-
-    const int N = a.size();
-    for(int k=0; k<N; ++k)
-        a[k] -= b[k];
-    return a;
-}
-
-template <typename T> numarray<T>  operator-(numarray<T> const& a, numarray<T> const& b)
-{
-    numarray<T> res = a;
-    res -= b;
-    return res;
+    return parallel_reduce(N,
+        [&v](int64_t begin, int64_t end) {
+            T current_min = v.at_unsafe(begin);
+            for (int64_t k = begin + 1; k < end; ++k) {
+                T const& element = v.at_unsafe(k);
+                if (element < current_min)
+                    current_min = element;
+            }
+            return current_min;
+        },
+        [](T const& a, T const& b) { return b < a ? b : a; });
 }
 
 
-template <typename T> numarray<T>& operator*=(numarray<T>& a, numarray<T> const& b)
-{
-    assert_cgp(a.size()>0 && b.size()>0, "Size must be >0");
-    assert_cgp(a.size()==b.size(), "Size do not agree");
-
-    const int N = a.size();
-    for(int k=0; k<N; ++k)
-        a[k] *= b[k];
-    return a;
-}
-template <typename T> numarray<T>  operator*(numarray<T> const& a, numarray<T> const& b)
+namespace detail
 {
-    numarray<T> res = a;
-    res *= b;
-    return res;
-}
-
-
-
-
-template <typename T> numarray<T>& operator*=(numarray<T>& a, float b)
-{
-    int const N = a.size();
-    for(int k=0; k<N; ++k)
-        a[k] *= b;
-    return a;
-}
-template <typename T> numarray<T>  operator*(numarray<T> const& a, float b)
-{
-    int const N = a.size();
-    numarray<T> res(N);
-    for(int k=0; k<N; ++k)
-        res[k] = a[k]*b;
-    return res;
-}
-template <typename T> numarray<T>  operator*(float a, numarray<T> const& b)
-{
-    int const N = b.size();
-    numarray<T> res(N);
-    for(int k=0; k<N; ++k)
-        res[k] = a*b[k];
-    return res;
-}
-
-template <typename T> numarray<T>& operator/=(numarray<T>& a, numarray<T> const& b)
-{
-    assert_cgp(a.size()>0 && b.size()>0, "Size must be >0");
-    assert_cgp(a.size()==b.size(), "Size do not agree");
-
-    const int N = a.size();
-    for(int k=0; k<N; ++k)
-        a[k] /= b[k];
-    return a;
-}
-template <typename T> numarray<T>& operator/=(numarray<T>& a, float b)
-{
-    assert_cgp(a.size()>0, "Size must be >0");
-    const int N = a.size();
-    for(int k=0; k<N; ++k)
-        a[k] /= b;
-    return a;
-}
-template <typename T> numarray<T>  operator/(numarray<T> const& a, numarray<T> const& b)
-{
-    numarray<T> res = a;
-    res /= b;
-    return res;
-}
-template <typename T> numarray<T>  operator/(numarray<T> const& a, float b)
-{
-    numarray<T> res = a;
-    res /= b;
-    return res;
+    template <typename NA, typename NB> bool is_equal_numarray(NA const& a, NB const& b)
+    {
+        int64_t const N = a.size();
+        if (b.size() != N)
+            return false;
+        if (N == 0)
+            return true;
+
+        return parallel_reduce(N,
+            [&a, &b](int64_t begin, int64_t end) {
+                using cgp::is_equal;
+                for (int64_t k = begin; k < end; ++k)
+                    if (is_equal(a.at_unsafe(k), b.at_unsafe(k)) == false)
+                        return false;
+                return true;
+            },
+            [](bool x, bool y) { return x && y; });
+    }
 }
 
-
-
-template <typename T1, typename T2> bool is_equal(numarray<T1> const& a, numarray<T2> const& b)
+template <typename T1, typename T2, typename A1, typename A2> bool is_equal(numarray<T1, A1> const& a, numarray<T2, A2> const& b)
 {
-    int const N = a.size();
-    if(b.size()!=N)
-        return false;
-
-    using cgp::is_equal;
-    for(int k=0; k<N; ++k)
-        if( is_equal(a[k],b[k])==false )
-            return false;
-    return true;
+    return detail::is_equal_numarray(a, b);
 }
-template <typename T> bool is_equal(numarray<T> const& a, numarray<T> const& b)
+template <typename T, typename Allocator> bool is_equal(numarray<T, Allocator> const& a, numarray<T, Allocator> const& b)
 {
-    return is_equal<T,T>(a,b);
+    return detail::is_equal_numarray(a, b);
 }
 
-template <typename T>
-numarray<T> numarray<T>::linespace(T const& p1, T const& p2, int N)
+template <typename T, typename Allocator>
+numarray<T, Allocator> numarray<T, Allocator>::linespace(T const& p1, T const& p2, int N)
 {
-    numarray<T> buf; 
+    numarray<T, Allocator> buf; 
     buf.resize(N);
 
     T const increment = (p2 - p1) / float(N - 1);
@@ -636,104 +525,104 @@ numarray<T> numarray<T>::linespace(T const& p1, T const& p2, int N)
 
 }
 
-template <typename T> auto const* ptr(numarray<T> const& v)
+template <typename T, typename Allocator> auto const* ptr(numarray<T, Allocator> const& v)
 {
     using cgp::ptr;
     return ptr(v[0]);
 }
 
-template <typename T> numarray<T> sub(numarray<T> const& a, T const& b)
+template <typename T, typename Allocator> numarray<T, Allocator> sub(numarray<T, Allocator> const& a, T const& b)
 {
-    int N= a.size();
-    numarray<T> res;
+    int64_t N= a.size();
+    numarray<T, Allocator> res;
     res.resize(N);
 
-    for(int k=0; k<N; ++k){
+    for(int64_t k=0; k<N; ++k){
         res[k] = a[k]-b;
     }
 
     return res;
 }
-template <typename T> numarray<T> add(numarray<T> const& a, T const& b)
+template <typename T, typename Allocator> numarray<T, Allocator> add(numarray<T, Allocator> const& a, T const& b)
 {
-    int N= a.size();
-    numarray<T> res;
+    int64_t N= a.size();
+    numarray<T, Allocator> res;
     res.resize(N);
 
-    for(int k=0; k<N; ++k){
+    for(int64_t k=0; k<N; ++k){
         res[k] = a[k]+b;
     }
 
     return res;
 }
-template <typename T> numarray<T> mul(numarray<T> const& a, T const& b)
+template <typename T, typename Allocator> numarray<T, Allocator> mul(numarray<T, Allocator> const& a, T const& b)
 {
-    int N= a.size();
-    numarray<T> res;
+    int64_t N= a.size();
+    numarray<T, Allocator> res;
     res.resize(N);
 
-    for(int k=0; k<N; ++k){
+    for(int64_t k=0; k<N; ++k){
         res[k] = a[k]*b;
     }
 
     return res;
 }
-template <typename T> numarray<T> div(numarray<T> const& a, T const& b)
+template <typename T, typename Allocator> numarray<T, Allocator> div(numarray<T, Allocator> const& a, T const& b)
 {
-    int N= a.size();
-    numarray<T> res;
+    int64_t N= a.size();
+    numarray<T, Allocator> res;
     res.resize(N);
 
-    for(int k=0; k<N; ++k){
+    for(int64_t k=0; k<N; ++k){
         res[k] = a[k]/b;
     }
 
     return res;
 }
 
-template <typename T> numarray<T>  sub(T const& a, numarray<T> const& b)
+template <typename T, typename Allocator> numarray<T, Allocator>  sub(T const& a, numarray<T, Allocator> const& b)
 {
-    int N= a.size();
-    numarray<T> res;
+    int64_t N= a.size();
+    numarray<T, Allocator> res;
     res.resize(N);
 
-    for(int k=0; k<N; ++k){
+    for(int64_t k=0; k<N; ++k){
         res[k] = a-b[k];
     }
 
     return res;
 }
-template <typename T> numarray<T>  add(T const& a, numarray<T> const& b)
+template <typename T, typename Allocator> numarray<T, Allocator>  add(T const& a, numarray<T, Allocator> const& b)
 {
-    int N= a.size();
-    numarray<T> res;
+    int64_t N= a.size();
+    numarray<T, Allocator> res;
     res.resize(N);
 
-    for(int k=0; k<N; ++k){
+    for(int64_t k=0; k<N; ++k){
         res[k] = a+b[k];
     }
 
     return res;
 }
-template <typename T> numarray<T>  mul(T const& a, numarray<T> const& b)
+template <typename T, typename Allocator> numarray<T, Allocator>  mul(T const& a, numarray<T, Allocator> const& b)
 {
-    int N= a.size();
-    numarray<T> res;
+    int64_t N= a.size();
+    numarray<T, Allocator> res;
     res.resize(N);
 
-    for(int k=0; k<N; ++k){
+    for(int64_t k=0; k<N; ++k){
         res[k] = a*b[k];
     }
 
     return res;
 }
-template <typename T> numarray<T>  div(T const& a, numarray<T> const& b)
+template <typename T, typename Allocator> numarray<T, Allocator>  div(T const& a, numarray<T, Allocator> const& b)
 {
-    int N= a.size();
-    numarray<T> res;
+    int64_t N= a.size();
+    numarray<T, Allocator> res;
     res.resize(N);
 
-    for(int k=0; k<N; ++k){
+    for(int64_t k=0; k<N; ++k){
         res[k] = a/b[k];
     }
 
@@ -0,0 +1,548 @@
+#pragma once
+
+#include "cgp/01_base/base.hpp"
+#include "numarray_fwd.hpp"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* ************************************************** */
+/*           Header                                   */
+/* ************************************************** */
+
+/** Expression templates for the element-wise operators of numarray (and grid_2D, grid_3D)
+ *
+ * Operators between containers (a+b, 2.0f*a, -a, a/b, etc.) do not compute a new container: they return a lightweight
+ * expression storing its operands. The expression is evaluated element by element in a single loop when it is assigned
+ * to a container (or when it is used to construct a container).
+ *   p = p + dt*v + 0.5f*dt*dt*a; // a single loop over p, v and a - no temporary numarray is allocated
+ *
+ * The syntax remains the same as with numarray operators returning new containers:
+ * - An expression converts implicitly to its container type (numarray<T>, grid_2D<T>, or grid_3D<T>).
+ * - An expression can be queried by e[k] and e.size(), and used with sum, average, min, max, is_equal, str, and <<.
+ * - evaluate(e) returns the container explicitly (for instance to call a function template expecting a numarray<T>).
+ *
+ * Note: "auto e = a+b;" stores the expression, not its values. Operands given as lvalue are referenced by the expression and
+ *  must remain alive until it is evaluated. Temporary operands (such as a+f(x) where f returns a numarray) are moved inside the expression.
+ **/
+
+namespace cgp
+{
+
+/** Description of the shape of the containers. Only operands of the same shape type can be combined.
+ * - size(shape): number of elements
+ * - is_equal(shape_a, shape_b): shapes compatibility
+ * - container<T>: type of the container storing the evaluation of an expression with this shape
+ * Specialized for numarray (size_t). The grids specialize it for their dimension (int2, int3). */
+template <typename S> struct expression_shape_traits;
+
+template <> struct expression_shape_traits<size_t> {
+    template <typename T> using container = numarray<T>;
+    static size_t size(size_t shape) { return shape; }
+    static bool is_equal(size_t a, size_t b) { return a==b; }
+    static std::string str(size_t shape) { return std::to_string(shape); }
+};
+
+/** Description of the containers that can be used as operands of an expression
+ * - shape(c): shape of the container
+ * - element(c, k): direct access to the k-th element stored contiguously in memory (no bound checking)
+ * Specialized for numarray here, and in grid_2D/grid_3D. */
+template <typename C> struct expression_container_traits {
+    static constexpr bool is_container = false;
+};
+
+template <typename T, typename Allocator> struct expression_container_traits<numarray<T, Allocator>> {
+    static constexpr bool is_container = true;
+    using shape_type = size_t;
+    using value_type = T;
+    static size_t shape(numarray<T, Allocator> const& v) { return v.data.size(); }
+    static T const* element(numarray<T, Allocator> const& v) { return v.data.data(); }
+    static T* element(numarray<T, Allocator>& v) { return v.data.data(); }
+};
+
+
+/** Base class of all expression nodes (used to detect expressions) */
+struct numarray_expression_base {};
+
+template <typename X> constexpr bool is_numarray_expression = std::is_base_of<numarray_expression_base, std::decay_t<X>>::value;
+template <typename X> constexpr bool is_numarray_container = expression_container_traits<std::decay_t<X>>::is_container;
+/** Operands accepted by the element-wise operators: containers and expressions */
+template <typename X> constexpr bool is_numarray_operand = is_numarray_expression<X> || is_numarray_container<X>;
+
+
+namespace expression_detail
+{
+    // Type of the node storing an operand in an expression
+    //  - expressions are stored by value (they are light)
+    //  - lvalue containers are stored as a pointer on their elements
+    //  - temporary containers are moved inside the expression
+    template <typename X, typename = void> struct operand_type;
+
+    // Container referenced by the expression
+    template <typename C> struct container_reference : numarray_expression_base {
+        using traits = expression_container_traits<C>;
+        using shape_type = typename traits::shape_type;
+        using value_type = typename traits::value_type;
+
+        value_type const* element;
+        shape_type shape_value;
+
+        explicit container_reference(C const& c) :element(traits::element(c)), shape_value(traits::shape(c)) {}
+        value_type const& operator[](size_t k) const { return element[k]; }
+        shape_type const& shape() const { return shape_value; }
+    };
+
+    // Temporary container owned by the expression
+    template <typename C> struct container_value : numarray_expression_base {
+        using traits = expression_container_traits<C>;
+        using shape_type = typename traits::shape_type;
+        using value_type = typename traits::value_type;
+
+        C container;
+
+        explicit container_value(C&& c) :container(std::move(c)) {}
+        value_type const& operator[](size_t k) const { return traits::element(container)[k]; }
+        shape_type shape() const { return traits::shape(container); }
+    };
+
+    template <typename X> struct operand_type<X, std::enable_if_t<is_numarray_expression<X>>> {
+        using type = std::decay_t<X>;
+    };
+    template <typename X> struct operand_type<X, std::enable_if_t<is_numarray_container<X> && std::is_lvalue_reference<X>::value>> {
+        using type = container_reference<std::decay_t<X>>;
+    };
+    template <typename X> struct operand_type<X, std::enable_if_t<is_numarray_container<X> && !std::is_lvalue_reference<X>::value>> {
+        using type = container_value<std::decay_t<X>>;
+    };
+    template <typename X> using operand_t = typename operand_type<X>::type;
+
+    // Scalar operand: the same value for all the elements
+    template <typename S> struct scalar {
+        S value;
+        S const& operator[](size_t) const { return value; }
+    };
+
+    // Element-wise operations
+    struct op_add { template <typename A, typename B> static auto apply(A const& a, B const& b) { return a+b; } };
+    struct op_sub { template <typename A, typename B> static auto apply(A const& a, B const& b) { return a-b; } };
+    struct op_mul { template <typename A, typename B> static auto apply(A const& a, B const& b) { return a*b; } };
+    struct op_div { template <typename A, typename B> static auto apply(A const& a, B const& b) { return a/b; } };
+    struct op_neg { template <typename A> static auto apply(A const& a) { return -a; } };
+}
+
+
+/** Element-wise binary operation between two operands.
+ * At most one of the two operands can be a scalar - the shape is given by the other one. */
+template <typename Op, typename A, typename B>
+struct numarray_expression : numarray_expression_base
+{
+    static constexpr bool a_is_scalar = !std::is_base_of<numarray_expression_base, A>::value;
+    using shape_type = typename std::conditional_t<a_is_scalar, B, A>::shape_type;
+    using value_type = std::decay_t<decltype(Op::apply(std::declval<A const&>()[0], std::declval<B const&>()[0]))>;
+
+    A a;
+    B b;
+
+    numarray_expression(A a_arg, B b_arg);
+
+    value_type operator[](size_t k) const { return Op::apply(a[k], b[k]); }
+    shape_type shape() const;
+    int64_t size() const;
+};
+
+/** Element-wise unary operation */
+template <typename Op, typename A>
+struct numarray_unary_expression : numarray_expression_base
+{
+    using shape_type = typename A::shape_type;
+    using value_type = std::decay_t<decltype(Op::apply(std::declval<A const&>()[0]))>;
+
+    A a;
+
+    explicit numarray_unary_expression(A a_arg) :a(std::move(a_arg)) {}
+
+    value_type operator[](size_t k) const { return Op::apply(a[k]); }
+    shape_type shape() const { return a.shape(); }
+    int64_t size() const { return int64_t(expression_shape_traits<shape_type>::size(shape())); }
+};
+
+template <typename X> using expression_shape_t = typename expression_detail::operand_t<X>::shape_type;
+template <typename X> using expression_value_t = typename expression_detail::operand_t<X>::value_type;
+/** Container type storing the evaluation of an expression (numarray<T>, grid_2D<T>, grid_3D<T>) */
+template <typename E> using expression_result_t = typename expression_shape_traits<expression_shape_t<E>>::template container<expression_value_t<E>>;
+
+/** Operands that can be combined together: they must have the same shape type (numarray with numarray, grid_2D with grid_2D, etc.) */
+template <typename A, typename B, typename = void> struct is_numarray_compatible : std::false_type {};
+template <typename A, typename B> struct is_numarray_compatible<A, B, std::enable_if_t<is_numarray_operand<A> && is_numarray_operand<B>>>
+    : std::is_same<expression_shape_t<A>, expression_shape_t<B>> {};
+
+/** Expressions that can be assigned to a container of shape type S */
+template <typename E, typename S, typename = void> struct is_numarray_expression_of_shape : std::false_type {};
+template <typename E, typename S> struct is_numarray_expression_of_shape<E, S, std::enable_if_t<is_numarray_expression<E>>>
+    : std::is_same<expression_shape_t<E>, S> {};
+
+
+/** Math operators
+ * Element-wise operations between containers/expressions, and scalar (float) or element values. */
+template <typename A, typename = std::enable_if_t<is_numarray_operand<A>>> auto operator-(A&& a);
+
+template <typename A, typename B, typename = std::enable_if_t<is_numarray_compatible<A,B>::value>> auto operator+(A&& a, B&& b);
+template <typename A, typename B, typename = std::enable_if_t<is_numarray_compatible<A,B>::value>> auto operator-(A&& a, B&& b);
+template <typename A, typename B, typename = std::enable_if_t<is_numarray_compatible<A,B>::value>> auto operator*(A&& a, B&& b);
+template <typename A, typename B, typename = std::enable_if_t<is_numarray_compatible<A,B>::value>> auto operator/(A&& a, B&& b);
+
+template <typename A, typename = std::enable_if_t<is_numarray_operand<A>>> auto operator+(A&& a, expression_value_t<A> const& b);
+template <typename A, typename = std::enable_if_t<is_numarray_operand<A>>> auto operator+(expression_value_t<A> const& a, A&& b);
+template <typename A, typename = std::enable_if_t<is_numarray_operand<A>>> auto operator-(A&& a, expression_value_t<A> const& b);
+template <typename A, typename = std::enable_if_t<is_numarray_operand<A>>> auto operator-(expression_value_t<A> const& a, A&& b);
+template <typename A, typename = std::enable_if_t<is_numarray_operand<A>>> auto operator*(A&& a, float b);
+template <typename A, typename = std::enable_if_t<is_numarray_operand<A>>> auto operator*(float a, A&& b);
+template <typename A, typename = std::enable_if_t<is_numarray_operand<A>>> auto operator/(A&& a, float b);
+template <typename A, typename = std::enable_if_t<is_numarray_operand<A>>> auto operator/(float a, A&& b);
+
+/** Compound assignment: the right-hand side is evaluated in a single loop directly in the container */
+template <typename C, typename B, typename = std::enable_if_t<is_numarray_container<C> && is_numarray_compatible<C,B>::value>> C& operator+=(C& a, B const& b);
+template <typename C, typename B, typename = std::enable_if_t<is_numarray_container<C> && is_numarray_compatible<C,B>::value>> C& operator-=(C& a, B const& b);
+template <typename C, typename B, typename = std::enable_if_t<is_numarray_container<C> && is_numarray_compatible<C,B>::value>> C& operator*=(C& a, B const& b);
+template <typename C, typename B, typename = std::enable_if_t<is_numarray_container<C> && is_numarray_compatible<C,B>::value>> C& operator/=(C& a, B const& b);
+template <typename C, typename = std::enable_if_t<is_numarray_container<C>>> C& operator+=(C& a, typename expression_container_traits<C>::value_type const& b);
+template <typename C, typename = std::enable_if_t<is_numarray_container<C>>> C& operator-=(C& a, typename expression_container_traits<C>::value_type const& b);
+template <typename C, typename = std::enable_if_t<is_numarray_container<C>>> C& operator*=(C& a, float b);
+template <typename C, typename = std::enable_if_t<is_numarray_container<C>>> C& operator/=(C& a, float b);
+
+/** Evaluate the expression in a new container */
+template <typename E, typename = std::enable_if_t<is_numarray_expression<E>>> expression_result_t<E> evaluate(E const& e);
+/** Evaluate the expression in the (already allocated) elements of a container
+ * The expression may use the container itself as operand (p = p + dt*v) as the evaluation is performed element by element. */
+template <typename T, typename E> void evaluate_in(T* out, E const& e, size_t N);
+/** Evaluate the expression in a std::vector, resized to the size of the expression if needed */
+template <typename T, typename Allocator, typename E> void evaluate_in(std::vector<T, Allocator>& out, E const& e);
+
+/** Reductions and outputs on expressions (without evaluating the expression in a container) */
+template <typename E, typename = std::enable_if_t<is_numarray_expression<E>>> auto sum(E const& e);
+template <typename E, typename = std::enable_if_t<is_numarray_expression<E>>> auto average(E const& e);
+template <typename E, typename = std::enable_if_t<is_numarray_expression<E>>> auto max(E const& e);
+template <typename E, typename = std::enable_if_t<is_numarray_expression<E>>> auto min(E const& e);
+template <typename X, typename Op, typename A, typename B> bool is_equal(numarray_expression<Op, A, B> const& a, X const& b);
+template <typename X, typename Op, typename A> bool is_equal(numarray_unary_expression<Op, A> const& a, X const& b);
+template <typename X, typename Op, typename A, typename B, typename = std::enable_if_t<!is_numarray_expression<X>>> bool is_equal(X const& a, numarray_expression<Op, A, B> const& b);
+template <typename X, typename Op, typename A, typename = std::enable_if_t<!is_numarray_expression<X>>> bool is_equal(X const& a, numarray_unary_expression<Op, A> const& b);
+template <typename E, typename = std::enable_if_t<is_numarray_expression<E>>> std::string str(E const& e);
+template <typename E, typename = std::enable_if_t<is_numarray_expression<E>>> std::ostream& operator<<(std::ostream& s, E const& e);
+
+}
+
+
+
+/* ************************************************** */
+/*           IMPLEMENTATION                           */
+/* ************************************************** */
+
+namespace cgp
+{
+
+namespace expression_detail
+{
+    template <typename X> operand_t<X&&> make_operand(X&& x)
+    {
+        return operand_t<X&&>(std::forward<X>(x));
+    }
+    template <typename S> scalar<S> make_scalar(S const& s)
+    {
+        return scalar<S>{s};
+    }
+
+    template <typename Op, typename A, typename B> numarray_expression<Op, A, B> make_binary(A&& a, B&& b)
+    {
+        return numarray_expression<Op, A, B>(std::move(a), std::move(b));
+    }
+
+    // Read access to the elements of an operand without copying it
+    template <typename B> decltype(auto) read_operand(B const& b)
+    {
+        if constexpr (is_numarray_expression<B>)
+            return (b);
+        else
+            return container_reference<B>(b);
+    }
+}
+
+template <typename Op, typename A, typename B>
+numarray_expression<Op, A, B>::numarray_expression(A a_arg, B b_arg)
+    :a(std::move(a_arg)), b(std::move(b_arg))
+{
+    if constexpr (std::is_base_of<numarray_expression_base, A>::value && std::is_base_of<numarray_expression_base, B>::value)
+        assert_cgp(expression_shape_traits<shape_type>::is_equal(a.shape(), b.shape()), "Size do not agree: a:"+expression_shape_traits<shape_type>::str(a.shape())+", b:"+expression_shape_traits<shape_type>::str(b.shape()));
+}
+
+template <typename Op, typename A, typename B>
+typename numarray_expression<Op, A, B>::shape_type numarray_expression<Op, A, B>::shape() const
+{
+    if constexpr (a_is_scalar)
+        return b.shape();
+    else
+        return a.shape();
+}
+
+template <typename Op, typename A, typename B>
+int64_t numarray_expression<Op, A, B>::size() const
+{
+    return int64_t(expression_shape_traits<shape_type>::size(shape()));
+}
+
+
+template <typename A, typename> auto operator-(A&& a)
+{
+    using namespace expression_detail;
+    return numarray_unary_expression<op_neg, operand_t<A&&>>(make_operand(std::forward<A>(a)));
+}
+
+template <typename A, typename B, typename> auto operator+(A&& a, B&& b)
+{
+    using namespace expression_detail;
+    return make_binary<op_add>(make_operand(std::forward<A>(a)), make_operand(std::forward<B>(b)));
+}
+template <typename A, typename B, typename> auto operator-(A&& a, B&& b)
+{
+    using namespace expression_detail;
+    return make_binary<op_sub>(make_operand(std::forward<A>(a)), make_operand(std::forward<B>(b)));
+}
+template <typename A, typename B, typename> auto operator*(A&& a, B&& b)
+{
+    using namespace expression_detail;
+    return make_binary<op_mul>(make_operand(std::forward<A>(a)), make_operand(std::forward<B>(b)));
+}
+template <typename A, typename B, typename> auto operator/(A&& a, B&& b)
+{
+    using namespace expression_detail;
+    return make_binary<op_div>(make_operand(std::forward<A>(a)), make_operand(std::forward<B>(b)));
+}
+
+template <typename A, typename> auto operator+(A&& a, expression_value_t<A> const& b)
+{
+    using namespace expression_detail;
+    return make_binary<op_add>(make_operand(std::forward<A>(a)), make_scalar(b));
+}
+template <typename A, typename> auto operator+(expression_value_t<A> const& a, A&& b)
+{
+    using namespace expression_detail;
+    return make_binary<op_add>(make_scalar(a), make_operand(std::forward<A>(b)));
+}
+template <typename A, typename> auto operator-(A&& a, expression_value_t<A> const& b)
+{
+    using namespace expression_detail;
+    return make_binary<op_sub>(make_operand(std::forward<A>(a)), make_scalar(b));
+}
+template <typename A, typename> auto operator-(expression_value_t<A> const& a, A&& b)
+{
+    using namespace expression_detail;
+    return make_binary<op_sub>(make_scalar(a), make_operand(std::forward<A>(b)));
+}
+template <typename A, typename> auto operator*(A&& a, float b)
+{
+    using namespace expression_detail;
+    return make_binary<op_mul>(make_operand(std::forward<A>(a)), make_scalar(b));
+}
+template <typename A, typename> auto operator*(float a, A&& b)
+{
+    using namespace expression_detail;
+    return make_binary<op_mul>(make_scalar(a), make_operand(std::forward<A>(b)));
+}
+template <typename A, typename> auto operator/(A&& a, float b)
+{
+    using namespace expression_detail;
+    return make_binary<op_div>(make_operand(std::forward<A>(a)), make_scalar(b));
+}
+template <typename A, typename> auto operator/(float a, A&& b)
+{
+    using namespace expression_detail;
+    return make_binary<op_div>(make_scalar(a), make_operand(std::forward<A>(b)));
+}
+
+
+template <typename T, typename E> void evaluate_in(T* out, E const& e, size_t N)
+{
+    // Large expressions are evaluated in parallel by chunks (see parallel_for)
+    parallel_for(int64_t(N), [out, &e](int64_t begin, int64_t end) {
+        for (int64_t k = begin; k < end; ++k)
+            out[k] = e[size_t(k)];
+    });
+}
+
+template <typename T, typename Allocator, typename E> void evaluate_in(std::vector<T, Allocator>& out, E const& e)
+{
+    size_t const N = size_t(e.size());
+    if (N == out.size()) {
+        // Elements of out may be used in the expression (p = p + dt*v): the evaluation is element-wise and can be done in place
+        evaluate_in(out.data(), e, N);
+    }
+    else {
+        std::vector<T, Allocator> buffer(N);
+        evaluate_in(buffer.data(), e, N);
+        out.swap(buffer);
+    }
+}
+
+template <typename E, typename> expression_result_t<E> evaluate(E const& e)
+{
+    return expression_result_t<E>(e);
+}
+
+namespace expression_detail
+{
+    // Apply a compound operation element by element in the container
+    template <typename C, typename B, typename F> C& compound_assign(C& a, B const& b, F const& f)
+    {
+        using traits = expression_container_traits<C>;
+        using shape_traits = expression_shape_traits<typename traits::shape_type>;
+        auto const& rhs = read_operand(b);
+        assert_cgp(shape_traits::is_equal(traits::shape(a), rhs.shape()), "Size do not agree: a:"+shape_traits::str(traits::shape(a))+", b:"+shape_traits::str(rhs.shape()));
+
+        auto* out = traits::element(a);
+        size_t const N = shape_traits::size(traits::shape(a));
+        parallel_for(int64_t(N), [out, &rhs, &f](int64_t begin, int64_t end) {
+            for (int64_t k = begin; k < end; ++k)
+                f(out[k], rhs[size_t(k)]);
+        });
+        return a;
+    }
+    template <typename C, typename S, typename F> C& compound_assign_scalar(C& a, S const& b, F const& f)
+    {
+        using traits = expression_container_traits<C>;
+        using shape_traits = expression_shape_traits<typename traits::shape_type>;
+        auto* out = traits::element(a);
+        size_t const N = shape_traits::size(traits::shape(a));
+        parallel_for(int64_t(N), [out, &b, &f](int64_t begin, int64_t end) {
+            for (int64_t k = begin; k < end; ++k)
+                f(out[k], b);
+        });
+        return a;
+    }
+}
+
+template <typename C, typename B, typename> C& operator+=(C& a, B const& b)
+{
+    return expression_detail::compound_assign(a, b, [](auto& x, auto const& y) { x += y; });
+}
+template <typename C, typename B, typename> C& operator-=(C& a, B const& b)
+{
+    return expression_detail::compound_assign(a, b, [](auto& x, auto const& y) { x -= y; });
+}
+template <typename C, typename B, typename> C& operator*=(C& a, B const& b)
+{
+    return expression_detail::compound_assign(a, b, [](auto& x, auto const& y) { x *= y; });
+}
+template <typename C, typename B, typename> C& operator/=(C& a, B const& b)
+{
+    return expression_detail::compound_assign(a, b, [](auto& x, auto const& y) { x /= y; });
+}
+template <typename C, typename> C& operator+=(C& a, typename expression_container_traits<C>::value_type const& b)
+{
+    return expression_detail::compound_assign_scalar(a, b, [](auto& x, auto const& y) { x += y; });
+}
+template <typename C, typename> C& operator-=(C& a, typename expression_container_traits<C>::value_type const& b)
+{
+    return expression_detail::compound_assign_scalar(a, b, [](auto& x, auto const& y) { x -= y; });
+}
+template <typename C, typename> C& operator*=(C& a, float b)
+{
+    return expression_detail::compound_assign_scalar(a, b, [](auto& x, float y) { x *= y; });
+}
+template <typename C, typename> C& operator/=(C& a, float b)
+{
+    return expression_detail::compound_assign_scalar(a, b, [](auto& x, float y) { x /= y; });
+}
+
+
+template <typename E, typename> auto sum(E const& e)
+{
+    size_t const N = size_t(e.size());
+    assert_cgp(N>0, "Cannot compute sum on empty numarray");
+
+    using T = typename E::value_type;
+    return parallel_reduce(int64_t(N),
+        [&e](int64_t begin, int64_t end) {
+            T value = {}; // assume value start at zero
+            for (int64_t k = begin; k < end; ++k)
+                value += e[size_t(k)];
+            return value;
+        },
+        [](T value, T const& b) { value += b; return value; });
+}
+template <typename E, typename> auto average(E const& e)
+{
+    size_t const N = size_t(e.size());
+    assert_cgp(N>0, "Cannot compute average on empty numarray");
+
+    typename E::value_type value = sum(e);
+    value /= float(N);
+    return value;
+}
+template <typename E, typename> auto max(E const& e)
+{
+    size_t const N = size_t(e.size());
+    assert_cgp(N>0, "Cannot get max on empty numarray");
+
+    using T = typename E::value_type;
+    return parallel_reduce(int64_t(N),
+        [&e](int64_t begin, int64_t end) {
+            T current_max = e[size_t(begin)];
+            for (int64_t k = begin + 1; k < end; ++k) {
+                T const element = e[size_t(k)];
+                if (element > current_max)
+                    current_max = element;
+            }
+            return current_max;
+        },
+        [](T const& a, T const& b) { return b > a ? b : a; });
+}
+template <typename E, typename> auto min(E const& e)
+{
+    size_t const N = size_t(e.size());
+    assert_cgp(N>0, "Cannot get min on empty numarray");
+
+    using T = typename E::value_type;
+    return parallel_reduce(int64_t(N),
+        [&e](int64_t begin, int64_t end) {
+            T current_min = e[size_t(begin)];
+            for (int64_t k = begin + 1; k < end; ++k) {
+                T const element = e[size_t(k)];
+                if (element < current_min)
+                    current_min = element;
+            }
+            return current_min;
+        },
+        [](T const& a, T const& b) { return b < a ? b : a; });
+}
+
+template <typename X, typename Op, typename A, typename B> bool is_equal(numarray_expression<Op, A, B> const& a, X const& b)
+{
+    return is_equal(evaluate(a), b);
+}
+template <typename X, typename Op, typename A> bool is_equal(numarray_unary_expression<Op, A> const& a, X const& b)
+{
+    return is_equal(evaluate(a), b);
+}
+template <typename X, typename Op, typename A, typename B, typename> bool is_equal(X const& a, numarray_expression<Op, A, B> const& b)
+{
+    return is_equal(a, evaluate(b));
+}
+template <typename X, typename Op, typename A, typename> bool is_equal(X const& a, numarray_unary_expression<Op, A> const& b)
+{
+    return is_equal(a, evaluate(b));
+}
+template <typename E, typename> std::string str(E const& e)
+{
+    return str(evaluate(e));
+}
+template <typename E, typename> std::ostream& operator<<(std::ostream& s, E const& e)
+{
+    s << evaluate(e);
+    return s;
+}
+
+}
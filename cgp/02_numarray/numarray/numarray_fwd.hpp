@@ -0,0 +1,9 @@
+#pragma once
+
+#include <memory>
+
+namespace cgp
+{
+    // Forward declaration of numarray (the default allocator is the one of std::vector)
+    template <typename T, typename Allocator = std::allocator<T>> struct numarray;
+}
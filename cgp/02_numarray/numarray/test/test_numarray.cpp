@@ -114,5 +114,82 @@ namespace cgp_test
 			assert_cgp_no_msg(cgp::is_equal(sum(a),  4.5f+8.2f+6.1f-3.6));
 		}
 
+		// test element-wise expressions (evaluated in a single loop on assignment)
+		{
+			cgp::numarray<float> a = { 1.0f, 2.0f, 3.0f };
+			cgp::numarray<float> const b = { 0.5f, -1.0f, 2.0f };
+			cgp::numarray<float> c = a + 2.0f*b - a/2.0f;
+			assert_cgp_no_msg(is_equal(c, { 1.5f, -1.0f, 5.5f }));
+			assert_cgp_no_msg(cgp::is_equal(sum(a*b), 4.5f));
+			assert_cgp_no_msg(cgp::is_equal(max(-a), -1.0f));
+			assert_cgp_no_msg(is_equal(a-b, cgp::numarray<float>{ 0.5f, 3.0f, 1.0f }));
+
+			a = a + b; // the assigned numarray is also an operand
+			assert_cgp_no_msg(is_equal(a, { 1.5f, 1.0f, 5.0f }));
+			a += b*b;
+			a -= 1.0f;
+			assert_cgp_no_msg(is_equal(a, { 0.75f, 1.0f, 8.0f }));
+
+			c = cgp::numarray<float>{ 1.0f, 1.0f } + 1.0f; // temporary operand, and resize of c
+			assert_cgp_no_msg(is_equal(c, { 2.0f, 2.0f }));
+		}
+		{
+			using cgp::vec3;
+			cgp::numarray<vec3> p = { {0,0,0}, {1,0,0} };
+			cgp::numarray<vec3> const v = { {1,0,0}, {0,1,0} };
+			float const dt = 0.5f;
+			p = p + dt*v + 0.5f*dt*dt*v;
+			assert_cgp_no_msg(is_equal(p[0], vec3{ 0.625f,0,0 }));
+			assert_cgp_no_msg(is_equal(p[1], vec3{ 1,0.625f,0 }));
+
+			cgp::numarray<float> const w = { 1.0f, 2.0f };
+			cgp::numarray<vec3> const r = w*v;
+			assert_cgp_no_msg(is_equal(r[1], vec3{ 0,2,0 }));
+		}
+
+		// test numarray with the frame arena allocator
+		{
+			cgp::frame_arena::global().reset();
+			{
+				cgp::numarray_frame<float> a = { 1.0f, 2.0f, 3.0f };
+				cgp::numarray<float> const b = { 1.0f, 1.0f, 1.0f };
+				a = a + 2.0f*b;
+				assert_cgp_no_msg(is_equal(a, { 3.0f, 4.0f, 5.0f }));
+				a.push_back(6.0f);
+				assert_cgp_no_msg(cgp::is_equal(sum(a), 18.0f));
+			}
+			cgp::frame_arena::global().reset();
+			assert_cgp_no_msg(cgp::frame_arena::global().last_frame.allocation >= 2);
+		}
+
+		// test parallel computation on arrays larger than the parallel grain
+		{
+			int const N = int(3 * cgp::parallel_grain + 17);
+			cgp::numarray<float> a(N);
+			for (int k = 0; k < N; ++k)
+				a[k] = 1.0f / float(k % 97 + 1);
+			a[int(2 * cgp::parallel_grain) + 5] = 10.0f;
+
+			// Reductions don't depend on the number of threads
+			cgp::set_parallel_thread_count(1);
+			float const s1 = sum(a);
+			cgp::set_parallel_thread_count(4);
+			float const s4 = sum(a);
+			assert_cgp_no_msg(s1 == s4);
+			assert_cgp_no_msg(max(a) == 10.0f);
+			assert_cgp_no_msg(min(a) == 1.0f / 97.0f);
+
+			cgp::numarray<float> b = 2.0f * a + 1.0f;
+			b -= a;
+			assert_cgp_no_msg(b.size() == size_t(N));
+			assert_cgp_no_msg(is_equal(b, a + 1.0f));
+			assert_cgp_no_msg(cgp::is_equal(b[N - 1], a[N - 1] + 1.0f));
+
+			std::vector<int> hit(N, 0);
+			cgp::parallel_for(N, [&](int64_t begin, int64_t end) { for (int64_t k = begin; k < end; ++k) hit[size_t(k)] += 1; });
+			assert_cgp_no_msg(std::count(hit.begin(), hit.end(), 1) == N);
+			cgp::set_parallel_thread_count(0);
+		}
+
 	}
 }
\ No newline at end of file
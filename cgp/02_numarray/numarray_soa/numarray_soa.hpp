@@ -0,0 +1,398 @@
+#pragma once
+
+#include "cgp/01_base/base.hpp"
+#include "../numarray_stack/numarray_stack.hpp"
+#include "../numarray/numarray.hpp"
+
+#include <algorithm>
+#include <initializer_list>
+
+/* ************************************************** */
+/*           Header                                   */
+/* ************************************************** */
+
+namespace cgp
+{
+
+/** Proxy on an element of a numarray_soa
+ * The components of the element are references on the separated component arrays, so that
+ *   v[i].x = 1.0f;  v[i] = vec3{1,2,3};  vec3 p = v[i];  v[i] += p;
+ * work as with numarray<vec3>. Use an explicit conversion (vec3 p = v[i]) before calling vec3 functions. */
+template <typename S, int N> struct numarray_soa_reference;
+
+/** Dynamic-sized container of vectors (vec2, vec3, vec4) stored as structure of arrays
+ *
+ * numarray<vec3> stores the elements interleaved (x0 y0 z0 x1 y1 z1 ...). numarray_soa<vec3> stores each component
+ * in a separated array (x0 x1 ..., y0 y1 ..., z0 z1 ...) aligned on 64 bytes, so that batch operations on a large
+ * number of vectors are processed with full-width SIMD instructions.
+ * - Elements are accessed as v[i] (a proxy for non-const numarray_soa, a copy of the vector for const numarray_soa)
+ * - The component arrays are available as v.component[0..N-1]
+ * - Conversion from numarray<vec3> with the constructor, and to numarray<vec3> with to_numarray()
+ *
+ * Only defined for numarray_stack<S,N> elements with N = 2, 3 or 4. Sizes and indices are 64 bits integers (int64_t) as in numarray.
+ **/
+template <typename T> struct numarray_soa;
+
+template <typename S, int N>
+struct numarray_soa<numarray_stack<S, N>>
+{
+    static_assert(N >= 2 && N <= 4, "numarray_soa is only defined for vectors of dimension 2, 3 or 4");
+    using value_type = numarray_stack<S, N>;
+
+    /** Component arrays (x, y, z, w) */
+    aligned_vector<S> component[N];
+
+    // Constructors
+    numarray_soa();                                   // Empty container - no elements
+    numarray_soa(int64_t size);                       // Container with a given size
+    numarray_soa(std::initializer_list<value_type> arg); // Inline initialization using { }
+    numarray_soa(numarray<value_type> const& arg);    // Conversion from interleaved storage
+
+    /** Conversion to interleaved storage */
+    numarray<value_type> to_numarray() const;
+
+    /** Container size */
+    int64_t size() const;
+    /** Resize all the component arrays */
+    numarray_soa<value_type>& resize(int64_t size);
+    /** Add an element at the end of the container */
+    numarray_soa<value_type>& push_back(value_type const& value);
+    /** Remove all elements of the container */
+    numarray_soa<value_type>& clear();
+    /** Fill the container with the same element */
+    numarray_soa<value_type>& fill(value_type const& value);
+
+    /** Element access
+     * Bound checking is performed unless CGP_NO_DEBUG is defined. */
+    value_type operator[](int64_t index) const;
+    numarray_soa_reference<S, N> operator[](int64_t index);
+};
+
+template <typename S, int N> std::string type_str(numarray_soa<numarray_stack<S, N>> const&);
+template <typename S, int N> std::ostream& operator<<(std::ostream& s, numarray_soa<numarray_stack<S, N>> const& v);
+template <typename S, int N> bool is_equal(numarray_soa<numarray_stack<S, N>> const& a, numarray_soa<numarray_stack<S, N>> const& b);
+
+/** Math operators
+ * Component-wise loops on the separated arrays (vectorized by the compiler). */
+template <typename S, int N> numarray_soa<numarray_stack<S, N>>& operator+=(numarray_soa<numarray_stack<S, N>>& a, numarray_soa<numarray_stack<S, N>> const& b);
+template <typename S, int N> numarray_soa<numarray_stack<S, N>>& operator-=(numarray_soa<numarray_stack<S, N>>& a, numarray_soa<numarray_stack<S, N>> const& b);
+template <typename S, int N> numarray_soa<numarray_stack<S, N>>& operator+=(numarray_soa<numarray_stack<S, N>>& a, numarray_stack<S, N> const& b);
+template <typename S, int N> numarray_soa<numarray_stack<S, N>>& operator-=(numarray_soa<numarray_stack<S, N>>& a, numarray_stack<S, N> const& b);
+template <typename S, int N> numarray_soa<numarray_stack<S, N>>& operator*=(numarray_soa<numarray_stack<S, N>>& a, float b);
+template <typename S, int N> numarray_soa<numarray_stack<S, N>>& operator/=(numarray_soa<numarray_stack<S, N>>& a, float b);
+
+template <typename S, int N> numarray_soa<numarray_stack<S, N>> operator-(numarray_soa<numarray_stack<S, N>> const& a);
+template <typename S, int N> numarray_soa<numarray_stack<S, N>> operator+(numarray_soa<numarray_stack<S, N>> const& a, numarray_soa<numarray_stack<S, N>> const& b);
+template <typename S, int N> numarray_soa<numarray_stack<S, N>> operator-(numarray_soa<numarray_stack<S, N>> const& a, numarray_soa<numarray_stack<S, N>> const& b);
+template <typename S, int N> numarray_soa<numarray_stack<S, N>> operator*(numarray_soa<numarray_stack<S, N>> const& a, float b);
+template <typename S, int N> numarray_soa<numarray_stack<S, N>> operator*(float a, numarray_soa<numarray_stack<S, N>> const& b);
+template <typename S, int N> numarray_soa<numarray_stack<S, N>> operator/(numarray_soa<numarray_stack<S, N>> const& a, float b);
+
+/** a += s*b (axpy): typical update of positions/velocities in a single pass */
+template <typename S, int N> void add_scaled(numarray_soa<numarray_stack<S, N>>& a, float s, numarray_soa<numarray_stack<S, N>> const& b);
+
+}
+
+
+
+/* ************************************************** */
+/*           IMPLEMENTATION                           */
+/* ************************************************** */
+
+namespace cgp
+{
+
+template <typename S> struct numarray_soa_reference<S, 2>
+{
+    S& x; S& y;
+    numarray_soa_reference(S& x_arg, S& y_arg) :x(x_arg), y(y_arg) {}
+    numarray_soa_reference(numarray_soa_reference const&) = default;
+    operator numarray_stack<S, 2>() const { return { x, y }; }
+    numarray_soa_reference& operator=(numarray_stack<S, 2> const& v) { x = v.x; y = v.y; return *this; }
+    numarray_soa_reference& operator=(numarray_soa_reference const& r) { return *this = numarray_stack<S, 2>(r); }
+};
+template <typename S> struct numarray_soa_reference<S, 3>
+{
+    S& x; S& y; S& z;
+    numarray_soa_reference(S& x_arg, S& y_arg, S& z_arg) :x(x_arg), y(y_arg), z(z_arg) {}
+    numarray_soa_reference(numarray_soa_reference const&) = default;
+    operator numarray_stack<S, 3>() const { return { x, y, z }; }
+    numarray_soa_reference& operator=(numarray_stack<S, 3> const& v) { x = v.x; y = v.y; z = v.z; return *this; }
+    numarray_soa_reference& operator=(numarray_soa_reference const& r) { return *this = numarray_stack<S, 3>(r); }
+};
+template <typename S> struct numarray_soa_reference<S, 4>
+{
+    S& x; S& y; S& z; S& w;
+    numarray_soa_reference(S& x_arg, S& y_arg, S& z_arg, S& w_arg) :x(x_arg), y(y_arg), z(z_arg), w(w_arg) {}
+    numarray_soa_reference(numarray_soa_reference const&) = default;
+    operator numarray_stack<S, 4>() const { return { x, y, z, w }; }
+    numarray_soa_reference& operator=(numarray_stack<S, 4> const& v) { x = v.x; y = v.y; z = v.z; w = v.w; return *this; }
+    numarray_soa_reference& operator=(numarray_soa_reference const& r) { return *this = numarray_stack<S, 4>(r); }
+};
+
+// The proxy is a temporary (v[i] += p): it is taken by value and writes through its references
+template <typename S, int N> numarray_soa_reference<S, N> operator+=(numarray_soa_reference<S, N> a, numarray_stack<S, N> const& b)
+{
+    a = numarray_stack<S, N>(a) + b;
+    return a;
+}
+template <typename S, int N> numarray_soa_reference<S, N> operator-=(numarray_soa_reference<S, N> a, numarray_stack<S, N> const& b)
+{
+    a = numarray_stack<S, N>(a) - b;
+    return a;
+}
+template <typename S, int N> numarray_soa_reference<S, N> operator*=(numarray_soa_reference<S, N> a, float b)
+{
+    a = numarray_stack<S, N>(a) * b;
+    return a;
+}
+
+
+template <typename S, int N>
+numarray_soa<numarray_stack<S, N>>::numarray_soa()
+    :component()
+{}
+
+template <typename S, int N>
+numarray_soa<numarray_stack<S, N>>::numarray_soa(int64_t size)
+    :component()
+{
+    resize(size);
+}
+
+template <typename S, int N>
+numarray_soa<numarray_stack<S, N>>::numarray_soa(std::initializer_list<value_type> arg)
+    :component()
+{
+    resize(int64_t(arg.size()));
+    int64_t k = 0;
+    for (value_type const& v : arg)
+        (*this)[k++] = v;
+}
+
+template <typename S, int N>
+numarray_soa<numarray_stack<S, N>>::numarray_soa(numarray<value_type> const& arg)
+    :component()
+{
+    size_t const M = arg.data.size();
+    resize(int64_t(M));
+    value_type const* in = arg.data.data();
+    for (int j = 0; j < N; ++j) {
+        S* out = component[j].data();
+        for (size_t k = 0; k < M; ++k)
+            out[k] = in[k].at_unsafe(j);
+    }
+}
+
+template <typename S, int N>
+numarray<numarray_stack<S, N>> numarray_soa<numarray_stack<S, N>>::to_numarray() const
+{
+    size_t const M = component[0].size();
+    numarray<value_type> res(static_cast<int64_t>(M));
+    value_type* out = res.data.data();
+    for (int j = 0; j < N; ++j) {
+        S const* in = component[j].data();
+        for (size_t k = 0; k < M; ++k)
+            out[k].at_unsafe(j) = in[k];
+    }
+    return res;
+}
+
+template <typename S, int N>
+int64_t numarray_soa<numarray_stack<S, N>>::size() const
+{
+    return int64_t(component[0].size());
+}
+
+template <typename S, int N>
+numarray_soa<numarray_stack<S, N>>& numarray_soa<numarray_stack<S, N>>::resize(int64_t size)
+{
+    assert_cgp_no_msg(size >= 0);
+    for (int j = 0; j < N; ++j)
+        component[j].resize(size_t(size));
+    return *this;
+}
+
+template <typename S, int N>
+numarray_soa<numarray_stack<S, N>>& numarray_soa<numarray_stack<S, N>>::push_back(value_type const& value)
+{
+    for (int j = 0; j < N; ++j)
+        component[j].push_back(value.at_unsafe(j));
+    return *this;
+}
+
+template <typename S, int N>
+numarray_soa<numarray_stack<S, N>>& numarray_soa<numarray_stack<S, N>>::clear()
+{
+    for (int j = 0; j < N; ++j)
+        component[j].clear();
+    return *this;
+}
+
+template <typename S, int N>
+numarray_soa<numarray_stack<S, N>>& numarray_soa<numarray_stack<S, N>>::fill(value_type const& value)
+{
+    for (int j = 0; j < N; ++j)
+        std::fill(component[j].begin(), component[j].end(), value.at_unsafe(j));
+    return *this;
+}
+
+#ifndef CGP_NO_DEBUG
+template <typename S, int N>
+void check_index_bounds(int64_t index, numarray_soa<numarray_stack<S, N>> const& data)
+{
+    if (index < 0 || index >= data.size())
+        error_cgp("Try to access numarray_soa[" + str(index) + "] while its size is " + str(data.size()) + "\n\t  Type of numarray_soa: " + type_str(data));
+}
+#else
+template <typename S, int N> void check_index_bounds(int64_t, numarray_soa<numarray_stack<S, N>> const&) {}
+#endif
+
+template <typename S, int N>
+numarray_stack<S, N> numarray_soa<numarray_stack<S, N>>::operator[](int64_t index) const
+{
+    check_index_bounds(index, *this);
+    value_type v;
+    for (int j = 0; j < N; ++j)
+        v.at_unsafe(j) = component[j][index];
+    return v;
+}
+
+template <typename S, int N>
+numarray_soa_reference<S, N> numarray_soa<numarray_stack<S, N>>::operator[](int64_t index)
+{
+    check_index_bounds(index, *this);
+    if constexpr (N == 2)
+        return { component[0][index], component[1][index] };
+    else if constexpr (N == 3)
+        return { component[0][index], component[1][index], component[2][index] };
+    else
+        return { component[0][index], component[1][index], component[2][index], component[3][index] };
+}
+
+
+template <typename S, int N> std::string type_str(numarray_soa<numarray_stack<S, N>> const&)
+{
+    return "numarray_soa<" + type_str(numarray_stack<S, N>()) + ">";
+}
+
+template <typename S, int N> std::ostream& operator<<(std::ostream& s, numarray_soa<numarray_stack<S, N>> const& v)
+{
+    s << v.to_numarray();
+    return s;
+}
+
+template <typename S, int N> bool is_equal(numarray_soa<numarray_stack<S, N>> const& a, numarray_soa<numarray_stack<S, N>> const& b)
+{
+    if (a.size() != b.size())
+        return false;
+    using cgp::is_equal;
+    for (int j = 0; j < N; ++j)
+        for (size_t k = 0; k < a.component[j].size(); ++k)
+            if (is_equal(a.component[j][k], b.component[j][k]) == false)
+                return false;
+    return true;
+}
+
+
+template <typename S, int N> numarray_soa<numarray_stack<S, N>>& operator+=(numarray_soa<numarray_stack<S, N>>& a, numarray_soa<numarray_stack<S, N>> const& b)
+{
+    assert_cgp(a.size() == b.size(), "Size do not agree");
+    size_t const M = size_t(a.size());
+    for (int j = 0; j < N; ++j) {
+        S* pa = a.component[j].data();
+        S const* pb = b.component[j].data();
+        for (size_t k = 0; k < M; ++k)
+            pa[k] += pb[k];
+    }
+    return a;
+}
+template <typename S, int N> numarray_soa<numarray_stack<S, N>>& operator-=(numarray_soa<numarray_stack<S, N>>& a, numarray_soa<numarray_stack<S, N>> const& b)
+{
+    assert_cgp(a.size() == b.size(), "Size do not agree");
+    size_t const M = size_t(a.size());
+    for (int j = 0; j < N; ++j) {
+        S* pa = a.component[j].data();
+        S const* pb = b.component[j].data();
+        for (size_t k = 0; k < M; ++k)
+            pa[k] -= pb[k];
+    }
+    return a;
+}
+template <typename S, int N> numarray_soa<numarray_stack<S, N>>& operator+=(numarray_soa<numarray_stack<S, N>>& a, numarray_stack<S, N> const& b)
+{
+    size_t const M = size_t(a.size());
+    for (int j = 0; j < N; ++j) {
+        S* pa = a.component[j].data();
+        S const bj = b.at_unsafe(j);
+        for (size_t k = 0; k < M; ++k)
+            pa[k] += bj;
+    }
+    return a;
+}
+template <typename S, int N> numarray_soa<numarray_stack<S, N>>& operator-=(numarray_soa<numarray_stack<S, N>>& a, numarray_stack<S, N> const& b)
+{
+    return a += (-b);
+}
+template <typename S, int N> numarray_soa<numarray_stack<S, N>>& operator*=(numarray_soa<numarray_stack<S, N>>& a, float b)
+{
+    size_t const M = size_t(a.size());
+    for (int j = 0; j < N; ++j) {
+        S* pa = a.component[j].data();
+        for (size_t k = 0; k < M; ++k)
+            pa[k] *= b;
+    }
+    return a;
+}
+template <typename S, int N> numarray_soa<numarray_stack<S, N>>& operator/=(numarray_soa<numarray_stack<S, N>>& a, float b)
+{
+    return a *= (1.0f/b);
+}
+template <typename S, int N> void add_scaled(numarray_soa<numarray_stack<S, N>>& a, float s, numarray_soa<numarray_stack<S, N>> const& b)
+{
+    assert_cgp(a.size() == b.size(), "Size do not agree");
+    size_t const M = size_t(a.size());
+    for (int j = 0; j < N; ++j) {
+        S* pa = a.component[j].data();
+        S const* pb = b.component[j].data();
+        for (size_t k = 0; k < M; ++k)
+            pa[k] += s*pb[k];
+    }
+}
+
+template <typename S, int N> numarray_soa<numarray_stack<S, N>> operator-(numarray_soa<numarray_stack<S, N>> const& a)
+{
+    numarray_soa<numarray_stack<S, N>> res = a;
+    res *= -1.0f;
+    return res;
+}
+template <typename S, int N> numarray_soa<numarray_stack<S, N>> operator+(numarray_soa<numarray_stack<S, N>> const& a, numarray_soa<numarray_stack<S, N>> const& b)
+{
+    numarray_soa<numarray_stack<S, N>> res = a;
+    res += b;
+    return res;
+}
+template <typename S, int N> numarray_soa<numarray_stack<S, N>> operator-(numarray_soa<numarray_stack<S, N>> const& a, numarray_soa<numarray_stack<S, N>> const& b)
+{
+    numarray_soa<numarray_stack<S, N>> res = a;
+    res -= b;
+    return res;
+}
+template <typename S, int N> numarray_soa<numarray_stack<S, N>> operator*(numarray_soa<numarray_stack<S, N>> const& a, float b)
+{
+    numarray_soa<numarray_stack<S, N>> res = a;
+    res *= b;
+    return res;
+}
+template <typename S, int N> numarray_soa<numarray_stack<S, N>> operator*(float a, numarray_soa<numarray_stack<S, N>> const& b)
+{
+    return b*a;
+}
+template <typename S, int N> numarray_soa<numarray_stack<S, N>> operator/(numarray_soa<numarray_stack<S, N>> const& a, float b)
+{
+    numarray_soa<numarray_stack<S, N>> res = a;
+    res /= b;
+    return res;
+}
+
+}
@@ -0,0 +1,56 @@
+#include "cgp/02_numarray/numarray.hpp"
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+
+	void test_numarray_soa()
+	{
+		using cgp::vec3;
+		using cgp::vec4;
+
+		{
+			cgp::numarray_soa<vec3> a = { {1,2,3}, {4,5,6} };
+			assert_cgp_no_msg(a.size() == 2);
+			assert_cgp_no_msg(cgp::is_equal(a.component[0][1], 4.0f));
+			assert_cgp_no_msg(cgp::is_equal(a.component[2][0], 3.0f));
+			assert_cgp_no_msg(reinterpret_cast<size_t>(a.component[1].data()) % 64 == 0);
+		}
+
+		{
+			cgp::numarray_soa<vec3> a(2);
+			a[0] = vec3{ 1,2,3 };
+			a[1].y = 7.0f;
+			a[1] += vec3{ 1,1,1 };
+			vec3 const p = a[1];
+			assert_cgp_no_msg(is_equal(p, vec3{ 1,8,1 }));
+			a[0] = a[1];
+			assert_cgp_no_msg(is_equal(vec3(a[0]), vec3{ 1,8,1 }));
+
+			cgp::numarray_soa<vec3> const& b = a;
+			assert_cgp_no_msg(cgp::is_equal(b[0].y, 8.0f));
+		}
+
+		{
+			cgp::numarray<vec4> const a = { {1,2,3,4}, {5,6,7,8}, {9,10,11,12} };
+			cgp::numarray_soa<vec4> const b = a;
+			assert_cgp_no_msg(is_equal(b.to_numarray(), a));
+			assert_cgp_no_msg(is_equal(b[2], vec4{ 9,10,11,12 }));
+		}
+
+		{
+			cgp::numarray_soa<vec3> a = { {1,2,3}, {4,5,6} };
+			cgp::numarray_soa<vec3> const b = { {1,1,1}, {2,0,-1} };
+			cgp::numarray_soa<vec3> c = a + 2.0f*b;
+			assert_cgp_no_msg(is_equal(c.to_numarray(), cgp::numarray<vec3>{ {3,4,5}, {8,5,4} }));
+			c -= a;
+			c /= 2.0f;
+			assert_cgp_no_msg(is_equal(c, b));
+			add_scaled(a, -1.0f, b);
+			assert_cgp_no_msg(is_equal(a.to_numarray(), cgp::numarray<vec3>{ {0,1,2}, {2,5,7} }));
+		}
+	}
+}
@@ -1,14 +1,15 @@
 #pragma once
 
 #include "cgp/01_base/base.hpp"
+#include "../../numarray/numarray_fwd.hpp"
 #include <array>
 #include <cmath>
+#include <utility>
 
 
 
 namespace cgp
 {
-    template <typename T> struct numarray;
 
     // Implementation of generic size numarray_stack
     //   numarray_stack is a constant size structure (size known at compile time).
@@ -27,7 +28,7 @@ namespace cgp
         // ******************************************************* //
 
         /** Size of the buffer (N - known at compile time) */
-        int size() const;
+        constexpr int size() const;
 
         /** Fill all data with the given value */
         numarray_stack<T,N>& fill(T const& value);
@@ -70,8 +71,8 @@ namespace cgp
     template <typename T, int N> std::ostream& operator<<(std::ostream& s, numarray_stack<T, N> const& v);
 
     /** Direct compiled-checked access to data */
-    template <int idx, typename T, int N> T const& get(numarray_stack<T,N> const& data);
-    template <int idx, typename T, int N> T& get(numarray_stack<T, N>& data);
+    template <int idx, typename T, int N> constexpr T const& get(numarray_stack<T,N> const& data);
+    template <int idx, typename T, int N> constexpr T& get(numarray_stack<T, N>& data);
 
 
     /** Convert all elements of the buffer to a string.
@@ -93,32 +94,27 @@ namespace cgp
 
 
     /** Math operators
-     * Common mathematical operations between buffers, and scalar or element values. */
-    template <typename T, int N> numarray_stack<T, N>  operator-(numarray_stack<T, N> const& a);
-
-    template <typename T, int N> numarray_stack<T, N>& operator+=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b);
-    //template <typename T, int N> numarray_stack<T, N>& operator+=(numarray_stack<T, N>& a, T const& b);
-    template <typename T, int N> numarray_stack<T, N>  operator+(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b);
-    //template <typename T, int N> numarray_stack<T, N>  operator+(numarray_stack<T, N> const& a, T const& b);
-    //template <typename T, int N> numarray_stack<T, N>  operator+(T const& a, numarray_stack<T, N> const& b);
-
-    template <typename T, int N> numarray_stack<T, N>& operator-=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b);
-    //template <typename T, int N> numarray_stack<T, N>& operator-=(numarray_stack<T, N>& a, T const& b);
-    template <typename T, int N> numarray_stack<T, N>  operator-(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b);
-    //template <typename T, int N> numarray_stack<T, N>  operator-(numarray_stack<T, N> const& a, T const& b);
-    //template <typename T, int N> numarray_stack<T, N>  operator-(T const& a, numarray_stack<T, N> const& b);
-
-    template <typename T, int N> numarray_stack<T, N>& operator*=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b);
-    template <typename T, int N> numarray_stack<T, N>& operator*=(numarray_stack<T, N>& a, float b);
-    template <typename T, int N> numarray_stack<T, N>  operator*(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b);
-    template <typename T, int N> numarray_stack<T, N>  operator*(numarray_stack<T, N> const& a, float b);
-    template <typename T, int N> numarray_stack<T, N>  operator*(float a, numarray_stack<T, N> const& b);
-
-    template <typename T, int N> numarray_stack<T, N>& operator/=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b);
-    template <typename T, int N> numarray_stack<T, N>& operator/=(numarray_stack<T, N>& a, float b);
-    template <typename T, int N> numarray_stack<T, N>  operator/(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b);
-    template <typename T, int N> numarray_stack<T, N>  operator/(numarray_stack<T, N> const& a, float b);
-    template <typename T, int N> numarray_stack<T, N>  operator/(float a, numarray_stack<T, N> const& b);
+     * Common mathematical operations between buffers, and scalar or element values.
+     * The operations are unrolled on the N components at compile time, and can be used in constant expressions (constexpr). */
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator-(numarray_stack<T, N> const& a);
+
+    template <typename T, int N> constexpr numarray_stack<T, N>& operator+=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator+(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b);
+
+    template <typename T, int N> constexpr numarray_stack<T, N>& operator-=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator-(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b);
+
+    template <typename T, int N> constexpr numarray_stack<T, N>& operator*=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b);
+    template <typename T, int N> constexpr numarray_stack<T, N>& operator*=(numarray_stack<T, N>& a, float b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator*(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator*(numarray_stack<T, N> const& a, float b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator*(float a, numarray_stack<T, N> const& b);
+
+    template <typename T, int N> constexpr numarray_stack<T, N>& operator/=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b);
+    template <typename T, int N> constexpr numarray_stack<T, N>& operator/=(numarray_stack<T, N>& a, float b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator/(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator/(numarray_stack<T, N> const& a, float b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator/(float a, numarray_stack<T, N> const& b);
 
 
     // Return the unit vector.
@@ -132,29 +128,29 @@ namespace cgp
     // Return ||v|| in the standard norm
     template <typename T, int N> T norm(numarray_stack<T, N> const& v);
     // Dot product between vectors
-    template <typename T, int N> T dot(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b);
+    template <typename T, int N> constexpr T dot(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b);
 
     // Math operators applied to each component
-    template <typename T, int N> T max(numarray_stack<T, N> const& v);
-    template <typename T, int N> T min(numarray_stack<T, N> const& v);
-    template <typename T, int N> T average(numarray_stack<T, N> const& a);
-    template <typename T, int N> T sum(numarray_stack<T, N> const& v);
+    template <typename T, int N> constexpr T max(numarray_stack<T, N> const& v);
+    template <typename T, int N> constexpr T min(numarray_stack<T, N> const& v);
+    template <typename T, int N> constexpr T average(numarray_stack<T, N> const& a);
+    template <typename T, int N> constexpr T sum(numarray_stack<T, N> const& v);
     template <typename T, int N> numarray_stack<T, N> abs(numarray_stack<T, N> const& a);
     template <typename T, int N> numarray_stack<T, N> clamp(numarray_stack<T, N> const& x, numarray_stack<T, N> const& p_min, numarray_stack<T, N> const& p_max);
 
 
     // Allow componentwise operations
-    template <typename T, int N> numarray_stack<T, N>  sub(numarray_stack<T, N> const& a, T const& b);
-    template <typename T, int N> numarray_stack<T, N>  add(numarray_stack<T, N> const& a, T const& b);
-    template <typename T, int N> numarray_stack<T, N>  mul(numarray_stack<T, N> const& a, T const& b);
-    template <typename T, int N> numarray_stack<T, N>  div(numarray_stack<T, N> const& a, T const& b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  sub(numarray_stack<T, N> const& a, T const& b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  add(numarray_stack<T, N> const& a, T const& b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  mul(numarray_stack<T, N> const& a, T const& b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  div(numarray_stack<T, N> const& a, T const& b);
 
-    template <typename T, int N> numarray_stack<T, N>  sub(T const& a, numarray_stack<T, N> const& b);
-    template <typename T, int N> numarray_stack<T, N>  add(T const& a, numarray_stack<T, N> const& b);
-    template <typename T, int N> numarray_stack<T, N>  mul(T const& a, numarray_stack<T, N> const& b);
-    template <typename T, int N> numarray_stack<T, N>  div(T const& a, numarray_stack<T, N> const& b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  sub(T const& a, numarray_stack<T, N> const& b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  add(T const& a, numarray_stack<T, N> const& b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  mul(T const& a, numarray_stack<T, N> const& b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  div(T const& a, numarray_stack<T, N> const& b);
 
-    template <typename T, int N> numarray_stack<T, N>  mul(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b);
+    template <typename T, int N> constexpr numarray_stack<T, N>  mul(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b);
 
 }
 
@@ -167,7 +163,7 @@ namespace cgp
 {
 
 
-    template <typename T, int N> int numarray_stack<T, N>::size() const
+    template <typename T, int N> constexpr int numarray_stack<T, N>::size() const
     {
         return N;
     }
@@ -282,12 +278,12 @@ namespace cgp
     }
 
 
-    template <int idx, typename T, int N> T const& get(numarray_stack<T, N> const& data)
+    template <int idx, typename T, int N> constexpr T const& get(numarray_stack<T, N> const& data)
     {
         static_assert(idx>=0 && idx < N, "Incorrect element indexing");
         return data.data[idx];
     }
-    template <int idx, typename T, int N> T& get(numarray_stack<T, N>& data)
+    template <int idx, typename T, int N> constexpr T& get(numarray_stack<T, N>& data)
     {
         static_assert(idx>=0 && idx < N, "Incorrect element indexing");
         return data.data[idx];
@@ -349,160 +345,130 @@ namespace cgp
 
 
 
-    template <typename T, int N> numarray_stack<T, N>  operator-(numarray_stack<T, N> const& a)
+    namespace detail
     {
-        numarray_stack<T, N> res;
-        for (int k = 0; k < N; ++k)
-            res[k] = -a[k];
-        return res;
+        // Unrolled loops on the components of numarray_stack:
+        //   The component index I is a template parameter expanded with fold expressions. The loops are compiled as straight-line code
+        //   without counter nor bounds check (get<I>), and can be evaluated at compile time.
+
+        // f(get<I>(args)...) - for the I-th component of all the arguments
+        template <int I, typename F, typename... Args> constexpr auto apply_component(F const& f, Args const&... args)
+        {
+            return f(get<I>(args)...);
+        }
+
+        // numarray_stack<T,N>{ f(get<0>(args)...), ..., f(get<N-1>(args)...) }
+        template <typename T, int N, typename F, typename... Args, int... I>
+        constexpr numarray_stack<T, N> componentwise_unrolled(std::integer_sequence<int, I...>, F const& f, Args const&... args)
+        {
+            return numarray_stack<T, N>{ static_cast<T>(apply_component<I>(f, args...))... };
+        }
+        template <typename T, int N, typename F, typename... Args>
+        constexpr numarray_stack<T, N> componentwise(F const& f, Args const&... args)
+        {
+            return componentwise_unrolled<T, N>(std::make_integer_sequence<int, N>(), f, args...);
+        }
+
+        // init + f(get<0>(args)...) + ... + f(get<N-1>(args)...), summed from left to right (as a loop on the components)
+        template <typename R, typename F, typename... Args, int... I>
+        constexpr R accumulate_unrolled(std::integer_sequence<int, I...>, R const& init, F const& f, Args const&... args)
+        {
+            return (init + ... + apply_component<I>(f, args...));
+        }
+        template <int N, typename R, typename F, typename... Args>
+        constexpr R accumulate(R const& init, F const& f, Args const&... args)
+        {
+            return accumulate_unrolled(std::make_integer_sequence<int, N>(), init, f, args...);
+        }
+
+        // Return the component c such that compare(c, c_k) is true for every other component c_k (the first one in case of equality)
+        template <typename T, int N, typename Compare, int... I>
+        constexpr T select_unrolled(std::integer_sequence<int, I...>, numarray_stack<T, N> const& v, Compare const& compare)
+        {
+            T current = get<0>(v);
+            ((current = compare(get<I>(v), current) ? get<I>(v) : current), ...);
+            return current;
+        }
     }
 
-    template <typename T, int N> numarray_stack<T, N>& operator+=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b)
+
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator-(numarray_stack<T, N> const& a)
     {
-        for (int k = 0; k < N; ++k)
-            a[k] += b[k];
+        return detail::componentwise<T, N>([](T const& x) { return -x; }, a);
+    }
+
+    template <typename T, int N> constexpr numarray_stack<T, N>& operator+=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b)
+    {
+        a = a + b;
         return a;
     }
-    //template <typename T, int N> numarray_stack<T, N>& operator+=(numarray_stack<T, N>& a, T const& b)
-    //{
-    //    for (int k = 0; k < N; ++k)
-    //        a[k] += b;
-    //    return a;
-    //}
-    template <typename T, int N> numarray_stack<T, N>  operator+(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator+(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b)
     {
-        numarray_stack<T, N> res;
-        for (int k = 0; k < N; ++k)
-            res[k] = a[k] + b[k];
-        return res;
-    }
-    //template <typename T, int N> numarray_stack<T, N>  operator+(numarray_stack<T, N> const& a, T const& b)
-    //{
-    //    numarray_stack<T, N> res;
-    //    for (int k = 0; k < N; ++k)
-    //        res[k] = a[k] + b;
-    //    return res;
-    //}
-    //template <typename T, int N> numarray_stack<T, N>  operator+(T const& a, numarray_stack<T, N> const& b)
-    //{
-    //    numarray_stack<T, N> res;
-    //    for (int k = 0; k < N; ++k)
-    //        res[k] = a + b[k];
-    //    return res;
-    //}
-
-    template <typename T, int N> numarray_stack<T, N>& operator-=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b)
+        return detail::componentwise<T, N>([](T const& x, T const& y) { return x + y; }, a, b);
+    }
+
+    template <typename T, int N> constexpr numarray_stack<T, N>& operator-=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b)
     {
-        for (int k = 0; k < N; ++k)
-            a[k] -= b[k];
+        a = a - b;
         return a;
     }
-    //template <typename T, int N> numarray_stack<T, N>& operator-=(numarray_stack<T, N>& a, T const& b)
-    //{
-    //    for (int k = 0; k < N; ++k)
-    //        a[k] -= b;
-    //    return a;
-    //}
-    template <typename T, int N> numarray_stack<T, N>  operator-(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator-(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b)
     {
-        numarray_stack<T, N> res;
-        for (int k = 0; k < N; ++k)
-            res[k] = a[k] - b[k];
-        return res;
-    }
-    //template <typename T, int N> numarray_stack<T, N>  operator-(numarray_stack<T, N> const& a, T const& b)
-    //{
-    //    numarray_stack<T, N> res;
-    //    for (int k = 0; k < N; ++k)
-    //        res[k] = a[k] - b;
-    //    return res;
-    //}
-    //template <typename T, int N> numarray_stack<T, N>  operator-(T const& a, numarray_stack<T, N> const& b)
-    //{
-    //    numarray_stack<T, N> res;
-    //    for (int k = 0; k < N; ++k)
-    //        res[k] = a - b[k];
-    //    return res;
-    //}
-
-    template <typename T, int N> numarray_stack<T, N>& operator*=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b)
+        return detail::componentwise<T, N>([](T const& x, T const& y) { return x - y; }, a, b);
+    }
+
+    template <typename T, int N> constexpr numarray_stack<T, N>& operator*=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b)
     {
-        for (int k = 0; k < N; ++k)
-            a[k] *= b[k];
+        a = a * b;
         return a;
     }
-    template <typename T, int N> numarray_stack<T, N>& operator*=(numarray_stack<T, N>& a, float b)
+    template <typename T, int N> constexpr numarray_stack<T, N>& operator*=(numarray_stack<T, N>& a, float b)
     {
-        for (int k = 0; k < N; ++k)
-            a[k] *= b;
+        a = a * b;
         return a;
     }
-    template <typename T, int N> numarray_stack<T, N>  operator*(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator*(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b)
     {
-        numarray_stack<T, N> res;
-        for (int k = 0; k < N; ++k)
-            res[k] = a[k] * b[k];
-        return res;
+        return detail::componentwise<T, N>([](T const& x, T const& y) { return x * y; }, a, b);
     }
-    template <typename T, int N> numarray_stack<T, N>  operator*(numarray_stack<T, N> const& a, float b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator*(numarray_stack<T, N> const& a, float b)
     {
-        numarray_stack<T, N> res;
-        for (int k = 0; k < N; ++k)
-            res[k] = a[k] * b;
-        return res;
+        return detail::componentwise<T, N>([b](T const& x) { return x * b; }, a);
     }
-    template <typename T, int N> numarray_stack<T, N>  operator*(float a, numarray_stack<T, N> const& b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator*(float a, numarray_stack<T, N> const& b)
     {
-        numarray_stack<T, N> res;
-        for (int k = 0; k < N; ++k)
-            res[k] = a * b[k];
-        return res;
+        return detail::componentwise<T, N>([a](T const& y) { return a * y; }, b);
     }
 
-    template <typename T, int N> numarray_stack<T, N>& operator/=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b)
+    template <typename T, int N> constexpr numarray_stack<T, N>& operator/=(numarray_stack<T, N>& a, numarray_stack<T, N> const& b)
     {
-        numarray_stack<T, N> res;
-        for (int k = 0; k < N; ++k)
-            res[k] = a[k] / b[k];
-        return res;
+        a = a / b;
+        return a;
     }
-    template <typename T, int N> numarray_stack<T, N>& operator/=(numarray_stack<T, N>& a, float b)
+    template <typename T, int N> constexpr numarray_stack<T, N>& operator/=(numarray_stack<T, N>& a, float b)
     {
-        for (int k = 0; k < N; ++k)
-            a[k] /= b;
+        a = a / b;
         return a;
     }
-    template <typename T, int N> numarray_stack<T, N>  operator/(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator/(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b)
     {
-        numarray_stack<T, N> res;
-        for (int k = 0; k < N; ++k)
-            res[k] = a[k] / b[k];
-        return res;
+        return detail::componentwise<T, N>([](T const& x, T const& y) { return x / y; }, a, b);
     }
-    template <typename T, int N> numarray_stack<T, N>  operator/(numarray_stack<T, N> const& a, float b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator/(numarray_stack<T, N> const& a, float b)
     {
-        numarray_stack<T, N> res;
-        for (int k = 0; k < N; ++k)
-            res[k] = a[k] / b;
-        return res;
+        return detail::componentwise<T, N>([b](T const& x) { return x / b; }, a);
     }
-    template <typename T, int N> numarray_stack<T, N>  operator/(float a, numarray_stack<T, N> const& b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  operator/(float a, numarray_stack<T, N> const& b)
     {
-        numarray_stack<T, N> res;
-        for (int k = 0; k < N; ++k)
-            res[k] = a / b[k];
-        return res;
+        return detail::componentwise<T, N>([a](T const& y) { return a / y; }, b);
     }
 
 
 
 
-    template <typename T, int N> T dot(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b)
+    template <typename T, int N> constexpr T dot(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b)
     {
-        T s = {};
-        for (int k = 0; k < N; ++k)
-            s += a[k] * b[k];
-        return s;
+        return detail::accumulate<N>(T{}, [](T const& x, T const& y) { return x * y; }, a, b);
     }
     template <typename T, int N> T norm(numarray_stack<T, N> const& a)
     {
@@ -540,125 +506,74 @@ namespace cgp
     }
 
 
-    template <typename T, int N> T max(numarray_stack<T, N> const& v)
+    template <typename T, int N> constexpr T max(numarray_stack<T, N> const& v)
     {
         static_assert(N > 0, "Cannot get max on empty numarray_stack");
-
-        T current_max = get<0>(v);
-        for (int k = 1; k < N; ++k) {
-            T const& element = v.at_unsafe(k);
-            if (element > current_max)
-                current_max = element;
-        }
-
-        return current_max;
+        return detail::select_unrolled(std::make_integer_sequence<int, N>(), v, [](T const& element, T const& current_max) { return element > current_max; });
     }
-    template <typename T, int N> T min(numarray_stack<T, N> const& v)
+    template <typename T, int N> constexpr T min(numarray_stack<T, N> const& v)
     {
         static_assert(N > 0, "Cannot get min on empty numarray_stack");
-
-        T current_min = get<0>(v);
-        for (int k = 1; k < N; ++k) {
-            T const& element = v.at_unsafe(k);
-            if (element < current_min)
-                current_min = element;
-        }
-
-        return current_min;
+        return detail::select_unrolled(std::make_integer_sequence<int, N>(), v, [](T const& element, T const& current_min) { return element < current_min; });
     }
-    template <typename T, int N> T average(numarray_stack<T, N> const& a)
+    template <typename T, int N> constexpr T average(numarray_stack<T, N> const& a)
     {
         static_assert(N > 0, "Cannot get average on empty numarray_stack");
         return sum(a)/static_cast<float>(N);
     }
-    template <typename T, int N> T sum(numarray_stack<T, N> const& v)
+    template <typename T, int N> constexpr T sum(numarray_stack<T, N> const& v)
     {
-        T element = T(); // assume element is initialized at 0
-        for (int k = 0; k < N; ++k)
-            element += v.at_unsafe(k);
-        return element;
+        // assume T() is 0
+        return detail::accumulate<N>(T(), [](T const& x) { return x; }, v);
     }
     template <typename T, int N> numarray_stack<T, N> abs(numarray_stack<T, N> const& a)
     {
-        numarray_stack<T, N> element;
-        for (int k = 0; k < N; ++k)
-            element[k] = abs(a[k]);
-        return element;
+        return detail::componentwise<T, N>([](T const& x) { return abs(x); }, a);
     }
     template <typename T, int N> numarray_stack<T, N> clamp(numarray_stack<T, N> const& x, numarray_stack<T, N> const& p_min, numarray_stack<T, N> const& p_max)
     {
-        numarray_stack<T, N> element;
-        for (int k = 0; k < N; ++k)
-            element[k] = clamp(x[k], p_min[k], p_max[k]);
-        return element;
+        return detail::componentwise<T, N>([](T const& value, T const& value_min, T const& value_max) { return clamp(value, value_min, value_max); }, x, p_min, p_max);
     }
 
     // Allow componentwise operations
-    template <typename T, int N> numarray_stack<T, N>  sub(numarray_stack<T, N> const& a, T const& b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  sub(numarray_stack<T, N> const& a, T const& b)
     {
-        numarray_stack<T, N> res;
-        for(int k=0; k<N; ++k)
-            res[k] = a[k]-b;
-        return res;
+        return detail::componentwise<T, N>([&b](T const& x) { return x - b; }, a);
     }
-    template <typename T, int N> numarray_stack<T, N>  add(numarray_stack<T, N> const& a, T const& b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  add(numarray_stack<T, N> const& a, T const& b)
     {
-        numarray_stack<T, N> res;
-        for(int k=0; k<N; ++k)
-            res[k] = a[k]+b;
-        return res;
+        return detail::componentwise<T, N>([&b](T const& x) { return x + b; }, a);
     }
 
-    template <typename T, int N> numarray_stack<T, N>  mul(numarray_stack<T, N> const& a, T const& b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  mul(numarray_stack<T, N> const& a, T const& b)
     {
-        numarray_stack<T, N> res;
-        for(int k=0; k<N; ++k)
-            res[k] = a[k]*b;
-        return res;
+        return detail::componentwise<T, N>([&b](T const& x) { return x * b; }, a);
     }
 
-    template <typename T, int N> numarray_stack<T, N>  div(numarray_stack<T, N> const& a, T b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  div(numarray_stack<T, N> const& a, T const& b)
     {
-        numarray_stack<T, N> res;
-        for(int k=0; k<N; ++k)
-            res[k] = a[k]/b;
-        return res;
+        return detail::componentwise<T, N>([&b](T const& x) { return x / b; }, a);
     }
 
-    template <typename T, int N> numarray_stack<T, N>  sub(T const& a, numarray_stack<T, N> const& b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  sub(T const& a, numarray_stack<T, N> const& b)
     {
-        numarray_stack<T, N> res;
-        for(int k=0; k<N; ++k)
-            res[k] = a-b[k];
-        return res;
+        return detail::componentwise<T, N>([&a](T const& y) { return a - y; }, b);
     }
-    template <typename T, int N> numarray_stack<T, N>  add(T const& a, numarray_stack<T, N> const& b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  add(T const& a, numarray_stack<T, N> const& b)
     {
-        numarray_stack<T, N> res;
-        for(int k=0; k<N; ++k)
-            res[k] = a+b[k];
-        return res;
+        return detail::componentwise<T, N>([&a](T const& y) { return a + y; }, b);
     }
-    template <typename T, int N> numarray_stack<T, N>  mul(T const& a, numarray_stack<T, N> const& b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  mul(T const& a, numarray_stack<T, N> const& b)
     {
-        numarray_stack<T, N> res;
-        for(int k=0; k<N; ++k)
-            res[k] = a*b[k];
-        return res;
+        return detail::componentwise<T, N>([&a](T const& y) { return a * y; }, b);
     }
-    template <typename T, int N> numarray_stack<T, N>  div(T const& a, numarray_stack<T, N> const& b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  div(T const& a, numarray_stack<T, N> const& b)
     {
-        numarray_stack<T, N> res;
-        for(int k=0; k<N; ++k)
-            res[k] = a/b[k];
-        return res;
+        return detail::componentwise<T, N>([&a](T const& y) { return a / y; }, b);
     }
 
-    template <typename T, int N> numarray_stack<T, N>  mul(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b)
+    template <typename T, int N> constexpr numarray_stack<T, N>  mul(numarray_stack<T, N> const& a, numarray_stack<T, N> const& b)
     {
-        numarray_stack<T, N> res;
-        for(int k=0; k<N; ++k)
-            res[k] = a[k]*b[k];
-        return res;
+        return detail::componentwise<T, N>([](T const& x, T const& y) { return x * y; }, a, b);
     }
 }
@@ -13,17 +13,17 @@ namespace cgp
         T x, y;
 
 
-        numarray_stack<T, 2>();
-        numarray_stack<T, 2>(T const& x, T const& y);
+        constexpr numarray_stack<T, 2>();
+        constexpr numarray_stack<T, 2>(T const& x, T const& y);
         template<typename T1,typename T2>
-        numarray_stack<T, 2>(T1 const& x, T2 const& y);
-        numarray_stack<T, 2>(numarray_stack<T,3> const& v);
-        numarray_stack<T, 2>(numarray_stack<T,4> const& v);
+        constexpr numarray_stack<T, 2>(T1 const& x, T2 const& y);
+        constexpr numarray_stack<T, 2>(numarray_stack<T,3> const& v);
+        constexpr numarray_stack<T, 2>(numarray_stack<T,4> const& v);
 
 
     
         /** Size of the buffer = 2 */
-        int size() const;
+        constexpr int size() const;
 
         /** Fill all data with the given value */
         numarray_stack<T, 2>& fill(T const& value);
@@ -61,31 +61,31 @@ namespace cgp
 namespace cgp
 {
 
-    template <typename T>  numarray_stack<T, 2>::numarray_stack()
+    template <typename T>  constexpr numarray_stack<T, 2>::numarray_stack()
         :x(T()),y(T())
     {}
 
-    template <typename T>  numarray_stack<T, 2>::numarray_stack(T const& x_arg, T const& y_arg)
+    template <typename T>  constexpr numarray_stack<T, 2>::numarray_stack(T const& x_arg, T const& y_arg)
         :x(x_arg),y(y_arg)
     {}
 
     template <typename T>
     template <typename T1,typename T2>
-    numarray_stack<T, 2>::numarray_stack(T1 const& x_arg, T2 const& y_arg)
+    constexpr numarray_stack<T, 2>::numarray_stack(T1 const& x_arg, T2 const& y_arg)
         :x(x_arg),y(y_arg)
     {}
 
     template <typename T>
-    numarray_stack<T, 2>::numarray_stack(numarray_stack<T, 3> const& v)
+    constexpr numarray_stack<T, 2>::numarray_stack(numarray_stack<T, 3> const& v)
         : x(v.x), y(v.y)
     {}
 
     template <typename T>
-    numarray_stack<T, 2>::numarray_stack(numarray_stack<T, 4> const& v)
+    constexpr numarray_stack<T, 2>::numarray_stack(numarray_stack<T, 4> const& v)
         : x(v.x), y(v.y)
     {}
     
-    template <typename T> int numarray_stack<T, 2>::size() const
+    template <typename T> constexpr int numarray_stack<T, 2>::size() const
     {
         return 2;
     }
@@ -158,15 +158,21 @@ namespace cgp
     template <typename T> T const* numarray_stack<T, 2>::cend() const { return &y+1; }
 
 
-    template <int idx, typename T> T const& get(numarray_stack<T, 2> const& data)
+    template <int idx, typename T> constexpr T const& get(numarray_stack<T, 2> const& data)
     {
-        static_assert(idx < 2, "Incorrect element indexing");
-        return (&data.x)[idx];
+        static_assert(idx >= 0 && idx < 2, "Incorrect element indexing");
+        if constexpr (idx == 0)
+            return data.x;
+        else
+            return data.y;
     }
-    template <int idx, typename T> T& get(numarray_stack<T, 2>& data)
+    template <int idx, typename T> constexpr T& get(numarray_stack<T, 2>& data)
     {
-        static_assert(idx < 2, "Incorrect element indexing");
-        return (&data.x)[idx];
+        static_assert(idx >= 0 && idx < 2, "Incorrect element indexing");
+        if constexpr (idx == 0)
+            return data.x;
+        else
+            return data.y;
     }
 
 
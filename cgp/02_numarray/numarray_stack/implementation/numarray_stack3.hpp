@@ -16,17 +16,17 @@ namespace cgp
 
 
 
-        numarray_stack<T, 3>();
-        numarray_stack<T, 3>(T const& x, T const& y, T const& z);
-        numarray_stack<T, 3>(numarray_stack<T, 2> const& xy, T const& z);
-        numarray_stack<T, 3>(T const& x, numarray_stack<T, 2> const& yz);
+        constexpr numarray_stack<T, 3>();
+        constexpr numarray_stack<T, 3>(T const& x, T const& y, T const& z);
+        constexpr numarray_stack<T, 3>(numarray_stack<T, 2> const& xy, T const& z);
+        constexpr numarray_stack<T, 3>(T const& x, numarray_stack<T, 2> const& yz);
         template<typename T1,typename T2, typename T3>
-        numarray_stack<T,3>(T1 const& x, T2 const& y, T3 const& z);
+        constexpr numarray_stack<T,3>(T1 const& x, T2 const& y, T3 const& z);
 
 
 
         /** Size of the buffer = 3 */
-        int size() const;
+        constexpr int size() const;
 
         /** Fill all data with the given value */
         numarray_stack<T, 3>& fill(T const& value);
@@ -70,27 +70,27 @@ namespace cgp
 namespace cgp
 {
 
-    template <typename T> numarray_stack<T, 3>::numarray_stack()
+    template <typename T> constexpr numarray_stack<T, 3>::numarray_stack()
         :x(T()),y(T()),z(T())
     {}
-    template <typename T> numarray_stack<T, 3>::numarray_stack(T const& x_arg, T const& y_arg, T const& z_arg)
+    template <typename T> constexpr numarray_stack<T, 3>::numarray_stack(T const& x_arg, T const& y_arg, T const& z_arg)
         : x(x_arg), y(y_arg), z(z_arg)
     {}
-    template <typename T> numarray_stack<T, 3>::numarray_stack(numarray_stack<T, 2> const& xy, T const& z_arg)
+    template <typename T> constexpr numarray_stack<T, 3>::numarray_stack(numarray_stack<T, 2> const& xy, T const& z_arg)
         : x(get<0>(xy)), y(get<1>(xy)), z(z_arg)
     {}
-    template <typename T> numarray_stack<T, 3>::numarray_stack(T const& x_arg, numarray_stack<T, 2> const& yz)
+    template <typename T> constexpr numarray_stack<T, 3>::numarray_stack(T const& x_arg, numarray_stack<T, 2> const& yz)
         : x(x_arg), y(get<0>(yz)), z(get<1>(yz))
     {}
 
     template <typename T>
     template<typename T1,typename T2, typename T3>
-    numarray_stack<T, 3>::numarray_stack(T1 const& x_arg, T2 const& y_arg, T3 const& z_arg)
+    constexpr numarray_stack<T, 3>::numarray_stack(T1 const& x_arg, T2 const& y_arg, T3 const& z_arg)
         :x(T(x_arg)), y(T(y_arg)), z(T(z_arg))
     {}
 
 
-    template <typename T> int numarray_stack<T, 3>::size() const
+    template <typename T> constexpr int numarray_stack<T, 3>::size() const
     {
         return 3;
     }
@@ -184,15 +184,25 @@ namespace cgp
     }
 
 
-    template <int idx, typename T> T const& get(numarray_stack<T, 3> const& data)
+    template <int idx, typename T> constexpr T const& get(numarray_stack<T, 3> const& data)
     {
-        static_assert(idx < 3, "Incorrect element indexing");
-        return (&data.x)[idx];
+        static_assert(idx >= 0 && idx < 3, "Incorrect element indexing");
+        if constexpr (idx == 0)
+            return data.x;
+        else if constexpr (idx == 1)
+            return data.y;
+        else
+            return data.z;
     }
-    template <int idx, typename T> T& get(numarray_stack<T, 3>& data)
-    {
-        static_assert(idx < 3, "Incorrect element indexing");
-        return (&data.x)[idx];
+    template <int idx, typename T> constexpr T& get(numarray_stack<T, 3>& data)
+    {
+        static_assert(idx >= 0 && idx < 3, "Incorrect element indexing");
+        if constexpr (idx == 0)
+            return data.x;
+        else if constexpr (idx == 1)
+            return data.y;
+        else
+            return data.z;
     }
 
 
@@ -13,19 +13,19 @@ namespace cgp
         T x, y, z, w;
 
 
-        numarray_stack<T, 4>();
-        numarray_stack<T, 4>(T const& x, T const& y, T const& z, T const& w);
-        numarray_stack<T, 4>(numarray_stack<T, 3> const& xyz, T const& w);
-        numarray_stack<T, 4>(T const& x, numarray_stack<T, 3> const& yzw);
+        constexpr numarray_stack<T, 4>();
+        constexpr numarray_stack<T, 4>(T const& x, T const& y, T const& z, T const& w);
+        constexpr numarray_stack<T, 4>(numarray_stack<T, 3> const& xyz, T const& w);
+        constexpr numarray_stack<T, 4>(T const& x, numarray_stack<T, 3> const& yzw);
 
-        numarray_stack<T, 4>(T const& x, T const& y, numarray_stack<T, 2> const& yz);
-        numarray_stack<T, 4>(numarray_stack<T, 2> const& xy, T const& z, T const& w);
-        numarray_stack<T, 4>(T const& x, numarray_stack<T, 2> const& yz, T const& w);
-        numarray_stack<T, 4>(numarray_stack<T, 2> const& xy, numarray_stack<T, 2> const& zw);
+        constexpr numarray_stack<T, 4>(T const& x, T const& y, numarray_stack<T, 2> const& yz);
+        constexpr numarray_stack<T, 4>(numarray_stack<T, 2> const& xy, T const& z, T const& w);
+        constexpr numarray_stack<T, 4>(T const& x, numarray_stack<T, 2> const& yz, T const& w);
+        constexpr numarray_stack<T, 4>(numarray_stack<T, 2> const& xy, numarray_stack<T, 2> const& zw);
 
 
         /** Size of the buffer = 4 */
-        int size() const;
+        constexpr int size() const;
 
         /** Fill all data with the given value */
         numarray_stack<T, 4>& fill(T const& value);
@@ -69,34 +69,34 @@ namespace cgp
 namespace cgp
 {
 
-    template <typename T> numarray_stack<T, 4>::numarray_stack()
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack()
         :x(T()), y(T()), z(T()), w(T())
     {}
-    template <typename T> numarray_stack<T, 4>::numarray_stack(T const& x_arg, T const& y_arg, T const& z_arg, T const& w_arg)
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack(T const& x_arg, T const& y_arg, T const& z_arg, T const& w_arg)
         : x(x_arg), y(y_arg), z(z_arg), w(w_arg)
     {}
-    template <typename T> numarray_stack<T, 4>::numarray_stack(numarray_stack<T, 3> const& xyz, T const& w_arg)
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack(numarray_stack<T, 3> const& xyz, T const& w_arg)
         : x(get<0>(xyz)), y(get<1>(xyz)), z(get<2>(xyz)), w(w_arg)
     {}
-    template <typename T> numarray_stack<T, 4>::numarray_stack(T const& x_arg, numarray_stack<T, 3> const& yzw)
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack(T const& x_arg, numarray_stack<T, 3> const& yzw)
         : x(x_arg), y(get<0>(yzw)), z(get<1>(yzw)), w(get<2>(yzw))
     {}
 
-    template <typename T> numarray_stack<T, 4>::numarray_stack(T const& x_arg, T const& y_arg, numarray_stack<T, 2> const& yz)
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack(T const& x_arg, T const& y_arg, numarray_stack<T, 2> const& yz)
         : x(x_arg), y(y_arg), z(get<0>(yz)), w(get<1>(yz))
     {}
-    template <typename T> numarray_stack<T, 4>::numarray_stack(numarray_stack<T, 2> const& xy, T const& z_arg, T const& w_arg)
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack(numarray_stack<T, 2> const& xy, T const& z_arg, T const& w_arg)
         : x(get<0>(xy)), y(get<1>(xy)), z(z_arg), w(w_arg)
     {}
-    template <typename T> numarray_stack<T, 4>::numarray_stack(T const& x_arg, numarray_stack<T, 2> const& yz, T const& w_arg)
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack(T const& x_arg, numarray_stack<T, 2> const& yz, T const& w_arg)
         : x(x_arg), y(get<0>(yz)), z(get<1>(yz)), w(w_arg)
     {}
-    template <typename T> numarray_stack<T, 4>::numarray_stack(numarray_stack<T, 2> const& xy, numarray_stack<T, 2> const& zw)
+    template <typename T> constexpr numarray_stack<T, 4>::numarray_stack(numarray_stack<T, 2> const& xy, numarray_stack<T, 2> const& zw)
         : x(get<0>(xy)), y(get<1>(xy)), z(get<0>(zw)), w(get<1>(zw))
     {}
 
 
-    template <typename T> int numarray_stack<T, 4>::size() const
+    template <typename T> constexpr int numarray_stack<T, 4>::size() const
     {
         return 4;
     }
@@ -190,15 +190,29 @@ namespace cgp
     }
 
 
-    template <int idx, typename T> T const& get(numarray_stack<T, 4> const& data)
+    template <int idx, typename T> constexpr T const& get(numarray_stack<T, 4> const& data)
     {
-        static_assert(idx < 4, "Incorrect element indexing");
-        return (&data.x)[idx];
+        static_assert(idx >= 0 && idx < 4, "Incorrect element indexing");
+        if constexpr (idx == 0)
+            return data.x;
+        else if constexpr (idx == 1)
+            return data.y;
+        else if constexpr (idx == 2)
+            return data.z;
+        else
+            return data.w;
     }
-    template <int idx, typename T> T& get(numarray_stack<T, 4>& data)
+    template <int idx, typename T> constexpr T& get(numarray_stack<T, 4>& data)
     {
-        static_assert(idx < 4, "Incorrect element indexing");
-        return (&data.x)[idx];
+        static_assert(idx >= 0 && idx < 4, "Incorrect element indexing");
+        if constexpr (idx == 0)
+            return data.x;
+        else if constexpr (idx == 1)
+            return data.y;
+        else if constexpr (idx == 2)
+            return data.z;
+        else
+            return data.w;
     }
 
     template <typename T> std::string type_str(numarray_stack<T, 4> const&)
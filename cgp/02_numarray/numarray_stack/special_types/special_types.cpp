@@ -13,6 +13,8 @@ namespace cgp
     std::string type_str(uint2 const&) { return "uint2"; }
     std::string type_str(uint3 const&) { return "uint3"; }
     std::string type_str(uint4 const&) { return "uint4"; }
+    std::string type_str(long2 const&) { return "long2"; }
+    std::string type_str(long3 const&) { return "long3"; }
 
     std::string type_str(vec2 const&) { return "vec2"; }
     std::string type_str(numarray_stack3<float> const&) { return "vec3"; }
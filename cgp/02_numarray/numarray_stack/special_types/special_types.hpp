@@ -5,6 +5,8 @@
 #include "../implementation/numarray_stack3.hpp"
 #include "../implementation/numarray_stack4.hpp"
 
+#include <cstdint>
+
 
 
 namespace cgp
@@ -24,6 +26,10 @@ namespace cgp
     using uint3 = numarray_stack3<unsigned int>;
     using uint4 = numarray_stack4<unsigned int>;
 
+    // 64 bits indices (for grids with more than 2^31 elements)
+    using long2 = numarray_stack2<int64_t>;
+    using long3 = numarray_stack3<int64_t>;
+
     using vec2 = numarray_stack2<float>;
     using vec3 = numarray_stack3<float>;
     using vec4 = numarray_stack4<float>;
@@ -35,6 +41,8 @@ namespace cgp
     std::string type_str(uint2 const&);
     std::string type_str(uint3 const&);
     std::string type_str(uint4 const&);
+    std::string type_str(long2 const&);
+    std::string type_str(long3 const&);
 
     std::string type_str(vec2 const&);
     std::string type_str(numarray_stack3<float> const&);
@@ -195,6 +195,18 @@ namespace cgp_test
 			assert_cgp_no_msg(cgp::is_equal(sum(a),  8.2f+6.1f-3.6));
 		}
 
+		// compile-time evaluation of the operators
+		{
+			using namespace cgp;
+			constexpr vec3 a = { 1,2,3 };
+			constexpr vec3 b = { 4,5,6 };
+			static_assert(get<1>(a+2.0f*b) == 12.0f && get<2>(b/a) == 2.0f, "constexpr vec3 operators");
+			static_assert(dot(a, b) == 32.0f && sum(a) == 6.0f && max(b) == 6.0f && min(-b) == -6.0f, "constexpr vec3 reductions");
+
+			constexpr numarray_stack<int, 6> c = { 3,-1,4,1,-5,9 };
+			static_assert(sum(c*c) == 133 && min(c) == -5 && max(c) == 9, "constexpr numarray_stack<int,6>");
+		}
+
 		
 
 	}
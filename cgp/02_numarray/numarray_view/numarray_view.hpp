@@ -0,0 +1,252 @@
+#pragma once
+
+#include "cgp/01_base/base.hpp"
+#include "../numarray/numarray.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+/* ************************************************** */
+/*           Header                                   */
+/* ************************************************** */
+
+namespace cgp
+{
+
+/** Non-owning view on a sequence of elements stored in memory
+ *
+ * A numarray_view is a pointer, a number of elements, and a stride (distance between two consecutive elements, 1 by default).
+ * It doesn't allocate nor copy the elements: the viewed buffer must remain valid while the view is used.
+ * - numarray, std::vector, and numarray_view<T> are implicitly converted to numarray_view<T const>
+ *   (functions taking a numarray_view<T const> accept all of them without copy)
+ * - A sub-range of a larger buffer is viewed with slice(first, size) - or slice(first, size, step) for every step-th element
+ * - Buffers that are not containers (mapped files, staging buffers) are viewed with numarray_view(pointer, size, stride)
+ *
+ * Use numarray_view<T> (non-const T) to modify the viewed elements.
+ **/
+template <typename T>
+struct numarray_view
+{
+    using value_type = std::remove_const_t<T>;
+
+    /** Pointer on the first element */
+    T* data;
+    /** Number of elements in the view */
+    size_t count;
+    /** Distance (in number of elements) between two consecutive elements of the view */
+    std::ptrdiff_t stride;
+
+    // Constructors
+    numarray_view();                                              // Empty view
+    numarray_view(T* data, size_t count, std::ptrdiff_t stride = 1); // View on an existing buffer
+
+    /** Implicit conversion from containers */
+    template <typename Allocator> numarray_view(numarray<value_type, Allocator>& v);
+    template <typename Allocator> numarray_view(std::vector<value_type, Allocator>& v);
+    template <typename Allocator, typename U = T, typename = std::enable_if_t<std::is_const<U>::value>> numarray_view(numarray<value_type, Allocator> const& v);
+    template <typename Allocator, typename U = T, typename = std::enable_if_t<std::is_const<U>::value>> numarray_view(std::vector<value_type, Allocator> const& v);
+    /** Conversion from a view on non-const elements to a view on const elements */
+    template <typename U = T, typename = std::enable_if_t<std::is_const<U>::value>> numarray_view(numarray_view<value_type> const& v);
+
+    /** Number of elements in the view */
+    size_t size() const;
+    bool empty() const;
+    /** True if the elements are stored contiguously (stride==1) */
+    bool is_contiguous() const;
+
+    /** Element access
+     * Bound checking is performed unless CGP_NO_DEBUG is defined. */
+    T& operator[](size_t index) const;
+    T& operator()(size_t index) const;
+    /** Direct access to the value - doesn't check index bounds*/
+    T& at(size_t index) const { return data[std::ptrdiff_t(index) * stride]; }
+
+    /** View on the elements [first, first+size*step[ taken every step elements of this view */
+    numarray_view slice(size_t first, size_t size, size_t step = 1) const;
+
+    /** Copy of the viewed elements in a new numarray */
+    numarray<value_type> to_numarray() const;
+
+    /** Iterators (allows "forall" loops, for(auto& e : view) {...}) */
+    struct iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::remove_const_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        T* p;
+        std::ptrdiff_t stride;
+
+        T& operator*() const { return *p; }
+        T* operator->() const { return p; }
+        iterator& operator++() { p += stride; return *this; }
+        iterator operator++(int) { iterator it = *this; p += stride; return it; }
+        bool operator==(iterator const& it) const { return p == it.p; }
+        bool operator!=(iterator const& it) const { return p != it.p; }
+    };
+    iterator begin() const;
+    iterator end() const;
+    iterator cbegin() const;
+    iterator cend() const;
+};
+
+template <typename T> std::string type_str(numarray_view<T> const&);
+
+/** Display all elements of the view.*/
+template <typename T> std::ostream& operator<<(std::ostream& s, numarray_view<T> const& v);
+template <typename T> std::string str(numarray_view<T> const& v, std::string const& separator=" ", std::string const& begin="", std::string const& end="");
+
+/** Element by element equality check (views with different size are always considered as not equal) */
+template <typename T1, typename T2> bool is_equal(numarray_view<T1> const& a, numarray_view<T2> const& b);
+
+}
+
+
+
+/* ************************************************** */
+/*           IMPLEMENTATION                           */
+/* ************************************************** */
+
+namespace cgp
+{
+
+template <typename T>
+numarray_view<T>::numarray_view()
+    :data(nullptr), count(0), stride(1)
+{}
+
+template <typename T>
+numarray_view<T>::numarray_view(T* data_arg, size_t count_arg, std::ptrdiff_t stride_arg)
+    :data(data_arg), count(count_arg), stride(stride_arg)
+{}
+
+template <typename T> template <typename Allocator>
+numarray_view<T>::numarray_view(numarray<value_type, Allocator>& v)
+    :data(v.data.data()), count(v.data.size()), stride(1)
+{}
+
+template <typename T> template <typename Allocator>
+numarray_view<T>::numarray_view(std::vector<value_type, Allocator>& v)
+    :data(v.data()), count(v.size()), stride(1)
+{}
+
+template <typename T> template <typename Allocator, typename U, typename>
+numarray_view<T>::numarray_view(numarray<value_type, Allocator> const& v)
+    :data(v.data.data()), count(v.data.size()), stride(1)
+{}
+
+template <typename T> template <typename Allocator, typename U, typename>
+numarray_view<T>::numarray_view(std::vector<value_type, Allocator> const& v)
+    :data(v.data()), count(v.size()), stride(1)
+{}
+
+template <typename T> template <typename U, typename>
+numarray_view<T>::numarray_view(numarray_view<value_type> const& v)
+    :data(v.data), count(v.count), stride(v.stride)
+{}
+
+template <typename T> size_t numarray_view<T>::size() const
+{
+    return count;
+}
+
+template <typename T> bool numarray_view<T>::empty() const
+{
+    return count == 0;
+}
+
+template <typename T> bool numarray_view<T>::is_contiguous() const
+{
+    return stride == 1;
+}
+
+#ifndef CGP_NO_DEBUG
+template <typename T> void check_index_bounds(size_t index, numarray_view<T> const& v)
+{
+    if (index >= v.size())
+        error_cgp("Try to access numarray_view[" + str(index) + "] while its size is " + str(v.size()) + "\n\t  Type of numarray_view: " + type_str(v));
+}
+#else
+template <typename T> void check_index_bounds(size_t, numarray_view<T> const&) {}
+#endif
+
+template <typename T> T& numarray_view<T>::operator[](size_t index) const
+{
+    check_index_bounds(index, *this);
+    return data[std::ptrdiff_t(index) * stride];
+}
+
+template <typename T> T& numarray_view<T>::operator()(size_t index) const
+{
+    check_index_bounds(index, *this);
+    return data[std::ptrdiff_t(index) * stride];
+}
+
+template <typename T> numarray_view<T> numarray_view<T>::slice(size_t first, size_t size, size_t step) const
+{
+    assert_cgp(step > 0, "The step of a numarray_view slice must be strictly positive");
+    assert_cgp(size == 0 || first + (size - 1) * step < count, "Slice [" + str(first) + ", " + str(first + size * step) + "[ is outside of the numarray_view of size " + str(count));
+    return numarray_view<T>(data + std::ptrdiff_t(first) * stride, size, stride * std::ptrdiff_t(step));
+}
+
+template <typename T> numarray<typename numarray_view<T>::value_type> numarray_view<T>::to_numarray() const
+{
+    numarray<value_type> res;
+    res.data.resize(count);
+    for (size_t k = 0; k < count; ++k)
+        res.data[k] = at(k);
+    return res;
+}
+
+template <typename T> typename numarray_view<T>::iterator numarray_view<T>::begin() const
+{
+    return { data, stride };
+}
+
+template <typename T> typename numarray_view<T>::iterator numarray_view<T>::end() const
+{
+    return { data + std::ptrdiff_t(count) * stride, stride };
+}
+
+template <typename T> typename numarray_view<T>::iterator numarray_view<T>::cbegin() const
+{
+    return begin();
+}
+
+template <typename T> typename numarray_view<T>::iterator numarray_view<T>::cend() const
+{
+    return end();
+}
+
+template <typename T> std::string type_str(numarray_view<T> const&)
+{
+    return "numarray_view<" + type_str(std::remove_const_t<T>()) + (std::is_const<T>::value ? " const>" : ">");
+}
+
+template <typename T> std::ostream& operator<<(std::ostream& s, numarray_view<T> const& v)
+{
+    s << str(v);
+    return s;
+}
+
+template <typename T> std::string str(numarray_view<T> const& v, std::string const& separator, std::string const& begin, std::string const& end)
+{
+    return cgp::detail::str_container(v, separator, begin, end);
+}
+
+template <typename T1, typename T2> bool is_equal(numarray_view<T1> const& a, numarray_view<T2> const& b)
+{
+    size_t const N = a.size();
+    if (N != b.size())
+        return false;
+    for (size_t k = 0; k < N; ++k)
+        if (is_equal(a.at(k), b.at(k)) == false)
+            return false;
+    return true;
+}
+
+}
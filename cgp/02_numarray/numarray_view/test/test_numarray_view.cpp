@@ -0,0 +1,61 @@
+#include "cgp/02_numarray/numarray.hpp"
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+
+	// Function taking a view: accepts numarray, std::vector and views without copy
+	static float sum_view(cgp::numarray_view<float const> v)
+	{
+		float s = 0.0f;
+		for (float x : v)
+			s += x;
+		return s;
+	}
+
+	void test_numarray_view()
+	{
+		using cgp::vec3;
+
+		{
+			cgp::numarray<float> const a = { 1,2,3,4,5,6 };
+			std::vector<float> const b = { 1,2,3 };
+			assert_cgp_no_msg(cgp::is_equal(sum_view(a), 21.0f));
+			assert_cgp_no_msg(cgp::is_equal(sum_view(b), 6.0f));
+
+			cgp::numarray_view<float const> v = a;
+			assert_cgp_no_msg(v.size() == 6);
+			assert_cgp_no_msg(v.data == a.data.data());
+			assert_cgp_no_msg(cgp::is_equal(sum_view(v.slice(1, 3)), 9.0f));
+			assert_cgp_no_msg(type_str(v) == "numarray_view<float const>");
+		}
+
+		{
+			// Strided view: every second element
+			cgp::numarray<float> a = { 0,1,2,3,4,5,6 };
+			cgp::numarray_view<float> v = a;
+			cgp::numarray_view<float> even = v.slice(0, 4, 2);
+			assert_cgp_no_msg(even.is_contiguous() == false);
+			assert_cgp_no_msg(cgp::is_equal(even.to_numarray(), cgp::numarray<float>{ 0,2,4,6 }));
+			for (float& x : even)
+				x = -x;
+			assert_cgp_no_msg(cgp::is_equal(a, cgp::numarray<float>{ 0,1,-2,3,-4,5,-6 }));
+
+			cgp::numarray_view<float> odd_of_even = even.slice(1, 2, 2);
+			assert_cgp_no_msg(cgp::is_equal(odd_of_even[1], -6.0f));
+			assert_cgp_no_msg(str(even.slice(1, 2)) == str(cgp::numarray<float>{ -2,-4 }));
+		}
+
+		{
+			// View on an external buffer of vec3
+			float buffer[9] = { 1,2,3, 4,5,6, 7,8,9 };
+			cgp::numarray_view<vec3 const> v(reinterpret_cast<vec3 const*>(buffer), 3);
+			assert_cgp_no_msg(is_equal(v[2], vec3{ 7,8,9 }));
+			assert_cgp_no_msg(cgp::is_equal(v, cgp::numarray_view<vec3 const>(cgp::numarray<vec3>{ {1,2,3}, {4,5,6}, {7,8,9} })));
+		}
+	}
+
+}
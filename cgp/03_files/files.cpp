@@ -6,6 +6,17 @@
 #include <iostream>
 #include <sys/stat.h>
 
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #define CGP_FILE_MEMORY_MAP_POSIX
+#endif
+
 #if defined(__linux__) || defined(__EMSCRIPTEN__)
 #pragma GCC diagnostic ignored "-Wunused-variable"
 #endif
@@ -68,12 +79,22 @@ namespace cgp
     {
         assert_file_exist(filename);
         struct stat stat_buf;
-        int rc = stat(filename.c_str(), &stat_buf);
-        assert_cgp(rc==0, "Cannot stat file_size " + filename);
+        if (stat(filename.c_str(), &stat_buf) != 0)
+            error_cgp("Cannot stat file_size " + filename);
 
         return stat_buf.st_size;
     }
 
+    int64_t file_get_modification_time(std::string const& filename)
+    {
+        assert_file_exist(filename);
+        struct stat stat_buf;
+        if (stat(filename.c_str(), &stat_buf) != 0)
+            error_cgp("Cannot stat file_modification_time " + filename);
+
+        return int64_t(stat_buf.st_mtime);
+    }
+
     
     std::vector <char> read_from_file_binary(std::string const& filename)
     {
@@ -91,4 +112,118 @@ namespace cgp
 
         return buffer;
     }
+
+
+    file_memory_map::file_memory_map()
+        :buffer_begin(nullptr), buffer_size(0), opened(false), handle_file(nullptr), handle_mapping(nullptr), fallback_buffer()
+    {}
+
+    file_memory_map::file_memory_map(std::string const& filename)
+        :file_memory_map()
+    {
+        open(filename);
+    }
+
+    file_memory_map::file_memory_map(file_memory_map&& other) noexcept
+        :file_memory_map()
+    {
+        *this = std::move(other);
+    }
+
+    file_memory_map& file_memory_map::operator=(file_memory_map&& other) noexcept
+    {
+        if (this != &other) {
+            close();
+            buffer_begin = other.buffer_begin;
+            buffer_size = other.buffer_size;
+            opened = other.opened;
+            handle_file = other.handle_file;
+            handle_mapping = other.handle_mapping;
+            fallback_buffer = std::move(other.fallback_buffer);
+            if (!fallback_buffer.empty())
+                buffer_begin = fallback_buffer.data();
+
+            other.buffer_begin = nullptr;
+            other.buffer_size = 0;
+            other.opened = false;
+            other.handle_file = nullptr;
+            other.handle_mapping = nullptr;
+        }
+        return *this;
+    }
+
+    file_memory_map::~file_memory_map()
+    {
+        close();
+    }
+
+    void file_memory_map::open(std::string const& filename)
+    {
+        close();
+        assert_file_exist(filename);
+
+        size_t const s = file_get_size(filename);
+        if (s == 0) { // empty files cannot be mapped, but are valid empty buffers
+            opened = true;
+            return;
+        }
+
+#if defined(_WIN32)
+        HANDLE const file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            error_cgp("Cannot open file " + filename);
+        HANDLE const mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            CloseHandle(file);
+            error_cgp("Cannot create file mapping " + filename);
+        }
+        void const* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            error_cgp("Cannot map file " + filename);
+        }
+
+        handle_file = file;
+        handle_mapping = mapping;
+        buffer_begin = static_cast<char const*>(view);
+#elif defined(CGP_FILE_MEMORY_MAP_POSIX)
+        int const fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            error_cgp("Cannot open file " + filename);
+        void* view = mmap(nullptr, s, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping remains valid after closing the file descriptor
+        if (view == MAP_FAILED)
+            error_cgp("Cannot map file " + filename);
+        madvise(view, s, MADV_SEQUENTIAL);
+
+        buffer_begin = static_cast<char const*>(view);
+#else
+        fallback_buffer = read_from_file_binary(filename);
+        buffer_begin = fallback_buffer.data();
+#endif
+        // Only set once the mapping succeeded: close() never unmaps an invalid buffer
+        buffer_size = s;
+        opened = true;
+    }
+
+    void file_memory_map::close()
+    {
+        if (buffer_begin != nullptr && fallback_buffer.empty()) {
+#if defined(_WIN32)
+            UnmapViewOfFile(buffer_begin);
+            CloseHandle(static_cast<HANDLE>(handle_mapping));
+            CloseHandle(static_cast<HANDLE>(handle_file));
+#elif defined(CGP_FILE_MEMORY_MAP_POSIX)
+            munmap(const_cast<char*>(buffer_begin), buffer_size);
+#endif
+        }
+
+        buffer_begin = nullptr;
+        buffer_size = 0;
+        opened = false;
+        handle_file = nullptr;
+        handle_mapping = nullptr;
+        fallback_buffer.clear();
+    }
 }
\ No newline at end of file
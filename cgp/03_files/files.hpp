@@ -5,6 +5,7 @@
 
 #include <string>
 #include <sstream>
+#include <cstdint>
 #include <fstream>
 
 namespace cgp
@@ -22,9 +23,46 @@ namespace cgp
 	/** Return the size in octets of a file*/
 	size_t file_get_size(std::string const& filename);
 
+	/** Return the last modification time of a file (in seconds since epoch) */
+	int64_t file_get_modification_time(std::string const& filename);
+
 	/** Read the entire content of a file as binary vector of octets*/
 	std::vector <char> read_from_file_binary(std::string const& filename);
 
+	/** Read-only access to the content of a file mapped in memory
+	 * The file is mapped using mmap (Unix) or MapViewOfFile (Windows) and its content is accessed as a contiguous buffer of octets without being copied.
+	 * On systems without memory mapping (Emscripten), the file is read in an internal buffer instead.
+	 * The mapping is released when the structure is destroyed (the structure can be moved but not copied). */
+	struct file_memory_map
+	{
+		file_memory_map();
+		file_memory_map(std::string const& filename);
+		file_memory_map(file_memory_map&& other) noexcept;
+		file_memory_map& operator=(file_memory_map&& other) noexcept;
+		file_memory_map(file_memory_map const&) = delete;
+		file_memory_map& operator=(file_memory_map const&) = delete;
+		~file_memory_map();
+
+		/** Map the file in memory (release the previous mapping if any) */
+		void open(std::string const& filename);
+		/** Release the mapping */
+		void close();
+
+		/** Pointer to the first octet of the file. data() + size() is one past the last octet. */
+		char const* data() const { return buffer_begin; }
+		/** Size of the file in octets */
+		size_t size() const { return buffer_size; }
+		bool is_open() const { return opened; }
+
+	private:
+		char const* buffer_begin;
+		size_t buffer_size;
+		bool opened;
+		void* handle_file;    // Windows only
+		void* handle_mapping; // Windows only
+		std::vector<char> fallback_buffer; // used when memory mapping is not available
+	};
+
 	std::string read_text_file(std::string const& filename);
 	template <typename T> void read_from_file(std::string const& filename, T& data);
 	template <typename T> void read_from_file(std::string const& filename, numarray<numarray<T>>& data);
@@ -2,4 +2,7 @@
 
 
 #include "grid_2D/grid_2D.hpp"
-#include "grid_3D/grid_3D.hpp"
\ No newline at end of file
+#include "grid_3D/grid_3D.hpp"
+#include "grid_3D_tiled/grid_3D_tiled.hpp"
+#include "grid_3D_sparse/grid_3D_sparse.hpp"
+#include "grid_view/grid_view.hpp"
\ No newline at end of file
@@ -18,14 +18,15 @@ namespace cgp
  * The grid_2D structure provide convenient access for 2D-grid organization where an element can be queried as grid_2D(i,j).
  * The indexing is obtained as grid_2D(k1,k2) = k1 + N1*k2
  * Elements of grid_2D are stored contiguously in heap memory and remain fully compatible with std::vector and pointers.
+ * The allocator of the storage can be changed with the second template parameter (std::allocator by default).
  **/
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 struct grid_2D
 {
     /** 2D dimension (Nx,Ny) of the container */
     int2 dimension;
     /** Internal storage as a 1D buffer */
-    numarray<T> data;
+    numarray<T, Allocator> data;
 
     /** Constructors */
     grid_2D();                        // Empty buffer - no elements
@@ -33,15 +34,19 @@ struct grid_2D
     grid_2D(int2 const& size);        // Build a grid_2D with specified dimension
     grid_2D(int size_1, int size_2);  // Build a grid_2D with specified dimension
 
+    /** Evaluation of an element-wise expression (such as a+2.0f*b) in a single loop, without temporary grid */
+    template <typename E, typename = std::enable_if_t<is_numarray_expression_of_shape<E, int2>::value>> grid_2D(E const& expression);
+    template <typename E, typename = std::enable_if_t<is_numarray_expression_of_shape<E, int2>::value>> grid_2D& operator=(E const& expression);
+
     /** Direct build a grid_2D from a given 1D-buffer and its 2D-dimension
     * \note: the size of the 1D-buffer must satisfy arg.size = size_1 * size_2 */
-    static grid_2D<T> from_buffer(numarray<T> const& arg, int size_1, int size_2);
+    static grid_2D from_buffer(numarray<T, Allocator> const& arg, int size_1, int size_2);
 
 
     /** Remove all elements from the grid_2D */
     void clear();
     /** Total number of elements size = dimension[0] * dimension[1] */
-    int size() const;
+    int64_t size() const;
     /** Fill all elements of the grid_2D with the same element*/
     void fill(T const& value);
 
@@ -62,67 +67,59 @@ struct grid_2D
     T& operator()(int k1, int k2);             // grid_2D(x, y) 
 
 
-    int index_to_offset(int k1, int k2) const;
-    int2 offset_to_index(int offset) const;
+    int64_t index_to_offset(int k1, int k2) const;
+    int2 offset_to_index(int64_t offset) const;
 
     /** Iterators
      * 1D-type iterators on grid_2D are compatible with STL syntax
      * allows "forall" loops (for(auto& e : buffer) {...}) */
-    typename std::vector<T>::iterator begin();
-    typename std::vector<T>::iterator end();
-    typename std::vector<T>::const_iterator begin() const;
-    typename std::vector<T>::const_iterator end() const;
-    typename std::vector<T>::const_iterator cbegin() const;
-    typename std::vector<T>::const_iterator cend() const;
+    typename std::vector<T, Allocator>::iterator begin();
+    typename std::vector<T, Allocator>::iterator end();
+    typename std::vector<T, Allocator>::const_iterator begin() const;
+    typename std::vector<T, Allocator>::const_iterator end() const;
+    typename std::vector<T, Allocator>::const_iterator cbegin() const;
+    typename std::vector<T, Allocator>::const_iterator cend() const;
 
     /** Direct access to the value - doesn't check index bounds*/
-    inline T const& at(int index) const { return data.at(index); }
-    inline T& at(int index) { return data.at(index); }
+    inline T const& at(int64_t index) const { return data.at(index); }
+    inline T& at(int64_t index) { return data.at(index); }
 
 
 };
 
 
-template <typename T> std::string type_str(grid_2D<T> const&);
+template <typename T, typename Allocator> std::string type_str(grid_2D<T, Allocator> const&);
 
 /** Display all elements of the buffer.*/
-template <typename T> std::ostream& operator<<(std::ostream& s, grid_2D<T> const& v);
+template <typename T, typename Allocator> std::ostream& operator<<(std::ostream& s, grid_2D<T, Allocator> const& v);
 
 /** Convert all elements of the buffer to a string.
  * \param buffer: the input buffer
  * \param separator: the separator between each element
  */
-template <typename T> std::string str(grid_2D<T> const& v, std::string const& separator=" ", std::string const& begin = "", std::string const& end = "");
+template <typename T, typename Allocator> std::string str(grid_2D<T, Allocator> const& v, std::string const& separator=" ", std::string const& begin = "", std::string const& end = "");
 
 
 /** Equality test between grid_2D */
-template <typename T1, typename T2> bool is_equal(grid_2D<T1> const& a, grid_2D<T2> const& b);
+template <typename T1, typename T2, typename A1, typename A2> bool is_equal(grid_2D<T1, A1> const& a, grid_2D<T2, A2> const& b);
 
 /** Math operators
- * Common mathematical operations between buffers, and scalar or element values. */
-template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, grid_2D<T> const& b);
-
-template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, T const& b);
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, T const& b);
-template <typename T> grid_2D<T>  operator+(T const& a, grid_2D<T> const& b);
-
-template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, T const& b);
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, T const& b);
-template <typename T> grid_2D<T>  operator-(T const& a, grid_2D<T> const& b);
-
-template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, float b);
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, float b);
-template <typename T> grid_2D<T>  operator*(float a, grid_2D<T> const& b);
-
-template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, float b);
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, float b);
+ * Element-wise operations between grids (a+b, a*b, 2.0f*a, a+=b, etc.) are expressions evaluated in a single loop (see numarray_expression.hpp).
+ * The following traits describe grid_2D as an operand of these expressions. */
+template <> struct expression_shape_traits<int2> {
+    template <typename T> using container = grid_2D<T>;
+    static size_t size(int2 const& shape) { return size_t(shape.x)*size_t(shape.y); }
+    static bool is_equal(int2 const& a, int2 const& b) { return cgp::is_equal(a, b); }
+    static std::string str(int2 const& shape) { return cgp::str(shape); }
+};
+template <typename T, typename Allocator> struct expression_container_traits<grid_2D<T, Allocator>> {
+    static constexpr bool is_container = true;
+    using shape_type = int2;
+    using value_type = T;
+    static int2 const& shape(grid_2D<T, Allocator> const& g) { return g.dimension; }
+    static T const* element(grid_2D<T, Allocator> const& g) { return g.data.data.data(); }
+    static T* element(grid_2D<T, Allocator>& g) { return g.data.data.data(); }
+};
 
 
 
@@ -139,79 +136,97 @@ namespace cgp
 
 
 
-template <typename T>
-grid_2D<T>::grid_2D()
+template <typename T, typename Allocator>
+grid_2D<T, Allocator>::grid_2D()
     :dimension(int2{0,0}),data()
 {}
 
-template <typename T>
-grid_2D<T>::grid_2D(int size)
-    :dimension({size,size}),data(size*size)
+template <typename T, typename Allocator>
+grid_2D<T, Allocator>::grid_2D(int size)
+    :dimension({size,size}),data(int64_t(size)*size)
 {
     assert_cgp_no_msg(size>0);
 }
 
-template <typename T>
-grid_2D<T>::grid_2D(int2 const& size)
-    :dimension(size),data(size[0]*size[1])
+template <typename T, typename Allocator>
+grid_2D<T, Allocator>::grid_2D(int2 const& size)
+    :dimension(size),data(int64_t(size[0])*size[1])
 {
     assert_cgp_no_msg(size[0]>=0 && size[1]>=0);
 }
 
-template <typename T>
-grid_2D<T>::grid_2D(int size_1, int size_2)
-    :dimension({size_1,size_2}),data(size_1*size_2)
+template <typename T, typename Allocator>
+grid_2D<T, Allocator>::grid_2D(int size_1, int size_2)
+    :dimension({size_1,size_2}),data(int64_t(size_1)*size_2)
 {
     assert_cgp_no_msg(size_1>=0 && size_2>=0);
 }
 
+template <typename T, typename Allocator>
+template <typename E, typename>
+grid_2D<T, Allocator>::grid_2D(E const& expression)
+    :dimension(expression.shape()),data()
+{
+    evaluate_in(data.data, expression);
+}
 
+template <typename T, typename Allocator>
+template <typename E, typename>
+grid_2D<T, Allocator>& grid_2D<T, Allocator>::operator=(E const& expression)
+{
+    int2 const new_dimension = expression.shape(); // the expression may refer to this grid
+    evaluate_in(data.data, expression);
+    dimension = new_dimension;
+    return *this;
+}
 
-template <typename T>
-int grid_2D<T>::size() const
+
+
+template <typename T, typename Allocator>
+int64_t grid_2D<T, Allocator>::size() const
 {
-    return dimension[0]*dimension[1];
+    return int64_t(dimension[0])*dimension[1];
 }
 
-template <typename T>
-void grid_2D<T>::clear()
+template <typename T, typename Allocator>
+void grid_2D<T, Allocator>::clear()
 {
     resize(0, 0);
 }
 
-template <typename T>
-void grid_2D<T>::resize(int size)
+template <typename T, typename Allocator>
+void grid_2D<T, Allocator>::resize(int size)
 {
     assert_cgp_no_msg(size>=0);
     resize(size,size);
 }
 
-template <typename T>
-void grid_2D<T>::resize(int2 const& size)
+template <typename T, typename Allocator>
+void grid_2D<T, Allocator>::resize(int2 const& size)
 {
     assert_cgp_no_msg(size[0]>=0 && size[1]>=0);
     dimension = size;
-    data.resize(size[0]*size[1]);
+    data.resize(int64_t(size[0])*size[1]);
 }
 
-template <typename T>
-void grid_2D<T>::resize(int size_1, int size_2)
+template <typename T, typename Allocator>
+void grid_2D<T, Allocator>::resize(int size_1, int size_2)
 {
     assert_cgp_no_msg(size_1>=0 && size_2>=0);
     dimension = {size_1,size_2};
     resize({size_1,size_2});
 }
 
-template <typename T>
-void grid_2D<T>::fill(T const& value)
+template <typename T, typename Allocator>
+void grid_2D<T, Allocator>::fill(T const& value)
 {
     data.fill(value);
 }
 
 
 #ifndef CGP_NO_DEBUG
-template <typename T>
-void check_index_bounds(int index1, int index2, grid_2D<T> const& data)
+template <typename T, typename Allocator>
+void check_index_bounds(int index1, int index2, grid_2D<T, Allocator> const& data)
 {
     size_t const N1 = data.dimension.x;
     size_t const N2 = data.dimension.y;
@@ -249,56 +264,56 @@ void check_index_bounds(int index1, int index2, grid_2D<T> const& data)
     }
 }
 #else
-template <typename T>
-void check_index_bounds(int , int , grid_2D<T> const& ) {}
+template <typename T, typename Allocator>
+void check_index_bounds(int , int , grid_2D<T, Allocator> const& ) {}
 #endif
 
 
 
-template <typename T>
-T const& grid_2D<T>::operator[](int2 const& index) const
+template <typename T, typename Allocator>
+T const& grid_2D<T, Allocator>::operator[](int2 const& index) const
 {
     check_index_bounds(index.x, index.y, *this);
-    int const idx = offset_grid(index.x, index.y, dimension.x);
+    int64_t const idx = offset_grid(index.x, index.y, dimension.x);
     return data[idx];
 }
 
-template <typename T>
-T& grid_2D<T>::operator[](int2 const& index)
+template <typename T, typename Allocator>
+T& grid_2D<T, Allocator>::operator[](int2 const& index)
 {
     check_index_bounds(index.x, index.y, *this);
-    int const idx = offset_grid(index.x, index.y, dimension.x);
+    int64_t const idx = offset_grid(index.x, index.y, dimension.x);
 
     return data[idx];
 }
 
-template <typename T>
-T const& grid_2D<T>::operator()(int2 const& index) const
+template <typename T, typename Allocator>
+T const& grid_2D<T, Allocator>::operator()(int2 const& index) const
 {
     return (*this)[index];
 }
 
-template <typename T>
-T& grid_2D<T>::operator()(int2 const& index)
+template <typename T, typename Allocator>
+T& grid_2D<T, Allocator>::operator()(int2 const& index)
 {
     return (*this)[index];
 }
 
 
-template <typename T>
-T const& grid_2D<T>::operator()(int k1, int k2) const
+template <typename T, typename Allocator>
+T const& grid_2D<T, Allocator>::operator()(int k1, int k2) const
 {
     check_index_bounds(k1, k2, *this);
-    int const idx = offset_grid(k1, k2, dimension.x);
+    int64_t const idx = offset_grid(k1, k2, dimension.x);
 
     return data[idx];
 }
 
-template <typename T>
-T& grid_2D<T>::operator()(int k1, int k2)
+template <typename T, typename Allocator>
+T& grid_2D<T, Allocator>::operator()(int k1, int k2)
 {
     check_index_bounds(k1, k2, *this);
-    int const idx = offset_grid(k1, k2, dimension.x);
+    int64_t const idx = offset_grid(k1, k2, dimension.x);
 
     return data[idx];
 }
@@ -306,38 +321,38 @@ T& grid_2D<T>::operator()(int k1, int k2)
 
 
 
-template <typename T>
-typename std::vector<T>::iterator grid_2D<T>::begin()
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator grid_2D<T, Allocator>::begin()
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::iterator grid_2D<T>::end()
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator grid_2D<T, Allocator>::end()
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_2D<T>::begin() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator grid_2D<T, Allocator>::begin() const
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_2D<T>::end() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator grid_2D<T, Allocator>::end() const
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_2D<T>::cbegin() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator grid_2D<T, Allocator>::cbegin() const
 {
     return data.cbegin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_2D<T>::cend() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator grid_2D<T, Allocator>::cend() const
 {
     return data.cend();
 }
@@ -351,13 +366,13 @@ typename std::vector<T>::const_iterator grid_2D<T>::cend() const
 
 
 
-template <typename T> std::string type_str(grid_2D<T> const&)
+template <typename T, typename Allocator> std::string type_str(grid_2D<T, Allocator> const&)
 {
     return "grid_2D<" + type_str(T()) + ">";
 }
 
 
-template <typename T1, typename T2> bool is_equal(grid_2D<T1> const& a, grid_2D<T2> const& b)
+template <typename T1, typename T2, typename A1, typename A2> bool is_equal(grid_2D<T1, A1> const& a, grid_2D<T2, A2> const& b)
 {
     if (is_equal(a.dimension, b.dimension)==false)
         return false;
@@ -367,151 +382,36 @@ template <typename T1, typename T2> bool is_equal(grid_2D<T1> const& a, grid_2D<
 
 
 
-template <typename T> std::ostream& operator<<(std::ostream& s, grid_2D<T> const& v)
+template <typename T, typename Allocator> std::ostream& operator<<(std::ostream& s, grid_2D<T, Allocator> const& v)
 {
     return s << v.data;
 }
-template <typename T> std::string str(grid_2D<T> const& v, std::string const& separator, std::string const& begin, std::string const& end)
+template <typename T, typename Allocator> std::string str(grid_2D<T, Allocator> const& v, std::string const& separator, std::string const& begin, std::string const& end)
 {
     return to_string(v.data, separator, begin, end);
 }
 
 
-template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, grid_2D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    a.data += b.data;
-}
-template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, T const& b)
-{
-    a.data += b;
-    return a;
-}
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, grid_2D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
-    res.data = a.data+b.data;
-    return res;
-
-}
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, T const& b)
-{
-    grid_2D<T> res(a.dimension);
-    res.data = a.data+b;
-    return res;
-}
-template <typename T> grid_2D<T>  operator+(T const& a, grid_2D<T> const& b)
-{
-    grid_2D<T> res(b.dimension);
-    res.data = a + b.data;
-    return res;
-}
-
-template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, grid_2D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    a.data -= b.data;
-}
-template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, T const& b)
-{
-    a.data -= b;
-    return a;
-}
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, grid_2D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
-    res.data = a.data-b.data;
-    return res;
-}
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, T const& b)
-{
-    grid_2D<T> res(a.dimension);
-    res.data = a.data-b;
-    return res;
-}
-template <typename T> grid_2D<T>  operator-(T const& a, grid_2D<T> const& b)
-{
-    grid_2D<T> res(a.dimension);
-    res.data = a-b.data;
-    return res;
-}
-
-template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, grid_2D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    a.data *= b.data;
-}
-template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, float b)
-{
-    a.data *= b;
-    return a;
-}
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, grid_2D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
-    res.data = a.data*b.data;
-    return res;
-}
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, float b)
-{
-    grid_2D<T> res(a.dimension);
-    res.data = a.data*b;
-    return res;
-}
-template <typename T> grid_2D<T>  operator*(float a, grid_2D<T> const& b)
-{
-    grid_2D<T> res(b.dimension);
-    res.data = a*b.data;
-    return res;
-}
-
-template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, grid_2D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    a.data /= b.data;
-    return a;
-}
-template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, float b)
-{
-    a.data /= b;
-    return a;
-}
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, grid_2D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
-    res.data = a.data/b.data;
-    return res;
-}
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, float b)
-{
-    grid_2D<T> res(a.dimension);
-    res.data = a.data/b;
-    return res;
-}
 
 
-template <typename T>
-grid_2D<T> grid_2D<T>::from_buffer(numarray<T> const& arg, int size_1, int size_2)
+template <typename T, typename Allocator>
+grid_2D<T, Allocator> grid_2D<T, Allocator>::from_buffer(numarray<T, Allocator> const& arg, int size_1, int size_2)
 {
-    assert_cgp(arg.size()==size_1*size_2, "Incoherent size to generate grid_2D");
+    assert_cgp(arg.size()==int64_t(size_1)*size_2, "Incoherent size to generate grid_2D");
 
-    grid_2D<T> b(size_1, size_2);
+    grid_2D<T, Allocator> b(size_1, size_2);
     b.data = arg;
 
     return b;
 }
 
-template <typename T>
-int grid_2D<T>::index_to_offset(int k1, int k2) const
+template <typename T, typename Allocator>
+int64_t grid_2D<T, Allocator>::index_to_offset(int k1, int k2) const
 {
     return offset_grid(k1,k2,dimension.x);
 }
-template <typename T>
-int2 grid_2D<T>::offset_to_index(int offset) const
+template <typename T, typename Allocator>
+int2 grid_2D<T, Allocator>::offset_to_index(int64_t offset) const
 {
     int2 idx = index_grid_from_offset(offset,dimension.x);
     return {idx.x, idx.y};
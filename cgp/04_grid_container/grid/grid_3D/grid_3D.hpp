@@ -16,14 +16,16 @@ namespace cgp
 *
 * The grid_3D structure provide convenient access for 3D-grid organization where an element can be queried as grid_3D(i,j).
 * Elements of grid_3D are stored contiguously in heap memory and remain fully compatible with std::vector and pointers.
+* The allocator of the storage can be changed with the second template parameter (std::allocator by default).
+* The dimension along each axis is an int, while the size and offsets are 64 bits integers (grids such as 1400x1400x1400 are supported).
 **/
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 struct grid_3D
 {
     /** 3D dimension (Nx,Ny,Nz) of the container */
     int3 dimension;
     /** Internal storage as a 1D buffer */
-    numarray<T> data;
+    numarray<T, Allocator> data;
 
     /** Constructors */
     grid_3D();                 // Emtpy grid
@@ -31,14 +33,18 @@ struct grid_3D
     grid_3D(int3 const& size); // Generate a grid of dimension size.x size.y size.z
     grid_3D(int size_1, int size_2, int size_3); // Generate a grid of dimension size_1 x size_2 x size_3
 
+    /** Evaluation of an element-wise expression (such as a+2.0f*b) in a single loop, without temporary grid */
+    template <typename E, typename = std::enable_if_t<is_numarray_expression_of_shape<E, int3>::value>> grid_3D(E const& expression);
+    template <typename E, typename = std::enable_if_t<is_numarray_expression_of_shape<E, int3>::value>> grid_3D& operator=(E const& expression);
+
     /** Direct build a grid_3D from a given 1D-buffer and its 3D-dimension
     * \note: the size of the 3D-buffer must satisfy arg.size = size_1 * size_2 * size_3 */
-    static grid_3D<T> from_array(numarray<T> const& arg, int size_1, int size_2, int size_3);
+    static grid_3D from_array(numarray<T, Allocator> const& arg, int size_1, int size_2, int size_3);
 
     /** Remove all elements from the grid_2D */
     void clear();
     /** Total number of elements size = dimension[0] * dimension[1] * dimension[2] */
-    int size() const;
+    int64_t size() const;
     /** Fill all elements of the grid_3D with the same element*/
     void fill(T const& value);
 
@@ -57,53 +63,47 @@ struct grid_3D
     T const& operator()(int k1, int k2, int k3) const;
     T& operator()(int k1, int k2, int k3);
 
-    int index_to_offset(int k1, int k2, int k3) const;
-    int index_to_offset(int3 const& index) const;
-    int3 offset_to_index(int offset) const;
+    int64_t index_to_offset(int k1, int k2, int k3) const;
+    int64_t index_to_offset(int3 const& index) const;
+    int3 offset_to_index(int64_t offset) const;
 
-    typename std::vector<T>::iterator begin();
-    typename std::vector<T>::iterator end();
-    typename std::vector<T>::const_iterator begin() const;
-    typename std::vector<T>::const_iterator end() const;
-    typename std::vector<T>::const_iterator cbegin() const;
-    typename std::vector<T>::const_iterator cend() const;
+    typename std::vector<T, Allocator>::iterator begin();
+    typename std::vector<T, Allocator>::iterator end();
+    typename std::vector<T, Allocator>::const_iterator begin() const;
+    typename std::vector<T, Allocator>::const_iterator end() const;
+    typename std::vector<T, Allocator>::const_iterator cbegin() const;
+    typename std::vector<T, Allocator>::const_iterator cend() const;
 
-    T const& at_unsafe(int index) const;
-    T & at_unsafe(int index);           
+    T const& at_unsafe(int64_t index) const;
+    T & at_unsafe(int64_t index);           
     T const& at_unsafe(int index1, int index2, int index3) const;
     T & at_unsafe(int index1, int index2, int index3);
 
 };
 
-template <typename T> std::string type_str(grid_3D<T> const&);
-template <typename T1, typename T2> bool is_equal(grid_3D<T1> const& a, grid_3D<T2> const& b);
-
-template <typename T> std::ostream& operator<<(std::ostream& s, grid_3D<T> const& v);
-template <typename T> std::string str(grid_3D<T> const& v, std::string const& separator=" ", std::string const& begin="", std::string const& end="");
-
-template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, T const& b);
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, T const& b);
-template <typename T> grid_3D<T>  operator+(T const& a, grid_3D<T> const& b);
-
-template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, T const& b);
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, T const& b);
-template <typename T> grid_3D<T>  operator-(T const& a, grid_3D<T> const& b);
+template <typename T, typename Allocator> std::string type_str(grid_3D<T, Allocator> const&);
+template <typename T1, typename T2, typename A1, typename A2> bool is_equal(grid_3D<T1, A1> const& a, grid_3D<T2, A2> const& b);
 
-template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, float b);
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, float b);
-template <typename T> grid_3D<T>  operator*(float a, grid_3D<T> const& b);
+template <typename T, typename Allocator> std::ostream& operator<<(std::ostream& s, grid_3D<T, Allocator> const& v);
+template <typename T, typename Allocator> std::string str(grid_3D<T, Allocator> const& v, std::string const& separator=" ", std::string const& begin="", std::string const& end="");
 
-template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, float b);
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, float b);
-template <typename T> grid_3D<T>  operator/(float a, grid_3D<T> const& b);
+/** Math operators
+ * Element-wise operations between grids (a+b, a*b, 2.0f*a, a+=b, etc.) are expressions evaluated in a single loop (see numarray_expression.hpp).
+ * The following traits describe grid_3D as an operand of these expressions. */
+template <> struct expression_shape_traits<int3> {
+    template <typename T> using container = grid_3D<T>;
+    static size_t size(int3 const& shape) { return size_t(shape.x)*size_t(shape.y)*size_t(shape.z); }
+    static bool is_equal(int3 const& a, int3 const& b) { return cgp::is_equal(a, b); }
+    static std::string str(int3 const& shape) { return cgp::str(shape); }
+};
+template <typename T, typename Allocator> struct expression_container_traits<grid_3D<T, Allocator>> {
+    static constexpr bool is_container = true;
+    using shape_type = int3;
+    using value_type = T;
+    static int3 const& shape(grid_3D<T, Allocator> const& g) { return g.dimension; }
+    static T const* element(grid_3D<T, Allocator> const& g) { return g.data.data.data(); }
+    static T* element(grid_3D<T, Allocator>& g) { return g.data.data.data(); }
+};
 
 }
 
@@ -117,88 +117,106 @@ namespace cgp
 {
 
 
-template <typename T>
-grid_3D<T>::grid_3D()
+template <typename T, typename Allocator>
+grid_3D<T, Allocator>::grid_3D()
     :dimension(int3{0,0,0}),data()
 {}
 
-template <typename T>
-grid_3D<T>::grid_3D(int size)
-    :dimension({size,size,size}),data(size*size*size)
+template <typename T, typename Allocator>
+grid_3D<T, Allocator>::grid_3D(int size)
+    :dimension({size,size,size}),data(int64_t(size)*size*size)
 {
     assert_cgp_no_msg(size>=0);
 }
 
-template <typename T>
-grid_3D<T>::grid_3D(int3 const& size)
-    :dimension(size),data(size[0]*size[1]*size[2])
+template <typename T, typename Allocator>
+grid_3D<T, Allocator>::grid_3D(int3 const& size)
+    :dimension(size),data(int64_t(size[0])*size[1]*size[2])
 {
     assert_cgp_no_msg(size[0]>=0 && size[1]>=0 && size[2]>=0);
 }
 
-template <typename T>
-grid_3D<T>::grid_3D(int size_1, int size_2, int size_3)
-    :dimension({size_1,size_2, size_3}),data(size_1*size_2*size_3)
+template <typename T, typename Allocator>
+grid_3D<T, Allocator>::grid_3D(int size_1, int size_2, int size_3)
+    :dimension({size_1,size_2, size_3}),data(int64_t(size_1)*size_2*size_3)
 {
     assert_cgp_no_msg(size_1>=0 && size_2>=0 && size_3>=0);
 }
 
-template <typename T>
-int grid_3D<T>::size() const
+template <typename T, typename Allocator>
+template <typename E, typename>
+grid_3D<T, Allocator>::grid_3D(E const& expression)
+    :dimension(expression.shape()),data()
+{
+    evaluate_in(data.data, expression);
+}
+
+template <typename T, typename Allocator>
+template <typename E, typename>
+grid_3D<T, Allocator>& grid_3D<T, Allocator>::operator=(E const& expression)
 {
-    return dimension[0]*dimension[1]*dimension[2];
+    int3 const new_dimension = expression.shape(); // the expression may refer to this grid
+    evaluate_in(data.data, expression);
+    dimension = new_dimension;
+    return *this;
 }
 
-template <typename T>
-void grid_3D<T>::resize(int size)
+template <typename T, typename Allocator>
+int64_t grid_3D<T, Allocator>::size() const
+{
+    return int64_t(dimension[0])*dimension[1]*dimension[2];
+}
+
+template <typename T, typename Allocator>
+void grid_3D<T, Allocator>::resize(int size)
 {
     assert_cgp_no_msg(size>=0);
     resize(size,size,size);
 }
 
-template <typename T>
-void grid_3D<T>::resize(int3 const& size)
+template <typename T, typename Allocator>
+void grid_3D<T, Allocator>::resize(int3 const& size)
 {
     assert_cgp_no_msg(size[0]>=0 && size[1]>=0 && size[2]>=0);
     dimension = size;
-    data.resize(size[0]*size[1]*size[2]);
+    data.resize(int64_t(size[0])*size[1]*size[2]);
 }
 
-template <typename T>
-void grid_3D<T>::resize(int size_1, int size_2, int size_3)
+template <typename T, typename Allocator>
+void grid_3D<T, Allocator>::resize(int size_1, int size_2, int size_3)
 {
     assert_cgp_no_msg(size_1>=0 && size_2>=0 && size_3>=0);
     dimension = {size_1, size_2, size_3};
     resize({size_1, size_2, size_3});
 }
 
-template <typename T>
-void grid_3D<T>::fill(T const& value)
+template <typename T, typename Allocator>
+void grid_3D<T, Allocator>::fill(T const& value)
 {
     data.fill(value);
 }
 
 
-template <typename T>
-grid_3D<T> grid_3D<T>::from_array(numarray<T> const& arg, int size_1, int size_2, int size_3)
+template <typename T, typename Allocator>
+grid_3D<T, Allocator> grid_3D<T, Allocator>::from_array(numarray<T, Allocator> const& arg, int size_1, int size_2, int size_3)
 {
-    assert_cgp(arg.size()==size_1*size_2*size_3, "Incoherent size to generate grid_2D");
+    assert_cgp(arg.size()==int64_t(size_1)*size_2*size_3, "Incoherent size to generate grid_3D");
 
-    grid_3D<T> b(size_1, size_2, size_3);
+    grid_3D<T, Allocator> b(size_1, size_2, size_3);
     b.data = arg;
 
     return b;
 }
 
-template <typename T>
-void grid_3D<T>::clear()
+template <typename T, typename Allocator>
+void grid_3D<T, Allocator>::clear()
 {
     data.clear();
 }
 
 
-template <typename T>
-static void check_index_bounds(int index1, int index2, int index3, grid_3D<T> const& data)
+template <typename T, typename Allocator>
+static void check_index_bounds(int index1, int index2, int index3, grid_3D<T, Allocator> const& data)
 {
 #ifndef cgp_NO_DEBUG
     int const N1 = data.dimension.x;
@@ -240,93 +258,93 @@ static void check_index_bounds(int index1, int index2, int index3, grid_3D<T> co
 }
 
 
-template <typename T> T const& grid_3D<T>::operator[](int3 const& index) const
+template <typename T, typename Allocator> T const& grid_3D<T, Allocator>::operator[](int3 const& index) const
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    int const  idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
+    int64_t const idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
     return data[idx];
 }
-template <typename T> T& grid_3D<T>::operator[](int3 const& index)
+template <typename T, typename Allocator> T& grid_3D<T, Allocator>::operator[](int3 const& index)
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    int const  idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
+    int64_t const idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
     return data[idx];
 }
-template <typename T> T const& grid_3D<T>::operator()(int3 const& index) const
+template <typename T, typename Allocator> T const& grid_3D<T, Allocator>::operator()(int3 const& index) const
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    int const  idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
+    int64_t const idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
     return data[idx];
 }
-template <typename T> T& grid_3D<T>::operator()(int3 const& index)
+template <typename T, typename Allocator> T& grid_3D<T, Allocator>::operator()(int3 const& index)
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    int const  idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
+    int64_t const idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
     return data[idx];
 }
-template <typename T> T const& grid_3D<T>::operator()(int k1, int k2, int k3) const
+template <typename T, typename Allocator> T const& grid_3D<T, Allocator>::operator()(int k1, int k2, int k3) const
 {
     check_index_bounds(k1, k2, k3, *this);
-    int const  idx = offset_grid(k1, k2, k3, dimension.x, dimension.y);
+    int64_t const idx = offset_grid(k1, k2, k3, dimension.x, dimension.y);
     return data[idx];
 }
-template <typename T> T& grid_3D<T>::operator()(int k1, int k2, int k3)
+template <typename T, typename Allocator> T& grid_3D<T, Allocator>::operator()(int k1, int k2, int k3)
 {
     check_index_bounds(k1, k2, k3, *this);
-    int const  idx = offset_grid(k1, k2, k3, dimension.x, dimension.y);
+    int64_t const idx = offset_grid(k1, k2, k3, dimension.x, dimension.y);
     return data[idx];
 }
 
 
 
-template <typename T>
-typename std::vector<T>::iterator grid_3D<T>::begin()
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator grid_3D<T, Allocator>::begin()
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::iterator grid_3D<T>::end()
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator grid_3D<T, Allocator>::end()
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_3D<T>::begin() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator grid_3D<T, Allocator>::begin() const
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_3D<T>::end() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator grid_3D<T, Allocator>::end() const
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_3D<T>::cbegin() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator grid_3D<T, Allocator>::cbegin() const
 {
     return data.cbegin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_3D<T>::cend() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator grid_3D<T, Allocator>::cend() const
 {
     return data.cend();
 }
 
-template <typename T>
-int grid_3D<T>::index_to_offset(int k1, int k2, int k3) const
+template <typename T, typename Allocator>
+int64_t grid_3D<T, Allocator>::index_to_offset(int k1, int k2, int k3) const
 {
     return offset_grid(k1, k2, k3, dimension.x, dimension.y);
 }
-template <typename T>
-int grid_3D<T>::index_to_offset(int3 const& index) const
+template <typename T, typename Allocator>
+int64_t grid_3D<T, Allocator>::index_to_offset(int3 const& index) const
 {
     return offset_grid(index, dimension.x, dimension.y);
 }
-template <typename T>
-int3 grid_3D<T>::offset_to_index(int offset) const
+template <typename T, typename Allocator>
+int3 grid_3D<T, Allocator>::offset_to_index(int64_t offset) const
 {
     return index_grid_from_offset(offset, dimension.x, dimension.y);
 }
@@ -338,12 +356,12 @@ int3 grid_3D<T>::offset_to_index(int offset) const
 
 
 
-template <typename T> std::string type_str(grid_3D<T> const&)
+template <typename T, typename Allocator> std::string type_str(grid_3D<T, Allocator> const&)
 {
     return "grid_3D<" + type_str(T()) + ">";
 }
 
-template <typename T1, typename T2> bool is_equal(grid_3D<T1> const& a, grid_3D<T2> const& b)
+template <typename T1, typename T2, typename A1, typename A2> bool is_equal(grid_3D<T1, A1> const& a, grid_3D<T2, A2> const& b)
 {
     if (is_equal(a.dimension, b.dimension) == false)
         return false;
@@ -351,165 +369,42 @@ template <typename T1, typename T2> bool is_equal(grid_3D<T1> const& a, grid_3D<
 }
 
 
-template <typename T> std::ostream& operator<<(std::ostream& s, grid_3D<T> const& v)
+template <typename T, typename Allocator> std::ostream& operator<<(std::ostream& s, grid_3D<T, Allocator> const& v)
 {
     return s << v.data;
 }
-template <typename T> std::string str(grid_3D<T> const& v, std::string const& separator, std::string const& begin, std::string const& end)
+template <typename T, typename Allocator> std::string str(grid_3D<T, Allocator> const& v, std::string const& separator, std::string const& begin, std::string const& end)
 {
     return str(v.data, separator, begin, end);
 }
 
 
-template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, grid_3D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    a.data += b.data;
-}
-template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, T const& b)
-{
-    a.data += b;
-    return a;
-}
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, grid_3D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
-    res.data = a.data+b.data;
-    return res;
-
-}
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, T const& b)
-{
-    grid_3D<T> res(a.dimension);
-    res.data = a.data+b;
-    return res;
-}
-template <typename T> grid_3D<T>  operator+(T const& a, grid_3D<T> const& b)
-{
-    grid_3D<T> res(b.dimension);
-    res.data = a + b.data;
-    return res;
-}
-
-template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, grid_3D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    a.data -= b.data;
-    return a;
-}
-template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, T const& b)
-{
-    a.data -= b;
-    return a;
-}
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, grid_3D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
-    res.data = a.data-b.data;
-    return res;
-}
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, T const& b)
-{
-    grid_3D<T> res(a.dimension);
-    res.data = a.data-b;
-    return res;
-}
-template <typename T> grid_3D<T>  operator-(T const& a, grid_3D<T> const& b)
-{
-    grid_3D<T> res(a.dimension);
-    res.data = a-b.data;
-    return res;
-}
-
-template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, grid_3D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    a.data *= b.data;
-    return a;
-}
-template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, float b)
-{
-    a.data *= b;
-    return a;
-}
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, grid_3D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
-    res.data = a.data*b.data;
-    return res;
-}
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, float b)
-{
-    grid_3D<T> res(a.dimension);
-    res.data = a.data*b;
-    return res;
-}
-template <typename T> grid_3D<T>  operator*(float a, grid_3D<T> const& b)
-{
-    grid_3D<T> res(b.dimension);
-    res.data = a*b.data;
-    return res;
-}
-
-template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, grid_3D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    a.data /= b.data;
-    return a;
-}
-template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, float b)
-{
-    a.data /= b;
-    return a;
-}
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, grid_3D<T> const& b)
-{
-    assert_cgp( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
-    res.data = a.data/b.data;
-    return res;
-}
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, float b)
-{
-    grid_3D<T> res(a.dimension);
-    res.data = a.data/b;
-    return res;
-}
-template <typename T> grid_3D<T>  operator/(float a, grid_3D<T> const& b)
-{
-    grid_3D<T> res(b.dimension);
-    res.data = a/b.data;
-    return res;
-}
 
 
 
 
 
-template <typename T>
-T const& grid_3D<T>::at_unsafe(int index) const
+template <typename T, typename Allocator>
+T const& grid_3D<T, Allocator>::at_unsafe(int64_t index) const
 {
     return data.at_unsafe(index);
 }
 
 
-template <typename T>
-T & grid_3D<T>::at_unsafe(int index)
+template <typename T, typename Allocator>
+T & grid_3D<T, Allocator>::at_unsafe(int64_t index)
 {
     return data.at_unsafe(index);
 }
 
-template <typename T>
-T const& grid_3D<T>::at_unsafe(int index1, int index2, int index3) const
+template <typename T, typename Allocator>
+T const& grid_3D<T, Allocator>::at_unsafe(int index1, int index2, int index3) const
 {
     return data.at_unsafe(offset_grid(index1, index2, index3, dimension.x, dimension.y));
 }
 
-template <typename T>
-T & grid_3D<T>::at_unsafe(int index1, int index2, int index3)
+template <typename T, typename Allocator>
+T & grid_3D<T, Allocator>::at_unsafe(int index1, int index2, int index3)
 {
     return data.at_unsafe(offset_grid(index1, index2, index3, dimension.x, dimension.y));
 }
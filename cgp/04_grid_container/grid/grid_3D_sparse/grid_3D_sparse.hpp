@@ -0,0 +1,341 @@
+#pragma once
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/02_numarray/numarray.hpp"
+#include "../grid_3D/grid_3D.hpp"
+#include "../grid_3D_tiled/grid_3D_tiled.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+/* ************************************************** */
+/*           Header                                   */
+/* ************************************************** */
+
+namespace cgp
+{
+
+/** Sparse container for 3D-grid data: only the bricks storing values different from a background value are allocated
+*
+* The grid of dimension (Nx,Ny,Nz) is split in bricks of BrickSize^3 elements (8x8x8 by default, BrickSize must be a power of 2).
+* The active bricks are stored one after the other in data (in their order of activation), and found from their coordinates with a hash table.
+* All the elements outside of the active bricks have the background value.
+* Used for large domains where only a small part of the voxels are relevant (ex. the narrow band of a signed distance field).
+*
+* - Reading: grid(i,j,k) returns the value of the element, or the background if its brick is inactive.
+*     The last brick found is cached, so that consecutive accesses in the same brick don't query the hash table.
+*     The cache is modified by the const access: a grid must not be read concurrently by several threads.
+* - Writing: grid.activate(i,j,k) allocates the brick if needed (filled with the background) and returns a reference on the element.
+*     The references are invalidated when a new brick is activated.
+* - Iteration: for_each_active visits the elements of the active bricks only.
+**/
+template <typename T, int BrickSize = 8>
+struct grid_3D_sparse
+{
+    static_assert(BrickSize > 0 && (BrickSize & (BrickSize - 1)) == 0, "The brick size of grid_3D_sparse must be a power of 2");
+
+    /** Number of elements along each axis of a brick, and total number of elements of a brick */
+    static constexpr int brick_size = BrickSize;
+    static constexpr int brick_volume = BrickSize * BrickSize * BrickSize;
+    /** brick_size = 2^brick_shift */
+    static constexpr int brick_shift = detail::log2_power_of_two(BrickSize);
+
+    /** 3D dimension (Nx,Ny,Nz) of the grid */
+    int3 dimension;
+    /** Number of bricks along each axis */
+    int3 brick_dimension;
+    /** Value of all the elements outside of the active bricks */
+    T background;
+    /** Values of the active bricks (brick after brick, x-fastest inside a brick) */
+    numarray<T> data;
+    /** Coordinates (bx,by,bz) of each active brick */
+    numarray<int3> brick_coordinates;
+
+    /** Constructors */
+    grid_3D_sparse();
+    grid_3D_sparse(int3 const& size, T const& background = T());
+    grid_3D_sparse(int size_1, int size_2, int size_3, T const& background = T());
+    /** Conversion from (and to) a dense grid. Only the bricks having at least one element different from the background are activated. */
+    template <typename Allocator> grid_3D_sparse(grid_3D<T, Allocator> const& grid, T const& background);
+    grid_3D<T> to_grid() const;
+
+    /** Remove all the bricks (all the elements take the background value) */
+    void clear();
+    /** Total number of elements size = dimension[0] * dimension[1] * dimension[2] (including the background) */
+    int64_t size() const;
+    /** Number of active bricks */
+    int number_of_bricks() const;
+    /** Resizing the grid (remove all the bricks) */
+    void resize(int3 const& size);
+    void resize(int size_1, int size_2, int size_3);
+
+    /** Read access: value of the element, or background if its brick is inactive
+     * Bound checking is performed unless CGP_NO_DEBUG is defined. */
+    T const& operator[](int3 const& index) const;
+    T const& operator()(int3 const& index) const;
+    T const& operator()(int k1, int k2, int k3) const;
+    /** Read access - doesn't check index bounds */
+    T const& value_unsafe(int k1, int k2, int k3) const;
+
+    /** Write access: activate the brick of the element if needed, and return a reference on the element */
+    T& activate(int3 const& index);
+    T& activate(int k1, int k2, int k3);
+    /** True if the brick containing the element is active */
+    bool is_active(int k1, int k2, int k3) const;
+
+    /** Index of the brick (bx,by,bz) in brick_coordinates (-1 if the brick is inactive). The brick must be inside the grid: (bx,by,bz) < brick_dimension */
+    int find_brick(int3 const& brick) const;
+    /** Index of the brick (bx,by,bz), activated if needed */
+    int activate_brick(int3 const& brick);
+    /** Pointer on the first element of the brick of index b (the element (lx,ly,lz) of the brick is at lx + B*(ly + B*lz)) */
+    T const* brick_data(int b) const { return data.data.data() + int64_t(b) * brick_volume; }
+    T* brick_data(int b) { return data.data.data() + int64_t(b) * brick_volume; }
+
+    /** Call f(k1, k2, k3, value) on the elements of the active bricks (brick after brick) */
+    template <typename F> void for_each_active(F const& f);
+    template <typename F> void for_each_active(F const& f) const;
+
+private:
+    std::unordered_map<int64_t, int> brick_table; // key of the brick -> index of the brick
+    mutable int64_t cache_key;                    // Last brick found (-1 if none)
+    mutable int cache_brick;
+    int64_t brick_key(int3 const& brick) const { return brick.x + int64_t(brick_dimension.x) * (brick.y + int64_t(brick_dimension.y) * brick.z); }
+};
+
+template <typename T, int BrickSize> std::string type_str(grid_3D_sparse<T, BrickSize> const&);
+
+/** Equality check (element by element, including the background) between two sparse grids */
+template <typename T, int BrickSize> bool is_equal(grid_3D_sparse<T, BrickSize> const& a, grid_3D_sparse<T, BrickSize> const& b);
+
+}
+
+
+
+/* ************************************************** */
+/*           IMPLEMENTATION                           */
+/* ************************************************** */
+
+namespace cgp
+{
+
+template <typename T, int BrickSize>
+grid_3D_sparse<T, BrickSize>::grid_3D_sparse()
+    :dimension(int3{0,0,0}), brick_dimension(int3{0,0,0}), background(), data(), brick_coordinates(), brick_table(), cache_key(-1), cache_brick(-1)
+{}
+
+template <typename T, int BrickSize>
+grid_3D_sparse<T, BrickSize>::grid_3D_sparse(int3 const& size, T const& background_arg)
+    :grid_3D_sparse()
+{
+    background = background_arg;
+    resize(size);
+}
+
+template <typename T, int BrickSize>
+grid_3D_sparse<T, BrickSize>::grid_3D_sparse(int size_1, int size_2, int size_3, T const& background_arg)
+    :grid_3D_sparse(int3{ size_1, size_2, size_3 }, background_arg)
+{}
+
+template <typename T, int BrickSize>
+template <typename Allocator>
+grid_3D_sparse<T, BrickSize>::grid_3D_sparse(grid_3D<T, Allocator> const& grid, T const& background_arg)
+    :grid_3D_sparse(grid.dimension, background_arg)
+{
+    for (int k3 = 0; k3 < dimension.z; ++k3)
+        for (int k2 = 0; k2 < dimension.y; ++k2)
+            for (int k1 = 0; k1 < dimension.x; ++k1)
+                if (is_equal(grid.at_unsafe(k1, k2, k3), background) == false)
+                    activate(k1, k2, k3) = grid.at_unsafe(k1, k2, k3);
+}
+
+template <typename T, int BrickSize>
+grid_3D<T> grid_3D_sparse<T, BrickSize>::to_grid() const
+{
+    grid_3D<T> grid(dimension);
+    grid.fill(background);
+    for_each_active([&grid](int k1, int k2, int k3, T const& value) { grid.at_unsafe(k1, k2, k3) = value; });
+    return grid;
+}
+
+template <typename T, int BrickSize>
+void grid_3D_sparse<T, BrickSize>::clear()
+{
+    data.clear();
+    brick_coordinates.clear();
+    brick_table.clear();
+    cache_key = -1;
+    cache_brick = -1;
+}
+
+template <typename T, int BrickSize>
+int64_t grid_3D_sparse<T, BrickSize>::size() const
+{
+    return int64_t(dimension.x) * dimension.y * dimension.z;
+}
+
+template <typename T, int BrickSize>
+int grid_3D_sparse<T, BrickSize>::number_of_bricks() const
+{
+    return int(brick_coordinates.size());
+}
+
+template <typename T, int BrickSize>
+void grid_3D_sparse<T, BrickSize>::resize(int3 const& size)
+{
+    assert_cgp_no_msg(size.x >= 0 && size.y >= 0 && size.z >= 0);
+    clear();
+    dimension = size;
+    brick_dimension = (size + int3{ BrickSize - 1, BrickSize - 1, BrickSize - 1 }) / BrickSize;
+}
+
+template <typename T, int BrickSize>
+void grid_3D_sparse<T, BrickSize>::resize(int size_1, int size_2, int size_3)
+{
+    resize(int3{ size_1, size_2, size_3 });
+}
+
+template <typename T, int BrickSize>
+int grid_3D_sparse<T, BrickSize>::find_brick(int3 const& brick) const
+{
+    int64_t const key = brick_key(brick);
+    if (key == cache_key)
+        return cache_brick;
+
+    auto const it = brick_table.find(key);
+    if (it == brick_table.end())
+        return -1;
+    cache_key = key;
+    cache_brick = it->second;
+    return cache_brick;
+}
+
+template <typename T, int BrickSize>
+int grid_3D_sparse<T, BrickSize>::activate_brick(int3 const& brick)
+{
+    int const found = find_brick(brick);
+    if (found != -1)
+        return found;
+
+    int const b = number_of_bricks();
+    brick_table[brick_key(brick)] = b;
+    brick_coordinates.push_back(brick);
+    data.data.resize(data.data.size() + brick_volume, background);
+
+    cache_key = brick_key(brick);
+    cache_brick = b;
+    return b;
+}
+
+template <typename T, int BrickSize>
+T const& grid_3D_sparse<T, BrickSize>::value_unsafe(int k1, int k2, int k3) const
+{
+    int constexpr mask = BrickSize - 1;
+    int const b = find_brick({ k1 >> brick_shift, k2 >> brick_shift, k3 >> brick_shift });
+    if (b == -1)
+        return background;
+    return brick_data(b)[(k1 & mask) + BrickSize * ((k2 & mask) + BrickSize * (k3 & mask))];
+}
+
+template <typename T, int BrickSize>
+bool grid_3D_sparse<T, BrickSize>::is_active(int k1, int k2, int k3) const
+{
+    return find_brick({ k1 >> brick_shift, k2 >> brick_shift, k3 >> brick_shift }) != -1;
+}
+
+
+#ifndef CGP_NO_DEBUG
+template <typename T, int BrickSize>
+void check_index_bounds(int k1, int k2, int k3, grid_3D_sparse<T, BrickSize> const& grid)
+{
+    int3 const& N = grid.dimension;
+    if (k1 < 0 || k2 < 0 || k3 < 0 || k1 >= N.x || k2 >= N.y || k3 >= N.z)
+        error_cgp("Try to access grid_3D_sparse(" + str(k1) + "," + str(k2) + "," + str(k3) + ") while its dimension is " + str(N) + "\n\t  Type of grid_3D_sparse: " + type_str(grid));
+}
+#else
+template <typename T, int BrickSize>
+void check_index_bounds(int, int, int, grid_3D_sparse<T, BrickSize> const&) {}
+#endif
+
+template <typename T, int BrickSize> T const& grid_3D_sparse<T, BrickSize>::operator[](int3 const& index) const
+{
+    check_index_bounds(index.x, index.y, index.z, *this);
+    return value_unsafe(index.x, index.y, index.z);
+}
+template <typename T, int BrickSize> T const& grid_3D_sparse<T, BrickSize>::operator()(int3 const& index) const
+{
+    check_index_bounds(index.x, index.y, index.z, *this);
+    return value_unsafe(index.x, index.y, index.z);
+}
+template <typename T, int BrickSize> T const& grid_3D_sparse<T, BrickSize>::operator()(int k1, int k2, int k3) const
+{
+    check_index_bounds(k1, k2, k3, *this);
+    return value_unsafe(k1, k2, k3);
+}
+
+template <typename T, int BrickSize> T& grid_3D_sparse<T, BrickSize>::activate(int3 const& index)
+{
+    return activate(index.x, index.y, index.z);
+}
+template <typename T, int BrickSize> T& grid_3D_sparse<T, BrickSize>::activate(int k1, int k2, int k3)
+{
+    check_index_bounds(k1, k2, k3, *this);
+    int constexpr mask = BrickSize - 1;
+    int const b = activate_brick({ k1 >> brick_shift, k2 >> brick_shift, k3 >> brick_shift });
+    return brick_data(b)[(k1 & mask) + BrickSize * ((k2 & mask) + BrickSize * (k3 & mask))];
+}
+
+
+namespace detail {
+    // Visit the elements of the active bricks of a (const or non-const) grid_3D_sparse
+    template <typename Grid, typename F> void grid_3D_sparse_for_each_active(Grid& grid, F const& f)
+    {
+        int constexpr BrickSize = Grid::brick_size;
+        int3 const& N = grid.dimension;
+        int const N_brick = grid.number_of_bricks();
+        for (int b = 0; b < N_brick; ++b) {
+            auto* value = grid.brick_data(b);
+            int3 const corner = grid.brick_coordinates[b] * BrickSize;
+            // Bricks on the border are partially inside the grid
+            int const Lx = std::min(BrickSize, N.x - corner.x), Ly = std::min(BrickSize, N.y - corner.y), Lz = std::min(BrickSize, N.z - corner.z);
+            for (int lz = 0; lz < Lz; ++lz)
+                for (int ly = 0; ly < Ly; ++ly)
+                    for (int lx = 0; lx < Lx; ++lx)
+                        f(corner.x + lx, corner.y + ly, corner.z + lz, value[lx + BrickSize * (ly + BrickSize * lz)]);
+        }
+    }
+}
+
+template <typename T, int BrickSize>
+template <typename F>
+void grid_3D_sparse<T, BrickSize>::for_each_active(F const& f)
+{
+    detail::grid_3D_sparse_for_each_active(*this, f);
+}
+
+template <typename T, int BrickSize>
+template <typename F>
+void grid_3D_sparse<T, BrickSize>::for_each_active(F const& f) const
+{
+    detail::grid_3D_sparse_for_each_active(*this, f);
+}
+
+template <typename T, int BrickSize> std::string type_str(grid_3D_sparse<T, BrickSize> const&)
+{
+    return "grid_3D_sparse<" + type_str(T()) + "," + str(BrickSize) + ">";
+}
+
+template <typename T, int BrickSize> bool is_equal(grid_3D_sparse<T, BrickSize> const& a, grid_3D_sparse<T, BrickSize> const& b)
+{
+    if (is_equal(a.dimension, b.dimension) == false)
+        return false;
+    // Active elements of a against b, and active elements of b against a (covers the elements active in only one grid)
+    bool equal = true;
+    a.for_each_active([&](int k1, int k2, int k3, T const& value) { equal = equal && is_equal(value, b.value_unsafe(k1, k2, k3)); });
+    b.for_each_active([&](int k1, int k2, int k3, T const& value) { equal = equal && is_equal(value, a.value_unsafe(k1, k2, k3)); });
+    if (a.number_of_bricks() < a.brick_dimension.x * int64_t(a.brick_dimension.y) * a.brick_dimension.z)
+        equal = equal && is_equal(a.background, b.background);
+    return equal;
+}
+
+}
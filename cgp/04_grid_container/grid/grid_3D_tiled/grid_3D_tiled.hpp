@@ -0,0 +1,441 @@
+#pragma once
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/02_numarray/numarray.hpp"
+#include "../grid_3D/grid_3D.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/* ************************************************** */
+/*           Header                                   */
+/* ************************************************** */
+
+namespace cgp
+{
+
+namespace detail {
+    constexpr int log2_power_of_two(int n) { return n <= 1 ? 0 : 1 + log2_power_of_two(n / 2); }
+}
+
+/** Container for 3D-grid data stored by bricks (cache-blocked layout)
+*
+* The grid is split in bricks of BrickSize^3 elements (8x8x8 by default, BrickSize must be a power of 2).
+* The elements of a brick are stored contiguously (x-fastest inside the brick), and the bricks are stored one after the other (x-fastest).
+* Neighbors along y and z are therefore close in memory (B and B^2 elements instead of Nx and Nx*Ny for grid_3D),
+* which improves the cache usage of stencils (gradient, Laplacian, marching cube corners, trilinear interpolation) on large volumes.
+*
+* The element access has the same syntax than grid_3D: grid(i,j,k).
+* Use for_each to visit all the elements in storage order (faster than three nested loops on i,j,k).
+* Stencils are applied brick by brick with apply_stencil: each brick is copied with a margin of one element (its halo) in a small buffer,
+*  where the 26 neighbors of an element are at constant offsets (the loops on the elements of a brick are then vectorized by the compiler).
+* The storage is padded to a multiple of BrickSize along each axis: data.size() >= size().
+*
+* Example: 7-point Laplacian
+*   using tiled = grid_3D_tiled<float>;
+*   f.apply_stencil(laplacian, [](float const* p) {
+*       return p[1] + p[-1] + p[tiled::halo_stride_y] + p[-tiled::halo_stride_y] + p[tiled::halo_stride_z] + p[-tiled::halo_stride_z] - 6 * p[0]; });
+**/
+template <typename T, int BrickSize = 8>
+struct grid_3D_tiled
+{
+    static_assert(BrickSize > 0 && (BrickSize & (BrickSize - 1)) == 0, "The brick size of grid_3D_tiled must be a power of 2");
+
+    /** Number of elements along each axis of a brick, and total number of elements of a brick */
+    static constexpr int brick_size = BrickSize;
+    static constexpr int brick_volume = BrickSize * BrickSize * BrickSize;
+    /** brick_size = 2^brick_shift */
+    static constexpr int brick_shift = detail::log2_power_of_two(BrickSize);
+    /** Buffer storing a brick and its halo (see copy_brick_with_halo): dimension along each axis, offsets to the neighbors along y and z, and total number of elements */
+    static constexpr int halo_size = BrickSize + 2;
+    static constexpr int halo_stride_y = halo_size;
+    static constexpr int halo_stride_z = halo_size * halo_size;
+    static constexpr int halo_volume = halo_size * halo_size * halo_size;
+
+    /** 3D dimension (Nx,Ny,Nz) of the grid */
+    int3 dimension;
+    /** Number of bricks along each axis */
+    int3 brick_dimension;
+    /** Internal storage as a 1D buffer (brick after brick) */
+    numarray<T> data;
+
+    /** Constructors */
+    grid_3D_tiled();
+    grid_3D_tiled(int3 const& size);
+    grid_3D_tiled(int size_1, int size_2, int size_3);
+    /** Conversion from (and to) the linear layout */
+    template <typename Allocator> explicit grid_3D_tiled(grid_3D<T, Allocator> const& grid);
+    grid_3D<T> to_grid() const;
+
+    /** Remove all elements from the grid */
+    void clear();
+    /** Total number of elements size = dimension[0] * dimension[1] * dimension[2] */
+    int64_t size() const;
+    /** Fill all elements of the grid with the same element*/
+    void fill(T const& value);
+    /** Resizing the grid (doesn't preserve the previous values) */
+    void resize(int3 const& size);
+    void resize(int size_1, int size_2, int size_3);
+
+    /** Element access
+     * Bound checking is performed unless CGP_NO_DEBUG is defined. */
+    T const& operator[](int3 const& index) const;
+    T& operator[](int3 const& index);
+    T const& operator()(int3 const& index) const;
+    T& operator()(int3 const& index);
+    T const& operator()(int k1, int k2, int k3) const;
+    T& operator()(int k1, int k2, int k3);
+
+    /** Direct access to the value - doesn't check index bounds*/
+    T const& at_unsafe(int k1, int k2, int k3) const { return data.at(index_to_offset(k1, k2, k3)); }
+    T& at_unsafe(int k1, int k2, int k3) { return data.at(index_to_offset(k1, k2, k3)); }
+
+    /** Offset of the element (k1,k2,k3) in data, and its inverse */
+    int64_t index_to_offset(int k1, int k2, int k3) const;
+    int3 offset_to_index(int64_t offset) const;
+    /** Distance in data from the element (k1,k2,k3) to its next neighbor along x, y and z (the neighbor may be in the next brick)
+     * Used by stencils: the neighbor (k1+1,k2,k3) is at offset+step.x, and (k1-1,k2,k3) at offset-neighbor_step(k1-1,k2,k3).x */
+    long3 neighbor_step(int k1, int k2, int k3) const;
+
+    /** Call f(k1, k2, k3, value) on all the elements of the grid in storage order (brick after brick) */
+    template <typename F> void for_each(F const& f);
+    template <typename F> void for_each(F const& f) const;
+
+    /** Pointer on the first element of the brick (bx,by,bz) (the element (lx,ly,lz) of the brick is at lx + B*(ly + B*lz)) */
+    T const* brick_data(int3 const& brick) const { return data.data.data() + brick_offset(brick); }
+    T* brick_data(int3 const& brick) { return data.data.data() + brick_offset(brick); }
+    /** Call f(brick, values) on all the bricks in storage order, values pointing to the brick_volume elements of the brick (including the padding of the bricks on the border) */
+    template <typename F> void for_each_brick(F const& f);
+    template <typename F> void for_each_brick(F const& f) const;
+
+    /** Copy the elements (x0-1 <= k1 <= x0+B, y0-1 <= k2 <= y0+B, z0-1 <= k3 <= z0+B) around the brick starting at (x0,y0,z0) = B*brick in buffer, of dimension halo_size^3 (x-fastest).
+     * The indices outside of the grid are clamped to its border. The element (x0,y0,z0) is at buffer[1 + halo_stride_y + halo_stride_z]. */
+    void copy_brick_with_halo(int3 const& brick, T* buffer) const;
+    /** Fill output (resized to the same dimension) with output(k1,k2,k3) = f(p), where p points to the element (k1,k2,k3) in the halo buffer of its brick:
+     * its neighbor (k1+dx,k2+dy,k3+dz) is at p[dx + dy*halo_stride_y + dz*halo_stride_z], for dx,dy,dz in {-1,0,1} (clamped on the border of the grid).
+     * The grid is processed brick by brick in storage order. */
+    template <typename F> void apply_stencil(grid_3D_tiled& output, F const& f) const;
+
+private:
+    int64_t brick_offset(int3 const& brick) const { return (brick.x + int64_t(brick_dimension.x) * (brick.y + int64_t(brick_dimension.y) * brick.z)) * brick_volume; }
+};
+
+template <typename T, int BrickSize> std::string type_str(grid_3D_tiled<T, BrickSize> const&);
+
+/** Equality check (element by element) between two tiled grids */
+template <typename T, int BrickSize> bool is_equal(grid_3D_tiled<T, BrickSize> const& a, grid_3D_tiled<T, BrickSize> const& b);
+
+}
+
+
+
+/* ************************************************** */
+/*           IMPLEMENTATION                           */
+/* ************************************************** */
+
+namespace cgp
+{
+
+template <typename T, int BrickSize>
+grid_3D_tiled<T, BrickSize>::grid_3D_tiled()
+    :dimension(int3{0,0,0}), brick_dimension(int3{0,0,0}), data()
+{}
+
+template <typename T, int BrickSize>
+grid_3D_tiled<T, BrickSize>::grid_3D_tiled(int3 const& size)
+    :grid_3D_tiled()
+{
+    resize(size);
+}
+
+template <typename T, int BrickSize>
+grid_3D_tiled<T, BrickSize>::grid_3D_tiled(int size_1, int size_2, int size_3)
+    :grid_3D_tiled()
+{
+    resize(size_1, size_2, size_3);
+}
+
+template <typename T, int BrickSize>
+template <typename Allocator>
+grid_3D_tiled<T, BrickSize>::grid_3D_tiled(grid_3D<T, Allocator> const& grid)
+    :grid_3D_tiled(grid.dimension)
+{
+    for_each([&grid](int k1, int k2, int k3, T& value) { value = grid.at_unsafe(k1, k2, k3); });
+}
+
+template <typename T, int BrickSize>
+grid_3D<T> grid_3D_tiled<T, BrickSize>::to_grid() const
+{
+    grid_3D<T> grid(dimension);
+    for_each([&grid](int k1, int k2, int k3, T const& value) { grid.at_unsafe(k1, k2, k3) = value; });
+    return grid;
+}
+
+template <typename T, int BrickSize>
+void grid_3D_tiled<T, BrickSize>::clear()
+{
+    resize(0, 0, 0);
+}
+
+template <typename T, int BrickSize>
+int64_t grid_3D_tiled<T, BrickSize>::size() const
+{
+    return int64_t(dimension.x) * dimension.y * dimension.z;
+}
+
+template <typename T, int BrickSize>
+void grid_3D_tiled<T, BrickSize>::fill(T const& value)
+{
+    data.fill(value);
+}
+
+template <typename T, int BrickSize>
+void grid_3D_tiled<T, BrickSize>::resize(int3 const& size)
+{
+    assert_cgp_no_msg(size.x >= 0 && size.y >= 0 && size.z >= 0);
+    dimension = size;
+    brick_dimension = (size + int3{ BrickSize - 1, BrickSize - 1, BrickSize - 1 }) / BrickSize;
+    data.resize(int64_t(brick_dimension.x) * brick_dimension.y * brick_dimension.z * brick_volume);
+}
+
+template <typename T, int BrickSize>
+void grid_3D_tiled<T, BrickSize>::resize(int size_1, int size_2, int size_3)
+{
+    resize(int3{ size_1, size_2, size_3 });
+}
+
+template <typename T, int BrickSize>
+int64_t grid_3D_tiled<T, BrickSize>::index_to_offset(int k1, int k2, int k3) const
+{
+    int constexpr mask = BrickSize - 1;
+    int64_t const brick = (k1 >> brick_shift) + int64_t(brick_dimension.x) * ((k2 >> brick_shift) + int64_t(brick_dimension.y) * (k3 >> brick_shift));
+    int const local = (k1 & mask) + BrickSize * ((k2 & mask) + BrickSize * (k3 & mask));
+    return brick * brick_volume + local;
+}
+
+template <typename T, int BrickSize>
+int3 grid_3D_tiled<T, BrickSize>::offset_to_index(int64_t offset) const
+{
+    int3 const brick = index_grid_from_offset(offset / brick_volume, brick_dimension.x, brick_dimension.y);
+    int3 const local = index_grid_from_offset(offset % brick_volume, BrickSize, BrickSize);
+    return brick * BrickSize + local;
+}
+
+template <typename T, int BrickSize>
+long3 grid_3D_tiled<T, BrickSize>::neighbor_step(int k1, int k2, int k3) const
+{
+    int constexpr mask = BrickSize - 1;
+    int64_t const brick_row = int64_t(brick_dimension.x) * brick_volume;
+    int64_t const brick_slice = brick_row * brick_dimension.y;
+    return {
+        (k1 & mask) != mask ? int64_t(1) : brick_volume - int64_t(mask),
+        (k2 & mask) != mask ? int64_t(BrickSize) : brick_row - int64_t(mask) * BrickSize,
+        (k3 & mask) != mask ? int64_t(BrickSize) * BrickSize : brick_slice - int64_t(mask) * BrickSize * BrickSize };
+}
+
+
+#ifndef CGP_NO_DEBUG
+template <typename T, int BrickSize>
+void check_index_bounds(int k1, int k2, int k3, grid_3D_tiled<T, BrickSize> const& grid)
+{
+    int3 const& N = grid.dimension;
+    if (k1 < 0 || k2 < 0 || k3 < 0 || k1 >= N.x || k2 >= N.y || k3 >= N.z)
+        error_cgp("Try to access grid_3D_tiled(" + str(k1) + "," + str(k2) + "," + str(k3) + ") while its dimension is " + str(N) + "\n\t  Type of grid_3D_tiled: " + type_str(grid));
+}
+#else
+template <typename T, int BrickSize>
+void check_index_bounds(int, int, int, grid_3D_tiled<T, BrickSize> const&) {}
+#endif
+
+template <typename T, int BrickSize> T const& grid_3D_tiled<T, BrickSize>::operator[](int3 const& index) const
+{
+    check_index_bounds(index.x, index.y, index.z, *this);
+    return at_unsafe(index.x, index.y, index.z);
+}
+template <typename T, int BrickSize> T& grid_3D_tiled<T, BrickSize>::operator[](int3 const& index)
+{
+    check_index_bounds(index.x, index.y, index.z, *this);
+    return at_unsafe(index.x, index.y, index.z);
+}
+template <typename T, int BrickSize> T const& grid_3D_tiled<T, BrickSize>::operator()(int3 const& index) const
+{
+    check_index_bounds(index.x, index.y, index.z, *this);
+    return at_unsafe(index.x, index.y, index.z);
+}
+template <typename T, int BrickSize> T& grid_3D_tiled<T, BrickSize>::operator()(int3 const& index)
+{
+    check_index_bounds(index.x, index.y, index.z, *this);
+    return at_unsafe(index.x, index.y, index.z);
+}
+template <typename T, int BrickSize> T const& grid_3D_tiled<T, BrickSize>::operator()(int k1, int k2, int k3) const
+{
+    check_index_bounds(k1, k2, k3, *this);
+    return at_unsafe(k1, k2, k3);
+}
+template <typename T, int BrickSize> T& grid_3D_tiled<T, BrickSize>::operator()(int k1, int k2, int k3)
+{
+    check_index_bounds(k1, k2, k3, *this);
+    return at_unsafe(k1, k2, k3);
+}
+
+
+namespace detail {
+    // Visit the elements of a (const or non-const) grid_3D_tiled in storage order
+    template <typename Grid, typename F> void grid_3D_tiled_for_each(Grid& grid, F const& f)
+    {
+        int constexpr BrickSize = Grid::brick_size;
+        int constexpr brick_volume = Grid::brick_volume;
+        int3 const& N = grid.dimension;
+        auto* value = grid.data.data.data();
+        for (int bz = 0; bz < grid.brick_dimension.z; ++bz) {
+            for (int by = 0; by < grid.brick_dimension.y; ++by) {
+                for (int bx = 0; bx < grid.brick_dimension.x; ++bx, value += brick_volume) {
+                    // Bricks on the border are partially filled
+                    int const x0 = bx * BrickSize, y0 = by * BrickSize, z0 = bz * BrickSize;
+                    int const Lx = std::min(BrickSize, N.x - x0), Ly = std::min(BrickSize, N.y - y0), Lz = std::min(BrickSize, N.z - z0);
+                    if (Lx == BrickSize && Ly == BrickSize && Lz == BrickSize) {
+                        // Full brick: loops with constant bounds
+                        auto* v = value;
+                        for (int lz = 0; lz < BrickSize; ++lz)
+                            for (int ly = 0; ly < BrickSize; ++ly)
+                                for (int lx = 0; lx < BrickSize; ++lx, ++v)
+                                    f(x0 + lx, y0 + ly, z0 + lz, *v);
+                    }
+                    else {
+                        for (int lz = 0; lz < Lz; ++lz)
+                            for (int ly = 0; ly < Ly; ++ly)
+                                for (int lx = 0; lx < Lx; ++lx)
+                                    f(x0 + lx, y0 + ly, z0 + lz, value[lx + BrickSize * (ly + BrickSize * lz)]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename T, int BrickSize>
+template <typename F>
+void grid_3D_tiled<T, BrickSize>::for_each(F const& f)
+{
+    detail::grid_3D_tiled_for_each(*this, f);
+}
+
+template <typename T, int BrickSize>
+template <typename F>
+void grid_3D_tiled<T, BrickSize>::for_each(F const& f) const
+{
+    detail::grid_3D_tiled_for_each(*this, f);
+}
+
+namespace detail {
+    // Visit the bricks of a (const or non-const) grid_3D_tiled in storage order
+    template <typename Grid, typename F> void grid_3D_tiled_for_each_brick(Grid& grid, F const& f)
+    {
+        auto* value = grid.data.data.data();
+        for (int bz = 0; bz < grid.brick_dimension.z; ++bz)
+            for (int by = 0; by < grid.brick_dimension.y; ++by)
+                for (int bx = 0; bx < grid.brick_dimension.x; ++bx, value += Grid::brick_volume)
+                    f(int3{ bx, by, bz }, value);
+    }
+}
+
+template <typename T, int BrickSize>
+template <typename F>
+void grid_3D_tiled<T, BrickSize>::for_each_brick(F const& f)
+{
+    detail::grid_3D_tiled_for_each_brick(*this, f);
+}
+
+template <typename T, int BrickSize>
+template <typename F>
+void grid_3D_tiled<T, BrickSize>::for_each_brick(F const& f) const
+{
+    detail::grid_3D_tiled_for_each_brick(*this, f);
+}
+
+template <typename T, int BrickSize>
+void grid_3D_tiled<T, BrickSize>::copy_brick_with_halo(int3 const& brick, T* buffer) const
+{
+    int constexpr B = BrickSize;
+    int constexpr mask = BrickSize - 1;
+    int3 const origin = B * brick;
+    int3 const& N = dimension;
+
+    // Offsets in data of the rows k2 and slices k3 of the halo (clamped to the grid)
+    int64_t const brick_row = int64_t(brick_dimension.x) * brick_volume;
+    int64_t const brick_slice = brick_row * brick_dimension.y;
+    int64_t offset_y[halo_size], offset_z[halo_size];
+    for (int l = -1; l <= B; ++l) {
+        int const k2 = std::min(std::max(origin.y + l, 0), N.y - 1);
+        int const k3 = std::min(std::max(origin.z + l, 0), N.z - 1);
+        offset_y[l + 1] = brick_row * (k2 >> brick_shift) + B * (k2 & mask);
+        offset_z[l + 1] = brick_slice * (k3 >> brick_shift) + B * B * (k3 & mask);
+    }
+
+    // Each row of the buffer is a row of B contiguous elements of a brick,
+    //  between the last element of the same row in the previous brick along x, and the first element in the next one.
+    T const* const first = data.data.data() + int64_t(brick.x) * brick_volume;
+    int const last_x = N.x - 1 - origin.x; // local index of the last element of the grid along x
+    for (int lz = 0; lz < halo_size; ++lz) {
+        for (int ly = 0; ly < halo_size; ++ly, buffer += halo_size) {
+            T const* center = first + offset_y[ly] + offset_z[lz];
+            buffer[0] = origin.x > 0 ? center[mask - brick_volume] : center[0];
+            if (last_x >= B) {
+                if constexpr (std::is_trivially_copyable<T>::value)
+                    std::memcpy(buffer + 1, center, B * sizeof(T)); // inlined copy of a constant size (std::copy calls memmove)
+                else
+                    std::copy(center, center + B, buffer + 1);
+                buffer[B + 1] = center[brick_volume];
+            }
+            else {
+                // Last brick along x
+                for (int lx = 0; lx <= B; ++lx)
+                    buffer[lx + 1] = center[std::min(lx, last_x)];
+            }
+        }
+    }
+}
+
+template <typename T, int BrickSize>
+template <typename F>
+void grid_3D_tiled<T, BrickSize>::apply_stencil(grid_3D_tiled& output, F const& f) const
+{
+    assert_cgp(&output != this, "The output of apply_stencil must be a different grid than its input");
+    int constexpr B = BrickSize;
+    if (is_equal(output.dimension, dimension) == false)
+        output.resize(dimension);
+
+    std::vector<T> buffer(halo_volume);
+    T const* const center = buffer.data() + 1 + halo_stride_y + halo_stride_z;
+    for_each_brick([&](int3 const& brick, T const*) {
+        copy_brick_with_halo(brick, buffer.data());
+        T* value = output.brick_data(brick);
+        for (int lz = 0; lz < B; ++lz)
+            for (int ly = 0; ly < B; ++ly, value += B) {
+                T const* p = center + halo_stride_y * ly + halo_stride_z * lz;
+                T row[B]; // local row: the compiler knows that it doesn't overlap the buffer, and vectorizes the loop
+                for (int lx = 0; lx < B; ++lx)
+                    row[lx] = f(p + lx);
+                std::copy(row, row + B, value);
+            }
+    });
+}
+
+template <typename T, int BrickSize> std::string type_str(grid_3D_tiled<T, BrickSize> const&)
+{
+    return "grid_3D_tiled<" + type_str(T()) + "," + str(BrickSize) + ">";
+}
+
+template <typename T, int BrickSize> bool is_equal(grid_3D_tiled<T, BrickSize> const& a, grid_3D_tiled<T, BrickSize> const& b)
+{
+    if (is_equal(a.dimension, b.dimension) == false)
+        return false;
+    bool equal = true;
+    a.for_each([&](int k1, int k2, int k3, T const& value) { equal = equal && is_equal(value, b.at_unsafe(k1, k2, k3)); });
+    return equal;
+}
+
+}
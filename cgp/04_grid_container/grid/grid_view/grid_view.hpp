@@ -0,0 +1,298 @@
+#pragma once
+
+#include "cgp/01_base/base.hpp"
+#include "../grid_2D/grid_2D.hpp"
+#include "../grid_3D/grid_3D.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+/* ************************************************** */
+/*           Header                                   */
+/* ************************************************** */
+
+namespace cgp
+{
+
+/** Non-owning view on 2D-grid data
+ *
+ * The element (k1,k2) is stored at data[k1 + stride_2*k2]. A grid_2D<T> is viewed with stride_2 = dimension.x,
+ * and a rectangular region of a larger grid is viewed with block(first, size) without copying its elements.
+ * grid_2D is implicitly converted to grid_2D_view<T const>: functions taking a view accept grids directly.
+ * The viewed buffer must remain valid while the view is used.
+ **/
+template <typename T>
+struct grid_2D_view
+{
+    using value_type = std::remove_const_t<T>;
+
+    /** Pointer on the element (0,0) */
+    T* data;
+    /** 2D dimension (Nx,Ny) of the view */
+    int2 dimension;
+    /** Distance (in number of elements) between the elements (k1,k2) and (k1,k2+1) */
+    std::ptrdiff_t stride_2;
+
+    // Constructors
+    grid_2D_view();
+    grid_2D_view(T* data, int2 const& dimension);                          // Contiguous buffer of size dimension.x * dimension.y
+    grid_2D_view(T* data, int2 const& dimension, std::ptrdiff_t stride_2);
+
+    /** Implicit conversion from grid_2D */
+    template <typename Allocator> grid_2D_view(grid_2D<value_type, Allocator>& grid);
+    template <typename Allocator, typename U = T, typename = std::enable_if_t<std::is_const<U>::value>> grid_2D_view(grid_2D<value_type, Allocator> const& grid);
+    template <typename U = T, typename = std::enable_if_t<std::is_const<U>::value>> grid_2D_view(grid_2D_view<value_type> const& view);
+
+    /** Total number of elements size = dimension.x * dimension.y */
+    int64_t size() const;
+    /** True if the rows are stored contiguously one after the other (stride_2==dimension.x) */
+    bool is_contiguous() const;
+
+    /** Element access
+     * Bound checking is performed unless CGP_NO_DEBUG is defined. */
+    T& operator()(int k1, int k2) const;
+    T& operator()(int2 const& index) const;
+    T& operator[](int2 const& index) const;
+    /** Direct access to the value - doesn't check index bounds*/
+    T& at_unsafe(int k1, int k2) const { return data[k1 + stride_2 * k2]; }
+
+    /** View on the region first <= (k1,k2) < first+size */
+    grid_2D_view block(int2 const& first, int2 const& size) const;
+
+    /** Copy of the viewed elements in a new grid_2D */
+    grid_2D<value_type> to_grid() const;
+};
+
+
+/** Non-owning view on 3D-grid data
+ *
+ * The element (k1,k2,k3) is stored at data[k1 + stride_2*k2 + stride_3*k3]. A grid_3D<T> is viewed with stride_2 = dimension.x
+ * and stride_3 = dimension.x*dimension.y, and a box of a larger grid is viewed with block(first, size) without copying its elements.
+ * grid_3D is implicitly converted to grid_3D_view<T const>: functions taking a view accept grids directly.
+ * The viewed buffer must remain valid while the view is used.
+ **/
+template <typename T>
+struct grid_3D_view
+{
+    using value_type = std::remove_const_t<T>;
+
+    /** Pointer on the element (0,0,0) */
+    T* data;
+    /** 3D dimension (Nx,Ny,Nz) of the view */
+    int3 dimension;
+    /** Distance (in number of elements) between the elements (k1,k2,k3) and (k1,k2+1,k3) */
+    std::ptrdiff_t stride_2;
+    /** Distance (in number of elements) between the elements (k1,k2,k3) and (k1,k2,k3+1) */
+    std::ptrdiff_t stride_3;
+
+    // Constructors
+    grid_3D_view();
+    grid_3D_view(T* data, int3 const& dimension);                          // Contiguous buffer of size dimension.x * dimension.y * dimension.z
+    grid_3D_view(T* data, int3 const& dimension, std::ptrdiff_t stride_2, std::ptrdiff_t stride_3);
+
+    /** Implicit conversion from grid_3D */
+    template <typename Allocator> grid_3D_view(grid_3D<value_type, Allocator>& grid);
+    template <typename Allocator, typename U = T, typename = std::enable_if_t<std::is_const<U>::value>> grid_3D_view(grid_3D<value_type, Allocator> const& grid);
+    template <typename U = T, typename = std::enable_if_t<std::is_const<U>::value>> grid_3D_view(grid_3D_view<value_type> const& view);
+
+    /** Total number of elements size = dimension.x * dimension.y * dimension.z */
+    int64_t size() const;
+    /** True if the elements are stored contiguously as in a grid_3D of the same dimension */
+    bool is_contiguous() const;
+
+    /** Element access
+     * Bound checking is performed unless CGP_NO_DEBUG is defined. */
+    T& operator()(int k1, int k2, int k3) const;
+    T& operator()(int3 const& index) const;
+    T& operator[](int3 const& index) const;
+    /** Direct access to the value - doesn't check index bounds*/
+    T& at_unsafe(int k1, int k2, int k3) const { return data[k1 + stride_2 * k2 + stride_3 * k3]; }
+
+    /** View on the box first <= (k1,k2,k3) < first+size */
+    grid_3D_view block(int3 const& first, int3 const& size) const;
+
+    /** Copy of the viewed elements in a new grid_3D */
+    grid_3D<value_type> to_grid() const;
+};
+
+template <typename T> std::string type_str(grid_2D_view<T> const&);
+template <typename T> std::string type_str(grid_3D_view<T> const&);
+
+}
+
+
+
+/* ************************************************** */
+/*           IMPLEMENTATION                           */
+/* ************************************************** */
+
+namespace cgp
+{
+
+template <typename T> grid_2D_view<T>::grid_2D_view()
+    :data(nullptr), dimension(0, 0), stride_2(0)
+{}
+
+template <typename T> grid_2D_view<T>::grid_2D_view(T* data_arg, int2 const& dimension_arg)
+    :data(data_arg), dimension(dimension_arg), stride_2(dimension_arg.x)
+{}
+
+template <typename T> grid_2D_view<T>::grid_2D_view(T* data_arg, int2 const& dimension_arg, std::ptrdiff_t stride_2_arg)
+    :data(data_arg), dimension(dimension_arg), stride_2(stride_2_arg)
+{}
+
+template <typename T> template <typename Allocator> grid_2D_view<T>::grid_2D_view(grid_2D<value_type, Allocator>& grid)
+    :grid_2D_view(grid.data.data.data(), grid.dimension)
+{}
+
+template <typename T> template <typename Allocator, typename U, typename> grid_2D_view<T>::grid_2D_view(grid_2D<value_type, Allocator> const& grid)
+    :grid_2D_view(grid.data.data.data(), grid.dimension)
+{}
+
+template <typename T> template <typename U, typename> grid_2D_view<T>::grid_2D_view(grid_2D_view<value_type> const& view)
+    :grid_2D_view(view.data, view.dimension, view.stride_2)
+{}
+
+template <typename T> int64_t grid_2D_view<T>::size() const
+{
+    return int64_t(dimension.x) * dimension.y;
+}
+
+template <typename T> bool grid_2D_view<T>::is_contiguous() const
+{
+    return stride_2 == dimension.x;
+}
+
+#ifndef CGP_NO_DEBUG
+template <typename T> void check_index_bounds(int k1, int k2, grid_2D_view<T> const& view)
+{
+    if (k1 < 0 || k2 < 0 || k1 >= view.dimension.x || k2 >= view.dimension.y)
+        error_cgp("Try to access grid_2D_view(" + str(k1) + "," + str(k2) + ") while its dimension is (" + str(view.dimension.x) + "," + str(view.dimension.y) + ")\n\t  Type of grid_2D_view: " + type_str(view));
+}
+#else
+template <typename T> void check_index_bounds(int, int, grid_2D_view<T> const&) {}
+#endif
+
+template <typename T> T& grid_2D_view<T>::operator()(int k1, int k2) const
+{
+    check_index_bounds(k1, k2, *this);
+    return at_unsafe(k1, k2);
+}
+
+template <typename T> T& grid_2D_view<T>::operator()(int2 const& index) const
+{
+    return (*this)(index.x, index.y);
+}
+
+template <typename T> T& grid_2D_view<T>::operator[](int2 const& index) const
+{
+    return (*this)(index.x, index.y);
+}
+
+template <typename T> grid_2D_view<T> grid_2D_view<T>::block(int2 const& first, int2 const& size) const
+{
+    assert_cgp(first.x >= 0 && first.y >= 0 && size.x >= 0 && size.y >= 0 && first.x + size.x <= dimension.x && first.y + size.y <= dimension.y,
+        "Block " + str(first) + " + " + str(size) + " is outside of the grid_2D_view of dimension " + str(dimension));
+    return grid_2D_view<T>(data + first.x + stride_2 * first.y, size, stride_2);
+}
+
+template <typename T> grid_2D<typename grid_2D_view<T>::value_type> grid_2D_view<T>::to_grid() const
+{
+    grid_2D<value_type> grid(dimension);
+    for (int k2 = 0; k2 < dimension.y; ++k2)
+        for (int k1 = 0; k1 < dimension.x; ++k1)
+            grid.data.at(k1 + dimension.x * k2) = at_unsafe(k1, k2);
+    return grid;
+}
+
+template <typename T> std::string type_str(grid_2D_view<T> const&)
+{
+    return "grid_2D_view<" + type_str(std::remove_const_t<T>()) + (std::is_const<T>::value ? " const>" : ">");
+}
+
+
+
+template <typename T> grid_3D_view<T>::grid_3D_view()
+    :data(nullptr), dimension(0, 0, 0), stride_2(0), stride_3(0)
+{}
+
+template <typename T> grid_3D_view<T>::grid_3D_view(T* data_arg, int3 const& dimension_arg)
+    :data(data_arg), dimension(dimension_arg), stride_2(dimension_arg.x), stride_3(std::ptrdiff_t(dimension_arg.x) * dimension_arg.y)
+{}
+
+template <typename T> grid_3D_view<T>::grid_3D_view(T* data_arg, int3 const& dimension_arg, std::ptrdiff_t stride_2_arg, std::ptrdiff_t stride_3_arg)
+    :data(data_arg), dimension(dimension_arg), stride_2(stride_2_arg), stride_3(stride_3_arg)
+{}
+
+template <typename T> template <typename Allocator> grid_3D_view<T>::grid_3D_view(grid_3D<value_type, Allocator>& grid)
+    :grid_3D_view(grid.data.data.data(), grid.dimension)
+{}
+
+template <typename T> template <typename Allocator, typename U, typename> grid_3D_view<T>::grid_3D_view(grid_3D<value_type, Allocator> const& grid)
+    :grid_3D_view(grid.data.data.data(), grid.dimension)
+{}
+
+template <typename T> template <typename U, typename> grid_3D_view<T>::grid_3D_view(grid_3D_view<value_type> const& view)
+    :grid_3D_view(view.data, view.dimension, view.stride_2, view.stride_3)
+{}
+
+template <typename T> int64_t grid_3D_view<T>::size() const
+{
+    return int64_t(dimension.x) * dimension.y * dimension.z;
+}
+
+template <typename T> bool grid_3D_view<T>::is_contiguous() const
+{
+    return stride_2 == dimension.x && stride_3 == std::ptrdiff_t(dimension.x) * dimension.y;
+}
+
+#ifndef CGP_NO_DEBUG
+template <typename T> void check_index_bounds(int k1, int k2, int k3, grid_3D_view<T> const& view)
+{
+    if (k1 < 0 || k2 < 0 || k3 < 0 || k1 >= view.dimension.x || k2 >= view.dimension.y || k3 >= view.dimension.z)
+        error_cgp("Try to access grid_3D_view(" + str(k1) + "," + str(k2) + "," + str(k3) + ") while its dimension is (" + str(view.dimension.x) + "," + str(view.dimension.y) + "," + str(view.dimension.z) + ")\n\t  Type of grid_3D_view: " + type_str(view));
+}
+#else
+template <typename T> void check_index_bounds(int, int, int, grid_3D_view<T> const&) {}
+#endif
+
+template <typename T> T& grid_3D_view<T>::operator()(int k1, int k2, int k3) const
+{
+    check_index_bounds(k1, k2, k3, *this);
+    return at_unsafe(k1, k2, k3);
+}
+
+template <typename T> T& grid_3D_view<T>::operator()(int3 const& index) const
+{
+    return (*this)(index.x, index.y, index.z);
+}
+
+template <typename T> T& grid_3D_view<T>::operator[](int3 const& index) const
+{
+    return (*this)(index.x, index.y, index.z);
+}
+
+template <typename T> grid_3D_view<T> grid_3D_view<T>::block(int3 const& first, int3 const& size) const
+{
+    assert_cgp(first.x >= 0 && first.y >= 0 && first.z >= 0 && size.x >= 0 && size.y >= 0 && size.z >= 0
+        && first.x + size.x <= dimension.x && first.y + size.y <= dimension.y && first.z + size.z <= dimension.z,
+        "Block " + str(first) + " + " + str(size) + " is outside of the grid_3D_view of dimension " + str(dimension));
+    return grid_3D_view<T>(data + first.x + stride_2 * first.y + stride_3 * first.z, size, stride_2, stride_3);
+}
+
+template <typename T> grid_3D<typename grid_3D_view<T>::value_type> grid_3D_view<T>::to_grid() const
+{
+    grid_3D<value_type> grid(dimension);
+    for (int k3 = 0; k3 < dimension.z; ++k3)
+        for (int k2 = 0; k2 < dimension.y; ++k2)
+            for (int k1 = 0; k1 < dimension.x; ++k1)
+                grid.at_unsafe(k1, k2, k3) = at_unsafe(k1, k2, k3);
+    return grid;
+}
+
+template <typename T> std::string type_str(grid_3D_view<T> const&)
+{
+    return "grid_3D_view<" + type_str(std::remove_const_t<T>()) + (std::is_const<T>::value ? " const>" : ">");
+}
+
+}
@@ -2,10 +2,52 @@
 #include "../grid.hpp"
 
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <new>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/mman.h>
+#endif
 
 namespace cgp_test {
 
+	// Allocator of zero-initialized memory that leaves the elements default-initialized on resize:
+	//  the pages are mapped on demand by the system (without reserving the swap space on POSIX), so that a grid of several GB only uses the memory of the elements actually written
+	template <typename T>
+	struct lazy_zero_allocator
+	{
+		using value_type = T;
+		lazy_zero_allocator() = default;
+		template <typename U> lazy_zero_allocator(lazy_zero_allocator<U> const&) {}
+
+#if defined(__linux__) || defined(__APPLE__)
+		T* allocate(size_t n)
+		{
+			void* p = mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+			if (p == MAP_FAILED)
+				throw std::bad_alloc();
+			return static_cast<T*>(p);
+		}
+		void deallocate(T* p, size_t n) { munmap(p, n * sizeof(T)); }
+#else
+		T* allocate(size_t n)
+		{
+			void* p = std::calloc(n, sizeof(T));
+			if (p == nullptr)
+				throw std::bad_alloc();
+			return static_cast<T*>(p);
+		}
+		void deallocate(T* p, size_t) { std::free(p); }
+#endif
+		template <typename U> void construct(U* p) { ::new (static_cast<void*>(p)) U; }
+		template <typename U, typename... Args> void construct(U* p, Args&&... args) { ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+	};
+	template <typename T, typename U> bool operator==(lazy_zero_allocator<T> const&, lazy_zero_allocator<U> const&) { return true; }
+	template <typename T, typename U> bool operator!=(lazy_zero_allocator<T> const&, lazy_zero_allocator<U> const&) { return false; }
+
 	void test_grid_2D()
 	{
 		{
@@ -90,6 +132,200 @@ namespace cgp_test {
 			assert_cgp_no_msg(type_str(a) == "grid_3D<int>");
 		}
 
+		{
+			// Views on 2D/3D grids and on blocks of a grid
+			cgp::grid_3D<int> a(4, 3, 2);
+			for (int k = 0; k < a.size(); ++k)
+				a.data[k] = k;
+			cgp::grid_3D_view<int const> v = a;
+			assert_cgp_no_msg(v.is_contiguous());
+			assert_cgp_no_msg(v(1, 2, 1) == a(1, 2, 1));
+
+			cgp::grid_3D_view<int const> block = v.block({ 1,1,1 }, { 2,2,1 });
+			assert_cgp_no_msg(block.is_contiguous() == false);
+			assert_cgp_no_msg(block(0, 0, 0) == a(1, 1, 1));
+			assert_cgp_no_msg(block(1, 1, 0) == a(2, 2, 1));
+			cgp::grid_3D<int> const copy = block.to_grid();
+			assert_cgp_no_msg(is_equal(copy.dimension, cgp::int3{ 2,2,1 }));
+			assert_cgp_no_msg(copy(1, 0, 0) == a(2, 1, 1));
+
+			cgp::grid_2D<float> b(3, 3);
+			cgp::grid_2D_view<float> w = b;
+			w.block({ 1,1 }, { 2,2 })(1, 1) = 5.0f;
+			assert_cgp_no_msg(cgp::is_equal(b(2, 2), 5.0f));
+			assert_cgp_no_msg(type_str(w) == "grid_2D_view<float>");
+		}
+
+		{
+			// 64 bits offsets: grids with more than 2^31 elements
+			int const N = 1400;
+			int64_t const offset = cgp::offset_grid(N - 1, N - 1, N - 1, N, N);
+			assert_cgp_no_msg(offset == int64_t(N) * N * N - 1);
+			assert_cgp_no_msg(is_equal(cgp::index_grid_from_offset(offset, N, N), cgp::int3{ N - 1,N - 1,N - 1 }));
+			assert_cgp_no_msg(cgp::offset_grid(cgp::long3{ 1, 2, int64_t(1) << 32 }, 4, 4) == 1 + 4 * 2 + (int64_t(1) << 36));
+
+			cgp::grid_3D_view<float const> v(nullptr, { N,N,N });
+			assert_cgp_no_msg(v.size() == int64_t(N) * N * N);
+
+			cgp::grid_3D<int> a(3, 4, 5);
+			for (int k = 0; k < a.size(); ++k)
+				assert_cgp_no_msg(a.index_to_offset(a.offset_to_index(k)) == k);
+
+			// Offsets around 2^31 for dimensions of 2^31 + 2^21 elements (computed without allocating the grid)
+			int64_t const size_3D = int64_t(2048) * 1024 * 1025;
+			assert_cgp_no_msg(size_3D == (int64_t(1) << 31) + (int64_t(1) << 21));
+			assert_cgp_no_msg(cgp::offset_grid(2047, 1023, 1024, 2048, 1024) == size_3D - 1);
+			assert_cgp_no_msg(cgp::offset_grid(cgp::int3{ 0,0,1024 }, 2048, 1024) == int64_t(1) << 31);
+			assert_cgp_no_msg(is_equal(cgp::index_grid_from_offset(size_3D - 1, 2048, 1024), cgp::int3{ 2047,1023,1024 }));
+			assert_cgp_no_msg(is_equal(cgp::index_grid_from_offset((int64_t(1) << 31) - 1, 2048, 1024), cgp::int3{ 2047,1023,1023 }));
+			assert_cgp_no_msg(is_equal(cgp::index_grid_from_offset(int64_t(1) << 31, 2048, 1024), cgp::int3{ 0,0,1024 }));
+
+			// 2D grid of 2^32 elements, and 3D grid with a dimension larger than 2^31 along the last axis
+			assert_cgp_no_msg(cgp::offset_grid(cgp::int2{ 65535,65535 }, 65536) == (int64_t(1) << 32) - 1);
+			assert_cgp_no_msg(is_equal(cgp::index_grid_from_offset((int64_t(1) << 32) - 1, 65536), cgp::int2{ 65535,65535 }));
+			int64_t const k3 = (int64_t(1) << 31) + 5;
+			assert_cgp_no_msg(is_equal(cgp::index_grid_from_offset_long(cgp::offset_grid(3, 2, k3, 4, 4), 4, 4), cgp::long3{ 3,2,k3 }));
+
+			// Container of 2^31 + 2^21 elements (skipped if the address space is not available)
+			try {
+				cgp::grid_3D<unsigned char, lazy_zero_allocator<unsigned char>> b;
+				b.resize(2048, 1024, 1025);
+				assert_cgp_no_msg(b.size() == size_3D && b.data.size() == size_3D);
+				b(2047, 1023, 1024) = 7;
+				b(0, 0, 1024) = 3;
+				b(cgp::int3{ 2047,1023,1023 }) = 5;
+				assert_cgp_no_msg(b.data[size_3D - 1] == 7);
+				assert_cgp_no_msg(b.data[int64_t(1) << 31] == 3 && b.data[(int64_t(1) << 31) - 1] == 5);
+				assert_cgp_no_msg(b.at_unsafe(2047, 1023, 1024) == 7 && b.at_unsafe(int64_t(1) << 31) == 3);
+				assert_cgp_no_msg(is_equal(b.offset_to_index(size_3D - 1), cgp::int3{ 2047,1023,1024 }));
+				assert_cgp_no_msg(b(1, 2, 3) == 0);
+
+				// Same number of elements with other dimensions: the elements are kept in the buffer
+				b.resize(1025, 2048, 1024);
+				assert_cgp_no_msg(b.size() == size_3D && is_equal(b.dimension, cgp::int3{ 1025,2048,1024 }));
+				assert_cgp_no_msg(b(1024, 2047, 1023) == 7);
+			}
+			catch (std::bad_alloc const&) {}
+		}
+
+		{
+			// Sparse storage: bricks of 4x4x4 elements allocated on write, background value elsewhere
+			cgp::grid_3D_sparse<float, 4> s(10, 9, 7, 2.0f);
+			assert_cgp_no_msg(s.size() == 10 * 9 * 7);
+			assert_cgp_no_msg(s.number_of_bricks() == 0);
+			assert_cgp_no_msg(cgp::is_equal(s(9, 8, 6), 2.0f));
+
+			s.activate(1, 2, 3) = -1.0f;
+			s.activate(9, 8, 6) = 5.0f;
+			s.activate(2, 3, 0) = 4.0f; // same brick as (1,2,3)
+			assert_cgp_no_msg(s.number_of_bricks() == 2);
+			assert_cgp_no_msg(s.is_active(0, 0, 0) && s.is_active(8, 8, 4) && !s.is_active(4, 0, 0));
+			assert_cgp_no_msg(cgp::is_equal(s(1, 2, 3), -1.0f));
+			assert_cgp_no_msg(cgp::is_equal(s(2, 3, 0), 4.0f));
+			assert_cgp_no_msg(cgp::is_equal(s(0, 0, 0), 2.0f));
+			assert_cgp_no_msg(cgp::is_equal(s(5, 0, 0), 2.0f));
+			assert_cgp_no_msg(cgp::is_equal(s(9, 8, 6), 5.0f));
+			assert_cgp_no_msg(type_str(s) == "grid_3D_sparse<float,4>");
+
+			// for_each_active only visits the elements of the active bricks inside the grid
+			int counter = 0;
+			s.for_each_active([&](int, int, int, float&) { ++counter; });
+			assert_cgp_no_msg(counter == 4 * 4 * 4 + 2 * 1 * 3);
+
+			// Conversion with a dense grid
+			cgp::grid_3D<float> const dense = s.to_grid();
+			assert_cgp_no_msg(cgp::is_equal(dense(1, 2, 3), -1.0f) && cgp::is_equal(dense(4, 4, 4), 2.0f));
+			cgp::grid_3D_sparse<float, 4> const s2(dense, 2.0f);
+			assert_cgp_no_msg(s2.number_of_bricks() == 2);
+			assert_cgp_no_msg(is_equal(s, s2));
+
+			s.clear();
+			assert_cgp_no_msg(s.number_of_bricks() == 0 && cgp::is_equal(s(1, 2, 3), 2.0f));
+		}
+
+		{
+			// Tiled storage: bricks of 4x4x4 elements, dimension not multiple of the brick size
+			cgp::grid_3D<int> a(5, 9, 3);
+			for (int k = 0; k < a.size(); ++k)
+				a.data[k] = k;
+			cgp::grid_3D_tiled<int, 4> t(a);
+			assert_cgp_no_msg(is_equal(t.dimension, a.dimension));
+			assert_cgp_no_msg(t.size() == a.size());
+			assert_cgp_no_msg(t(4, 8, 2) == a(4, 8, 2));
+			assert_cgp_no_msg(t.index_to_offset(1, 0, 0) == 1);
+			assert_cgp_no_msg(t.index_to_offset(0, 1, 0) == 4);
+			assert_cgp_no_msg(t.index_to_offset(4, 0, 0) == 64);
+			assert_cgp_no_msg(is_equal(t.offset_to_index(t.index_to_offset(3, 5, 2)), cgp::int3{ 3,5,2 }));
+			assert_cgp_no_msg(is_equal(t.to_grid(), a));
+			assert_cgp_no_msg(type_str(t) == "grid_3D_tiled<int,4>");
+
+			// Neighbors reached by steps within a brick and across bricks
+			for (int k3 = 0; k3 < 2; ++k3) {
+				for (int k2 = 0; k2 < 8; ++k2) {
+					for (int k1 = 0; k1 < 4; ++k1) {
+						cgp::long3 const step = t.neighbor_step(k1, k2, k3);
+						int64_t const offset = t.index_to_offset(k1, k2, k3);
+						assert_cgp_no_msg(t.data[offset + step.x] == a(k1 + 1, k2, k3));
+						assert_cgp_no_msg(t.data[offset + step.y] == a(k1, k2 + 1, k3));
+						assert_cgp_no_msg(t.data[offset + step.z] == a(k1, k2, k3 + 1));
+					}
+				}
+			}
+
+			// for_each_brick visits the bricks in storage order
+			int64_t brick_counter = 0;
+			t.for_each_brick([&](cgp::int3 const& brick, int const* values) {
+				assert_cgp_no_msg(values == t.data.data.data() + brick_counter * t.brick_volume);
+				assert_cgp_no_msg(values == t.brick_data(brick) && t.index_to_offset(4 * brick.x, 4 * brick.y, 4 * brick.z) == brick_counter * t.brick_volume);
+				++brick_counter;
+			});
+			assert_cgp_no_msg(brick_counter == 2 * 3 * 1);
+
+			// for_each visits every element once, in storage order
+			int64_t counter = 0;
+			bool ordered = true;
+			t.for_each([&](int k1, int k2, int k3, int& value) {
+				ordered = ordered && value == a(k1, k2, k3) && t.index_to_offset(k1, k2, k3) >= counter;
+				counter = t.index_to_offset(k1, k2, k3);
+				value = -1;
+			});
+			assert_cgp_no_msg(ordered);
+			for (int k = 0; k < a.size(); ++k)
+				assert_cgp_no_msg(t(a.offset_to_index(k)) == -1);
+		}
+
+		{
+			// Halo of the bricks and stencils on a tiled grid: same values as on the linear grid with the indices clamped to the border
+			cgp::int3 const N = { 21,17,13 };
+			cgp::grid_3D<int> a(N);
+			for (int k = 0; k < a.size(); ++k)
+				a.data[k] = (k * 7919) % 1000;
+			cgp::grid_3D_tiled<int, 4> const t(a);
+			auto const clamped = [&](int k1, int k2, int k3) {
+				return a(std::min(std::max(k1, 0), N.x - 1), std::min(std::max(k2, 0), N.y - 1), std::min(std::max(k3, 0), N.z - 1)); };
+
+			// Interior brick, and bricks on the lower and upper borders (the last one partially filled)
+			using tiled = cgp::grid_3D_tiled<int, 4>;
+			std::vector<int> buffer(tiled::halo_volume);
+			for (cgp::int3 const& brick : { cgp::int3{ 1,1,1 }, cgp::int3{ 2,2,1 }, cgp::int3{ 0,0,0 }, cgp::int3{ 5,4,3 } }) {
+				t.copy_brick_with_halo(brick, buffer.data());
+				for (int lz = -1; lz <= 4; ++lz)
+					for (int ly = -1; ly <= 4; ++ly)
+						for (int lx = -1; lx <= 4; ++lx)
+							assert_cgp_no_msg(buffer[(lx + 1) + tiled::halo_stride_y * (ly + 1) + tiled::halo_stride_z * (lz + 1)] == clamped(4 * brick.x + lx, 4 * brick.y + ly, 4 * brick.z + lz));
+			}
+
+			// 7-point Laplacian
+			cgp::grid_3D_tiled<int, 4> laplacian;
+			t.apply_stencil(laplacian, [](int const* p) {
+				return p[1] + p[-1] + p[tiled::halo_stride_y] + p[-tiled::halo_stride_y] + p[tiled::halo_stride_z] + p[-tiled::halo_stride_z] - 6 * p[0]; });
+			assert_cgp_no_msg(is_equal(laplacian.dimension, N));
+			for (int k3 = 0; k3 < N.z; ++k3)
+				for (int k2 = 0; k2 < N.y; ++k2)
+					for (int k1 = 0; k1 < N.x; ++k1)
+						assert_cgp_no_msg(laplacian(k1, k2, k3) == clamped(k1 + 1, k2, k3) + clamped(k1 - 1, k2, k3) + clamped(k1, k2 + 1, k3) + clamped(k1, k2 - 1, k3) + clamped(k1, k2, k3 + 1) + clamped(k1, k2, k3 - 1) - 6 * a(k1, k2, k3));
+		}
+
 	}
 
 }
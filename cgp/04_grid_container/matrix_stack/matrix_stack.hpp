@@ -7,6 +7,7 @@
 
 #include <sstream>
 #include <iomanip>
+#include <utility>
 
 
 /* ************************************************** */
@@ -34,8 +35,8 @@ namespace cgp
         numarray_stack< numarray_stack<T, N2>, N1> data;
 
         /** Constructors */
-        matrix_stack();
-        matrix_stack(numarray_stack< numarray_stack<T, N2>, N1> const& elements);
+        constexpr matrix_stack();
+        constexpr matrix_stack(numarray_stack< numarray_stack<T, N2>, N1> const& elements);
         matrix_stack(numarray_stack<T, N1* N2> const& elements);
 
         // Construct from a matrix with different size.
@@ -46,11 +47,11 @@ namespace cgp
         matrix_stack(std::initializer_list<T> const& arg);
         matrix_stack(std::initializer_list<numarray_stack<T,N1> > const& arg);
 
-        static matrix_stack<T, N1, N2> build_identity();
-        static matrix_stack<T, N1, N2> diagonal(numarray_stack<T, std::min(N1,N2)> const& arg);
+        static constexpr matrix_stack<T, N1, N2> build_identity();
+        static constexpr matrix_stack<T, N1, N2> diagonal(numarray_stack<T, std::min(N1,N2)> const& arg);
 
         /** Total number of elements size = dimension[0] * dimension[1] */
-        int size() const;
+        constexpr int size() const;
         /** Return {N1,N2} */
         int2 dimension() const;
         /** Fill all elements of the grid_2D with the same element*/
@@ -137,10 +138,10 @@ namespace cgp
 
 
     /** Direct compiled-checked access to data */
-    template <int idx1, int idx2, typename T, int N1, int N2> T const& get(matrix_stack<T, N1, N2> const& data);
-    template <int idx1, int idx2, typename T, int N1, int N2> T& get(matrix_stack<T, N1, N2>& data);
-    template <int idx1, typename T, int N1, int N2> numarray_stack<T, N2> const& get(matrix_stack<T, N1, N2> const& data);
-    template <int idx1, typename T, int N1, int N2> numarray_stack<T, N2>& get(matrix_stack<T, N1, N2>& data);
+    template <int idx1, int idx2, typename T, int N1, int N2> constexpr T const& get(matrix_stack<T, N1, N2> const& data);
+    template <int idx1, int idx2, typename T, int N1, int N2> constexpr T& get(matrix_stack<T, N1, N2>& data);
+    template <int idx1, typename T, int N1, int N2> constexpr numarray_stack<T, N2> const& get(matrix_stack<T, N1, N2> const& data);
+    template <int idx1, typename T, int N1, int N2> constexpr numarray_stack<T, N2>& get(matrix_stack<T, N1, N2>& data);
     template <int offset, typename T, int N1, int N2> T const& get_offset(matrix_stack<T, N1, N2> const& data);
     template <int offset, typename T, int N1, int N2> T& get_offset(matrix_stack<T, N1, N2>& data);
 
@@ -148,37 +149,38 @@ namespace cgp
     template <typename Ta, typename Tb, int Na1, int Na2, int Nb1, int Nb2> bool is_equal(matrix_stack<Ta, Na1, Na2> const& a, matrix_stack<Tb, Nb1, Nb2> const& b);
 
     /** Math operators
-     * Common mathematical operations between buffers, and scalar or element values. */
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>& operator+=(matrix_stack<T, N1, N2>& a, matrix_stack<T, N1, N2> const& b);
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>  operator+(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N1, N2> const& b);
+     * Common mathematical operations between buffers, and scalar or element values.
+     * The loops on the elements are unrolled at compile time, and the operators can be used in constant expressions (constexpr). */
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>& operator+=(matrix_stack<T, N1, N2>& a, matrix_stack<T, N1, N2> const& b);
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>  operator+(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N1, N2> const& b);
 
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>& operator-=(matrix_stack<T, N1, N2>& a, matrix_stack<T, N1, N2> const& b);
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>  operator-(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N1, N2> const& b);
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>& operator-=(matrix_stack<T, N1, N2>& a, matrix_stack<T, N1, N2> const& b);
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>  operator-(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N1, N2> const& b);
 
 
-    template <typename T, int N> matrix_stack<T, N, N>& operator*=(matrix_stack<T, N, N>& a, matrix_stack<T, N, N> const& b);
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>& operator*=(matrix_stack<T, N1, N2>& a, float b);
-    template <typename T, int N1, int N2, int N3> matrix_stack<T, N1, N3>  operator*(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N2, N3> const& b);
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>  operator*(matrix_stack<T, N1, N2> const& a, float b);
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>  operator*(float a, matrix_stack<T, N1, N2> const& b);
+    template <typename T, int N> constexpr matrix_stack<T, N, N>& operator*=(matrix_stack<T, N, N>& a, matrix_stack<T, N, N> const& b);
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>& operator*=(matrix_stack<T, N1, N2>& a, float b);
+    template <typename T, int N1, int N2, int N3> constexpr matrix_stack<T, N1, N3>  operator*(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N2, N3> const& b);
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>  operator*(matrix_stack<T, N1, N2> const& a, float b);
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>  operator*(float a, matrix_stack<T, N1, N2> const& b);
 
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>& operator/=(matrix_stack<T, N1, N2>& a, float b);
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>  operator/(matrix_stack<T, N1, N2> const& a, float b);
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>& operator/=(matrix_stack<T, N1, N2>& a, float b);
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>  operator/(matrix_stack<T, N1, N2> const& a, float b);
 
     // Unary negation
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2> operator-(matrix_stack<T, N1, N2> const& m);
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2> operator-(matrix_stack<T, N1, N2> const& m);
 
     // Componentwise multiplication between two matrices with the same size
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2> multiply_componentwise(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N1, N2> const& b);
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2> multiply_componentwise(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N1, N2> const& b);
 
     // Matrix vector product
-    template <typename T, int N1, int N2> numarray_stack<T, N1> operator*(matrix_stack<T, N1, N2> const& a, numarray_stack<T, N2> const& b);
+    template <typename T, int N1, int N2> constexpr numarray_stack<T, N1> operator*(matrix_stack<T, N1, N2> const& a, numarray_stack<T, N2> const& b);
 
     /** Transposition of matrix */
-    template <typename T, int N1, int N2> matrix_stack<T, N2, N1> transpose(matrix_stack<T, N1, N2> const& m);
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N2, N1> transpose(matrix_stack<T, N1, N2> const& m);
 
     /** Trace of a square matrix*/
-    template <typename T, int N> T trace(matrix_stack<T, N, N> const& m);
+    template <typename T, int N> constexpr T trace(matrix_stack<T, N, N> const& m);
 
     /** Componentwise norm : sqrt(sum_(i,j) a_ij^2) */
     template <typename T, int N1, int N2> T norm(matrix_stack<T,N1,N2> const& m);
@@ -229,12 +231,12 @@ namespace cgp
 
 
     template <typename T, int N1, int N2>
-    matrix_stack<T, N1, N2>::matrix_stack()
+    constexpr matrix_stack<T, N1, N2>::matrix_stack()
         : data()
     {}
 
     template <typename T, int N1, int N2>
-    matrix_stack<T, N1, N2>::matrix_stack(numarray_stack< numarray_stack<T, N2>, N1> const& elements)
+    constexpr matrix_stack<T, N1, N2>::matrix_stack(numarray_stack< numarray_stack<T, N2>, N1> const& elements)
         :data(elements)
     {}
 
@@ -292,7 +294,7 @@ namespace cgp
     }
 
 
-    template <typename T, int N1, int N2> int matrix_stack<T, N1, N2>::size() const { return N1 * N2; }
+    template <typename T, int N1, int N2> constexpr int matrix_stack<T, N1, N2>::size() const { return N1 * N2; }
     template <typename T, int N1, int N2> int2 matrix_stack<T, N1, N2>::dimension() const { return { N1,N2 }; }
     template <typename T, int N1, int N2> matrix_stack<T, N1, N2>& matrix_stack<T, N1, N2>::fill(T const& value)
     {
@@ -522,22 +524,22 @@ namespace cgp
         return size_in_memory(T{})*N1*N2;
     }
 
-    template <int idx1, int idx2, typename T, int N1, int N2> T const& get(matrix_stack<T, N1, N2> const& data)
+    template <int idx1, int idx2, typename T, int N1, int N2> constexpr T const& get(matrix_stack<T, N1, N2> const& data)
     {
         static_assert( (idx1 < N1) && (idx2 < N2), "Index too large for matrix_stack access");
-        return data.at(idx1, idx2);
+        return get<idx2>(get<idx1>(data.data));
     }
-    template <int idx1, int idx2, typename T, int N1, int N2> T& get(matrix_stack<T, N1, N2>& data)
+    template <int idx1, int idx2, typename T, int N1, int N2> constexpr T& get(matrix_stack<T, N1, N2>& data)
     {
         static_assert((idx1 < N1) && (idx2 < N2), "Index too large for matrix_stack access");
-        return data.at(idx1, idx2);
+        return get<idx2>(get<idx1>(data.data));
     }
-    template <int idx1, typename T, int N1, int N2> numarray_stack<T, N2> const& get(matrix_stack<T, N1, N2> const& data)
+    template <int idx1, typename T, int N1, int N2> constexpr numarray_stack<T, N2> const& get(matrix_stack<T, N1, N2> const& data)
     {
         static_assert(idx1<N1, "Index too large for matrix_stack access");
         return get<idx1>(data.data);
     }
-    template <int idx1, typename T, int N1, int N2> numarray_stack<T, N2>& get(matrix_stack<T, N1, N2>& data)
+    template <int idx1, typename T, int N1, int N2> constexpr numarray_stack<T, N2>& get(matrix_stack<T, N1, N2>& data)
     {
         static_assert(idx1 < N1, "Index too large for matrix_stack access");
         return get<idx1>(data.data);
@@ -599,7 +601,79 @@ namespace cgp
     }
 
 
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>& operator+=(matrix_stack<T, N1, N2>& a, matrix_stack<T, N1, N2> const& b)
+    namespace detail
+    {
+        // Unrolled matrix products (see detail::componentwise in numarray_stack): the indices are template parameters expanded in fold expressions
+        //   and the sums are computed in the order of the indices, from T{}.
+
+        // sum_k2 a(k1,k2) b(k2,k3)
+        template <int k1, int k3, typename T, int N1, int N2, int N3, int... K2>
+        constexpr T product_element(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N2, N3> const& b, std::integer_sequence<int, K2...>)
+        {
+            return (T{} + ... + (get<k1, K2>(a) * get<K2, k3>(b)));
+        }
+        template <int k1, typename T, int N1, int N2, int N3, int... K3>
+        constexpr numarray_stack<T, N3> product_row(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N2, N3> const& b, std::integer_sequence<int, K3...>)
+        {
+            return numarray_stack<T, N3>{ product_element<k1, K3>(a, b, std::make_integer_sequence<int, N2>())... };
+        }
+        template <typename T, int N1, int N2, int N3, int... K1>
+        constexpr matrix_stack<T, N1, N3> product(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N2, N3> const& b, std::integer_sequence<int, K1...>)
+        {
+            return matrix_stack<T, N1, N3>(numarray_stack<numarray_stack<T, N3>, N1>{ product_row<K1>(a, b, std::make_integer_sequence<int, N3>())... });
+        }
+
+        // sum_k2 a(k1,k2) b(k2)
+        template <int k1, typename T, int N1, int N2, int... K2>
+        constexpr T product_vector_element(matrix_stack<T, N1, N2> const& a, numarray_stack<T, N2> const& b, std::integer_sequence<int, K2...>)
+        {
+            return (T{} + ... + (get<k1, K2>(a) * get<K2>(b)));
+        }
+        template <typename T, int N1, int N2, int... K1>
+        constexpr numarray_stack<T, N1> product_vector(matrix_stack<T, N1, N2> const& a, numarray_stack<T, N2> const& b, std::integer_sequence<int, K1...>)
+        {
+            return numarray_stack<T, N1>{ product_vector_element<K1>(a, b, std::make_integer_sequence<int, N2>())... };
+        }
+
+        // Column k2 of m
+        template <int k2, typename T, int N1, int N2, int... K1>
+        constexpr numarray_stack<T, N1> column(matrix_stack<T, N1, N2> const& m, std::integer_sequence<int, K1...>)
+        {
+            return numarray_stack<T, N1>{ get<K1, k2>(m)... };
+        }
+        template <typename T, int N1, int N2, int... K2>
+        constexpr matrix_stack<T, N2, N1> transpose(matrix_stack<T, N1, N2> const& m, std::integer_sequence<int, K2...>)
+        {
+            return matrix_stack<T, N2, N1>(numarray_stack<numarray_stack<T, N1>, N2>{ column<K2>(m, std::make_integer_sequence<int, N1>())... });
+        }
+
+        // Matrix with the value d_k at (k,k), and 0 elsewhere
+        template <int k, typename T, int N> constexpr T diagonal_value(numarray_stack<T, N> const& d)
+        {
+            if constexpr (k < N)
+                return get<k>(d);
+            else
+                return T{};
+        }
+        template <int k1, typename T, int N2, int N, int... K2>
+        constexpr numarray_stack<T, N2> diagonal_row(numarray_stack<T, N> const& d, std::integer_sequence<int, K2...>)
+        {
+            return numarray_stack<T, N2>{ (K2 == k1 ? diagonal_value<K2>(d) : T{})... };
+        }
+        template <typename T, int N1, int N2, int N, int... K1>
+        constexpr matrix_stack<T, N1, N2> diagonal(numarray_stack<T, N> const& d, std::integer_sequence<int, K1...>)
+        {
+            return matrix_stack<T, N1, N2>(numarray_stack<numarray_stack<T, N2>, N1>{ diagonal_row<K1, T, N2>(d, std::make_integer_sequence<int, N2>())... });
+        }
+
+        template <typename T, int N, int... K>
+        constexpr T trace(matrix_stack<T, N, N> const& m, std::integer_sequence<int, K...>)
+        {
+            return (T{} + ... + get<K, K>(m));
+        }
+    }
+
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>& operator+=(matrix_stack<T, N1, N2>& a, matrix_stack<T, N1, N2> const& b)
     {
         a.data += b.data;
         return a;
@@ -609,12 +683,9 @@ namespace cgp
         a.data += b;
         return a;
     }
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>  operator+(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N1, N2> const& b)
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>  operator+(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N1, N2> const& b)
     {
-        matrix_stack<T, N1, N2> res;
-        res.data = a.data + b.data;
-        return res;
-
+        return matrix_stack<T, N1, N2>(a.data + b.data);
     }
     template <typename T, int N1, int N2> matrix_stack<T, N1, N2> operator+(matrix_stack<T, N1, N2> const& a, T const& b)
     {
@@ -629,106 +700,70 @@ namespace cgp
         return res;
     }
 
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>& operator-=(matrix_stack<T, N1, N2>& a, matrix_stack<T, N1, N2> const& b)
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>& operator-=(matrix_stack<T, N1, N2>& a, matrix_stack<T, N1, N2> const& b)
     {
         a.data -= b.data;
         return a;
     }
 
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>  operator-(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N1, N2> const& b)
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>  operator-(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N1, N2> const& b)
     {
-        matrix_stack<T, N1, N2> res;
-        res.data = a.data - b.data;
-        return res;
+        return matrix_stack<T, N1, N2>(a.data - b.data);
     }
 
 
-    template <typename T, int N> matrix_stack<T, N, N>& operator*=(matrix_stack<T, N, N>& a, matrix_stack<T, N, N> const& b)
+    template <typename T, int N> constexpr matrix_stack<T, N, N>& operator*=(matrix_stack<T, N, N>& a, matrix_stack<T, N, N> const& b)
     {
-        matrix_stack<T, N, N> res = a * b;
-        a = res;
+        a = a * b;
         return a;
     }
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>& operator*=(matrix_stack<T, N1, N2>& a, float b)
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>& operator*=(matrix_stack<T, N1, N2>& a, float b)
     {
         a.data *= b;
         return a;
     }
-    template <typename T, int N1, int N2, int N3> matrix_stack<T, N1, N3>  operator*(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N2, N3> const& b)
+    template <typename T, int N1, int N2, int N3> constexpr matrix_stack<T, N1, N3>  operator*(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N2, N3> const& b)
     {
-        matrix_stack<T, N1, N3> res;
-        for (int k1 = 0; k1 < N1; ++k1)
-        {
-            for (int k3 = 0; k3 < N3; ++k3)
-            {
-                T s {};
-                for (int k2 = 0; k2 < N2; ++k2)
-                    s += a.at(k1, k2) * b.at(k2, k3);
-                res(k1, k3) = s;
-            }
-        }
-
-        return res;
+        return detail::product(a, b, std::make_integer_sequence<int, N1>());
     }
 
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2> operator*(matrix_stack<T, N1, N2> const& a, float b)
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2> operator*(matrix_stack<T, N1, N2> const& a, float b)
     {
-        matrix_stack<T, N1, N2> res;
-        res.data = a.data * b;
-        return res;
+        return matrix_stack<T, N1, N2>(a.data * b);
     }
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2> operator*(float a, matrix_stack<T, N1, N2> const& b)
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2> operator*(float a, matrix_stack<T, N1, N2> const& b)
     {
-        matrix_stack<T, N1, N2> res;
-        res.data = a * b.data;
-        return res;
+        return matrix_stack<T, N1, N2>(a * b.data);
     }
 
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>& operator/=(matrix_stack<T, N1, N2>& a, float b)
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>& operator/=(matrix_stack<T, N1, N2>& a, float b)
     {
         a.data /= b;
         return a;
     }
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2>  operator/(matrix_stack<T, N1, N2> const& a, float b)
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2>  operator/(matrix_stack<T, N1, N2> const& a, float b)
     {
-        matrix_stack<T, N1, N2> res;
-        res.data = a.data / b;
-        return res;
+        return matrix_stack<T, N1, N2>(a.data / b);
     }
 
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2> operator-(matrix_stack<T, N1, N2> const& m)
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2> operator-(matrix_stack<T, N1, N2> const& m)
     {
-        matrix_stack<T, N1, N2> res = m;
-        res *= -1.0f;
-        return res;
+        return matrix_stack<T, N1, N2>(m.data * -1.0f);
     }
 
-    template <typename T, int N1, int N2> matrix_stack<T, N1, N2> multiply_componentwise(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N1, N2> const& b)
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N1, N2> multiply_componentwise(matrix_stack<T, N1, N2> const& a, matrix_stack<T, N1, N2> const& b)
     {
-        matrix_stack<T, N1, N2> res;
-        res.data = a.data * b.data;
-        return res;
+        return matrix_stack<T, N1, N2>(a.data * b.data);
     }
 
-    template <typename T, int N1, int N2> numarray_stack<T, N1> operator*(matrix_stack<T, N1, N2> const& a, numarray_stack<T, N2> const& b)
+    template <typename T, int N1, int N2> constexpr numarray_stack<T, N1> operator*(matrix_stack<T, N1, N2> const& a, numarray_stack<T, N2> const& b)
     {
-        numarray_stack<T, N1> res = {};
-        for (int k1 = 0; k1 < N1; ++k1) {
-            auto& current = res.at_unsafe(k1);
-            for (int k2 = 0; k2 < N2; ++k2)
-                current += a.at(k1,k2) * b.at(k2);
-            res.at_unsafe(k1) = current;
-        }
-        return res;
+        return detail::product_vector(a, b, std::make_integer_sequence<int, N1>());
     }
 
-    template <typename T, int N1, int N2> matrix_stack<T, N2, N1> transpose(matrix_stack<T, N1, N2> const& m)
+    template <typename T, int N1, int N2> constexpr matrix_stack<T, N2, N1> transpose(matrix_stack<T, N1, N2> const& m)
     {
-        matrix_stack<T, N2, N1> res;
-        for (int k1 = 0; k1 < N1; ++k1)
-            for (int k2 = 0; k2 < N2; ++k2)
-                res(k2, k1) = m(k1, k2);
-        return res;
+        return detail::transpose(m, std::make_integer_sequence<int, N2>());
     }
 
 
@@ -756,23 +791,16 @@ namespace cgp
     }
 
     template <typename T, int N1, int N2>
-    matrix_stack<T, N1, N2> matrix_stack<T, N1, N2>::build_identity()
+    constexpr matrix_stack<T, N1, N2> matrix_stack<T, N1, N2>::build_identity()
     {
-        int const N = std::min(N1, N2);
-        matrix_stack<T, N1, N2> id = {};
-        for (int k = 0; k < N; ++k)
-            id.at_unsafe(k, k) = cgp_trait<T>::one();
-        return id;
+        constexpr int N = std::min(N1, N2);
+        return diagonal(detail::componentwise<T, N>([](T const&) { return cgp_trait<T>::one(); }, numarray_stack<T, N>{}));
     }
 
     template <typename T, int N1, int N2>
-    matrix_stack<T, N1, N2> matrix_stack<T, N1, N2>::diagonal(numarray_stack<T, std::min(N1, N2)> const& arg)
+    constexpr matrix_stack<T, N1, N2> matrix_stack<T, N1, N2>::diagonal(numarray_stack<T, std::min(N1, N2)> const& arg)
     {
-        int const N = std::min(N1, N2);
-        matrix_stack<T, N1, N2> m = {};
-        for (int k = 0; k < N; ++k)
-            m.at_unsafe(k, k) = arg[k];
-        return m;
+        return detail::diagonal<T, N1, N2>(arg, std::make_integer_sequence<int, N1>());
     }
 
     
@@ -783,17 +811,14 @@ namespace cgp
         T s{};
         for(int k1=0; k1<N1; ++k1)
             for(int k2=0; k2<N2; ++k2)
-                s += m.at_unsafe(k1,k2);
+                s += m.at(k1,k2) * m.at(k1,k2);
 
         return sqrt(s);
     }
 
-    template <typename T, int N> T trace(matrix_stack<T, N, N> const& m)
+    template <typename T, int N> constexpr T trace(matrix_stack<T, N, N> const& m)
     {
-        T s = {};
-        for (int k = 0; k < N; ++k)
-            s += m(k, k);
-        return s;
+        return detail::trace(m, std::make_integer_sequence<int, N>());
     }
 
     template <typename T, int N1, int N2>
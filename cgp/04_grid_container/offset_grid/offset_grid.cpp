@@ -6,26 +6,39 @@
 namespace cgp
 {
 
-	int2 index_grid_from_offset(int offset, int N1)
+	int2 index_grid_from_offset(int64_t offset, int N1)
 	{
-		int const k2 = offset / N1;
-		int const k1 = offset - k2 * N1;
-		return { k1,k2 };
+		int64_t const k2 = offset / N1;
+		int64_t const k1 = offset - k2 * N1;
+		return { int(k1), int(k2) };
 	}
-	int3 index_grid_from_offset(int offset, int N1, int N2)
+	int3 index_grid_from_offset(int64_t offset, int N1, int N2)
 	{
-		int const k3 = offset / (N1*N2);
-		int const k2 = (offset - N1 * N2 * k3) / N1;
-		int const k1 = offset - N1 * (N2 * k3 - k2);
+		long3 const k = index_grid_from_offset_long(offset, N1, N2);
+		return { int(k.x), int(k.y), int(k.z) };
+	}
+	long3 index_grid_from_offset_long(int64_t offset, int64_t N1, int64_t N2)
+	{
+		int64_t const k3 = offset / (N1 * N2);
+		int64_t const k2 = (offset - N1 * N2 * k3) / N1;
+		int64_t const k1 = offset - N1 * (k2 + N2 * k3);
 
 		return { k1,k2,k3 };
 	}
 
-	int offset_grid(int3 const& k, int N1, int N2)
+	int64_t offset_grid(int3 const& k, int N1, int N2)
+	{
+		return offset_grid(k.x, k.y, k.z, N1, N2);
+	}
+	int64_t offset_grid(long3 const& k, int64_t N1, int64_t N2)
 	{
 		return offset_grid(k.x, k.y, k.z, N1, N2);
 	}
-	int offset_grid(int2 const& k, int N1)
+	int64_t offset_grid(int2 const& k, int N1)
+	{
+		return offset_grid(k.x, k.y, N1);
+	}
+	int64_t offset_grid(long2 const& k, int64_t N1)
 	{
 		return offset_grid(k.x, k.y, N1);
 	}
@@ -2,6 +2,7 @@
 
 #include <tuple>
 #include <cstddef>
+#include <cstdint>
 
 #include "cgp/02_numarray/numarray_stack/numarray_stack.hpp"
 
@@ -15,20 +16,26 @@ namespace cgp
 	template <int N1> std::pair<int, int> index_grid_from_offset_stack(int offset);
 
 
+	// Offsets are computed with 64 bits integers: grids with more than 2^31 elements (such as 1400^3) don't overflow.
+
 	// 1D offset corresponding to the index (k1,k2) in a 2D grid
-	inline int offset_grid(int k1, int k2, int N1);
+	inline int64_t offset_grid(int64_t k1, int64_t k2, int64_t N1);
 	// 1D offset corresponding to the index (k1,k2) in a 2D grid
-	int offset_grid(int2 const& k, int N1);
+	int64_t offset_grid(int2 const& k, int N1);
+	int64_t offset_grid(long2 const& k, int64_t N1);
 
 	// 1D offset corresponding to the index (k1,k2,k3) in a 2D grid
-	inline int offset_grid(int k1, int k2, int k3, int N1, int N2);
+	inline int64_t offset_grid(int64_t k1, int64_t k2, int64_t k3, int64_t N1, int64_t N2);
 	// 1D offset corresponding to the index (k1,k2,k3) in a 2D grid
-	int offset_grid(int3 const& k, int N1, int N2);
+	int64_t offset_grid(int3 const& k, int N1, int N2);
+	int64_t offset_grid(long3 const& k, int64_t N1, int64_t N2);
 	
-	// Index (k1,k2) corresponding to a given offset in a 2D grid with static size
-	int2 index_grid_from_offset(int offset, int N1);
-	// Index (k1,k2,k3) corresponding to a given offset in a 3D grid with static size
-	int3 index_grid_from_offset(int offset, int N1, int N2);
+	// Index (k1,k2) corresponding to a given offset in a 2D grid
+	int2 index_grid_from_offset(int64_t offset, int N1);
+	// Index (k1,k2,k3) corresponding to a given offset in a 3D grid
+	int3 index_grid_from_offset(int64_t offset, int N1, int N2);
+	// Index (k1,k2,k3) corresponding to a given offset in a 3D grid with dimensions that may exceed 2^31 along an axis
+	long3 index_grid_from_offset_long(int64_t offset, int64_t N1, int64_t N2);
 
 }
 
@@ -47,11 +54,11 @@ namespace cgp
 		return { k1,k2 };
 	}
 
-	inline int offset_grid(int k1, int k2, int N1)
+	inline int64_t offset_grid(int64_t k1, int64_t k2, int64_t N1)
 	{
 		return k1 + N1 * k2;
 	}
-	inline int offset_grid(int k1, int k2, int k3, int N1, int N2)
+	inline int64_t offset_grid(int64_t k1, int64_t k2, int64_t k3, int64_t N1, int64_t N2)
 	{
 		return k1 + N1 * (k2 + N2 * k3);
 	}
@@ -16,38 +16,38 @@ namespace cgp
 	//   struct vec3 { float x, y, z; }
 	//   (with additional functions handled as a buffer_stack)
 
-	inline vec3 operator*(vec3 const& a, float w);
-	inline vec3 operator*(float w, vec3 const& a);
-	inline vec3& operator*=(vec3& a, float w);
-	inline vec3 operator/(vec3 const& a, float w);
-	inline vec3& operator/=(vec3& a, float w);
-	inline vec3 operator+(vec3 const& a, vec3 const& b);
-	inline vec3& operator+=(vec3& a, vec3 const& b);
-	inline vec3 operator-(vec3 const& a, vec3 const& b);
-	inline vec3& operator-=(vec3& a, vec3 const& b);
-	inline vec3 operator-(vec3 const& a);
-	inline float dot(vec3 const& a, vec3 const& b);
+	inline constexpr vec3 operator*(vec3 const& a, float w);
+	inline constexpr vec3 operator*(float w, vec3 const& a);
+	inline constexpr vec3& operator*=(vec3& a, float w);
+	inline constexpr vec3 operator/(vec3 const& a, float w);
+	inline constexpr vec3& operator/=(vec3& a, float w);
+	inline constexpr vec3 operator+(vec3 const& a, vec3 const& b);
+	inline constexpr vec3& operator+=(vec3& a, vec3 const& b);
+	inline constexpr vec3 operator-(vec3 const& a, vec3 const& b);
+	inline constexpr vec3& operator-=(vec3& a, vec3 const& b);
+	inline constexpr vec3 operator-(vec3 const& a);
+	inline constexpr float dot(vec3 const& a, vec3 const& b);
 	inline float norm(vec3 const& p);
-	inline vec3 cross(vec3 const& a, vec3 const& b);
+	inline constexpr vec3 cross(vec3 const& a, vec3 const& b);
 }
 
 namespace cgp
 {
 
-	inline vec3 operator*(vec3 const& a, float w) {
+	inline constexpr vec3 operator*(vec3 const& a, float w) {
 		vec3 p = a;
 		p *= w;
 
 		return p;
 	}
-	inline vec3 operator*(float w, vec3 const& a) {
+	inline constexpr vec3 operator*(float w, vec3 const& a) {
 		vec3 p = a;
 		p *= w;
 
 		return p;
 	}
 
-	inline vec3& operator*=(vec3& a, float w) {
+	inline constexpr vec3& operator*=(vec3& a, float w) {
 		a.x *= w;
 		a.y *= w;
 		a.z *= w;
@@ -55,14 +55,14 @@ namespace cgp
 		return a;
 	}
 
-	inline vec3 operator/(vec3 const& a, float w) {
+	inline constexpr vec3 operator/(vec3 const& a, float w) {
 		vec3 p = a;
 		p /= w;
 
 		return p;
 	}
 
-	inline vec3& operator/=(vec3& a, float w) {
+	inline constexpr vec3& operator/=(vec3& a, float w) {
 		a.x /= w;
 		a.y /= w;
 		a.z /= w;
@@ -70,14 +70,14 @@ namespace cgp
 		return a;
 	}
 
-	inline vec3 operator+(vec3 const& a, vec3 const& b) {
+	inline constexpr vec3 operator+(vec3 const& a, vec3 const& b) {
 		vec3 p = a;
 		p += b;
 
 		return p;
 	}
 
-	inline vec3& operator+=(vec3& a, vec3 const& b) {
+	inline constexpr vec3& operator+=(vec3& a, vec3 const& b) {
 		a.x += b.x; 
 		a.y += b.y;
 		a.z += b.z;
@@ -85,14 +85,14 @@ namespace cgp
 		return a;
 	}
 
-	inline vec3 operator-(vec3 const& a, vec3 const& b) {
+	inline constexpr vec3 operator-(vec3 const& a, vec3 const& b) {
 		vec3 p = a;
 		p -= b;
 
 		return p;
 	}
 
-	inline vec3& operator-=(vec3& a, vec3 const& b) {
+	inline constexpr vec3& operator-=(vec3& a, vec3 const& b) {
 		a.x -= b.x;
 		a.y -= b.y;
 		a.z -= b.z;
@@ -100,11 +100,11 @@ namespace cgp
 		return a;
 	}
 
-	inline vec3 operator-(vec3 const& a) {
+	inline constexpr vec3 operator-(vec3 const& a) {
 		return vec3(-a.x, -a.y, -a.z);
 	}
 
-	inline float dot(vec3 const& a, vec3 const& b) {
+	inline constexpr float dot(vec3 const& a, vec3 const& b) {
 		return a.x * b.x + a.y * b.y + a.z * b.z;
 	}
 
@@ -114,7 +114,7 @@ namespace cgp
 	}
 
 	
-	inline vec3 cross(vec3 const& a, vec3 const& b)
+	inline constexpr vec3 cross(vec3 const& a, vec3 const& b)
 	{
 		return vec3(
 			a.y * b.z - a.z * b.y,
@@ -13,14 +13,15 @@ namespace cgp
 	vec3 orthogonal_vector(vec3 const& v);
 
 	// Determinant of mat
-	float det(mat2 const& m);
-	float det(mat3 const& m);
-	float det(mat4 const& m);
+	constexpr float det(mat2 const& m);
+	constexpr float det(mat3 const& m);
+	constexpr float det(mat4 const& m);
 
 	// Compute inverse of mat (using determinants/Cramer rule)
-	mat2 inverse(mat2 const& m);
-	mat3 inverse(mat3 const& m);
-	mat4 inverse(mat4 const& m);
+	//  det and inverse are constexpr: they can be evaluated at compile time on constant matrices
+	constexpr mat2 inverse(mat2 const& m);
+	constexpr mat3 inverse(mat3 const& m);
+	constexpr mat4 inverse(mat4 const& m);
 
 	// Compute the matrix resulting from a * transpose(b)
 	mat2 tensor_product(vec2 const& a, vec2 const& b);
@@ -29,3 +30,130 @@ namespace cgp
 
 }
 
+
+
+namespace cgp
+{
+	namespace detail
+	{
+		// The determinant must be non null to compute the inverse (std::abs is not constexpr)
+		constexpr bool is_invertible_det(float d) { return d > 1e-5f || d < -1e-5f; }
+
+		// 2x2 minors of the two upper rows (s) and of the two lower rows (c) of a 4x4 matrix,
+		//  each minor being shared by several cofactors (instead of computing 16 independent 3x3 determinants)
+		struct mat4_minors
+		{
+			float s0, s1, s2, s3, s4, s5;
+			float c0, c1, c2, c3, c4, c5;
+
+			constexpr explicit mat4_minors(mat4 const& m)
+				: s0(get<0,0>(m)*get<1,1>(m) - get<1,0>(m)*get<0,1>(m))
+				, s1(get<0,0>(m)*get<1,2>(m) - get<1,0>(m)*get<0,2>(m))
+				, s2(get<0,0>(m)*get<1,3>(m) - get<1,0>(m)*get<0,3>(m))
+				, s3(get<0,1>(m)*get<1,2>(m) - get<1,1>(m)*get<0,2>(m))
+				, s4(get<0,1>(m)*get<1,3>(m) - get<1,1>(m)*get<0,3>(m))
+				, s5(get<0,2>(m)*get<1,3>(m) - get<1,2>(m)*get<0,3>(m))
+				, c0(get<2,0>(m)*get<3,1>(m) - get<3,0>(m)*get<2,1>(m))
+				, c1(get<2,0>(m)*get<3,2>(m) - get<3,0>(m)*get<2,2>(m))
+				, c2(get<2,0>(m)*get<3,3>(m) - get<3,0>(m)*get<2,3>(m))
+				, c3(get<2,1>(m)*get<3,2>(m) - get<3,1>(m)*get<2,2>(m))
+				, c4(get<2,1>(m)*get<3,3>(m) - get<3,1>(m)*get<2,3>(m))
+				, c5(get<2,2>(m)*get<3,3>(m) - get<3,2>(m)*get<2,3>(m))
+			{}
+
+			constexpr float det() const { return s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0; }
+		};
+	}
+
+	constexpr float det(mat2 const& m)
+	{
+		return get<0,0>(m)*get<1,1>(m) - get<0,1>(m)*get<1,0>(m);
+	}
+	constexpr float det(mat3 const& m)
+	{
+		float const xx = get<0,0>(m);
+		float const xy = get<0,1>(m);
+		float const xz = get<0,2>(m);
+
+		float const yx = get<1,0>(m);
+		float const yy = get<1,1>(m);
+		float const yz = get<1,2>(m);
+
+		float const zx = get<2,0>(m);
+		float const zy = get<2,1>(m);
+		float const zz = get<2,2>(m);
+
+		return xx*yy*zz + xy*yz*zx + yx*zy*xz - (zx*yy*xz + zy*yz*xx + yx*xy*zz);
+	}
+	constexpr float det(mat4 const& m)
+	{
+		return detail::mat4_minors(m).det();
+	}
+
+	constexpr mat2 inverse(mat2 const& m)
+	{
+		float const d = det(m);
+		assert_cgp( detail::is_invertible_det(d) , "Determinant is null");
+
+		return mat2(get<1,1>(m)/d, -get<0,1>(m)/d,
+			-get<1,0>(m)/d, get<0,0>(m)/d);
+	}
+	constexpr mat3 inverse(mat3 const& m)
+	{
+		float const d = det(m);
+		assert_cgp( detail::is_invertible_det(d) , "Determinant is null");
+
+		/** xx xy xz
+		    yx yy yz
+			zx zy zz 	*/
+		float const xx = get<0,0>(m);
+		float const xy = get<0,1>(m);
+		float const xz = get<0,2>(m);
+
+		float const yx = get<1,0>(m);
+		float const yy = get<1,1>(m);
+		float const yz = get<1,2>(m);
+
+		float const zx = get<2,0>(m);
+		float const zy = get<2,1>(m);
+		float const zz = get<2,2>(m);
+
+		float const x00 =   yy*zz-zy*yz;
+		float const x10 = -(yx*zz-zx*yz);
+		float const x20 =   yx*zy-zx*yy;
+
+		float const x01 =  -(xy*zz-zy*xz);
+		float const x11 =    xx*zz-zx*xz;
+		float const x21 =  -(xx*zy-zx*xy);
+
+		float const x02 =    xy*yz-yy*xz;
+		float const x12 =  -(xx*yz-yx*xz);
+		float const x22 =    xx*yy-yx*xy;
+
+		return mat3(x00/d, x01/d, x02/d,
+			x10/d, x11/d, x12/d,
+			x20/d, x21/d, x22/d);
+	}
+	constexpr mat4 inverse(mat4 const& m)
+	{
+		float const a00=get<0,0>(m), a01=get<0,1>(m), a02=get<0,2>(m), a03=get<0,3>(m);
+		float const a10=get<1,0>(m), a11=get<1,1>(m), a12=get<1,2>(m), a13=get<1,3>(m);
+		float const a20=get<2,0>(m), a21=get<2,1>(m), a22=get<2,2>(m), a23=get<2,3>(m);
+		float const a30=get<3,0>(m), a31=get<3,1>(m), a32=get<3,2>(m), a33=get<3,3>(m);
+
+		detail::mat4_minors const minors(m);
+		float const s0=minors.s0, s1=minors.s1, s2=minors.s2, s3=minors.s3, s4=minors.s4, s5=minors.s5;
+		float const c0=minors.c0, c1=minors.c1, c2=minors.c2, c3=minors.c3, c4=minors.c4, c5=minors.c5;
+
+		float const d = minors.det();
+		assert_cgp( detail::is_invertible_det(d) , "Determinant is null");
+		float const inv_d = 1.0f/d;
+
+		return mat4(
+			( a11*c5 - a12*c4 + a13*c3)*inv_d, (-a01*c5 + a02*c4 - a03*c3)*inv_d, ( a31*s5 - a32*s4 + a33*s3)*inv_d, (-a21*s5 + a22*s4 - a23*s3)*inv_d,
+			(-a10*c5 + a12*c2 - a13*c1)*inv_d, ( a00*c5 - a02*c2 + a03*c1)*inv_d, (-a30*s5 + a32*s2 - a33*s1)*inv_d, ( a20*s5 - a22*s2 + a23*s1)*inv_d,
+			( a10*c4 - a11*c2 + a13*c0)*inv_d, (-a00*c4 + a01*c2 - a03*c0)*inv_d, ( a30*s4 - a31*s2 + a33*s0)*inv_d, (-a20*s4 + a21*s2 - a23*s0)*inv_d,
+			(-a10*c3 + a11*c1 - a12*c0)*inv_d, ( a00*c3 - a01*c1 + a02*c0)*inv_d, (-a30*s3 + a31*s1 - a32*s0)*inv_d, ( a20*s3 - a21*s1 + a22*s0)*inv_d);
+	}
+}
+
@@ -23,6 +23,8 @@ namespace cgp_test
 			assert_cgp_no_msg( is_equal(det(a),44.385f) );
 			assert_cgp_no_msg( is_equal(inverse(a),mat3{0.011716f,0.159964f,0.158837f, 0.321280f,-0.228681f,0.125042f, 0.202546f,0.073223f,-0.138560f}) );
 			assert_cgp_no_msg( is_equal(inverse(a)*a, mat3::build_identity()) );
+			assert_cgp_no_msg( norm(inverse(a)*a - mat3::build_identity())<1e-5f );
+			assert_cgp_no_msg( is_equal(norm(mat3::build_diagonal(vec3{1.0f,2.0f,2.0f})), 3.0f) );
 		}
 
 		//det and inverse mat4
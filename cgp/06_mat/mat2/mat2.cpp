@@ -5,37 +5,6 @@
 
 namespace cgp
 {
-    mat2::matrix_stack()
-        :data()
-    {}
-    mat2::matrix_stack(numarray_stack<vec2, 2> const& elements)
-        : data(elements)
-    {}
-    mat2::matrix_stack(vec2 const& row_1, vec2 const& row_2)
-        : data({ row_1,row_2 })
-    {}
-    mat2::matrix_stack(numarray_stack<float, 4> const& elements)
-        : data({
-            vec2{ get<0>(elements),get<1>(elements) },
-            vec2{ get<2>(elements),get<3>(elements) } })
-    {}
-    mat2::matrix_stack(
-        float xx, float xy,
-        float yx, float yy)
-        : data({ vec2{xx,xy},vec2{yx,yy} })
-    {}
-
-
-    mat2::matrix_stack(float value)
-        :data({
-        vec2(value,0),
-        vec2(0,value) })
-    {}
-    mat2::matrix_stack(float xx, float yy)
-        :data({
-        vec2(xx,0),
-        vec2(0,yy) })
-    {}
     mat2::matrix_stack(std::initializer_list<float> const& arg)
         :data()
     {
@@ -116,7 +85,6 @@ namespace cgp
 
 
     
-    mat2 mat2::build_identity() {return mat2(1, 0, 0, 1); }
     mat2 mat2::build_constant(float value) { return mat2(value, value, value, value); }
 
     
@@ -29,11 +29,11 @@ namespace cgp
         // ******************************************************* //
         //  Constructors
         // ******************************************************* //
-        matrix_stack();
-        matrix_stack(numarray_stack<vec2, 2> const& elements);
-        matrix_stack(vec2 const& row_1, vec2 const& row_2);
-        matrix_stack(numarray_stack<float, 4> const& elements);
-        matrix_stack(
+        constexpr matrix_stack();
+        constexpr matrix_stack(numarray_stack<vec2, 2> const& elements);
+        constexpr matrix_stack(vec2 const& row_1, vec2 const& row_2);
+        constexpr matrix_stack(numarray_stack<float, 4> const& elements);
+        constexpr matrix_stack(
             float xx, float xy, 
             float yx, float yy);
 
@@ -43,8 +43,8 @@ namespace cgp
         explicit matrix_stack(matrix_stack<float, N1_arg, N2_arg> const& M);
 
         // Build as a diagonal matrix (glm compatibility)
-        explicit matrix_stack(float value);
-        explicit matrix_stack(float xx, float yy);
+        constexpr explicit matrix_stack(float value);
+        constexpr explicit matrix_stack(float xx, float yy);
 
         matrix_stack(std::initializer_list<float> const& arg);
         matrix_stack(std::initializer_list<vec2> const& arg);
@@ -67,7 +67,7 @@ namespace cgp
         // ******************************************************* //
 
         // Build the identity matrix
-        static mat2 build_identity();
+        static constexpr mat2 build_identity();
 
         // Build a matrix filled with a single value
         static mat2 build_constant(float value);
@@ -130,6 +130,34 @@ namespace cgp
 
 namespace cgp
 {
+    constexpr mat2::matrix_stack()
+        :data()
+    {}
+    constexpr mat2::matrix_stack(numarray_stack<vec2, 2> const& elements)
+        : data(elements)
+    {}
+    constexpr mat2::matrix_stack(vec2 const& row_1, vec2 const& row_2)
+        : data(row_1, row_2)
+    {}
+    constexpr mat2::matrix_stack(numarray_stack<float, 4> const& elements)
+        : data(
+            vec2(get<0>(elements), get<1>(elements)),
+            vec2(get<2>(elements), get<3>(elements)))
+    {}
+    constexpr mat2::matrix_stack(
+        float xx, float xy,
+        float yx, float yy)
+        : data(vec2(xx, xy), vec2(yx, yy))
+    {}
+    constexpr mat2::matrix_stack(float value)
+        : data(vec2(value, 0), vec2(0, value))
+    {}
+    constexpr mat2::matrix_stack(float xx, float yy)
+        : data(vec2(xx, 0), vec2(0, yy))
+    {}
+
+    constexpr mat2 mat2::build_identity() { return mat2(1, 0, 0, 1); }
+
     // Construct from a matrix with different size.
     //  Consider the min between (N1,N1_arg) and (N2,N2_arg)
     template <int N1_arg, int N2_arg>
@@ -3,42 +3,13 @@
 #include "mat4.hpp"
 #include "cgp/09_geometric_transformation/rotation_transform/rotation_transform.hpp"
 
+#if (defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64)) && !defined(CGP_NO_SIMD)
+#define CGP_MAT4_SSE
+#include <xmmintrin.h>
+#endif
+
 namespace cgp
 {
-    mat4::matrix_stack()
-        :data()
-    {}
-
-    mat4::matrix_stack(numarray_stack< vec4, 4> const& elements)
-        : data(elements)
-    {}
-
-    mat4::matrix_stack(vec4 const& row_1, vec4 const& row_2, vec4 const& row_3, vec4 const& row_4)
-        :data({ row_1,row_2,row_3,row_4 })
-    {}
-
-    mat4::matrix_stack(numarray_stack<float, 16> const& elements)
-        : data({
-            vec4{ get<0>(elements),get<1>(elements),get<2>(elements),get<3>(elements)},
-            vec4{ get<4>(elements),get<5>(elements),get<6>(elements),get<7>(elements)},
-            vec4{ get<8>(elements),get<9>(elements),get<10>(elements),get<11>(elements)},
-            vec4{ get<12>(elements),get<13>(elements),get<14>(elements),get<15>(elements)} })
-    {}
-
-
-    mat4::matrix_stack(
-        float xx, float xy, float xz, float xw,
-        float yx, float yy, float yz, float yw,
-        float zx, float zy, float zz, float zw,
-        float wx, float wy, float wz, float ww)
-        : data(
-            vec4(xx, xy, xz, xw),
-            vec4(yx, yy, yz, yw),
-            vec4(zx, zy, zz, zw),
-            vec4(wx, wy, wz, ww)
-        )
-    {}
-
     mat4::matrix_stack(mat3 const& M)
         :data({
         vec4(get<0,0>(M), get<0,1>(M), get<0,2>(M), 0),
@@ -47,23 +18,6 @@ namespace cgp
         vec4(0, 0, 0, 1) })
     {}
 
-    mat4::matrix_stack(float value)
-        :data({
-        vec4(value,0,0,0),
-        vec4(0,value,0,0),
-        vec4(0,0,value,0),
-        vec4(0,0,0,value) })
-    {}
-
-    mat4::matrix_stack(float xx, float yy, float zz, float ww)
-        :data({
-        vec4(xx,0,0,0),
-        vec4(0,yy,0,0),
-        vec4(0,0,zz,0),
-        vec4(0,0,0,ww) })
-    {}
-
-
     mat4::matrix_stack(std::initializer_list<float> const& arg)
         :data()
     {
@@ -115,23 +69,6 @@ namespace cgp
 
 
 
-    mat4 matrix_stack<float, 4, 4>::build_identity()
-    {
-        return matrix_stack<float, 4, 4>{
-            1.0f, 0.0f, 0.0f, 0.0f,
-            0.0f, 1.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 1.0f, 0.0f,
-            0.0f, 0.0f, 0.0f, 1.0f};
-    }
-    mat4 matrix_stack<float, 4, 4>::build_zero()
-    {
-        return matrix_stack<float, 4, 4>{
-            0.0f, 0.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 0.0f, 0.0f};
-    }
-
     mat4 matrix_stack<float, 4, 4>::build_constant(float value)
     {
         return matrix_stack<float, 4, 4>{
@@ -472,6 +409,76 @@ namespace cgp
     }
 
 
+#ifdef CGP_MAT4_SSE
+    // The SSE versions compute the sums in the same order as the scalar code: the results are identical.
+    namespace
+    {
+        // Row k of a*b: a(k,0)*b_row0 + a(k,1)*b_row1 + a(k,2)*b_row2 + a(k,3)*b_row3
+        inline __m128 product_row(float const* a_row, __m128 b0, __m128 b1, __m128 b2, __m128 b3)
+        {
+            __m128 r = _mm_mul_ps(_mm_set1_ps(a_row[0]), b0);
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a_row[1]), b1));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a_row[2]), b2));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a_row[3]), b3));
+            return r;
+        }
+    }
+
+    mat4 operator*(mat4 const& a, mat4 const& b)
+    {
+        float const* pa = a.begin();
+        float const* pb = b.begin();
+        __m128 const b0 = _mm_loadu_ps(pb);
+        __m128 const b1 = _mm_loadu_ps(pb + 4);
+        __m128 const b2 = _mm_loadu_ps(pb + 8);
+        __m128 const b3 = _mm_loadu_ps(pb + 12);
+
+        mat4 res;
+        float* pr = res.begin();
+        _mm_storeu_ps(pr,      product_row(pa,      b0, b1, b2, b3));
+        _mm_storeu_ps(pr + 4,  product_row(pa + 4,  b0, b1, b2, b3));
+        _mm_storeu_ps(pr + 8,  product_row(pa + 8,  b0, b1, b2, b3));
+        _mm_storeu_ps(pr + 12, product_row(pa + 12, b0, b1, b2, b3));
+        return res;
+    }
+    mat4& operator*=(mat4& a, mat4 const& b)
+    {
+        a = a * b;
+        return a;
+    }
+    vec4 operator*(mat4 const& M, vec4 const& v)
+    {
+        float const* pM = M.begin();
+        __m128 r0 = _mm_mul_ps(_mm_loadu_ps(pM), _mm_loadu_ps(&v.x));
+        __m128 r1 = _mm_mul_ps(_mm_loadu_ps(pM + 4), _mm_loadu_ps(&v.x));
+        __m128 r2 = _mm_mul_ps(_mm_loadu_ps(pM + 8), _mm_loadu_ps(&v.x));
+        __m128 r3 = _mm_mul_ps(_mm_loadu_ps(pM + 12), _mm_loadu_ps(&v.x));
+        // Column j now contains the products M(k,j)*v[j] of the row k
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        __m128 const r = _mm_add_ps(_mm_add_ps(_mm_add_ps(r0, r1), r2), r3);
+
+        vec4 res;
+        _mm_storeu_ps(&res.x, r);
+        return res;
+    }
+    mat4 transpose(mat4 const& M)
+    {
+        float const* pM = M.begin();
+        __m128 r0 = _mm_loadu_ps(pM);
+        __m128 r1 = _mm_loadu_ps(pM + 4);
+        __m128 r2 = _mm_loadu_ps(pM + 8);
+        __m128 r3 = _mm_loadu_ps(pM + 12);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        mat4 res;
+        float* pr = res.begin();
+        _mm_storeu_ps(pr, r0);
+        _mm_storeu_ps(pr + 4, r1);
+        _mm_storeu_ps(pr + 8, r2);
+        _mm_storeu_ps(pr + 12, r3);
+        return res;
+    }
+#else
     mat4 operator*(mat4 const& a, mat4 const& b)
     {
         float const axx=get<0,0>(a), axy=get<0,1>(a), axz=get<0,2>(a), axw=get<0,3>(a);
@@ -491,6 +498,25 @@ namespace cgp
             awx*bxx+awy*byx+awz*bzx+aww*bwx, awx*bxy+awy*byy+awz*bzy+aww*bwy, awx*bxz+awy*byz+awz*bzz+aww*bwz, awx*bxw+awy*byw+awz*bzw+aww*bww
         };
     }
+    vec4 operator*(mat4 const& M, vec4 const& v)
+    {
+        return vec4{
+            get<0,0>(M)*v.x + get<0,1>(M)*v.y + get<0,2>(M)*v.z + get<0,3>(M)*v.w,
+            get<1,0>(M)*v.x + get<1,1>(M)*v.y + get<1,2>(M)*v.z + get<1,3>(M)*v.w,
+            get<2,0>(M)*v.x + get<2,1>(M)*v.y + get<2,2>(M)*v.z + get<2,3>(M)*v.w,
+            get<3,0>(M)*v.x + get<3,1>(M)*v.y + get<3,2>(M)*v.z + get<3,3>(M)*v.w
+        };
+    }
+    mat4 transpose(mat4 const& M)
+    {
+        return mat4{
+            get<0,0>(M), get<1,0>(M), get<2,0>(M), get<3,0>(M),
+            get<0,1>(M), get<1,1>(M), get<2,1>(M), get<3,1>(M),
+            get<0,2>(M), get<1,2>(M), get<2,2>(M), get<3,2>(M),
+            get<0,3>(M), get<1,3>(M), get<2,3>(M), get<3,3>(M)
+        };
+    }
+#endif
     mat4 operator*(float s, mat4 const& M)
     {
         return mat4{
@@ -500,6 +526,7 @@ namespace cgp
             s*get<3,0>(M), s*get<3,1>(M), s*get<3,2>(M), s*get<3,3>(M),
         };
     }
+#ifndef CGP_MAT4_SSE
     mat4& operator*=(mat4& a, mat4 const& b)
     {
         float* pa = a.begin();
@@ -537,6 +564,7 @@ namespace cgp
 
         return a;
     }
+#endif
     mat4& operator*=(mat4& M, float s)
     {
         float* pM = M.begin();
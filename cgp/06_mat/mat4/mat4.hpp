@@ -36,11 +36,11 @@ namespace cgp
         // ******************************************************* //
         //  Constructors
         // ******************************************************* //
-        matrix_stack();
-        matrix_stack(numarray_stack< numarray_stack<float, 4>, 4> const& elements);
-        matrix_stack(vec4 const& row_1, vec4 const& row_2, vec4 const& row_3, vec4 const& row_4);
-        matrix_stack(numarray_stack<float, 16> const& elements);
-        matrix_stack(
+        constexpr matrix_stack();
+        constexpr matrix_stack(numarray_stack< numarray_stack<float, 4>, 4> const& elements);
+        constexpr matrix_stack(vec4 const& row_1, vec4 const& row_2, vec4 const& row_3, vec4 const& row_4);
+        constexpr matrix_stack(numarray_stack<float, 16> const& elements);
+        constexpr matrix_stack(
             float xx, float xy, float xz, float xw,
             float yx, float yy, float yz, float yw,
             float zx, float zy, float zz, float zw,
@@ -58,8 +58,8 @@ namespace cgp
         explicit matrix_stack(matrix_stack<float, N1_arg, N2_arg> const& M);
 
         // Build as a diagonal matrix (glm compatibility)
-        explicit matrix_stack(float value);
-        explicit matrix_stack(float xx, float yy, float zz, float ww=1.0f);
+        constexpr explicit matrix_stack(float value);
+        constexpr explicit matrix_stack(float xx, float yy, float zz, float ww=1.0f);
 
         matrix_stack(std::initializer_list<float> const& arg);
         matrix_stack(std::initializer_list<numarray_stack<float, 4> > const& arg);
@@ -71,9 +71,9 @@ namespace cgp
         // ******************************************************* //
 
         // Build the identity matrix
-        static mat4 build_identity();
+        static constexpr mat4 build_identity();
         // Build a zero matrix (similar to default constructor)
-        static mat4 build_zero();
+        static constexpr mat4 build_zero();
 
         // Build a matrix filled with a single value
         static mat4 build_constant(float value);
@@ -262,16 +262,69 @@ namespace cgp
     };
 
     mat4 operator*(mat4 const& a, mat4 const& b);
+    vec4 operator*(mat4 const& M, vec4 const& v);
     mat4 operator*(float s, mat4 const& M);
     mat4& operator*=(mat4& a, mat4 const& b); // a = a*b
     mat4& operator*=(mat4& M, float s);
     mat4& operator+=(mat4& a, mat4 const& b);
+    mat4 transpose(mat4 const& M);
 
 }
 
 
 namespace cgp
 {
+    constexpr mat4::matrix_stack()
+        :data()
+    {}
+    constexpr mat4::matrix_stack(numarray_stack< vec4, 4> const& elements)
+        : data(elements)
+    {}
+    constexpr mat4::matrix_stack(vec4 const& row_1, vec4 const& row_2, vec4 const& row_3, vec4 const& row_4)
+        : data(row_1, row_2, row_3, row_4)
+    {}
+    constexpr mat4::matrix_stack(numarray_stack<float, 16> const& elements)
+        : data(
+            vec4(get<0>(elements), get<1>(elements), get<2>(elements), get<3>(elements)),
+            vec4(get<4>(elements), get<5>(elements), get<6>(elements), get<7>(elements)),
+            vec4(get<8>(elements), get<9>(elements), get<10>(elements), get<11>(elements)),
+            vec4(get<12>(elements), get<13>(elements), get<14>(elements), get<15>(elements)))
+    {}
+    constexpr mat4::matrix_stack(
+        float xx, float xy, float xz, float xw,
+        float yx, float yy, float yz, float yw,
+        float zx, float zy, float zz, float zw,
+        float wx, float wy, float wz, float ww)
+        : data(
+            vec4(xx, xy, xz, xw),
+            vec4(yx, yy, yz, yw),
+            vec4(zx, zy, zz, zw),
+            vec4(wx, wy, wz, ww))
+    {}
+    constexpr mat4::matrix_stack(float value)
+        : data(vec4(value, 0, 0, 0), vec4(0, value, 0, 0), vec4(0, 0, value, 0), vec4(0, 0, 0, value))
+    {}
+    constexpr mat4::matrix_stack(float xx, float yy, float zz, float ww)
+        : data(vec4(xx, 0, 0, 0), vec4(0, yy, 0, 0), vec4(0, 0, zz, 0), vec4(0, 0, 0, ww))
+    {}
+
+    constexpr mat4 mat4::build_identity()
+    {
+        return mat4(
+            1.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 1.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 1.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 1.0f);
+    }
+    constexpr mat4 mat4::build_zero()
+    {
+        return mat4(
+            0.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f);
+    }
+
     template <int N1_arg, int N2_arg>
     matrix_stack<float, 4, 4>::matrix_stack(matrix_stack<float, N1_arg, N2_arg> const& M)
         :data()
@@ -329,6 +329,64 @@ namespace cgp_test
 			assert_cgp_no_msg(is_equal(M2b, mat2{ 2,0, 0,2 }));
 			assert_cgp_no_msg(is_equal(M3b, mat2{ 2,0, 0,3 }));
 		}
+		// mat4 products, transpose and inverse (specialized kernels) against the scalar expressions
+		{
+			using namespace cgp;
+
+			mat4 A = { 1.5f,-2,0.25f,3,  0.5f,4,-1,2,  -3,0.75f,2,1,  1,-1,0.5f,5 };
+			mat4 B = { 2,1,0,-1,  0.5f,3,1,2,  1,-2,4,0.25f,  -1,0,1,3 };
+			vec4 v = { 1,-2,0.5f,3 };
+
+			mat4 AB_generic;
+			vec4 Av_generic;
+			for (int i = 0; i < 4; ++i) {
+				Av_generic[i] = A(i,0)*v[0] + A(i,1)*v[1] + A(i,2)*v[2] + A(i,3)*v[3];
+				for (int j = 0; j < 4; ++j)
+					AB_generic(i,j) = A(i,0)*B(0,j) + A(i,1)*B(1,j) + A(i,2)*B(2,j) + A(i,3)*B(3,j);
+			}
+
+			mat4 AB = A*B;
+			vec4 Av = A*v;
+			for (int i = 0; i < 4; ++i) {
+				assert_cgp_no_msg(Av[i] == Av_generic[i]);
+				for (int j = 0; j < 4; ++j)
+					assert_cgp_no_msg(AB(i,j) == AB_generic(i,j));
+			}
+			mat4 C = A;
+			C *= B;
+			assert_cgp_no_msg(is_equal(C, AB));
+
+			mat4 At = transpose(A);
+			for (int i = 0; i < 4; ++i)
+				for (int j = 0; j < 4; ++j)
+					assert_cgp_no_msg(At(i,j) == A(j,i));
+
+			assert_cgp_no_msg(is_equal(inverse(A)*A, mat4::build_identity()));
+			assert_cgp_no_msg(is_equal(B*inverse(B), mat4::build_identity()));
+		}
+		// compile-time evaluation of the matrix operations
+		{
+			using namespace cgp;
+
+			constexpr mat3 A(2,1,0, 0,1,3, 4,0,1);
+			static_assert(det(A) == 14.0f, "constexpr det(mat3)");
+			constexpr vec3 Av = A*vec3(1,2,3);
+			static_assert(Av.x == 4.0f && Av.y == 11.0f && Av.z == 7.0f, "constexpr mat3*vec3");
+			constexpr mat3 I = A*inverse(A);
+			static_assert(get<0,0>(I) > 0.9999f && get<0,0>(I) < 1.0001f && get<0,1>(I) > -1e-5f && get<0,1>(I) < 1e-5f, "constexpr inverse(mat3)");
+			static_assert(get<1,0>(transpose(A)) == 1.0f && trace(A) == 4.0f, "constexpr transpose/trace");
+
+			constexpr mat4 M(2,0,0,1, 0,3,0,2, 0,0,4,3, 0,0,0,1);
+			static_assert(det(M) == 24.0f && get<0,3>(inverse(M)) == -0.5f, "constexpr det/inverse(mat4)");
+			static_assert(get<1,0>(inverse(mat2(1,2,3,4))) == 1.5f, "constexpr inverse(mat2)");
+
+			constexpr matrix_stack<float, 5, 5> G = matrix_stack<float, 5, 5>::build_identity()*3.0f;
+			static_assert(trace(G*G) == 45.0f, "constexpr generic matrix_stack product");
+
+			// Same values at run time
+			assert_cgp_no_msg(is_equal(inverse(A), inverse(mat3{ 2,1,0, 0,1,3, 4,0,1 })));
+			assert_cgp_no_msg(is_equal(det(M), det(mat4{ 2,0,0,1, 0,3,0,2, 0,0,4,3, 0,0,0,1 })));
+		}
 
 
 	}
@@ -5,4 +5,6 @@
 #include "interpolation/interpolation.hpp"
 #include "projection/projection.hpp"
 #include "quaternion/quaternion.hpp"
+#include "rotation_batch/rotation_batch.hpp"
 #include "rotation_transform/rotation_transform.hpp"
+#include "transform_points/transform_points.hpp"
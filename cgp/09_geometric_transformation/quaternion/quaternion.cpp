@@ -1,5 +1,6 @@
 #include "cgp/01_base/base.hpp"
 #include "quaternion.hpp"
+#include <cmath>
 #include <iostream>
 
 namespace cgp
@@ -97,6 +98,35 @@ namespace cgp
         return q/norm(q);
     }
 
+    quaternion nlerp(quaternion const& q1, quaternion const& q2, float alpha)
+    {
+        quaternion q = dot(q1, q2) < 0 ?
+            (1.0f - alpha) * q1 - alpha * q2 :
+            (1.0f - alpha) * q1 + alpha * q2;
+        return q / norm(q);
+    }
+
+    quaternion slerp(quaternion const& q1, quaternion const& q2, float alpha)
+    {
+        float d = dot(q1, q2);
+        float const sign = d < 0 ? -1.0f : 1.0f;
+        d = sign * d;
+
+        // q = w1 q1 + w2 q2, with w1 = sin((1-alpha) theta)/sin(theta), w2 = sin(alpha theta)/sin(theta), and cos(theta) = dot(q1,q2)
+        //  Very close quaternions use the linear weights (avoids the division by sin(theta)~0)
+        float w1 = 1.0f - alpha;
+        float w2 = alpha;
+        if (d < 0.9995f) {
+            float const theta = std::acos(d);
+            float const s = std::sin(theta);
+            w1 = std::sin((1.0f - alpha) * theta) / s;
+            w2 = std::sin(alpha * theta) / s;
+        }
+
+        quaternion const q = w1 * q1 + (sign * w2) * q2;
+        return q / norm(q);
+    }
+
     std::istream& operator>>(std::istream& stream, quaternion& data)
     {
         stream >> data.x;
@@ -31,5 +31,11 @@ namespace cgp
 
     quaternion normalize(quaternion const& q);
 
+    // Interpolation between unit quaternions q1 (alpha=0) and q2 (alpha=1) along the shortest path (q2 and -q2 represent the same rotation)
+    //  nlerp: normalized linear interpolation - fast, but the angular velocity is not constant
+    //  slerp: spherical linear interpolation - constant angular velocity
+    quaternion nlerp(quaternion const& q1, quaternion const& q2, float alpha);
+    quaternion slerp(quaternion const& q1, quaternion const& q2, float alpha);
+
 	std::istream& operator>>(std::istream& stream, quaternion& data);
 }
\ No newline at end of file
@@ -0,0 +1,313 @@
+#include "cgp/01_base/base.hpp"
+#include "rotation_batch.hpp"
+
+#include <algorithm>
+
+#if (defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64)) && !defined(CGP_NO_SIMD)
+#define CGP_ROTATION_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace cgp
+{
+	namespace
+	{
+		// The batched functions work on quaternions, and on rotation_transform (storing a unit quaternion)
+		quaternion const& quaternion_of(quaternion const& q) { return q; }
+		quaternion const& quaternion_of(rotation_transform const& r) { return r.data; }
+		quaternion& quaternion_of(quaternion& q) { return q; }
+		quaternion& quaternion_of(rotation_transform& r) { return r.data; }
+
+		struct alpha_constant
+		{
+			float value;
+			float operator()(size_t) const { return value; }
+		};
+		struct alpha_per_element
+		{
+			numarray_view<float const> value;
+			float operator()(size_t k) const { return value.at(k); }
+		};
+
+		// Call f(k, count) on the groups of 4 consecutive elements [k, k+count[ (count<4 for the last group only)
+		//  The chunks of parallel_for have a size multiple of 4: the groups are the same whatever the number of threads.
+		template <typename F> void for_each_group_of_4(size_t N, F const& f)
+		{
+			parallel_for(int64_t(N), [&](int64_t begin, int64_t end) {
+				for (int64_t k = begin; k < end; k += 4)
+					f(size_t(k), int(std::min(int64_t(4), end - k)));
+			});
+		}
+
+#ifdef CGP_ROTATION_SSE
+		// Components of 4 quaternions, one quaternion per lane
+		struct quaternion_x4
+		{
+			__m128 x, y, z, w;
+		};
+
+		quaternion_x4 load_x4(float const* const p[4])
+		{
+			quaternion_x4 q = { _mm_loadu_ps(p[0]), _mm_loadu_ps(p[1]), _mm_loadu_ps(p[2]), _mm_loadu_ps(p[3]) };
+			_MM_TRANSPOSE4_PS(q.x, q.y, q.z, q.w);
+			return q;
+		}
+		void store_x4(quaternion_x4 q, float* const p[4])
+		{
+			_MM_TRANSPOSE4_PS(q.x, q.y, q.z, q.w);
+			_mm_storeu_ps(p[0], q.x);
+			_mm_storeu_ps(p[1], q.y);
+			_mm_storeu_ps(p[2], q.z);
+			_mm_storeu_ps(p[3], q.w);
+		}
+
+		// mask ? a : b (per lane)
+		__m128 select(__m128 mask, __m128 a, __m128 b)
+		{
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+		}
+
+		// Same order of the operations as dot(vec4,vec4)
+		__m128 dot_x4(quaternion_x4 const& a, quaternion_x4 const& b)
+		{
+			__m128 d = _mm_mul_ps(a.x, b.x);
+			d = _mm_add_ps(d, _mm_mul_ps(a.y, b.y));
+			d = _mm_add_ps(d, _mm_mul_ps(a.z, b.z));
+			d = _mm_add_ps(d, _mm_mul_ps(a.w, b.w));
+			return d;
+		}
+
+		// normalize(w1 q1 + w2 q2)
+		quaternion_x4 normalized_combination_x4(__m128 w1, quaternion_x4 const& q1, __m128 w2, quaternion_x4 const& q2)
+		{
+			quaternion_x4 q = {
+				_mm_add_ps(_mm_mul_ps(w1, q1.x), _mm_mul_ps(w2, q2.x)),
+				_mm_add_ps(_mm_mul_ps(w1, q1.y), _mm_mul_ps(w2, q2.y)),
+				_mm_add_ps(_mm_mul_ps(w1, q1.z), _mm_mul_ps(w2, q2.z)),
+				_mm_add_ps(_mm_mul_ps(w1, q1.w), _mm_mul_ps(w2, q2.w)) };
+			__m128 const n = _mm_sqrt_ps(dot_x4(q, q));
+			q.x = _mm_div_ps(q.x, n);
+			q.y = _mm_div_ps(q.y, n);
+			q.z = _mm_div_ps(q.z, n);
+			q.w = _mm_div_ps(q.w, n);
+			return q;
+		}
+
+		// sin(x): reduction to r = x - j pi/2 in [-pi/4,pi/4] (pi/2 split in 3 parts to keep the precision of r), and polynomial approximations of sin and cos on [-pi/4,pi/4] (Cephes sinf/cosf)
+		//  Any x is accepted (slerp with a coefficient alpha outside [0,1] extrapolates the rotation and evaluates sin(alpha theta) for any angle)
+		__m128 sin_x4(__m128 x)
+		{
+			// (v + 1.5 2^23) - 1.5 2^23 rounds v to the nearest integer (|v| < 2^22)
+			__m128 const round_magic = _mm_set1_ps(12582912.0f);
+			__m128 const one = _mm_set1_ps(1.0f);
+			__m128 const j = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(2.0f / Pi)), round_magic), round_magic);
+			__m128 r = _mm_sub_ps(x, _mm_mul_ps(j, _mm_set1_ps(1.5703125f)));
+			r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(4.837512969970703125e-4f)));
+			r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(7.54978995489188216e-8f)));
+
+			// Quadrant q = j mod 4: sin(x) = sin(r), cos(r), -sin(r), -cos(r) for q = 0, 1, 2, 3
+			__m128 const j_4 = _mm_mul_ps(j, _mm_set1_ps(0.25f));
+			__m128 j_4_floor = _mm_sub_ps(_mm_add_ps(j_4, round_magic), round_magic);
+			j_4_floor = _mm_sub_ps(j_4_floor, _mm_and_ps(_mm_cmpgt_ps(j_4_floor, j_4), one));
+			__m128 const q = _mm_sub_ps(j, _mm_mul_ps(j_4_floor, _mm_set1_ps(4.0f)));
+			__m128 const use_cos = _mm_or_ps(_mm_cmpeq_ps(q, one), _mm_cmpeq_ps(q, _mm_set1_ps(3.0f)));
+			__m128 const negative = _mm_and_ps(_mm_cmpge_ps(q, _mm_set1_ps(2.0f)), _mm_set1_ps(-0.0f));
+
+			__m128 const z = _mm_mul_ps(r, r);
+
+			__m128 ps = _mm_set1_ps(-1.9515295891e-4f);
+			ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(8.3321608736e-3f));
+			ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(-1.6666654611e-1f));
+			__m128 const s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, z), ps));
+
+			__m128 pc = _mm_set1_ps(2.443315711809948e-5f);
+			pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(-1.388731625493765e-3f));
+			pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(4.166664568298827e-2f));
+			__m128 const c = _mm_add_ps(_mm_sub_ps(one, _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_mul_ps(_mm_mul_ps(z, z), pc));
+
+			return _mm_xor_ps(select(use_cos, c, s), negative);
+		}
+
+		// acos(x) for x in [0,1]: polynomial approximation of asin (Cephes asinf), with acos(x) = 2 asin(sqrt((1-x)/2)) for x>0.5
+		__m128 acos_x4(__m128 x)
+		{
+			__m128 const upper = _mm_cmpgt_ps(x, _mm_set1_ps(0.5f));
+			__m128 const z = select(upper, _mm_mul_ps(_mm_set1_ps(0.5f), _mm_sub_ps(_mm_set1_ps(1.0f), x)), _mm_mul_ps(x, x));
+			__m128 const s = select(upper, _mm_sqrt_ps(z), x);
+
+			__m128 p = _mm_set1_ps(4.2163199048e-2f);
+			p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(2.4181311049e-2f));
+			p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(4.5470025998e-2f));
+			p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(7.4953002686e-2f));
+			p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.6666752422e-1f));
+			__m128 const asin_s = _mm_add_ps(s, _mm_mul_ps(_mm_mul_ps(s, z), p));
+
+			return select(upper, _mm_add_ps(asin_s, asin_s), _mm_sub_ps(_mm_set1_ps(Pi / 2.0f), asin_s));
+		}
+
+		// Sign bit of the lanes where dot(q1,q2)<0: q2 is replaced by -q2 (shortest path)
+		__m128 shortest_path_sign(__m128 d)
+		{
+			return _mm_and_ps(_mm_cmplt_ps(d, _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+		}
+#endif
+
+		// Same computations as nlerp(quaternion,quaternion,float)
+		struct nlerp_method
+		{
+			static quaternion apply(quaternion const& q1, quaternion const& q2, float alpha)
+			{
+				return nlerp(q1, q2, alpha);
+			}
+#ifdef CGP_ROTATION_SSE
+			static quaternion_x4 apply(quaternion_x4 const& q1, quaternion_x4 const& q2, __m128 alpha)
+			{
+				__m128 const sign = shortest_path_sign(dot_x4(q1, q2));
+				return normalized_combination_x4(_mm_sub_ps(_mm_set1_ps(1.0f), alpha), q1, _mm_xor_ps(alpha, sign), q2);
+			}
+#endif
+		};
+
+		// Same computations as slerp(quaternion,quaternion,float), with approximations of acos and sin in the SSE version
+		struct slerp_method
+		{
+			static quaternion apply(quaternion const& q1, quaternion const& q2, float alpha)
+			{
+				return slerp(q1, q2, alpha);
+			}
+#ifdef CGP_ROTATION_SSE
+			static quaternion_x4 apply(quaternion_x4 const& q1, quaternion_x4 const& q2, __m128 alpha)
+			{
+				__m128 const d_signed = dot_x4(q1, q2);
+				__m128 const sign = shortest_path_sign(d_signed);
+				__m128 const d = _mm_xor_ps(d_signed, sign);
+				__m128 const one = _mm_set1_ps(1.0f);
+				__m128 const beta = _mm_sub_ps(one, alpha);
+
+				// The lanes with very close quaternions use the linear weights (the trigonometric weights are computed on all the lanes, and discarded)
+				__m128 const linear = _mm_cmpge_ps(d, _mm_set1_ps(0.9995f));
+				__m128 const theta = acos_x4(_mm_min_ps(d, one));
+				__m128 const s = select(linear, one, sin_x4(theta)); // (avoids a division by 0 on the discarded lanes)
+				__m128 const w1 = select(linear, beta, _mm_div_ps(sin_x4(_mm_mul_ps(beta, theta)), s));
+				__m128 const w2 = select(linear, alpha, _mm_div_ps(sin_x4(_mm_mul_ps(alpha, theta)), s));
+
+				return normalized_combination_x4(w1, q1, _mm_xor_ps(w2, sign), q2);
+			}
+#endif
+		};
+
+		template <typename Method, typename T, typename Alpha>
+		void interpolate(numarray_view<T const> q1, numarray_view<T const> q2, Alpha const& alpha, numarray_view<T> q)
+		{
+			assert_cgp(q1.size() == q.size() && q2.size() == q.size(), "Interpolated arrays must have the same size (q1: " + str(q1.size()) + ", q2: " + str(q2.size()) + ", result: " + str(q.size()) + ")");
+
+			for_each_group_of_4(q.size(), [&](size_t k, int count) {
+#ifdef CGP_ROTATION_SSE
+				// The missing elements of the last group are replaced by the last element, and are not stored
+				float const* p1[4];
+				float const* p2[4];
+				float* p[4];
+				float a[4];
+				float unused[4][4];
+				for (int j = 0; j < 4; ++j) {
+					size_t const idx = k + size_t(std::min(j, count - 1));
+					p1[j] = &quaternion_of(q1.at(idx)).x;
+					p2[j] = &quaternion_of(q2.at(idx)).x;
+					a[j] = alpha(idx);
+					p[j] = j < count ? &quaternion_of(q.at(idx)).x : unused[j];
+				}
+				store_x4(Method::apply(load_x4(p1), load_x4(p2), _mm_loadu_ps(a)), p);
+#else
+				for (size_t idx = k; idx < k + size_t(count); ++idx)
+					quaternion_of(q.at(idx)) = Method::apply(quaternion_of(q1.at(idx)), quaternion_of(q2.at(idx)), alpha(idx));
+#endif
+			});
+		}
+
+		template <typename T>
+		void convert_to_matrix(numarray_view<T const> q, numarray_view<mat3> M)
+		{
+			assert_cgp(q.size() == M.size(), "Rotations and matrices must have the same size (rotations: " + str(q.size()) + ", matrices: " + str(M.size()) + ")");
+
+			for_each_group_of_4(q.size(), [&](size_t k, int count) {
+#ifdef CGP_ROTATION_SSE
+				float const* p[4];
+				for (int j = 0; j < 4; ++j)
+					p[j] = &quaternion_of(q.at(k + size_t(std::min(j, count - 1)))).x;
+				quaternion_x4 const a = load_x4(p);
+
+				// Same expressions as rotation_transform::convert_quaternion_to_matrix
+				__m128 const one = _mm_set1_ps(1.0f);
+				__m128 const two = _mm_set1_ps(2.0f);
+				__m128 const xx = _mm_mul_ps(a.x, a.x), yy = _mm_mul_ps(a.y, a.y), zz = _mm_mul_ps(a.z, a.z);
+				__m128 const xy = _mm_mul_ps(a.x, a.y), xz = _mm_mul_ps(a.x, a.z), yz = _mm_mul_ps(a.y, a.z);
+				__m128 const wx = _mm_mul_ps(a.w, a.x), wy = _mm_mul_ps(a.w, a.y), wz = _mm_mul_ps(a.w, a.z);
+
+				alignas(16) float m[9][4];
+				_mm_store_ps(m[0], _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))));
+				_mm_store_ps(m[1], _mm_mul_ps(two, _mm_sub_ps(xy, wz)));
+				_mm_store_ps(m[2], _mm_mul_ps(two, _mm_add_ps(xz, wy)));
+				_mm_store_ps(m[3], _mm_mul_ps(two, _mm_add_ps(xy, wz)));
+				_mm_store_ps(m[4], _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))));
+				_mm_store_ps(m[5], _mm_mul_ps(two, _mm_sub_ps(yz, wx)));
+				_mm_store_ps(m[6], _mm_mul_ps(two, _mm_sub_ps(xz, wy)));
+				_mm_store_ps(m[7], _mm_mul_ps(two, _mm_add_ps(yz, wx)));
+				_mm_store_ps(m[8], _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))));
+
+				for (int j = 0; j < count; ++j)
+					M.at(k + size_t(j)) = mat3(m[0][j], m[1][j], m[2][j], m[3][j], m[4][j], m[5][j], m[6][j], m[7][j], m[8][j]);
+#else
+				for (size_t idx = k; idx < k + size_t(count); ++idx)
+					M.at(idx) = rotation_transform::convert_quaternion_to_matrix(quaternion_of(q.at(idx)));
+#endif
+			});
+		}
+	}
+
+	void nlerp(numarray_view<quaternion const> q1, numarray_view<quaternion const> q2, float alpha, numarray_view<quaternion> q)
+	{
+		interpolate<nlerp_method>(q1, q2, alpha_constant{ alpha }, q);
+	}
+	void nlerp(numarray_view<quaternion const> q1, numarray_view<quaternion const> q2, numarray_view<float const> alpha, numarray_view<quaternion> q)
+	{
+		assert_cgp(alpha.size() == q.size(), "The number of interpolation coefficients (" + str(alpha.size()) + ") must be the number of elements (" + str(q.size()) + ")");
+		interpolate<nlerp_method>(q1, q2, alpha_per_element{ alpha }, q);
+	}
+	void nlerp(numarray_view<rotation_transform const> r1, numarray_view<rotation_transform const> r2, float alpha, numarray_view<rotation_transform> r)
+	{
+		interpolate<nlerp_method>(r1, r2, alpha_constant{ alpha }, r);
+	}
+	void nlerp(numarray_view<rotation_transform const> r1, numarray_view<rotation_transform const> r2, numarray_view<float const> alpha, numarray_view<rotation_transform> r)
+	{
+		assert_cgp(alpha.size() == r.size(), "The number of interpolation coefficients (" + str(alpha.size()) + ") must be the number of elements (" + str(r.size()) + ")");
+		interpolate<nlerp_method>(r1, r2, alpha_per_element{ alpha }, r);
+	}
+
+	void slerp(numarray_view<quaternion const> q1, numarray_view<quaternion const> q2, float alpha, numarray_view<quaternion> q)
+	{
+		interpolate<slerp_method>(q1, q2, alpha_constant{ alpha }, q);
+	}
+	void slerp(numarray_view<quaternion const> q1, numarray_view<quaternion const> q2, numarray_view<float const> alpha, numarray_view<quaternion> q)
+	{
+		assert_cgp(alpha.size() == q.size(), "The number of interpolation coefficients (" + str(alpha.size()) + ") must be the number of elements (" + str(q.size()) + ")");
+		interpolate<slerp_method>(q1, q2, alpha_per_element{ alpha }, q);
+	}
+	void slerp(numarray_view<rotation_transform const> r1, numarray_view<rotation_transform const> r2, float alpha, numarray_view<rotation_transform> r)
+	{
+		interpolate<slerp_method>(r1, r2, alpha_constant{ alpha }, r);
+	}
+	void slerp(numarray_view<rotation_transform const> r1, numarray_view<rotation_transform const> r2, numarray_view<float const> alpha, numarray_view<rotation_transform> r)
+	{
+		assert_cgp(alpha.size() == r.size(), "The number of interpolation coefficients (" + str(alpha.size()) + ") must be the number of elements (" + str(r.size()) + ")");
+		interpolate<slerp_method>(r1, r2, alpha_per_element{ alpha }, r);
+	}
+
+	void convert_quaternion_to_matrix(numarray_view<quaternion const> q, numarray_view<mat3> M)
+	{
+		convert_to_matrix(q, M);
+	}
+	void convert_rotation_to_matrix(numarray_view<rotation_transform const> r, numarray_view<mat3> M)
+	{
+		convert_to_matrix(r, M);
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "cgp/02_numarray/numarray_view/numarray_view.hpp"
+#include "cgp/09_geometric_transformation/quaternion/quaternion.hpp"
+#include "cgp/09_geometric_transformation/rotation_transform/rotation_transform.hpp"
+
+namespace cgp
+{
+	// Operations on large sets of rotations (ex. blending all the joints of an animated skeleton).
+	//  The elements are processed by groups of 4 quaternions with SSE instructions when they are available (see CGP_NO_SIMD),
+	//  and by chunks on several threads for very large sets (see parallel_for).
+	//  The elements can be a numarray, a std::vector, or a view on a part of a larger buffer (see numarray_view).
+	//  The result can be one of the inputs (in place computation).
+
+	/** Interpolation q[k] = nlerp(q1[k], q2[k], alpha) for all k (see nlerp(quaternion,quaternion,float)) */
+	void nlerp(numarray_view<quaternion const> q1, numarray_view<quaternion const> q2, float alpha, numarray_view<quaternion> q);
+	/** Interpolation with a coefficient per element q[k] = nlerp(q1[k], q2[k], alpha[k]) */
+	void nlerp(numarray_view<quaternion const> q1, numarray_view<quaternion const> q2, numarray_view<float const> alpha, numarray_view<quaternion> q);
+	void nlerp(numarray_view<rotation_transform const> r1, numarray_view<rotation_transform const> r2, float alpha, numarray_view<rotation_transform> r);
+	void nlerp(numarray_view<rotation_transform const> r1, numarray_view<rotation_transform const> r2, numarray_view<float const> alpha, numarray_view<rotation_transform> r);
+
+	/** Interpolation q[k] = slerp(q1[k], q2[k], alpha) for all k (see slerp(quaternion,quaternion,float)). A coefficient alpha outside [0,1] extrapolates the rotation.
+	*   The SSE version evaluates acos and sin with polynomial approximations: the results may differ from the function on a single quaternion by a few 1e-7 */
+	void slerp(numarray_view<quaternion const> q1, numarray_view<quaternion const> q2, float alpha, numarray_view<quaternion> q);
+	/** Interpolation with a coefficient per element q[k] = slerp(q1[k], q2[k], alpha[k]) */
+	void slerp(numarray_view<quaternion const> q1, numarray_view<quaternion const> q2, numarray_view<float const> alpha, numarray_view<quaternion> q);
+	void slerp(numarray_view<rotation_transform const> r1, numarray_view<rotation_transform const> r2, float alpha, numarray_view<rotation_transform> r);
+	void slerp(numarray_view<rotation_transform const> r1, numarray_view<rotation_transform const> r2, numarray_view<float const> alpha, numarray_view<rotation_transform> r);
+
+	/** Rotation matrices M[k] = rotation_transform::convert_quaternion_to_matrix(q[k]) for all k */
+	void convert_quaternion_to_matrix(numarray_view<quaternion const> q, numarray_view<mat3> M);
+	/** Rotation matrices M[k] = r[k].matrix() for all k */
+	void convert_rotation_to_matrix(numarray_view<rotation_transform const> r, numarray_view<mat3> M);
+}
@@ -16,6 +16,8 @@ namespace cgp
 		:data(q)
 	{
 		assert_cgp(cgp::abs(norm(q)-1.0f)<5e-2f, "Quaternion should have unit norm to represent rotation");
+		// The products with vectors and the conversion to matrix expect an exact unit quaternion (rounding errors of the accepted input are removed)
+		data = q / norm(q);
 	}
 
 	rotation_transform rotation_transform::from_quaternion(quaternion const& q)
@@ -192,19 +194,16 @@ namespace cgp
 
 	rotation_transform rotation_transform::lerp(rotation_transform const& r1, rotation_transform const& r2, float const alpha)
 	{
-		quaternion q1 = r1.data;
-		quaternion q2 = r2.data;
-
-		if(dot(q1,q2)<0)
-			q2 *= -1.0f;
-
-		quaternion q;
-		q = (1.0f-alpha)*q1 + alpha*q2;
-		q = q / norm(q);
-		return rotation_transform{ q };
+		return nlerp(r1, r2, alpha);
+	}
+	rotation_transform rotation_transform::nlerp(rotation_transform const& r1, rotation_transform const& r2, float const alpha)
+	{
+		return rotation_transform{ cgp::nlerp(r1.data, r2.data, alpha) };
+	}
+	rotation_transform rotation_transform::slerp(rotation_transform const& r1, rotation_transform const& r2, float const alpha)
+	{
+		return rotation_transform{ cgp::slerp(r1.data, r2.data, alpha) };
 	}
-
-	//rotation_transform rotation_transform::slerp(rotation_transform const& r1, rotation_transform const& r2, float const alpha);
 
 	rotation_transform inverse(rotation_transform const& r)
 	{
@@ -233,9 +232,11 @@ namespace cgp
 
 	vec3 operator*(rotation_transform const& r, vec3 const& p)
 	{
-		quaternion const qp = quaternion(p.x, p.y, p.z, 0.0f);
-		quaternion res = r.data * qp * conjugate(r.data);
-		return res.xyz();
+		// Expansion of the quaternion products q (p,0) conjugate(q) for a unit quaternion q=(v,w):
+		//   p + 2w (v x p) + 2 v x (v x p) = p + w t + v x t, with t = 2 (v x p)
+		vec3 const v = { r.data.x, r.data.y, r.data.z };
+		vec3 const t = 2.0f * cross(v, p);
+		return p + r.data.w * t + cross(v, t);
 	}
 
 	vec4 operator*(rotation_transform const& r, vec4 const& p)
@@ -22,6 +22,7 @@ namespace cgp
 
 		// Empty constructor: identity, q = [(0,0,0), 1]
 		rotation_transform();
+		// The quaternion is normalized (its norm is expected to be close to 1)
 		rotation_transform(quaternion const& q);
 
 		// Construct rotation from a quaternion representation
@@ -65,10 +66,12 @@ namespace cgp
 		static void convert_quaternion_to_axis_angle(quaternion const& q, vec3& axis, float& angle);
 
 
-		// Linear interpolation of rotation
+		// Linear interpolation of rotation (normalized linear interpolation of the quaternions, same as nlerp)
 		static rotation_transform lerp(rotation_transform const& r1, rotation_transform const& r2, float const alpha);
-		// Spherical Linear interpolation of rotation
-		//static rotation slerp(rotation const& r1, rotation const& r2, float const alpha);
+		// Normalized linear interpolation of rotation - fast, but the angular velocity is not constant
+		static rotation_transform nlerp(rotation_transform const& r1, rotation_transform const& r2, float const alpha);
+		// Spherical Linear interpolation of rotation - constant angular velocity
+		static rotation_transform slerp(rotation_transform const& r1, rotation_transform const& r2, float const alpha);
 
 	};
 
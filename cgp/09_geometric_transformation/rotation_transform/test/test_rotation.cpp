@@ -2,6 +2,8 @@
 
 #include "cgp/01_base/base.hpp"
 #include "../rotation_transform.hpp"
+#include "cgp/09_geometric_transformation/rotation_batch/rotation_batch.hpp"
+#include "cgp/09_geometric_transformation/transform_points/transform_points.hpp"
 
 #include <iostream>
 using namespace cgp;
@@ -51,6 +53,92 @@ namespace cgp_test
 
 		}
 
+		// Rotation applied to points: single point, matrix, quaternion products, and all the points of an array
+		{
+			rotation_transform const R = rotation_transform::from_axis_angle(normalize(vec3{ 2,-1,0.5f }), 2.2f);
+			quaternion const& q = R.data;
+			numarray<vec3> p;
+			for (int k = 0; k < 37; ++k)
+				p.push_back(vec3{ std::cos(0.7f * k), 0.1f * k - 2.0f, std::sin(1.3f * k) });
+
+			numarray<vec3> p_rotated = p;
+			transform_points(R, p_rotated);
+			for (int k = 0; k < p.size(); ++k) {
+				vec3 const Rp = R * p[k];
+				assert_cgp_no_msg(is_equal(Rp, (q * quaternion(p[k].x, p[k].y, p[k].z, 0.0f) * conjugate(q)).xyz()));
+				assert_cgp_no_msg(is_equal(Rp, R.matrix() * p[k]));
+				assert_cgp_no_msg(is_equal(p_rotated[k], Rp));
+			}
+			assert_cgp_no_msg(is_equal(R * vec4(p[3], 2.0f), vec4(R * p[3], 2.0f)));
+
+			// Quaternion accepted with a norm slightly different from 1: same rotation as the normalized quaternion
+			rotation_transform const R_approx = rotation_transform(1.04f * q);
+			assert_cgp_no_msg(std::abs(norm(R_approx.data) - 1.0f) < 1e-6f);
+			for (int k = 0; k < p.size(); ++k) {
+				assert_cgp_no_msg(is_equal(R_approx * p[k], R * p[k]));
+				assert_cgp_no_msg(is_equal(norm(R_approx * p[k]), norm(p[k])));
+			}
+			assert_cgp_no_msg(is_equal(R_approx.matrix(), R.matrix()));
+		}
+
+		// Interpolation of rotations
+		{
+			vec3 const axis = normalize(vec3{ 1,2,-1 });
+			rotation_transform const R1 = rotation_transform::from_axis_angle(axis, 0.3f);
+			rotation_transform const R2 = rotation_transform::from_axis_angle(axis, 1.9f);
+			for (float alpha : {0.0f, 0.25f, 0.5f, 1.0f}) {
+				rotation_transform const R = rotation_transform::from_axis_angle(axis, 0.3f + alpha * 1.6f);
+				assert_cgp_no_msg(is_equal(rotation_transform::slerp(R1, R2, alpha).matrix(), R.matrix()));
+				// -q represents the same rotation: the shortest path is taken
+				assert_cgp_no_msg(is_equal(rotation_transform(slerp(R1.data, -1.0f * R2.data, alpha)).matrix(), R.matrix()));
+				assert_cgp_no_msg(is_equal(rotation_transform::nlerp(R1, R2, alpha).matrix(), rotation_transform::lerp(R1, R2, alpha).matrix()));
+			}
+			assert_cgp_no_msg(is_equal(rotation_transform::nlerp(R1, R2, 0.5f).matrix(), rotation_transform::from_axis_angle(axis, 1.1f).matrix()));
+		}
+
+		// Batched interpolation and conversion against the functions on a single rotation
+		{
+			int const N = 103; // (not a multiple of the groups of 4 rotations)
+			numarray<rotation_transform> R1, R2;
+			numarray<float> alpha;
+			for (int k = 0; k < N; ++k) {
+				float const u = float(k) / N;
+				R1.push_back(rotation_transform::from_axis_angle(normalize(vec3{ 1.0f,u,2 * u - 1 }), 6.0f * u));
+				// Includes identical, very close, opposite, and half-turn apart rotations
+				float const angle = k % 5 == 0 ? 0.0f : (k % 5 == 1 ? 1e-3f : (k % 5 == 2 ? 2 * Pi : 3.0f * u));
+				R2.push_back(R1[k] * rotation_transform::from_axis_angle(normalize(vec3{ u,1,0.5f }), k % 7 == 0 ? Pi : angle));
+				alpha.push_back(u);
+			}
+
+			numarray<rotation_transform> R_nlerp(N), R_slerp(N), R_slerp_alpha(N), R_extrapolate(N);
+			nlerp(R1, R2, 0.3f, R_nlerp);
+			slerp(R1, R2, 0.3f, R_slerp);
+			slerp(R1, R2, alpha, R_slerp_alpha);
+			numarray<float> alpha_extrapolate(N);
+			for (int k = 0; k < N; ++k)
+				alpha_extrapolate[k] = 12.0f * alpha[k] - 5.0f;
+			slerp(R1, R2, alpha_extrapolate, R_extrapolate);
+			numarray<mat3> M(N);
+			convert_rotation_to_matrix(R1, M);
+
+			for (int k = 0; k < N; ++k) {
+				assert_cgp_no_msg(norm(R_nlerp[k].data - rotation_transform::nlerp(R1[k], R2[k], 0.3f).data) < 1e-6f);
+				assert_cgp_no_msg(norm(R_slerp[k].data - rotation_transform::slerp(R1[k], R2[k], 0.3f).data) < 1e-6f);
+				assert_cgp_no_msg(norm(R_slerp_alpha[k].data - rotation_transform::slerp(R1[k], R2[k], alpha[k]).data) < 1e-6f);
+				assert_cgp_no_msg(norm(R_extrapolate[k].data - rotation_transform::slerp(R1[k], R2[k], alpha_extrapolate[k]).data) < 1e-5f);
+				assert_cgp_no_msg(is_equal(M[k], R1[k].matrix()));
+			}
+
+			// In place computation on a strided view of quaternions
+			numarray<quaternion> q(N);
+			for (int k = 0; k < N; ++k)
+				q[k] = R1[k].data;
+			numarray_view<quaternion> q_odd = numarray_view<quaternion>(q).slice(1, N / 2, 2);
+			slerp(q_odd, q_odd, 0.7f, q_odd);
+			for (int k = 0; k < N; ++k)
+				assert_cgp_no_msg(norm(q[k] - R1[k].data) < 1e-6f);
+		}
+
 
 
 	}
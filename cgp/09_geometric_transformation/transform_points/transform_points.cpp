@@ -0,0 +1,109 @@
+#include "cgp/01_base/base.hpp"
+#include "transform_points.hpp"
+
+#include <cmath>
+
+namespace cgp
+{
+	namespace
+	{
+		// Call f(element) on all the elements of the view, chunk by chunk on several threads.
+		//  Contiguous views are accessed through a plain pointer (allows the compiler to vectorize the loop).
+		template <typename F> void transform_each(numarray_view<vec3> elements, F const& f)
+		{
+			parallel_for(int64_t(elements.size()), [&](int64_t begin, int64_t end) {
+				if (elements.is_contiguous()) {
+					vec3* const p = elements.data;
+					for (int64_t k = begin; k < end; ++k)
+						f(p[k]);
+				}
+				else {
+					for (int64_t k = begin; k < end; ++k)
+						f(elements.at(size_t(k)));
+				}
+			});
+		}
+
+		// p = L p + t (the coefficients are copied in local variables: the loop only reads/writes the points)
+		void transform_affine(numarray_view<vec3> points, mat3 const& L, vec3 const& t)
+		{
+			float const xx = get<0,0>(L), xy = get<0,1>(L), xz = get<0,2>(L);
+			float const yx = get<1,0>(L), yy = get<1,1>(L), yz = get<1,2>(L);
+			float const zx = get<2,0>(L), zy = get<2,1>(L), zz = get<2,2>(L);
+			float const tx = t.x, ty = t.y, tz = t.z;
+
+			transform_each(points, [=](vec3& p) {
+				float const x = p.x, y = p.y, z = p.z;
+				p.x = xx*x + xy*y + xz*z + tx;
+				p.y = yx*x + yy*y + yz*z + ty;
+				p.z = zx*x + zy*y + zz*z + tz;
+			});
+		}
+
+		mat3 linear_block(mat4 const& M)
+		{
+			return mat3{
+				get<0,0>(M), get<0,1>(M), get<0,2>(M),
+				get<1,0>(M), get<1,1>(M), get<1,2>(M),
+				get<2,0>(M), get<2,1>(M), get<2,2>(M) };
+		}
+	}
+
+	bool is_affine(mat4 const& M)
+	{
+		return get<3,0>(M) == 0.0f && get<3,1>(M) == 0.0f && get<3,2>(M) == 0.0f && get<3,3>(M) == 1.0f;
+	}
+
+	void transform_points(mat3 const& M, numarray_view<vec3> points)
+	{
+		transform_affine(points, M, vec3{ 0,0,0 });
+	}
+
+	void transform_points(mat4 const& M, numarray_view<vec3> points)
+	{
+		if (is_affine(M)) {
+			transform_affine(points, linear_block(M), vec3{ get<0,3>(M), get<1,3>(M), get<2,3>(M) });
+			return;
+		}
+
+		transform_each(points, [&M](vec3& p) {
+			vec4 const q = M * vec4(p, 1.0f);
+			p = q.xyz() / q.w;
+		});
+	}
+
+	void transform_points(rotation_transform const& R, numarray_view<vec3> points)
+	{
+		transform_affine(points, R.matrix(), vec3{ 0,0,0 });
+	}
+
+	void transform_normals(mat3 const& M, numarray_view<vec3> normals)
+	{
+		// cofactor(M) = det(M) inverse(M)^T. The cross product of two transformed vectors is (M a)x(M b) = cofactor(M) (a x b):
+		//  the normals remain consistent with the orientation of the triangles (as normal_per_vertex), including for mirror transforms (det(M)<0).
+		float const mxx = get<0,0>(M), mxy = get<0,1>(M), mxz = get<0,2>(M);
+		float const myx = get<1,0>(M), myy = get<1,1>(M), myz = get<1,2>(M);
+		float const mzx = get<2,0>(M), mzy = get<2,1>(M), mzz = get<2,2>(M);
+
+		float const xx = myy*mzz - myz*mzy, xy = myz*mzx - myx*mzz, xz = myx*mzy - myy*mzx;
+		float const yx = mxz*mzy - mxy*mzz, yy = mxx*mzz - mxz*mzx, yz = mxy*mzx - mxx*mzy;
+		float const zx = mxy*myz - mxz*myy, zy = mxz*myx - mxx*myz, zz = mxx*myy - mxy*myx;
+
+		transform_each(normals, [=](vec3& n) {
+			float const x = n.x, y = n.y, z = n.z;
+			float const nx = xx*x + xy*y + xz*z;
+			float const ny = yx*x + yy*y + yz*z;
+			float const nz = zx*x + zy*y + zz*z;
+			float const L2 = nx*nx + ny*ny + nz*nz;
+			float const s = L2 > 0 ? 1.0f / std::sqrt(L2) : 0.0f;
+			n.x = s*nx;
+			n.y = s*ny;
+			n.z = s*nz;
+		});
+	}
+
+	void transform_normals(mat4 const& M, numarray_view<vec3> normals)
+	{
+		transform_normals(linear_block(M), normals);
+	}
+}
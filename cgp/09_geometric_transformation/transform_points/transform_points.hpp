@@ -0,0 +1,32 @@
+#pragma once
+
+#include "cgp/02_numarray/numarray_view/numarray_view.hpp"
+#include "cgp/05_vec/vec.hpp"
+#include "cgp/06_mat/mat.hpp"
+#include "cgp/09_geometric_transformation/rotation_transform/rotation_transform.hpp"
+
+namespace cgp
+{
+	// Transformation of large sets of points and normals in place (ex. all the vertices of a mesh).
+	//  The transformation is computed once (and not per element), and the elements are processed by chunks on several threads (see parallel_for).
+	//  The elements can be a numarray, a std::vector, or a view on a part of a larger buffer (see numarray_view).
+
+	/** Apply the linear transform p = M p to all the points */
+	void transform_points(mat3 const& M, numarray_view<vec3> points);
+	/** Apply the 4x4 matrix transform to all the points: p = (M (p,1)).xyz / (M (p,1)).w
+	*   The division is skipped when M is an affine transform (last row equal to (0,0,0,1)) */
+	void transform_points(mat4 const& M, numarray_view<vec3> points);
+	/** Apply the rotation to all the points: p = R p
+	*   The rotation is converted once to its matrix (the rotated vectors remain unit vectors: this function also applies to the normals) */
+	void transform_points(rotation_transform const& R, numarray_view<vec3> points);
+
+	/** Transform the normals of a surface deformed by the linear transform M: n = normalize( cofactor(M) n ), with cofactor(M) = det(M) inverse(M)^T
+	*   The normals keep the orientation given by the triangles (they are flipped by mirror transforms, as the ones computed by normal_per_vertex),
+	*   and singular matrices (ex. a scaling by 0 along an axis) are handled. Null normals remain null. */
+	void transform_normals(mat3 const& M, numarray_view<vec3> normals);
+	/** Transform the normals of a surface deformed by the affine transform M (only the linear block of M is used) */
+	void transform_normals(mat4 const& M, numarray_view<vec3> normals);
+
+	/** True if the last row of M is (0,0,0,1) */
+	bool is_affine(mat4 const& M);
+}
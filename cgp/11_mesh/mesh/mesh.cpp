@@ -1,9 +1,8 @@
 #include "mesh.hpp"
+#include "cgp/11_mesh/mesh_adjacency/mesh_adjacency.hpp"
 
 
 
-#include <set>
-
 namespace cgp
 {
 	mesh& mesh::fill_empty_field()
@@ -45,7 +44,7 @@ namespace cgp
 	}
 
 
-	void normal_per_vertex(numarray<vec3> const& position, numarray<uint3> const& connectivity, numarray<vec3>& normals, bool invert)
+	void normal_per_vertex(numarray_view<vec3 const> position, numarray_view<uint3 const> connectivity, numarray<vec3>& normals, bool invert)
 	{
 		size_t const N = position.size();
 		if(normals.size()!=N)
@@ -106,7 +105,7 @@ namespace cgp
 
 			
 	}
-	numarray<vec3> normal_per_vertex(numarray<vec3> const& position, numarray<uint3> const& connectivity, bool invert)
+	numarray<vec3> normal_per_vertex(numarray_view<vec3 const> position, numarray_view<uint3 const> connectivity, bool invert)
 	{
 		numarray<vec3> normals;
 		normal_per_vertex(position, connectivity, normals, invert);
@@ -244,89 +243,66 @@ namespace cgp
 	}
 	mesh& mesh::scale(float sx,float sy, float sz)
 	{
-		for (vec3& p : position){
-			p.x *= sx;
-			p.y *= sy;
-			p.z *= sz;
-		}
-		normal_update();
-		return *this;
+		return apply_transform(mat3{ sx,0,0, 0,sy,0, 0,0,sz });
 	}
 	mesh& mesh::rotate(vec3 const& axis, float angle)
 	{
-		rotation_transform R = rotation_transform::from_axis_angle(axis, angle);
-		for (vec3& p : position)
-			p = R*p;
-		for(vec3& n : normal)
-			n = R*n;
+		rotation_transform const R = rotation_transform::from_axis_angle(axis, angle);
+		transform_points(R, position);
+		transform_points(R, normal);
 		return *this;
 	}
 	mesh& mesh::apply_transform(mat3 const& M)
 	{
-		for (vec3& p : position)
-			p = M * p;
-		normal_update();
+		transform_points(M, position);
+		// The normals are transformed directly (inverse transpose) when they exist, and are computed from the triangles otherwise
+		if (normal.size() == position.size())
+			transform_normals(M, normal);
+		else
+			normal_update();
 		return *this;
 	}
 	mesh& mesh::apply_transform(mat4 const& M)
 	{
-		for (vec3& p : position) {
-			vec4 q = M * vec4(p, 1.0f);
-			p = q.xyz() / q.w;
-		}
-		normal_update();
+		transform_points(M, position);
+		// A projective transform doesn't transform the normals linearly: they are computed from the triangles
+		if (normal.size() == position.size() && is_affine(M))
+			transform_normals(M, normal);
+		else
+			normal_update();
 		return *this;
 	}
 	mesh& mesh::apply_transform(cgp::affine const& M) {
-		for (vec3& p : position)
-			p = M*p;
-		for(vec3& n : normal) {
-			n = M.rotation*n;
-		}
+		mat4 const T = M.matrix();
+		transform_points(T, position);
+		transform_normals(T, normal);
 		return *this;
 	}
 	mesh& mesh::apply_transform(cgp::affine_rt const& M) {
-		for (vec3& p : position)
-			p = M*p;
-		for(vec3& n : normal) {
-			n = M.rotation*n;
-		}
+		mat4 const T = M.matrix();
+		transform_points(T, position);
+		transform_normals(T, normal);
 		return *this;
 	}
 	mesh& mesh::apply_transform(cgp::affine_rts const& M)
 	{
-		for (vec3& p : position)
-			p = M*p;
-		for(vec3& n : normal) {
-			n = M.rotation*n;
-		}
+		mat4 const T = M.matrix();
+		transform_points(T, position);
+		transform_normals(T, normal);
 		return *this;
 	}
 
 
 	numarray<numarray<int> > connectivity_one_ring(numarray<uint3> const& connectivity)
 	{
-		size_t const N = connectivity.size();
-		numarray<std::set<int> > one_ring;
-		one_ring.resize(N);
-		for (size_t k = 0; k < N; ++k)
-		{
-			uint3 const& tri = connectivity[k];
-			one_ring[ get<0>(tri) ].insert( get<1>(tri) );
-			one_ring[ get<0>(tri) ].insert( get<2>(tri) );
-
-			one_ring[ get<1>(tri) ].insert( get<0>(tri) );
-			one_ring[ get<1>(tri) ].insert( get<2>(tri) );
-
-			one_ring[ get<2>(tri) ].insert( get<0>(tri) );
-			one_ring[ get<2>(tri) ].insert( get<1>(tri) );
-		}
+		csr_adjacency const one_ring = vertex_to_vertex_adjacency(connectivity);
 
 		numarray<numarray<int> > one_ring_buffer;
-		one_ring_buffer.resize(N);
-		for(int k=0; k<N; ++k)
-			for(int idx : one_ring[k])
-				one_ring_buffer[k].push_back(idx);
+		one_ring_buffer.resize(one_ring.size());
+		for (int k = 0; k < one_ring_buffer.size(); ++k) {
+			numarray_view<int const> const neighbors = one_ring.neighbors(k);
+			one_ring_buffer[k].data.assign(neighbors.begin(), neighbors.end());
+		}
 		return one_ring_buffer;
 	}
 
@@ -334,13 +310,25 @@ namespace cgp
 	{
 		assert_cgp(position.size() > 0, "Mesh must have more than 1 position");
 
-		p_min = position[0];
-		p_max = position[0];
-		for (int k = 1; k < position.size(); ++k) {
-			vec3 const& p = position[k];
-			p_min = vec3(std::min(p_min.x, p.x), std::min(p_min.y, p.y), std::min(p_min.z, p.z));
-			p_max = vec3(std::max(p_max.x, p.x), std::max(p_max.y, p.y), std::max(p_max.z, p.z));
-		}
+		// Min/max of each chunk of positions, then of the chunks (see parallel_reduce)
+		std::pair<vec3, vec3> const box = parallel_reduce(position.size(),
+			[this](int64_t begin, int64_t end) {
+				vec3 b_min = position.at_unsafe(begin);
+				vec3 b_max = position.at_unsafe(begin);
+				for (int64_t k = begin + 1; k < end; ++k) {
+					vec3 const& p = position.at_unsafe(k);
+					b_min = vec3(std::min(b_min.x, p.x), std::min(b_min.y, p.y), std::min(b_min.z, p.z));
+					b_max = vec3(std::max(b_max.x, p.x), std::max(b_max.y, p.y), std::max(b_max.z, p.z));
+				}
+				return std::make_pair(b_min, b_max);
+			},
+			[](std::pair<vec3, vec3> const& a, std::pair<vec3, vec3> const& b) {
+				return std::make_pair(
+					vec3(std::min(a.first.x, b.first.x), std::min(a.first.y, b.first.y), std::min(a.first.z, b.first.z)),
+					vec3(std::max(a.second.x, b.second.x), std::max(a.second.y, b.second.y), std::max(a.second.z, b.second.z)));
+			});
+		p_min = box.first;
+		p_max = box.second;
 	}
 
 	mesh& mesh::centered()
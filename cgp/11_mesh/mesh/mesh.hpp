@@ -38,9 +38,9 @@ namespace cgp
 		/** Apply a rotation to position. Shorthand for(vec3& p: position) { p = R*p; }, with R the corresponding rotation. Also update the normals.*/
 		mesh& rotate(vec3 const& axis, float angle);
 		
-		/** Apply 3x3 matrix transformation to position. Also update the normals. */
+		/** Apply 3x3 matrix transformation to position. Also update the normals (transformed by the inverse transpose of M, see transform_normals). */
 		mesh& apply_transform(mat3 const& M);
-		/** Apply 4x4 matrix transformation to position. Also update the normals. */
+		/** Apply 4x4 matrix transformation to position. Also update the normals (recomputed from the triangles if M is a projective transform). */
 		mesh& apply_transform(mat4 const& M);
 		mesh& apply_transform(cgp::affine const& M);
 		mesh& apply_transform(cgp::affine_rt const& M);
@@ -56,16 +56,19 @@ namespace cgp
 	};
 
 	/** Compute automaticaly a per-vertex normal given a set of positions and their connectivity 
+	* The positions and triangles can be a numarray, a std::vector, or a view on a part of a larger buffer (see numarray_view).
 	* Version where the normal is passed as in/out argument (usefull in case of real-time update of the normals) 
 	*   allows to save time and avoid unecessary allocation if the normal vector has already the correct size.	*/
-	void normal_per_vertex(numarray<vec3> const& position, numarray<uint3> const& connectivity, numarray<vec3>& normals_to_fill, bool invert=false);
+	void normal_per_vertex(numarray_view<vec3 const> position, numarray_view<uint3 const> connectivity, numarray<vec3>& normals_to_fill, bool invert=false);
 	/** Compute automaticaly a per-vertex normal given a set of positions and their connectivity */
-	numarray<vec3> normal_per_vertex(numarray<vec3> const& position, numarray<uint3> const& connectivity, bool invert=false);
+	numarray<vec3> normal_per_vertex(numarray_view<vec3 const> position, numarray_view<uint3 const> connectivity, bool invert=false);
 
 	/** Check if the mesh looks coherent (correct indexing and size of buffer, no degenerate triangle, etc) */
 	bool mesh_check(mesh const& m);
 
 
+	/** One-ring of each vertex (the vertices sharing an edge with the vertex, in increasing order) stored as one numarray per vertex
+	*   The compact storage given by vertex_to_vertex_adjacency avoids the allocation of one array per vertex. */
 	numarray<numarray<int> > connectivity_one_ring(numarray<uint3> const& connectivity);
 
 	std::string str(mesh const& m);
@@ -0,0 +1,135 @@
+#include "test_mesh.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "../mesh.hpp"
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	static bool is_close(numarray<vec3> const& a, numarray<vec3> const& b, float tolerance = 1e-5f)
+	{
+		if (a.size() != b.size())
+			return false;
+		for (int k = 0; k < a.size(); ++k)
+			if (norm(a[k] - b[k]) > tolerance)
+				return false;
+		return true;
+	}
+
+	// Tetrahedron with shared vertices (smooth per-vertex normals) or with 3 distinct vertices per triangle (faceted normals)
+	static mesh tetrahedron(bool faceted)
+	{
+		numarray<vec3> const p = { {0.1f,0.0f,0.0f}, {1.0f,0.2f,0.0f}, {0.3f,1.0f,0.1f}, {0.2f,0.3f,1.0f} };
+		numarray<uint3> const triangle = { {0,2,1}, {0,1,3}, {1,2,3}, {0,3,2} };
+
+		mesh m;
+		if (faceted) {
+			for (int k = 0; k < triangle.size(); ++k) {
+				for (int j = 0; j < 3; ++j)
+					m.position.push_back(p[triangle[k][j]]);
+				m.connectivity.push_back(uint3{ 3 * k, 3 * k + 1, 3 * k + 2 });
+			}
+		}
+		else {
+			m.position = p;
+			m.connectivity = triangle;
+		}
+		m.fill_empty_field();
+		return m;
+	}
+
+	// Normals of the transformed mesh recomputed from its triangles
+	static numarray<vec3> updated_normals(mesh m)
+	{
+		m.normal_update();
+		return m.normal;
+	}
+
+	void test_mesh()
+	{
+		// The transformed normals of a faceted mesh are the normals recomputed from the transformed triangles
+		{
+			mesh m = tetrahedron(true);
+			m.scale(2.0f, 0.5f, 3.0f);
+			assert_cgp_no_msg(is_close(m.normal, updated_normals(m)));
+
+			// Mirror: the normals follow the orientation of the triangles
+			m.scale(-1.0f, 1.0f, 1.0f);
+			assert_cgp_no_msg(is_close(m.normal, updated_normals(m)));
+
+			mat4 const M = mat4::build_affine(mat3{ 1.0f,0.5f,0.0f, 0.0f,2.0f,0.0f, 0.3f,0.0f,0.7f }, vec3{ 4.0f,-2.0f,1.5f });
+			m.apply_transform(M);
+			assert_cgp_no_msg(is_close(m.normal, updated_normals(m)));
+
+			m.apply_transform(affine_rts(rotation_transform::from_axis_angle({ 1,1,0 }, 0.7f), { 1,2,3 }, 1.5f));
+			assert_cgp_no_msg(is_close(m.normal, updated_normals(m)));
+
+			// Projective transform: the normals are recomputed
+			mat4 P = mat4::build_identity();
+			P(3, 0) = 0.2f;
+			m.apply_transform(P);
+			assert_cgp_no_msg(is_close(m.normal, updated_normals(m)));
+		}
+
+		// Rigid transforms keep the relative areas of the triangles: the smooth normals are also identical to the recomputed ones
+		{
+			mesh m = tetrahedron(false);
+			m.rotate({ 0.2f,1.0f,0.5f }, 1.2f);
+			assert_cgp_no_msg(is_close(m.normal, updated_normals(m)));
+			m.apply_transform(mat4::build_affine(rotation_transform::from_axis_angle({ 0,0,1 }, 2.0f).matrix(), vec3{ 3,0,-1 }));
+			assert_cgp_no_msg(is_close(m.normal, updated_normals(m)));
+		}
+
+		// transform_points and transform_normals on arrays processed in several chunks
+		{
+			int const N = 100000;
+			numarray<vec3> p(N);
+			for (int k = 0; k < N; ++k)
+				p[k] = vec3{ std::cos(0.01f * k), std::sin(0.02f * k), 0.001f * k - 50.0f };
+
+			mat3 const L = mat3{ 2.0f,0.1f,0.0f, 0.0f,0.5f,0.3f, 0.2f,0.0f,1.5f };
+			numarray<vec3> q = p;
+			transform_points(L, q);
+			for (int k = 0; k < N; k += 997)
+				assert_cgp_no_msg(norm(q[k] - L * p[k]) < 1e-4f);
+
+			mat4 P = mat4::build_affine(L, vec3{ 1,2,3 });
+			P(3, 2) = 0.01f;
+			q = p;
+			transform_points(P, q);
+			for (int k = 0; k < N; k += 997) {
+				vec4 const h = P * vec4(p[k], 1.0f);
+				assert_cgp_no_msg(norm(q[k] - vec3(h.x, h.y, h.z) / h.w) < 1e-3f);
+			}
+
+			rotation_transform const R = rotation_transform::from_axis_angle({ 1,-1,2 }, 0.4f);
+			q = p;
+			transform_points(R, q);
+			for (int k = 0; k < N; k += 997)
+				assert_cgp_no_msg(norm(q[k] - R * p[k]) < 1e-4f);
+
+			// Normals: n is orthogonal to the tangent t before the transform, L n is orthogonal to L t after
+			numarray<vec3> n(N);
+			for (int k = 0; k < N; ++k)
+				n[k] = normalize(vec3{ 1.0f, 0.5f, 0.01f * (k % 100) });
+			vec3 const t0 = { 0.5f,-1.0f,0.0f };
+			transform_normals(L, n);
+			for (int k = 0; k < N; k += 997) {
+				vec3 const t1 = normalize(vec3{ -0.01f * (k % 100), 0.0f, 1.0f });
+				assert_cgp_no_msg(std::abs(dot(n[k], L * t0)) < 1e-4f);
+				assert_cgp_no_msg(std::abs(dot(n[k], L * t1)) < 1e-4f);
+				assert_cgp_no_msg(std::abs(norm(n[k]) - 1.0f) < 1e-5f);
+			}
+
+			// Singular matrix (flattening along z): the normals of the plane z=0 are kept, and the others become null
+			numarray<vec3> n_flat = { {0,0,1}, {1,0,0} };
+			transform_normals(mat3{ 2,0,0, 0,3,0, 0,0,0 }, n_flat);
+			assert_cgp_no_msg(is_close(n_flat, numarray<vec3>{ {0,0,1}, {0,0,0} }));
+		}
+	}
+}
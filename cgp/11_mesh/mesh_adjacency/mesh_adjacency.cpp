@@ -0,0 +1,220 @@
+#include "cgp/01_base/base.hpp"
+#include "mesh_adjacency.hpp"
+
+#include <algorithm>
+#include <climits>
+
+namespace cgp
+{
+	size_t csr_adjacency::size() const
+	{
+		return offset.size() > 0 ? size_t(offset.size() - 1) : 0;
+	}
+	int csr_adjacency::degree(int i) const
+	{
+		assert_cgp(i >= 0 && size_t(i) < size(), "Index " + str(i) + " outside the adjacency of " + str(size()) + " elements");
+		return int(offset.at_unsafe(i + 1) - offset.at_unsafe(i));
+	}
+	numarray_view<int const> csr_adjacency::neighbors(int i) const
+	{
+		return numarray_view<int const>(index.data.data() + offset.at_unsafe(i), size_t(degree(i)));
+	}
+
+	namespace
+	{
+		// Number of vertices: N_vertex if it is given, otherwise the largest index + 1
+		int vertex_count(numarray_view<uint3 const> connectivity, int N_vertex)
+		{
+			if (N_vertex >= 0 || connectivity.size() == 0)
+				return std::max(N_vertex, 0);
+
+			unsigned int const max_index = parallel_reduce(int64_t(connectivity.size()),
+				[&](int64_t begin, int64_t end) {
+					unsigned int m = 0;
+					for (int64_t k = begin; k < end; ++k) {
+						uint3 const& tri = connectivity.at(size_t(k));
+						m = std::max(m, std::max(tri.x, std::max(tri.y, tri.z)));
+					}
+					return m;
+				},
+				[](unsigned int a, unsigned int b) { return std::max(a, b); });
+			assert_cgp(max_index < unsigned(INT_MAX), "Vertex index " + str(max_index) + " is too large for the int indices of the adjacency");
+			return int(max_index) + 1;
+		}
+
+		// Distinct vertices of a triangle (degenerate triangles with a repeated vertex have less than 3 corners)
+		int distinct_corners(uint3 const& tri, int corner[3], int N_vertex)
+		{
+			if (tri.x >= unsigned(N_vertex) || tri.y >= unsigned(N_vertex) || tri.z >= unsigned(N_vertex))
+				error_cgp("Triangle " + str(tri) + " refers to a vertex outside the " + str(N_vertex) + " vertices");
+			int N = 0;
+			corner[N++] = int(tri.x);
+			if (tri.y != tri.x)
+				corner[N++] = int(tri.y);
+			if (tri.z != tri.x && tri.z != tri.y)
+				corner[N++] = int(tri.z);
+			return N;
+		}
+
+		// Counts stored in offset[i+1] are replaced by the start of the lists: offset[i+1] = offset[i] + count[i]
+		void accumulate_offset(numarray<int64_t>& offset)
+		{
+			for (int64_t k = 1; k < offset.size(); ++k)
+				offset.at_unsafe(k) += offset.at_unsafe(k - 1);
+		}
+	}
+
+	csr_adjacency vertex_to_face_adjacency(numarray_view<uint3 const> connectivity, int N_vertex)
+	{
+		N_vertex = vertex_count(connectivity, N_vertex);
+		size_t const N_triangle = connectivity.size();
+		int corner[3];
+
+		// Counting sort of the corners of the triangles by vertex: the triangles are listed in increasing order around each vertex
+		csr_adjacency adjacency;
+		adjacency.offset.resize_clear(int64_t(N_vertex) + 1);
+		for (size_t k = 0; k < N_triangle; ++k) {
+			int const N_corner = distinct_corners(connectivity.at(k), corner, N_vertex);
+			for (int j = 0; j < N_corner; ++j)
+				++adjacency.offset.at_unsafe(corner[j] + 1);
+		}
+		accumulate_offset(adjacency.offset);
+
+		adjacency.index.resize(adjacency.offset.at_unsafe(N_vertex));
+		numarray<int64_t> fill = adjacency.offset;
+		for (size_t k = 0; k < N_triangle; ++k) {
+			int const N_corner = distinct_corners(connectivity.at(k), corner, N_vertex);
+			for (int j = 0; j < N_corner; ++j)
+				adjacency.index.at_unsafe(fill.at_unsafe(corner[j])++) = int(k);
+		}
+
+		return adjacency;
+	}
+
+	csr_adjacency vertex_to_vertex_adjacency(numarray_view<uint3 const> connectivity, int N_vertex)
+	{
+		csr_adjacency const faces = vertex_to_face_adjacency(connectivity, N_vertex);
+		N_vertex = int(faces.size());
+		int corner[3];
+
+		// Counting sort of the half-edges a->b of the triangles by their first vertex a.
+		//  The half-edges are generated by increasing b (from the triangles around b): the sort being stable, the list of each vertex a
+		//  is sorted with its duplicates (the edge a-b shared by two triangles) next to each other (as the second pass of a radix sort).
+		numarray<int64_t> start;
+		start.resize_clear(int64_t(N_vertex) + 1);
+		for (size_t k = 0; k < connectivity.size(); ++k) {
+			int const N_corner = distinct_corners(connectivity.at(k), corner, N_vertex);
+			for (int j = 0; j < N_corner; ++j)
+				start.at_unsafe(corner[j] + 1) += N_corner - 1;
+		}
+		accumulate_offset(start);
+
+		numarray<int> half_edge;
+		half_edge.resize(start.at_unsafe(N_vertex));
+		numarray<int64_t> fill = start;
+		for (int b = 0; b < N_vertex; ++b) {
+			for (int f : faces.neighbors(b)) {
+				int const N_corner = distinct_corners(connectivity.at(size_t(f)), corner, N_vertex);
+				for (int j = 0; j < N_corner; ++j)
+					if (corner[j] != b)
+						half_edge.at_unsafe(fill.at_unsafe(corner[j])++) = b;
+			}
+		}
+
+		// Removal of the duplicates: size of each list without duplicates, then copy of the distinct neighbors
+		csr_adjacency adjacency;
+		adjacency.offset.resize_clear(int64_t(N_vertex) + 1);
+		parallel_for(N_vertex, [&](int64_t begin, int64_t end) {
+			for (int64_t a = begin; a < end; ++a) {
+				int64_t const first = start.at_unsafe(a), last = start.at_unsafe(a + 1);
+				int64_t N_distinct = 0;
+				for (int64_t k = first; k < last; ++k)
+					if (k == first || half_edge.at_unsafe(k) != half_edge.at_unsafe(k - 1))
+						++N_distinct;
+				adjacency.offset.at_unsafe(a + 1) = N_distinct;
+			}
+		});
+		accumulate_offset(adjacency.offset);
+
+		adjacency.index.resize(adjacency.offset.at_unsafe(N_vertex));
+		parallel_for(N_vertex, [&](int64_t begin, int64_t end) {
+			for (int64_t a = begin; a < end; ++a) {
+				int64_t const first = start.at_unsafe(a), last = start.at_unsafe(a + 1);
+				int64_t idx = adjacency.offset.at_unsafe(a);
+				for (int64_t k = first; k < last; ++k)
+					if (k == first || half_edge.at_unsafe(k) != half_edge.at_unsafe(k - 1))
+						adjacency.index.at_unsafe(idx++) = half_edge.at_unsafe(k);
+			}
+		});
+
+		return adjacency;
+	}
+
+	csr_adjacency edge_to_face_adjacency(numarray_view<uint3 const> connectivity, numarray<int2>& edges, int N_vertex)
+	{
+		csr_adjacency const one_ring = vertex_to_vertex_adjacency(connectivity, N_vertex);
+		N_vertex = int(one_ring.size());
+		size_t const N_triangle = connectivity.size();
+
+		// The edges a-b (a<b) are numbered by increasing a, then b: they are the neighbors b>a in the (sorted) one-ring of a.
+		//  upper[a]: position in one_ring.index of the first neighbor b>a, first_edge[a]: number of the first edge starting at a
+		numarray<int64_t> upper, first_edge;
+		upper.resize(N_vertex);
+		first_edge.resize_clear(int64_t(N_vertex) + 1);
+		parallel_for(N_vertex, [&](int64_t begin, int64_t end) {
+			for (int64_t a = begin; a < end; ++a) {
+				int const* const first = one_ring.index.data.data() + one_ring.offset.at_unsafe(a);
+				int const* const last = one_ring.index.data.data() + one_ring.offset.at_unsafe(a + 1);
+				int const* const p = std::upper_bound(first, last, int(a));
+				upper.at_unsafe(a) = p - one_ring.index.data.data();
+				first_edge.at_unsafe(a + 1) = last - p;
+			}
+		});
+		accumulate_offset(first_edge);
+
+		edges.resize(first_edge.at_unsafe(N_vertex));
+		parallel_for(N_vertex, [&](int64_t begin, int64_t end) {
+			for (int64_t a = begin; a < end; ++a) {
+				int64_t e = first_edge.at_unsafe(a);
+				for (int64_t k = upper.at_unsafe(a); k < one_ring.offset.at_unsafe(a + 1); ++k)
+					edges.at_unsafe(e++) = int2{ int(a), one_ring.index.at_unsafe(k) };
+			}
+		});
+
+		// Number of the (at most 3) edges of each triangle, -1 for the missing edges of degenerate triangles
+		auto edge_number = [&](int a, int b) -> int64_t {
+			if (a > b)
+				std::swap(a, b);
+			int const* const first = one_ring.index.data.data() + upper.at_unsafe(a);
+			int const* const last = one_ring.index.data.data() + one_ring.offset.at_unsafe(a + 1);
+			return first_edge.at_unsafe(a) + (std::lower_bound(first, last, b) - first);
+		};
+		numarray<int64_t> triangle_edge;
+		triangle_edge.resize(3 * int64_t(N_triangle));
+		parallel_for(int64_t(N_triangle), [&](int64_t begin, int64_t end) {
+			int corner[3];
+			for (int64_t k = begin; k < end; ++k) {
+				int const N_corner = distinct_corners(connectivity.at(size_t(k)), corner, N_vertex);
+				triangle_edge.at_unsafe(3 * k + 0) = N_corner >= 2 ? edge_number(corner[0], corner[1]) : -1;
+				triangle_edge.at_unsafe(3 * k + 1) = N_corner == 3 ? edge_number(corner[1], corner[2]) : -1;
+				triangle_edge.at_unsafe(3 * k + 2) = N_corner == 3 ? edge_number(corner[2], corner[0]) : -1;
+			}
+		});
+
+		// Counting sort of the sides of the triangles by edge: the triangles are listed in increasing order around each edge
+		csr_adjacency adjacency;
+		adjacency.offset.resize_clear(edges.size() + 1);
+		for (int64_t k = 0; k < triangle_edge.size(); ++k)
+			if (triangle_edge.at_unsafe(k) >= 0)
+				++adjacency.offset.at_unsafe(triangle_edge.at_unsafe(k) + 1);
+		accumulate_offset(adjacency.offset);
+
+		adjacency.index.resize(adjacency.offset.at_unsafe(edges.size()));
+		numarray<int64_t> fill = adjacency.offset;
+		for (int64_t k = 0; k < triangle_edge.size(); ++k)
+			if (triangle_edge.at_unsafe(k) >= 0)
+				adjacency.index.at_unsafe(fill.at_unsafe(triangle_edge.at_unsafe(k))++) = int(k / 3);
+
+		return adjacency;
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "cgp/02_numarray/numarray.hpp"
+#include "cgp/05_vec/vec.hpp"
+
+namespace cgp
+{
+	/** Adjacency lists stored in compressed sparse row (CSR) format
+	* The neighbors of the element i are index[offset[i]] ... index[offset[i+1]-1]:
+	*   all the lists are stored in two flat buffers (instead of one allocation per element).
+	* Usage: for (int j : adjacency.neighbors(i)) { ... } */
+	struct csr_adjacency
+	{
+		/** Start of the list of each element in index (size: number of elements + 1, offset[0]=0) */
+		numarray<int64_t> offset;
+		/** Concatenation of the lists of all the elements */
+		numarray<int> index;
+
+		/** Number of elements (the number of lists) */
+		size_t size() const;
+		/** Number of neighbors of the element i */
+		int degree(int i) const;
+		/** Neighbors of the element i (view on a part of index) */
+		numarray_view<int const> neighbors(int i) const;
+	};
+
+	// Adjacency of the triangles of a mesh (indices of the three vertices of each triangle)
+	//  The vertices are numbered from 0 to N_vertex-1 (by default N_vertex is the largest index + 1, vertices without triangles have empty lists).
+	//  The adjacency is built in O(number of triangles) with counting sorts, the lists are sorted in increasing order.
+
+	/** One-ring of each vertex: the vertices sharing an edge with the vertex i (each neighbor appears once) */
+	csr_adjacency vertex_to_vertex_adjacency(numarray_view<uint3 const> connectivity, int N_vertex = -1);
+	/** Triangles around each vertex: the triangles having the vertex i as a corner */
+	csr_adjacency vertex_to_face_adjacency(numarray_view<uint3 const> connectivity, int N_vertex = -1);
+	/** Triangles around each edge: the triangles having the edge e = (edges[e].x, edges[e].y) as a side (2 triangles for an interior edge of a manifold mesh, 1 on the border)
+	*   edges is filled with the edges of the mesh, each edge being stored once with edges[e].x < edges[e].y (edges are sorted by their first, then second vertex) */
+	csr_adjacency edge_to_face_adjacency(numarray_view<uint3 const> connectivity, numarray<int2>& edges, int N_vertex = -1);
+}
@@ -0,0 +1,92 @@
+#include "test_mesh_adjacency.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "../mesh_adjacency.hpp"
+#include "cgp/11_mesh/mesh/mesh.hpp"
+
+#include <set>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	void test_mesh_adjacency()
+	{
+		// Two triangles sharing the edge 1-2, a degenerate triangle, and an isolated vertex 5
+		{
+			numarray<uint3> connectivity = { uint3{0,1,2}, uint3{2,1,3}, uint3{3,4,3} };
+
+			csr_adjacency const one_ring = vertex_to_vertex_adjacency(connectivity, 6);
+			assert_cgp_no_msg(one_ring.size() == 6);
+			assert_cgp_no_msg(is_equal(one_ring.neighbors(0).to_numarray(), numarray<int>{ 1,2 }));
+			assert_cgp_no_msg(is_equal(one_ring.neighbors(1).to_numarray(), numarray<int>{ 0,2,3 }));
+			assert_cgp_no_msg(is_equal(one_ring.neighbors(3).to_numarray(), numarray<int>{ 1,2,4 }));
+			assert_cgp_no_msg(is_equal(one_ring.neighbors(4).to_numarray(), numarray<int>{ 3 }));
+			assert_cgp_no_msg(one_ring.degree(5) == 0);
+
+			csr_adjacency const faces = vertex_to_face_adjacency(connectivity);
+			assert_cgp_no_msg(faces.size() == 5);
+			assert_cgp_no_msg(is_equal(faces.neighbors(2).to_numarray(), numarray<int>{ 0,1 }));
+			assert_cgp_no_msg(is_equal(faces.neighbors(3).to_numarray(), numarray<int>{ 1,2 }));
+
+			numarray<int2> edges;
+			csr_adjacency const edge_faces = edge_to_face_adjacency(connectivity, edges);
+			assert_cgp_no_msg(is_equal(edges, numarray<int2>{ {0,1}, {0,2}, {1,2}, {1,3}, {2,3}, {3,4} }));
+			assert_cgp_no_msg(is_equal(edge_faces.neighbors(2).to_numarray(), numarray<int>{ 0,1 }));
+			assert_cgp_no_msg(is_equal(edge_faces.neighbors(5).to_numarray(), numarray<int>{ 2 }));
+			assert_cgp_no_msg(edge_faces.degree(0) == 1);
+		}
+
+		// Grid of triangles against a std::set based construction
+		{
+			int const N = 13;
+			numarray<uint3> connectivity;
+			for (int ku = 0; ku < N - 1; ++ku) {
+				for (int kv = 0; kv < N - 1; ++kv) {
+					unsigned int const idx = ku * N + kv;
+					connectivity.push_back(uint3{ idx, idx + 1, idx + 1 + N });
+					connectivity.push_back(uint3{ idx, idx + 1 + N, idx + N });
+				}
+			}
+
+			numarray<std::set<int> > one_ring_set(N * N);
+			std::set<std::pair<int, int> > edge_set;
+			for (uint3 const& tri : connectivity) {
+				for (int j = 0; j < 3; ++j) {
+					int const a = tri[j], b = tri[(j + 1) % 3];
+					one_ring_set[a].insert(b);
+					one_ring_set[b].insert(a);
+					edge_set.insert({ std::min(a, b), std::max(a, b) });
+				}
+			}
+
+			csr_adjacency const one_ring = vertex_to_vertex_adjacency(connectivity);
+			numarray<numarray<int> > const one_ring_array = connectivity_one_ring(connectivity);
+			assert_cgp_no_msg(one_ring.size() == N * N && one_ring_array.size() == N * N);
+			for (int k = 0; k < N * N; ++k) {
+				numarray<int> const expected(std::vector<int>(one_ring_set[k].begin(), one_ring_set[k].end()));
+				assert_cgp_no_msg(is_equal(one_ring.neighbors(k).to_numarray(), expected));
+				assert_cgp_no_msg(is_equal(one_ring_array[k], expected));
+			}
+
+			numarray<int2> edges;
+			csr_adjacency const edge_faces = edge_to_face_adjacency(connectivity, edges);
+			assert_cgp_no_msg(edges.size() == int64_t(edge_set.size()));
+			for (int e = 0; e < edges.size(); ++e) {
+				bool const border = (edges[e].x % N == edges[e].y % N && (edges[e].x % N == 0 || edges[e].x % N == N - 1))
+					|| (edges[e].x / N == edges[e].y / N && (edges[e].x / N == 0 || edges[e].x / N == N - 1));
+				assert_cgp_no_msg(edge_faces.degree(e) == (border ? 1 : 2));
+				for (int f : edge_faces.neighbors(e)) {
+					uint3 const& tri = connectivity[f];
+					int const n = int(tri.x == unsigned(edges[e].x) || tri.y == unsigned(edges[e].x) || tri.z == unsigned(edges[e].x))
+						+ int(tri.x == unsigned(edges[e].y) || tri.y == unsigned(edges[e].y) || tri.z == unsigned(edges[e].y));
+					assert_cgp_no_msg(n == 2);
+				}
+			}
+		}
+	}
+}
@@ -6,17 +6,31 @@ namespace cgp
 void bounding_box::initialize(mesh const& m) {
     initialize(m.position);
 }
-void bounding_box::initialize(numarray<vec3> const& position) 
+void bounding_box::initialize(numarray_view<vec3 const> position) 
 {
     assert_cgp(position.size()>0, "Must be at least 1 position for a bounding box");
 
-    p_min = position[0];
-    p_max = position[0];
-    for (int k = 1; k < position.size(); ++k) {
-        vec3 const& p = position[k];
-        p_min = vec3(std::min(p_min.x, p.x), std::min(p_min.y, p.y), std::min(p_min.z, p.z));
-        p_max = vec3(std::max(p_max.x, p.x), std::max(p_max.y, p.y), std::max(p_max.z, p.z));
-    }
+    // Bounding box of each chunk of positions, then of the chunks (see parallel_reduce)
+    bounding_box const box = parallel_reduce(int64_t(position.size()),
+        [&position](int64_t begin, int64_t end) {
+            bounding_box b;
+            b.p_min = position.at(begin);
+            b.p_max = position.at(begin);
+            for (int64_t k = begin + 1; k < end; ++k) {
+                vec3 const& p = position.at(k);
+                b.p_min = vec3(std::min(b.p_min.x, p.x), std::min(b.p_min.y, p.y), std::min(b.p_min.z, p.z));
+                b.p_max = vec3(std::max(b.p_max.x, p.x), std::max(b.p_max.y, p.y), std::max(b.p_max.z, p.z));
+            }
+            return b;
+        },
+        [](bounding_box const& a, bounding_box const& b) {
+            bounding_box c;
+            c.p_min = vec3(std::min(a.p_min.x, b.p_min.x), std::min(a.p_min.y, b.p_min.y), std::min(a.p_min.z, b.p_min.z));
+            c.p_max = vec3(std::max(a.p_max.x, b.p_max.x), std::max(a.p_max.y, b.p_max.y), std::max(a.p_max.z, b.p_max.z));
+            return c;
+        });
+    p_min = box.p_min;
+    p_max = box.p_max;
 
 }
 
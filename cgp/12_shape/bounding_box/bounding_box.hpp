@@ -14,8 +14,8 @@ struct bounding_box
 
     // Initialize a bounding box structure from a mesh
     void initialize(mesh const& m);
-    // Initialize a bounding box structure from a set of positions
-    void initialize(numarray<vec3> const& positions);
+    // Initialize a bounding box structure from a set of positions (numarray, std::vector, or view on a part of a buffer)
+    void initialize(numarray_view<vec3 const> positions);
 
     // Extend the bounding box by a given distance d
     //  p_min <- p_min - d; p_max <- p_max + d
@@ -21,14 +21,16 @@ namespace cgp
 		return curve;
 	}
 
-	numarray<vec3> curve_to_segments(numarray<vec3> const& curve_in)
+	numarray<vec3> curve_to_segments(numarray_view<vec3 const> curve_in)
 	{
 		assert_cgp(curve_in.size() >= 2, "Curve should have N_sample>=2");
 
+		size_t const N = curve_in.size();
 		numarray<vec3> segments;
-		for (int k = 1; k < curve_in.size(); ++k) {
-			segments.push_back(curve_in[k - 1]);
-			segments.push_back(curve_in[k]);
+		segments.resize(int(2 * (N - 1)));
+		for (size_t k = 1; k < N; ++k) {
+			segments.at(int(2 * k - 2)) = curve_in.at(k - 1);
+			segments.at(int(2 * k - 1)) = curve_in.at(k);
 		}
 
 		return segments;
@@ -1,3 +1,7 @@
 #pragma once
 
-#include "marching_cube/marching_cube.hpp"
\ No newline at end of file
+#include "marching_cube/marching_cube.hpp"
+#include "minmax_block_pyramid/minmax_block_pyramid.hpp"
+#include "marching_cube_chunked/marching_cube_chunked.hpp"
+#include "sdf_expression/sdf_expression.hpp"
+#include "mesh_to_sdf/mesh_to_sdf.hpp"
\ No newline at end of file
@@ -2,15 +2,20 @@
 
 #include "cgp/09_geometric_transformation/interpolation/interpolation.hpp"
 #include "helper/marching_cubes_lut.hpp"
+#include <algorithm>
+#include <limits>
+#include <tuple>
 #include <unordered_map>
 
 namespace cgp
 {
 
-	// Helper structure to hash a pair of index (a,b) as a unique number
-	struct hash_edge {
-		size_t operator()(std::pair<int, int> const& key) const;
-	};
+	void fill_position(vec3& cube_position, float ux, float uy, float uz, vec3 const& domain_min, vec3 const& domain_length)
+	{
+		cube_position.x = domain_min.x + ux * domain_length.x;
+		cube_position.y = domain_min.y + uy * domain_length.y;
+		cube_position.z = domain_min.z + uz * domain_length.z;
+	}
 
 	// Helper structure to store voxels information
 	struct cube_parameters {
@@ -19,72 +24,404 @@ namespace cgp
 		std::array<vec3, 8>   position;
 	};
 
+	// Helper structure giving the cells visited on each row (ky,kz) of the grid between x_begin <= kx < x_end
+	//  Without pyramid, all the cells are visited. Otherwise, only the cells of the active blocks are visited.
+	//  Usage: for (size_t kx = cells.first(ky, kz); kx < cells.x_end; kx = cells.next(ky, kz, kx))
+	struct marching_cube_active_cells {
+		size_t x_begin = 0;
+		size_t x_end = 0;
+		size_t block_size = 0;
+		size_t N_block_y = 0;
+		std::vector<std::vector<size_t>> active_x; // sorted indices bx of the active blocks for each row of blocks (by,bz). Empty if there is no pyramid.
+
+		marching_cube_active_cells(int3 const& samples, float iso, minmax_block_pyramid const* pyramid, size_t x_begin_arg, size_t x_end_arg)
+			:x_begin(x_begin_arg), x_end(x_end_arg)
+		{
+			if (pyramid == nullptr)
+				return;
+			if (!is_equal(pyramid->samples, samples))
+				error_cgp("The pyramid has a different dimension than the field");
+
+			int3 const dimension = pyramid->block_dimension();
+			block_size = pyramid->block_size;
+			N_block_y = dimension.y;
+			active_x.resize(size_t(dimension.y) * dimension.z);
+			for (int3 const& block : pyramid->active_blocks(iso))
+				active_x[block.y + N_block_y * block.z].push_back(block.x);
+		}
+		marching_cube_active_cells(int3 const& samples, float iso, minmax_block_pyramid const* pyramid)
+			:marching_cube_active_cells(samples, iso, pyramid, 0, samples.x - 1)
+		{}
+
+		size_t first(size_t ky, size_t kz) const
+		{
+			if (active_x.empty())
+				return x_begin;
+			return next_active(ky, kz, x_begin);
+		}
 
-	mesh marching_cube(grid_3D<float> const& field, spatial_domain_grid_3D const& domain, float iso)
-	{
-		assert_cgp_no_msg(is_equal(field.dimension, domain.samples));
+		size_t next(size_t ky, size_t kz, size_t kx) const
+		{
+			++kx;
+			if (active_x.empty() || kx % block_size != 0)
+				return kx;
+			// End of a block: jump to the next active block of the row
+			return next_active(ky, kz, kx);
+		}
 
-		// Compute the marching cube
-		std::vector<vec3> position;
-		std::vector<marching_cube_relative_coordinates> relative;
-		int const N = marching_cube(position, field.data.data, domain, iso, &relative);
+	private:
+		// First cell kx' >= kx in an active block of the row (x_end if there is none)
+		size_t next_active(size_t ky, size_t kz, size_t kx) const
+		{
+			std::vector<size_t> const& row = active_x[ky / block_size + N_block_y * (kz / block_size)];
+			auto const it = std::lower_bound(row.begin(), row.end(), kx / block_size);
+			return it == row.end() ? x_end : std::min(x_end, std::max(kx, *it * block_size));
+		}
+	};
 
 
-		// Compute the mesh with non-duplicated vertices
-		mesh m;
-		int const N_triangle = N / 3;
+	// Access to the values of the field on the linear (grid_3D_view) and brick (grid_3D_sparse, grid_3D_tiled) layouts
+	//  corner_values fills the values at the 8 corners of the cell (kx,ky,kz) in the order of marching_cube_lut_offset_cube
+	static float field_value(grid_3D_view<float const> const& field, size_t kx, size_t ky, size_t kz)
+	{
+		return field.at_unsafe(int(kx), int(ky), int(kz));
+	}
+	static void corner_values(grid_3D_view<float const> const& field, size_t kx, size_t ky, size_t kz, float* value)
+	{
+		float const* p = &field.at_unsafe(int(kx), int(ky), int(kz));
+		std::ptrdiff_t const sy = field.stride_2, sz = field.stride_3;
+		value[0] = p[0];  value[1] = p[1];  value[2] = p[1 + sy];  value[3] = p[sy];
+		value[4] = p[sz]; value[5] = p[1 + sz]; value[6] = p[1 + sy + sz]; value[7] = p[sy + sz];
+	}
 
-		// Storage avoiding to duplicate vertices at the same position if they are on the same voxel edge
-		std::unordered_map<std::pair<int, int>, int, hash_edge> unique_edge;
+	// Values of a grid stored by bricks read by the cells of the brick b: their corners are in the bricks b+(dx,dy,dz), with dx,dy,dz in {0,1}.
+	//  The 8 bricks are found once (in the hash table of a grid_3D_sparse), the missing ones (nullptr) are at the background value.
+	//  The values at the (B+1)^3 corners of the cells of the brick are copied in a local buffer, where the 8 corners of a cell are at constant offsets.
+	struct marching_cube_brick_neighborhood {
+		static int constexpr B = grid_3D_sparse<float>::brick_size;
+		static int constexpr shift = grid_3D_sparse<float>::brick_shift;
+		static_assert(grid_3D_tiled<float>::brick_size == B, "The bricks of grid_3D_sparse and grid_3D_tiled have the same size");
+		static int constexpr S = B + 1; // number of grid points along each axis of the buffer
+		int3 dimension;
+		int3 origin;  // first grid point of the brick b
+		std::array<float, S * S * S> value;
+		vec2 minmax;  // (min,max) of the values at the grid points of the buffer inside the grid
+
+		marching_cube_brick_neighborhood(grid_3D_sparse<float> const& field, int3 const& b)
+			:dimension(field.dimension), origin(B * b)
+		{
+			std::array<float const*, 8> brick;
+			for (int k = 0; k < 8; ++k) {
+				int3 const neighbor = b + int3{ k & 1, (k >> 1) & 1, k >> 2 };
+				bool const inside = neighbor.x < field.brick_dimension.x && neighbor.y < field.brick_dimension.y && neighbor.z < field.brick_dimension.z;
+				int const index = inside ? field.find_brick(neighbor) : -1;
+				brick[k] = index == -1 ? nullptr : field.brick_data(index);
+			}
+			fill(brick, field.background);
+		}
+		marching_cube_brick_neighborhood(grid_3D_tiled<float> const& field, int3 const& b)
+			:dimension(field.dimension), origin(B * b)
+		{
+			// The bricks outside of the grid are never read: the cells are inside the grid
+			std::array<float const*, 8> brick;
+			for (int k = 0; k < 8; ++k) {
+				int3 const neighbor = b + int3{ k & 1, (k >> 1) & 1, k >> 2 };
+				bool const inside = neighbor.x < field.brick_dimension.x && neighbor.y < field.brick_dimension.y && neighbor.z < field.brick_dimension.z;
+				brick[k] = inside ? field.brick_data(neighbor) : nullptr;
+			}
+			fill(brick, 0.0f);
+		}
 
-		for (int k_tri = 0; k_tri < N_triangle; ++k_tri) {
+		// Check if the corners of the cells of the brick have values on both sides of the iso-value
+		//  Same convention as minmax_block_pyramid::straddle: otherwise, all the cells are of type 0 or 255 and the brick has no triangle.
+		bool straddle(float iso) const
+		{
+			return minmax_block_pyramid::straddle(minmax, iso);
+		}
 
-			uint3 triangle_index;
-			for (int k = 0; k < 3; ++k) {
+	private:
+		// Copy the rows of B values of the brick (or of its neighbor along y, z) followed by the first value of the next brick along x
+		void fill(std::array<float const*, 8> const& brick, float background)
+		{
+			int constexpr mask = B - 1;
+			int const Lx = std::min(B, dimension.x - 1 - origin.x); // last grid point inside the grid along each axis
+			int const Ly = std::min(B, dimension.y - 1 - origin.y);
+			int const Lz = std::min(B, dimension.z - 1 - origin.z);
+			float value_min = std::numeric_limits<float>::max(), value_max = -std::numeric_limits<float>::max();
+			for (int lz = 0; lz <= Lz; ++lz) {
+				for (int ly = 0; ly <= Ly; ++ly) {
+					int const k = 2 * (ly >> shift) + 4 * (lz >> shift);
+					int const row = B * ((ly & mask) + B * (lz & mask));
+					float* v = value.data() + S * (ly + S * lz);
+					if (brick[k] != nullptr)
+						std::copy(brick[k] + row, brick[k] + row + B, v);
+					else
+						std::fill(v, v + B, background);
+					v[B] = brick[k + 1] != nullptr ? brick[k + 1][row] : background;
+					for (int lx = 0; lx <= Lx; ++lx) {
+						value_min = std::min(value_min, v[lx]);
+						value_max = std::max(value_max, v[lx]);
+					}
+				}
+			}
+			minmax = { value_min, value_max };
+		}
+	};
+	static float field_value(marching_cube_brick_neighborhood const& field, size_t kx, size_t ky, size_t kz)
+	{
+		int constexpr S = marching_cube_brick_neighborhood::S;
+		return field.value[(int(kx) - field.origin.x) + S * ((int(ky) - field.origin.y) + S * (int(kz) - field.origin.z))];
+	}
+	static void corner_values(marching_cube_brick_neighborhood const& field, size_t kx, size_t ky, size_t kz, float* value)
+	{
+		int constexpr S = marching_cube_brick_neighborhood::S;
+		float const* p = &field.value[(int(kx) - field.origin.x) + S * ((int(ky) - field.origin.y) + S * (int(kz) - field.origin.z))];
+		value[0] = p[0];     value[1] = p[1];         value[2] = p[1 + S];         value[3] = p[S];
+		value[4] = p[S * S]; value[5] = p[1 + S * S]; value[6] = p[1 + S + S * S]; value[7] = p[S + S * S];
+	}
 
-				int const idx = 3 * k_tri + k;
+	// Marching cube with shared vertices on the cells cell_min <= (kx,ky,kz) < cell_max
+	//  If gradient_normal is true, the normals are interpolated from the gradient of the field at the grid points (central differences).
+	//   They are oriented as -gradient, which is the orientation given by the triangles of the lookup table.
+	//  If fill_fields is false, only the positions (and normals) and the connectivity are set (the mesh is a part of a larger mesh).
+	//  If vertex_edge is not null, it is filled with the edge of the grid of each vertex, encoded as 3*offset(kx,ky,kz) + axis for the edge starting at the grid point (kx,ky,kz).
+	template <typename Field>
+	static mesh marching_cube_indexed(Field const& field, spatial_domain_grid_3D const& domain, float iso, int3 const& cell_min, int3 const& cell_max, minmax_block_pyramid const* pyramid, bool gradient_normal, bool fill_fields = true, std::vector<int64_t>* vertex_edge = nullptr)
+	{
+		assert_cgp_no_msg(is_equal(field.dimension, domain.samples));
 
-				// The indices of the edge of the current vertex
-				std::pair<int, int> const edge = { relative[3 * k_tri+k].k0, relative[3 * k_tri+k].k1 };
+		static std::array<std::array<int, 16>, 256> const triTable = marching_cube_lut_triTable();
+		static std::array<std::pair<int, int>, 12> const lut_edge_order = marching_cube_lut_edge_order();
+		static std::array<int3, 8> const lut_offset_cube = marching_cube_lut_offset_cube();
+
+		// Each edge of the cube is described by its first corner (the one with the smallest coordinates) and its axis (0:x, 1:y, 2:z)
+		std::array<int3, 12> edge_corner;
+		std::array<int, 12> edge_axis;
+		for (int k = 0; k < 12; ++k) {
+			int3 const& a = lut_offset_cube[lut_edge_order[k].first];
+			int3 const& b = lut_offset_cube[lut_edge_order[k].second];
+			edge_corner[k] = { std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z) };
+			edge_axis[k] = a.x != b.x ? 0 : (a.y != b.y ? 1 : 2);
+		}
 
-				// Check if this edge has already been encountered
-				auto const it = unique_edge.find(edge);
+		vec3 const domain_min = domain.center - domain.length / 2.0;
+		vec3 const& domain_length = domain.length;
 
-				// if it is a new edge, add this vertex as a new one in the mesh
-				if (it == unique_edge.end()) {
-					int const idx_new_vertex = m.position.size(); // create a new vertex index
-					triangle_index[k] = idx_new_vertex; // set the current index to the triangle connectivity
-					m.position.push_back(position[idx]); // add this vertex in the mesh
-					unique_edge[edge] = idx_new_vertex; // add the edge in the unique structure for further check
-				}
-				// if the edge has already been encountered - only reuse the index in the connectivity but do not add the vertex again
-				else {
-					int const idx_existing_vertex = it->second;   // the index that has already be defined
-					triangle_index[k] = idx_existing_vertex;      // set this existing index in the triangle connectivity
+		size_t const Nx = domain.samples.x;
+		size_t const Ny = domain.samples.y;
+		size_t const Nz = domain.samples.z;
+		float const dx = 1 / (Nx - 1.0f);
+		float const dy = 1 / (Ny - 1.0f);
+		float const dz = 1 / (Nz - 1.0f);
+
+		mesh m;
+		size_t const x_begin = std::max(0, cell_min.x), x_end = std::min(cell_max.x, int(Nx) - 1);
+		size_t const y_begin = std::max(0, cell_min.y), y_end = std::min(cell_max.y, int(Ny) - 1);
+		size_t const z_begin = std::max(0, cell_min.z), z_end = std::min(cell_max.z, int(Nz) - 1);
+		if (x_begin >= x_end || y_begin >= y_end || z_begin >= z_end)
+			return m;
+
+		// Rolling cache storing the index of the vertex created on each edge of the grid (-1 if there is no vertex yet)
+		//  edge_xy[layer][axis] stores the x and y edges starting at the grid points of the layers kz (layer=0) and kz+1 (layer=1)
+		//  edge_z stores the z edges between the layers kz and kz+1
+		//  Each vertex is therefore created once, and shared by all the triangles using it.
+		size_t const Px = x_end - x_begin + 1; // number of grid points of the region along x
+		size_t const Py = y_end - y_begin + 1;
+		std::array<std::array<std::vector<int>, 2>, 2> edge_xy;
+		for (auto& layer : edge_xy)
+			for (auto& edge : layer)
+				edge.assign(Px * Py, -1);
+		std::vector<int> edge_z(Px * Py, -1);
+
+		// Gradient of the field at the grid point k=(kx,ky,kz) (one-sided differences on the border)
+		size_t const N_axis[3] = { Nx, Ny, Nz };
+		vec3 const voxel_length = domain.voxel_length();
+		auto gradient = [&](size_t const* k) -> vec3 {
+			vec3 g;
+			for (int axis = 0; axis < 3; ++axis) {
+				size_t previous[3] = { k[0], k[1], k[2] };
+				size_t next[3] = { k[0], k[1], k[2] };
+				if (k[axis] > 0) --previous[axis];
+				if (k[axis] + 1 < N_axis[axis]) ++next[axis];
+				float const h = (next[axis] - previous[axis]) * voxel_length[axis];
+				g[axis] = (field_value(field, next[0], next[1], next[2]) - field_value(field, previous[0], previous[1], previous[2])) / h;
+			}
+			return g;
+		};
+
+		// Return the index of the vertex on the edge starting at the grid point (kx,ky,kz) along axis, and create it if needed
+		auto vertex_on_edge = [&](size_t kx, size_t ky, size_t kz, int layer, int axis) -> int {
+			size_t const local = (kx - x_begin) + Px * (ky - y_begin);
+			int& slot = axis == 2 ? edge_z[local] : edge_xy[layer][axis][local];
+			if (slot == -1) {
+				size_t const i0[3] = { kx, ky, kz };
+				size_t const i1[3] = { kx + (axis == 0), ky + (axis == 1), kz + (axis == 2) };
+				float const v0 = field_value(field, i0[0], i0[1], i0[2]) - iso;
+				float const v1 = field_value(field, i1[0], i1[1], i1[2]) - iso;
+				float const alpha = (0 - v0) / (v1 - v0);
+
+				vec3 p0, p1;
+				float const ux = kx * dx, uy = ky * dy, uz = kz * dz;
+				fill_position(p0, ux, uy, uz, domain_min, domain_length);
+				fill_position(p1, ux + (axis == 0 ? dx : 0), uy + (axis == 1 ? dy : 0), uz + (axis == 2 ? dz : 0), domain_min, domain_length);
+
+				slot = m.position.size();
+				m.position.push_back((1 - alpha) * p0 + alpha * p1);
+
+				if (gradient_normal)
+					m.normal.push_back(-normalize((1 - alpha) * gradient(i0) + alpha * gradient(i1)));
+				if (vertex_edge != nullptr)
+					vertex_edge->push_back(3 * offset_grid(long3{ int64_t(kx), int64_t(ky), int64_t(kz) }, Nx, Ny) + axis);
+			}
+			return slot;
+		};
+
+		marching_cube_active_cells const cells(domain.samples, iso, pyramid, x_begin, x_end);
+		for (size_t kz = z_begin; kz < z_end; ++kz) {
+			for (size_t ky = y_begin; ky < y_end; ++ky) {
+				for (size_t kx = cells.first(ky, kz); kx < x_end; kx = cells.next(ky, kz, kx)) {
+
+					// Type of cube given by the sign of the values at its vertices
+					float value[8];
+					corner_values(field, kx, ky, kz, value);
+					int type = 0;
+					for (int k = 0; k < 8; ++k)
+						if (value[k] - iso < 0)
+							type |= (1 << k);
+
+					// No change of sign
+					if (type == 0 || type == 255)
+						continue;
+
+					for (size_t k = 0; triTable[type][k] != -1; k += 3) {
+						uint3 triangle_index;
+						for (int j = 0; j < 3; ++j) {
+							int const edge = triTable[type][k + j];
+							int3 const& c = edge_corner[edge];
+							triangle_index[j] = vertex_on_edge(kx + c.x, ky + c.y, kz + c.z, c.z, edge_axis[edge]);
+						}
+						m.connectivity.push_back(triangle_index);
+					}
 				}
 			}
-			m.connectivity.push_back(triangle_index); // add the new triangle
-			
-			
+
+			// The layer kz+1 becomes the first layer of the next slice of voxels
+			for (int axis = 0; axis < 2; ++axis) {
+				std::swap(edge_xy[0][axis], edge_xy[1][axis]);
+				std::fill(edge_xy[1][axis].begin(), edge_xy[1][axis].end(), -1);
+			}
+			std::fill(edge_z.begin(), edge_z.end(), -1);
 		}
 
-		m.fill_empty_field();
+		if (fill_fields && m.position.size() > 0)
+			m.fill_empty_field();
 		return m;
 	}
 
+	mesh marching_cube(grid_3D_view<float const> field, spatial_domain_grid_3D const& domain, float iso, minmax_block_pyramid const* pyramid)
+	{
+		return marching_cube_indexed(field, domain, iso, { 0,0,0 }, domain.samples - int3{ 1,1,1 }, pyramid, false);
+	}
 
-	size_t hash_edge::operator()(std::pair<int, int> const& key) const {
-		return std::hash<int>{}(key.first) ^ std::hash<int>{}(key.second);
+	mesh marching_cube(grid_3D_view<float const> field, spatial_domain_grid_3D const& domain, float iso, int3 const& cell_min, int3 const& cell_max, minmax_block_pyramid const* pyramid)
+	{
+		return marching_cube_indexed(field, domain, iso, cell_min, cell_max, pyramid, true);
 	}
 
+	// Marching cube extracted brick by brick on the list of bricks (sorted by (z,y,x) index), the cells of the brick b reading their values in marching_cube_brick_neighborhood(field, b)
+	//  The vertices on the faces of the bricks are shared with the adjacent bricks (found from their edge in the grid).
+	template <typename Grid>
+	static mesh marching_cube_by_bricks(Grid const& field, std::vector<int3> const& bricks, spatial_domain_grid_3D const& domain, float iso)
+	{
+		int constexpr B = marching_cube_brick_neighborhood::B;
+		int const Nx = domain.samples.x, Ny = domain.samples.y;
+		mesh m;
+		std::unordered_map<int64_t, unsigned int> border_vertex; // edge of the grid -> index of the vertex in m
+		std::vector<int64_t> vertex_edge;
+		std::vector<unsigned int> new_index;
+		for (int3 const& b : bricks) {
+			// Bricks without a change of sign are skipped before allocating the caches of marching_cube_indexed
+			marching_cube_brick_neighborhood const neighborhood(field, b);
+			if (!neighborhood.straddle(iso))
+				continue;
+
+			int3 const cell_min = B * b;
+			int3 const cell_max = cell_min + int3{ B,B,B };
+			vertex_edge.clear();
+			mesh const brick = marching_cube_indexed(neighborhood, domain, iso, cell_min, cell_max, nullptr, false, false, &vertex_edge);
+
+			new_index.resize(brick.position.size());
+			for (size_t k = 0; k < brick.position.size(); ++k) {
+				int3 const p = index_grid_from_offset(vertex_edge[k] / 3, Nx, Ny);
+				bool const border = p.x == cell_min.x || p.y == cell_min.y || p.z == cell_min.z || p.x == cell_max.x || p.y == cell_max.y || p.z == cell_max.z;
+				if (border) {
+					auto const it = border_vertex.insert({ vertex_edge[k], (unsigned int)m.position.size() });
+					new_index[k] = it.first->second;
+					if (it.second == false)
+						continue;
+				}
+				else
+					new_index[k] = m.position.size();
+				m.position.push_back(brick.position[k]);
+			}
+			for (uint3 const& triangle : brick.connectivity)
+				m.connectivity.push_back({ new_index[triangle.x], new_index[triangle.y], new_index[triangle.z] });
+		}
+
+		if (m.position.size() > 0)
+			m.fill_empty_field();
+		return m;
+	}
 
-	void fill_position(vec3& cube_position, float ux, float uy, float uz, vec3 const& domain_min, vec3 const& domain_length)
+	static void sort_bricks(std::vector<int3>& bricks)
 	{
-		cube_position.x = domain_min.x + ux * domain_length.x;
-		cube_position.y = domain_min.y + uy * domain_length.y;
-		cube_position.z = domain_min.z + uz * domain_length.z;
+		std::sort(bricks.begin(), bricks.end(), [](int3 const& a, int3 const& b) { return std::make_tuple(a.z, a.y, a.x) < std::make_tuple(b.z, b.y, b.x); });
+		bricks.erase(std::unique(bricks.begin(), bricks.end(), [](int3 const& a, int3 const& b) { return is_equal(a, b); }), bricks.end());
 	}
 
+	mesh marching_cube(grid_3D_sparse<float> const& field, spatial_domain_grid_3D const& domain, float iso)
+	{
+		assert_cgp_no_msg(is_equal(field.dimension, domain.samples));
+
+		// Cells (kx,ky,kz) to visit: the cells having a corner in an active brick, i.e. the cells of the active bricks and of their neighbors at -x, -y, -z.
+		//  The other cells have their 8 corners at the background value.
+		std::vector<int3> bricks;
+		for (int3 const& b : field.brick_coordinates)
+			for (int dz = 0; dz < 2; ++dz)
+				for (int dy = 0; dy < 2; ++dy)
+					for (int dx = 0; dx < 2; ++dx)
+						if (b.x >= dx && b.y >= dy && b.z >= dz)
+							bricks.push_back(b - int3{ dx,dy,dz });
+		sort_bricks(bricks);
+
+		return marching_cube_by_bricks(field, bricks, domain, iso);
+	}
+
+	mesh marching_cube(grid_3D_tiled<float> const& field, spatial_domain_grid_3D const& domain, float iso, minmax_block_pyramid const* pyramid)
+	{
+		assert_cgp_no_msg(is_equal(field.dimension, domain.samples));
+		int constexpr B = grid_3D_tiled<float>::brick_size;
+
+		// All the bricks, or the bricks overlapping a block of cells of the pyramid that may contain the iso-surface
+		std::vector<int3> bricks;
+		if (pyramid == nullptr) {
+			field.for_each_brick([&bricks](int3 const& b, float const*) { bricks.push_back(b); });
+			return marching_cube_by_bricks(field, bricks, domain, iso);
+		}
+
+		if (!is_equal(pyramid->samples, domain.samples))
+			error_cgp("The pyramid has a different dimension than the field");
+		int const s = pyramid->block_size;
+		for (int3 const& block : pyramid->active_blocks(iso))
+			for (int bz = block.z * s / B; bz <= (block.z * s + s - 1) / B && bz < field.brick_dimension.z; ++bz)
+				for (int by = block.y * s / B; by <= (block.y * s + s - 1) / B && by < field.brick_dimension.y; ++by)
+					for (int bx = block.x * s / B; bx <= (block.x * s + s - 1) / B && bx < field.brick_dimension.x; ++bx)
+						bricks.push_back({ bx,by,bz });
+		sort_bricks(bricks);
+		return marching_cube_by_bricks(field, bricks, domain, iso);
+	}
+
+
 	void interpolate_position_on_edge(vec3& p, float& alpha, int idx0, int idx1, std::array<vec3, 8> const& cube_position, std::array<float, 8> const& cube_value)
 	{
 		vec3 const& p0 = cube_position[idx0];
@@ -102,7 +439,9 @@ namespace cgp
 
 
 
-	size_t marching_cube(std::vector<vec3>& position, std::vector<float> const& field, spatial_domain_grid_3D const& domain, float iso, std::vector<marching_cube_relative_coordinates>* relative)
+	// Marching cube restricted to the slab of voxels kz_begin <= kz < kz_end
+	//  The triangles are stored in position (and relative) starting at counter_position. Return the new value of counter_position.
+	static size_t marching_cube_slab(size_t kz_begin, size_t kz_end, std::vector<vec3>& position, std::vector<marching_cube_relative_coordinates>* relative, size_t counter_position, numarray_view<float const> field, spatial_domain_grid_3D const& domain, float iso, marching_cube_active_cells const& cells)
 	{
 		// Table of correspondance between the 256 type of cube and the edges on which new vertices are created
 		static std::array<std::array<int, 16>, 256> const triTable = marching_cube_lut_triTable();
@@ -121,8 +460,6 @@ namespace cgp
 		float const dy = 1 / (Ny - 1.0f);
 		float const dz = 1 / (Nz - 1.0f);
 
-		size_t counter_position = 0;
-
 		// Marching-Cube
 		// *************************** //
 		cube_parameters cube;
@@ -133,11 +470,11 @@ namespace cgp
 
 		bool exist_cube_value_positive;
 		bool exist_cube_value_negative;
-		for (size_t kz = 0; kz < Nz - 1; ++kz) {
+		for (size_t kz = kz_begin; kz < kz_end; ++kz) {
 			float const uz = kz * dz;
 			for (size_t ky = 0; ky < Ny - 1; ++ky) {
 				float const uy = ky * dy;
-				for (size_t kx = 0; kx < Nx - 1; ++kx) {
+				for (size_t kx = cells.first(ky, kz); kx < Nx - 1; kx = cells.next(ky, kz, kx)) {
 					float const ux = kx * dx;
 
 					size_t const index_corner = kx + Nx * (ky + Ny * kz);
@@ -148,7 +485,7 @@ namespace cgp
 
 					// get values
 					for (size_t k = 0; k < 8; ++k)
-						cube.value[k] = field[cube.index[k]] - iso;
+						cube.value[k] = field.at(cube.index[k]) - iso;
 
 					// check if there is at least one change of sign in the vertices
 					exist_cube_value_positive = false;
@@ -260,4 +597,67 @@ namespace cgp
 		return counter_position;
 
 	}
+
+	// Number of threads used for a field of N_voxel voxels (small fields are processed on a single thread)
+	static int marching_cube_thread_count(int thread_count, size_t N_voxel)
+	{
+		size_t const minimal_voxel_per_thread = 1 << 16;
+		return int(std::min(size_t(parallel_thread_count(thread_count)), std::max(size_t(1), N_voxel / minimal_voxel_per_thread)));
+	}
+
+	size_t marching_cube(std::vector<vec3>& position, numarray_view<float const> field, spatial_domain_grid_3D const& domain, float iso, std::vector<marching_cube_relative_coordinates>* relative, int thread_count, minmax_block_pyramid const* pyramid, marching_cube_workspace* workspace)
+	{
+		size_t const Nz = domain.samples.z;
+		if (Nz < 2)
+			return 0;
+		assert_cgp(field.size() == size_t(domain.samples.x) * domain.samples.y * Nz, "The field has a different size than the domain samples");
+		size_t const N_layer = Nz - 1;
+		marching_cube_active_cells const cells(domain.samples, iso, pyramid);
+
+		int const N_thread = marching_cube_thread_count(thread_count, field.size());
+		if (N_thread == 1)
+			return marching_cube_slab(0, N_layer, position, relative, 0, field, domain, iso, cells);
+
+		// The domain is split in z-slabs (more slabs than threads to balance the load as the surface is not uniformly distributed)
+		//  The first slab is directly stored in position, the other ones in their own buffer (kept in the workspace, and only grown between the calls).
+		size_t const N_slab = std::min(N_layer, size_t(4 * N_thread));
+		marching_cube_workspace local_workspace;
+		marching_cube_workspace& w = workspace != nullptr ? *workspace : local_workspace;
+		if (w.slab_position.size() < N_slab)
+			w.slab_position.resize(N_slab);
+		if (relative != nullptr && w.slab_relative.size() < N_slab)
+			w.slab_relative.resize(N_slab);
+		w.slab_counter.assign(N_slab, 0);
+		std::vector<std::vector<vec3>>& slab_position = w.slab_position;
+		std::vector<std::vector<marching_cube_relative_coordinates>>& slab_relative = w.slab_relative;
+		std::vector<size_t>& slab_counter = w.slab_counter;
+
+		parallel_for_task(N_slab, [&](int64_t k_slab, int) {
+			size_t const kz_begin = k_slab * N_layer / N_slab;
+			size_t const kz_end = (k_slab + 1) * N_layer / N_slab;
+			if (k_slab == 0)
+				slab_counter[0] = marching_cube_slab(kz_begin, kz_end, position, relative, 0, field, domain, iso, cells);
+			else
+				slab_counter[k_slab] = marching_cube_slab(kz_begin, kz_end, slab_position[k_slab], relative != nullptr ? &slab_relative[k_slab] : nullptr, 0, field, domain, iso, cells);
+		}, N_thread);
+
+		// Concatenate the slabs in order: the result is identical to the single thread version
+		size_t counter_position = slab_counter[0];
+		size_t N_total = 0;
+		for (size_t k_slab = 0; k_slab < N_slab; ++k_slab)
+			N_total += slab_counter[k_slab];
+		if (position.size() < N_total)
+			position.resize(N_total);
+		if (relative != nullptr && relative->size() < N_total)
+			relative->resize(N_total);
+		for (size_t k_slab = 1; k_slab < N_slab; ++k_slab) {
+			size_t const N = slab_counter[k_slab];
+			std::copy(slab_position[k_slab].begin(), slab_position[k_slab].begin() + N, position.begin() + counter_position);
+			if (relative != nullptr)
+				std::copy(slab_relative[k_slab].begin(), slab_relative[k_slab].begin() + N, relative->begin() + counter_position);
+			counter_position += N;
+		}
+
+		return counter_position;
+	}
 }
\ No newline at end of file
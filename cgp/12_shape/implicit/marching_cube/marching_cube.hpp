@@ -3,12 +3,32 @@
 #include "cgp/04_grid_container/grid/grid.hpp"
 #include "cgp/11_mesh/mesh.hpp"
 #include "cgp/12_shape/spatial_domain/spatial_domain.hpp"
+#include "cgp/12_shape/implicit/minmax_block_pyramid/minmax_block_pyramid.hpp"
 
 namespace cgp {
 
 	/** A simple-to-use marching cube that takes as input a discrete field, a 3D domain, and the iso-value, and returns a mesh without duplicating the vertices at the same position. 
-	* A new mesh is created at each call which is good for single call, but not ideal for efficiency if used in the animation loop. */
-	mesh marching_cube(grid_3D<float> const& field, spatial_domain_grid_3D const& domain, float iso);
+	* The vertices are shared between the triangles during the extraction (one vertex per edge of the grid crossing the iso-surface, stored in a cache of two layers of the grid).
+	* A new mesh is created at each call which is good for single call, but not ideal for efficiency if used in the animation loop.
+	* If the (min,max) pyramid of the field is given, only the cells of the blocks that may contain the iso-surface are visited (the result is the same).
+	* The field can be a grid_3D, or a view on a block of a larger grid (see grid_3D_view). */
+	mesh marching_cube(grid_3D_view<float const> field, spatial_domain_grid_3D const& domain, float iso, minmax_block_pyramid const* pyramid=nullptr);
+
+	/** Marching cube restricted to the cells cell_min <= (kx,ky,kz) < cell_max of the grid (the cell (kx,ky,kz) has the grid points (kx,ky,kz) and (kx+1,ky+1,kz+1) as corners).
+	* The normals are interpolated from the gradient of the field, so that the meshes of adjacent regions are continuous along their common border.
+	* Used to extract the surface by bricks (see marching_cube_chunked) */
+	mesh marching_cube(grid_3D_view<float const> field, spatial_domain_grid_3D const& domain, float iso, int3 const& cell_min, int3 const& cell_max, minmax_block_pyramid const* pyramid=nullptr);
+
+	/** Marching cube on a sparse field (see grid_3D_sparse): only the cells touching an active brick are visited, the other cells being at the background value.
+	* The cost is proportional to the number of active bricks, and not to the size of the domain.
+	* The mesh is extracted brick by brick, the vertices computed on the common faces of two bricks are merged. */
+	mesh marching_cube(grid_3D_sparse<float> const& field, spatial_domain_grid_3D const& domain, float iso);
+
+	/** Marching cube on a field stored by bricks (see grid_3D_tiled): the cells are visited brick by brick in the storage order of the field.
+	* The values of a brick (and of the first layers of its neighbors) are scanned once, the bricks without a change of sign are skipped without visiting their cells.
+	* The triangles are the ones of the marching cube on the linear grid (in a different order), the vertices computed on the common faces of two bricks are merged.
+	* If the (min,max) pyramid of the field is given, only the bricks overlapping the blocks that may contain the iso-surface are visited. */
+	mesh marching_cube(grid_3D_tiled<float> const& field, spatial_domain_grid_3D const& domain, float iso, minmax_block_pyramid const* pyramid=nullptr);
 
 
 	struct marching_cube_relative_coordinates {
@@ -17,9 +37,21 @@ namespace cgp {
 		float alpha;
 	};
 
+	/** Buffers of the multi-threaded marching cube storing the triangles of each z-slab before their concatenation.
+	* Passing the same workspace to successive calls (ex. extraction at each frame of an animation) reuses the memory allocated by the previous calls. */
+	struct marching_cube_workspace {
+		std::vector<std::vector<vec3>> slab_position;
+		std::vector<std::vector<marching_cube_relative_coordinates>> slab_relative;
+		std::vector<size_t> slab_counter;
+	};
+
 	/** A fast marching cube that generate triangles in minimizing the number of resize of not needed. The vertices of the triangles are duplicated.
 	* - Return the actual number of valid vertices (that may be smaller than the size of the position)
 	* - If the parameter relative is not null, it is filled with the indices of the indice grid corresponding to the edge on which the vertex lie. 
+	* - The domain is split in z-slabs processed by thread_count threads (0: global number of threads, see set_parallel_thread_count - small fields use a single thread). The slabs are concatenated in order, so the result doesn't depend on the number of threads.
+	* - If the (min,max) pyramid of the field is given, only the cells of the blocks that may contain the iso-surface are visited (the result is the same).
+	* - The field can be a std::vector, a numarray, or a view on a buffer storing the values (see numarray_view).
+	* - If the workspace is given, the buffers of the slabs are kept between the calls (otherwise they are allocated at each call).
 	* - Note: the parameters are set using row std::vector to handle possibly large mesh with indices using size_t instead of int */
-	size_t marching_cube(std::vector<vec3>& position, std::vector<float> const& field, spatial_domain_grid_3D const& domain, float iso, std::vector<marching_cube_relative_coordinates>* relative=nullptr);
+	size_t marching_cube(std::vector<vec3>& position, numarray_view<float const> field, spatial_domain_grid_3D const& domain, float iso, std::vector<marching_cube_relative_coordinates>* relative=nullptr, int thread_count=0, minmax_block_pyramid const* pyramid=nullptr, marching_cube_workspace* workspace=nullptr);
 }
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "test_marching_cube.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "../marching_cube.hpp"
+#include "cgp/12_shape/implicit/marching_cube_chunked/marching_cube_chunked.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+#include <vector>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	// Positions of the corners of each triangle, sorted: independent of the order of the triangles and of the sharing of the vertices
+	static std::vector<std::array<float, 9>> sorted_triangles(mesh const& m)
+	{
+		std::vector<std::array<float, 9>> triangles;
+		for (uint3 const& t : m.connectivity) {
+			std::array<float, 9> corners;
+			for (int j = 0; j < 3; ++j)
+				for (int c = 0; c < 3; ++c)
+					corners[3 * j + c] = m.position[t[j]][c];
+			triangles.push_back(corners);
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	static grid_3D<float> sphere_field(spatial_domain_grid_3D const& domain, float radius)
+	{
+		grid_3D<float> field;
+		field.resize(domain.samples);
+		for (int z = 0; z < domain.samples.z; ++z)
+			for (int y = 0; y < domain.samples.y; ++y)
+				for (int x = 0; x < domain.samples.x; ++x)
+					field(x, y, z) = norm(domain.position({ x,y,z })) - radius;
+		return field;
+	}
+
+	void test_marching_cube()
+	{
+		// 64^3 samples: large enough to be split in slabs processed by several threads
+		int const N = 64;
+		spatial_domain_grid_3D const domain = spatial_domain_grid_3D::from_center_length({ 0,0,0 }, { 2,2,2 }, { N,N,N });
+		grid_3D<float> field = sphere_field(domain, 0.6f);
+
+		// Triangle soup: the multi-threaded extraction is identical to the single thread one
+		std::vector<vec3> soup;
+		std::vector<marching_cube_relative_coordinates> relative;
+		size_t const N_soup = marching_cube(soup, field.data.data, domain, 0.0f, &relative, 1);
+		assert_cgp_no_msg(N_soup > 0 && N_soup % 3 == 0);
+		{
+			std::vector<vec3> soup_thread;
+			std::vector<marching_cube_relative_coordinates> relative_thread;
+			marching_cube_workspace workspace;
+			for (int k = 0; k < 2; ++k) {
+				size_t const N_thread = marching_cube(soup_thread, field.data.data, domain, 0.0f, &relative_thread, 4, nullptr, &workspace);
+				assert_cgp_no_msg(N_thread == N_soup);
+				assert_cgp_no_msg(std::memcmp(soup_thread.data(), soup.data(), N_soup * sizeof(vec3)) == 0);
+				for (size_t i = 0; i < N_soup; ++i)
+					assert_cgp_no_msg(relative_thread[i].k0 == relative[i].k0 && relative_thread[i].k1 == relative[i].k1);
+			}
+		}
+
+		// Indexed mesh: same triangles as the soup, where the vertices on the same edge of the grid are welded
+		mesh const m = marching_cube(field, domain, 0.0f);
+		{
+			assert_cgp_no_msg(m.connectivity.size() * 3 == N_soup);
+			std::map<std::pair<size_t, size_t>, unsigned int> edge_to_vertex;
+			for (size_t i = 0; i < N_soup; ++i) {
+				unsigned int const vertex = m.connectivity[i / 3][i % 3];
+				std::pair<size_t, size_t> const edge = { std::min(relative[i].k0, relative[i].k1), std::max(relative[i].k0, relative[i].k1) };
+				auto const it = edge_to_vertex.insert({ edge, vertex });
+				assert_cgp_no_msg(it.first->second == vertex);
+				assert_cgp_no_msg(norm(m.position[vertex] - soup[i]) < 1e-5f);
+			}
+			assert_cgp_no_msg(edge_to_vertex.size() == m.position.size());
+		}
+
+		// The (min,max) pyramid skips empty cells without changing the result
+		minmax_block_pyramid pyramid(field);
+		{
+			std::vector<vec3> soup_pyramid;
+			size_t const N_pyramid = marching_cube(soup_pyramid, field.data.data, domain, 0.0f, nullptr, 1, &pyramid);
+			assert_cgp_no_msg(N_pyramid == N_soup);
+			assert_cgp_no_msg(std::memcmp(soup_pyramid.data(), soup.data(), N_soup * sizeof(vec3)) == 0);
+
+			mesh const m_pyramid = marching_cube(field, domain, 0.0f, &pyramid);
+			assert_cgp_no_msg(m_pyramid.connectivity.size() == m.connectivity.size());
+			assert_cgp_no_msg(sorted_triangles(m_pyramid) == sorted_triangles(m));
+		}
+
+		// Tiled field: extraction brick by brick, same triangles as the linear grid (all the bricks, or only the ones touching active blocks of the pyramid)
+		{
+			grid_3D_tiled<float> const tiled(field);
+			mesh const m_tiled = marching_cube(tiled, domain, 0.0f);
+			assert_cgp_no_msg(m_tiled.position.size() == m.position.size());
+			assert_cgp_no_msg(sorted_triangles(m_tiled) == sorted_triangles(m));
+
+			mesh const m_tiled_pyramid = marching_cube(tiled, domain, 0.0f, &pyramid);
+			assert_cgp_no_msg(m_tiled_pyramid.position.size() == m.position.size());
+			assert_cgp_no_msg(sorted_triangles(m_tiled_pyramid) == sorted_triangles(m));
+
+			// Dimension which is not a multiple of the brick size, and pyramid blocks overlapping several bricks
+			spatial_domain_grid_3D const domain_odd = spatial_domain_grid_3D::from_center_length({ 0,0,0 }, { 2,2,2 }, { 37,29,45 });
+			grid_3D<float> const field_odd = sphere_field(domain_odd, 0.7f);
+			minmax_block_pyramid const pyramid_odd(field_odd, 6);
+			mesh const m_odd = marching_cube(field_odd, domain_odd, 0.0f);
+			assert_cgp_no_msg(sorted_triangles(marching_cube(grid_3D_tiled<float>(field_odd), domain_odd, 0.0f)) == sorted_triangles(m_odd));
+			assert_cgp_no_msg(sorted_triangles(marching_cube(grid_3D_tiled<float>(field_odd), domain_odd, 0.0f, &pyramid_odd)) == sorted_triangles(m_odd));
+		}
+
+		// Sparse field storing a narrow band around the sphere: same surface as the dense field with the same values
+		{
+			float const band = 0.1f;
+			grid_3D<float> clamped = field;
+			for (float& v : clamped.data)
+				v = std::min(std::max(v, -band), band);
+			grid_3D_sparse<float> const sparse(clamped, band);
+			assert_cgp_no_msg(sparse.number_of_bricks() < (N / 8) * (N / 8) * (N / 8));
+
+			mesh const m_sparse = marching_cube(sparse, domain, 0.0f);
+			mesh const m_dense = marching_cube(sparse.to_grid(), domain, 0.0f);
+			assert_cgp_no_msg(m_sparse.position.size() == m_dense.position.size());
+			assert_cgp_no_msg(sorted_triangles(m_sparse) == sorted_triangles(m_dense));
+		}
+
+		// Chunked extraction
+		{
+			marching_cube_chunked chunked;
+			chunked.initialize(field, domain, 0.0f, 16);
+			auto const full_extraction = [&]() { return marching_cube(field, domain, 0.0f, { 0,0,0 }, domain.samples - int3{ 1,1,1 }); };
+			assert_cgp_no_msg(sorted_triangles(chunked.merged_mesh()) == sorted_triangles(full_extraction()));
+
+			// Local edit: a bump added on the surface
+			int3 const index_min = { 36,28,28 }, index_max = { 52,36,36 };
+			for (int z = index_min.z; z <= index_max.z; ++z)
+				for (int y = index_min.y; y <= index_max.y; ++y)
+					for (int x = index_min.x; x <= index_max.x; ++x)
+						field(x, y, z) -= 0.05f;
+			chunked.notify_modified(index_min, index_max);
+			std::vector<int> const updated = chunked.update(field);
+			assert_cgp_no_msg(updated.size() > 0 && int(updated.size()) < chunked.number_of_bricks());
+
+			// Only the modified bricks are extracted again, and the mesh is the same as a full extraction of the edited field
+			assert_cgp_no_msg(sorted_triangles(chunked.merged_mesh()) == sorted_triangles(full_extraction()));
+
+			// The pyramid updated locally is identical to the one built from the edited field
+			pyramid.update(field, index_min, index_max);
+			minmax_block_pyramid const rebuilt(field);
+			assert_cgp_no_msg(pyramid.level.size() == rebuilt.level.size());
+			for (size_t k = 0; k < rebuilt.level.size(); ++k)
+				assert_cgp_no_msg(is_equal(pyramid.level[k], rebuilt.level[k]));
+			for (size_t k = 0; k < chunked.pyramid.level.size(); ++k)
+				assert_cgp_no_msg(is_equal(chunked.pyramid.level[k], minmax_block_pyramid(field, chunked.pyramid.block_size).level[k]));
+		}
+	}
+}
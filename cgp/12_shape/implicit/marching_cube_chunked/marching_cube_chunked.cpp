@@ -0,0 +1,108 @@
+#include "marching_cube_chunked.hpp"
+
+#include <algorithm>
+
+namespace cgp {
+
+	marching_cube_chunked::marching_cube_chunked()
+		:brick_size(32), iso(0), domain(), brick_dimension({ 0,0,0 }), brick_mesh(), pyramid()
+	{}
+
+	void marching_cube_chunked::initialize(grid_3D<float> const& field, spatial_domain_grid_3D const& domain_arg, float iso_arg, int brick_size_arg)
+	{
+		assert_cgp_no_msg(is_equal(field.dimension, domain_arg.samples));
+		assert_cgp(brick_size_arg > 0, "Brick size must be strictly positive");
+
+		domain = domain_arg;
+		iso = iso_arg;
+		brick_size = brick_size_arg;
+
+		int3 const N_cell = domain.samples - int3{ 1,1,1 };
+		for (int k = 0; k < 3; ++k)
+			brick_dimension[k] = std::max(1, (N_cell[k] + brick_size - 1) / brick_size);
+
+		int const N_brick = number_of_bricks();
+		brick_mesh.assign(N_brick, mesh());
+		brick_dirty.assign(N_brick, 1);
+		modified_region.clear();
+
+		// Blocks of the pyramid subdivide the bricks
+		pyramid.build(field, std::min(8, brick_size));
+
+		update(field);
+	}
+
+	void marching_cube_chunked::notify_modified(int3 const& index_min, int3 const& index_max)
+	{
+		modified_region.push_back({ index_min, index_max });
+
+		// The triangles of the cells having a modified corner change, as well as the normals of the vertices on the edges next to the modified grid points (central differences):
+		//  the cells index_min-2 <= (kx,ky,kz) <= index_max+1 are extracted again
+		int3 b_min, b_max;
+		for (int k = 0; k < 3; ++k) {
+			int const cell_min = std::max(0, index_min[k] - 2);
+			int const cell_max = std::min(domain.samples[k] - 2, index_max[k] + 1);
+			if (cell_min > cell_max)
+				return;
+			b_min[k] = std::min(cell_min / brick_size, brick_dimension[k] - 1);
+			b_max[k] = std::min(cell_max / brick_size, brick_dimension[k] - 1);
+		}
+
+		for (int bz = b_min.z; bz <= b_max.z; ++bz)
+			for (int by = b_min.y; by <= b_max.y; ++by)
+				for (int bx = b_min.x; bx <= b_max.x; ++bx)
+					brick_dirty[brick_index({ bx,by,bz })] = 1;
+	}
+
+	void marching_cube_chunked::set_iso(float iso_arg)
+	{
+		iso = iso_arg;
+		std::fill(brick_dirty.begin(), brick_dirty.end(), 1);
+	}
+
+	std::vector<int> marching_cube_chunked::update(grid_3D<float> const& field)
+	{
+		assert_cgp(is_equal(field.dimension, domain.samples), "The field has a different dimension than the one used to initialize the chunked marching cube");
+
+		for (auto const& region : modified_region)
+			pyramid.update(field, region.first, region.second);
+		modified_region.clear();
+
+		std::vector<int> updated;
+		for (int bz = 0; bz < brick_dimension.z; ++bz) {
+			for (int by = 0; by < brick_dimension.y; ++by) {
+				for (int bx = 0; bx < brick_dimension.x; ++bx) {
+					int const k = brick_index({ bx,by,bz });
+					if (brick_dirty[k] == 0)
+						continue;
+
+					int3 const cell_min = brick_size * int3{ bx,by,bz };
+					int3 const cell_max = cell_min + int3{ brick_size,brick_size,brick_size };
+					brick_mesh[k] = marching_cube(field, domain, iso, cell_min, cell_max, &pyramid);
+					brick_dirty[k] = 0;
+					updated.push_back(k);
+				}
+			}
+		}
+		return updated;
+	}
+
+	int marching_cube_chunked::brick_index(int3 const& brick) const
+	{
+		return brick.x + brick_dimension.x * (brick.y + brick_dimension.y * brick.z);
+	}
+
+	int marching_cube_chunked::number_of_bricks() const
+	{
+		return brick_dimension.x * brick_dimension.y * brick_dimension.z;
+	}
+
+	mesh marching_cube_chunked::merged_mesh() const
+	{
+		mesh m;
+		for (mesh const& brick : brick_mesh)
+			m.push_back(brick);
+		return m;
+	}
+
+}
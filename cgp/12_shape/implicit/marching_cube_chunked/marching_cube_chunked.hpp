@@ -0,0 +1,59 @@
+#pragma once
+
+#include "cgp/12_shape/implicit/marching_cube/marching_cube.hpp"
+#include "cgp/12_shape/implicit/minmax_block_pyramid/minmax_block_pyramid.hpp"
+
+namespace cgp {
+
+	/** Marching cube of a field decomposed in bricks of brick_size^3 cells, each brick storing its own mesh.
+	* After a local modification of the field, only the bricks touching the modified region are extracted again, so that the cost is proportional to the edited area.
+	* - Seams: adjacent bricks share the grid points of their common face. The vertices on this face are duplicated in both meshes, but computed identically (same edge, same interpolation),
+	*     and the normals are interpolated from the gradient of the field. The surface is therefore continuous across the bricks.
+	* - A min/max block pyramid of the field is maintained to skip the empty parts of the bricks.
+	*
+	* Usage:
+	*   marching_cube_chunked chunked;
+	*   chunked.initialize(field, domain, iso);          // Extract all the bricks
+	*   // ... modify the field on the grid points p_min <= (kx,ky,kz) <= p_max
+	*   chunked.notify_modified(p_min, p_max);
+	*   std::vector<int> const updated = chunked.update(field); // Extract the modified bricks and return their index
+	*   for (int k : updated)  // update the display of these bricks only (see chunked_mesh_drawable)
+	*       drawable.update_chunk(k, chunked.brick_mesh[k]);
+	*/
+	struct marching_cube_chunked
+	{
+		int brick_size;
+		float iso;
+		spatial_domain_grid_3D domain;
+		int3 brick_dimension;          // Number of bricks along each direction
+		std::vector<mesh> brick_mesh;  // Mesh of each brick (brick (bx,by,bz) is stored at the index bx + Nx*(by + Ny*bz), see brick_index)
+		minmax_block_pyramid pyramid;
+
+		marching_cube_chunked();
+
+		/** Build the pyramid and extract all the bricks */
+		void initialize(grid_3D<float> const& field, spatial_domain_grid_3D const& domain, float iso, int brick_size = 32);
+
+		/** Notify that the grid points index_min <= (kx,ky,kz) <= index_max (bounds included) of the field have been modified.
+		* The bricks are marked as dirty, and are extracted at the next call to update() */
+		void notify_modified(int3 const& index_min, int3 const& index_max);
+
+		/** Change the iso-value: all the bricks are marked as dirty */
+		void set_iso(float iso);
+
+		/** Extract the dirty bricks. Return the index of the bricks whose mesh has been recomputed. */
+		std::vector<int> update(grid_3D<float> const& field);
+
+		/** Index of the brick (bx,by,bz) in brick_mesh */
+		int brick_index(int3 const& brick) const;
+		int number_of_bricks() const;
+
+		/** Concatenation of the meshes of all the bricks (the vertices on the border of the bricks are duplicated) */
+		mesh merged_mesh() const;
+
+	private:
+		std::vector<char> brick_dirty;
+		std::vector<std::pair<int3, int3>> modified_region; // regions of grid points modified since the last update (used to update the pyramid)
+	};
+
+}
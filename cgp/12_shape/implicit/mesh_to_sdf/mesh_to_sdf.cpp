@@ -0,0 +1,400 @@
+#include "mesh_to_sdf.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace cgp {
+
+	// Closest feature of a triangle (a,b,c) to a point
+	enum class triangle_feature { face, vertex_a, vertex_b, vertex_c, edge_ab, edge_bc, edge_ca };
+
+	// Component-wise vector arithmetic for the inner loops (avoids the index checks of the generic numarray_stack operators)
+	static inline vec3 sub(vec3 const& a, vec3 const& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+	static inline vec3 madd(vec3 const& a, float s, vec3 const& u) { return { a.x + s * u.x, a.y + s * u.y, a.z + s * u.z }; }
+	static inline float dot3(vec3 const& a, vec3 const& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+	// Closest point to p on the segment [a,b]
+	static vec3 closest_point_segment(vec3 const& p, vec3 const& a, vec3 const& b)
+	{
+		vec3 const ab = sub(b, a);
+		float const L2 = dot3(ab, ab);
+		float const t = L2 > 0 ? std::min(std::max(dot3(sub(p, a), ab) / L2, 0.0f), 1.0f) : 0.0f;
+		return madd(a, t, ab);
+	}
+
+	// Closest point to p on the triangle (a,b,c) using the Voronoi regions of its features (Ericson, Real-Time Collision Detection)
+	static vec3 closest_point_triangle(vec3 const& p, vec3 const& a, vec3 const& b, vec3 const& c, triangle_feature& feature)
+	{
+		vec3 const ab = sub(b, a), ac = sub(c, a), ap = sub(p, a);
+		float const d1 = dot3(ab, ap), d2 = dot3(ac, ap);
+		if (d1 <= 0 && d2 <= 0) { feature = triangle_feature::vertex_a; return a; }
+
+		vec3 const bp = sub(p, b);
+		float const d3 = dot3(ab, bp), d4 = dot3(ac, bp);
+		if (d3 >= 0 && d4 <= d3) { feature = triangle_feature::vertex_b; return b; }
+
+		float const vc = d1 * d4 - d3 * d2;
+		if (vc <= 0 && d1 >= 0 && d3 <= 0) { feature = triangle_feature::edge_ab; return madd(a, d1 / (d1 - d3), ab); }
+
+		vec3 const cp = sub(p, c);
+		float const d5 = dot3(ab, cp), d6 = dot3(ac, cp);
+		if (d6 >= 0 && d5 <= d6) { feature = triangle_feature::vertex_c; return c; }
+
+		float const vb = d5 * d2 - d1 * d6;
+		if (vb <= 0 && d2 >= 0 && d6 <= 0) { feature = triangle_feature::edge_ca; return madd(a, d2 / (d2 - d6), ac); }
+
+		float const va = d3 * d6 - d5 * d4;
+		if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) { feature = triangle_feature::edge_bc; return madd(b, (d4 - d3) / ((d4 - d3) + (d5 - d6)), sub(c, b)); }
+
+		float const sum = va + vb + vc;
+		if (sum <= 0) {
+			// Degenerated (flat) triangle: closest point on its edges
+			feature = triangle_feature::edge_ab;
+			vec3 q = closest_point_segment(p, a, b);
+			vec3 const q_bc = closest_point_segment(p, b, c);
+			vec3 const q_ca = closest_point_segment(p, c, a);
+			if (dot3(sub(p, q_bc), sub(p, q_bc)) < dot3(sub(p, q), sub(p, q))) { q = q_bc; feature = triangle_feature::edge_bc; }
+			if (dot3(sub(p, q_ca), sub(p, q_ca)) < dot3(sub(p, q), sub(p, q))) { q = q_ca; feature = triangle_feature::edge_ca; }
+			return q;
+		}
+		feature = triangle_feature::face;
+		return madd(madd(a, vb / sum, ab), vc / sum, ac);
+	}
+
+	// Angle weighted pseudo-normals of the faces, edges and vertices of the mesh (Baerentzen and Aanaes, Signed distance computation using the angle weighted pseudonormal, 2005)
+	//  The sign of the distance to the closest point q is given by dot(p-q, pseudo-normal of the feature of q)
+	struct mesh_pseudo_normal {
+		std::vector<vec3> face;   // [triangle]
+		std::vector<vec3> edge;   // [3*triangle+k] edge between the corners k and (k+1)%3
+		std::vector<vec3> vertex; // [merged vertex]
+		std::vector<int> merged;  // index of the vertex after merging the vertices with identical positions
+
+		void initialize(mesh const& m, int N_thread);
+		// Pseudo-normal of the feature of the triangle of index k and vertices f
+		vec3 const& normal(int k, uint3 const& f, triangle_feature feature) const;
+	};
+
+	void mesh_pseudo_normal::initialize(mesh const& m, int N_thread)
+	{
+		std::vector<vec3> const& position = m.position.data;
+		std::vector<uint3> const& triangle = m.connectivity.data;
+		int const N_vertex = int(position.size());
+		int const N_triangle = int(triangle.size());
+
+		// Merge the vertices with identical positions: the adjacency of meshes with duplicated vertices (texture seams, triangle soups) is recovered
+		std::vector<int> order(N_vertex);
+		std::iota(order.begin(), order.end(), 0);
+		auto const less = [&position](int i, int j) {
+			vec3 const& a = position[i];
+			vec3 const& b = position[j];
+			return a.x < b.x || (a.x == b.x && (a.y < b.y || (a.y == b.y && a.z < b.z)));
+		};
+		std::sort(order.begin(), order.end(), less);
+		merged.resize(N_vertex);
+		for (int k = 0; k < N_vertex; ++k)
+			merged[order[k]] = (k > 0 && !less(order[k - 1], order[k])) ? merged[order[k - 1]] : order[k];
+
+		// Faces normals and angle weighted vertex normals
+		face.resize(N_triangle);
+		vertex.assign(N_vertex, vec3{ 0,0,0 });
+		for (int k = 0; k < N_triangle; ++k) {
+			uint3 const& f = triangle[k];
+			vec3 const p[3] = { position[f.x], position[f.y], position[f.z] };
+			int const v[3] = { merged[f.x], merged[f.y], merged[f.z] };
+			vec3 const n = cross(sub(p[1], p[0]), sub(p[2], p[0]));
+			float const L = std::sqrt(dot3(n, n));
+			face[k] = L > 0 ? vec3{ n.x / L, n.y / L, n.z / L } : vec3{ 0,0,0 };
+			for (int j = 0; j < 3; ++j) {
+				vec3 const u = sub(p[(j + 1) % 3], p[j]);
+				vec3 const w = sub(p[(j + 2) % 3], p[j]);
+				float const L2 = dot3(u, u) * dot3(w, w);
+				if (L2 > 0) {
+					float const angle = std::acos(std::min(std::max(dot3(u, w) / std::sqrt(L2), -1.0f), 1.0f));
+					vertex[v[j]] = madd(vertex[v[j]], angle, face[k]);
+				}
+			}
+		}
+
+		// Triangles around each merged vertex (compressed storage: the triangles around the vertex i are one_ring[one_ring_start[i] .. one_ring_start[i+1]-1])
+		std::vector<int> one_ring_start(N_vertex + 1, 0);
+		for (int k = 0; k < N_triangle; ++k)
+			for (int j = 0; j < 3; ++j)
+				one_ring_start[merged[triangle[k][j]] + 1]++;
+		for (int k = 0; k < N_vertex; ++k)
+			one_ring_start[k + 1] += one_ring_start[k];
+		std::vector<int> one_ring(one_ring_start[N_vertex]);
+		std::vector<int> fill = one_ring_start;
+		for (int k = 0; k < N_triangle; ++k)
+			for (int j = 0; j < 3; ++j)
+				one_ring[fill[merged[triangle[k][j]]]++] = k;
+
+		// Edge normals: sum of the normals of the triangles sharing the edge
+		edge.resize(3 * size_t(N_triangle));
+		auto edge_normals = [&](int k_begin, int k_end) {
+			for (int k = k_begin; k < k_end; ++k) {
+				int const v[3] = { merged[triangle[k].x], merged[triangle[k].y], merged[triangle[k].z] };
+				for (int j = 0; j < 3; ++j) {
+					int const a = v[j];
+					int const b = v[(j + 1) % 3];
+					vec3 n = { 0,0,0 };
+					for (int r = one_ring_start[a]; r < one_ring_start[a + 1]; ++r) {
+						uint3 const& f = triangle[one_ring[r]];
+						if (merged[f.x] == b || merged[f.y] == b || merged[f.z] == b)
+							n = madd(n, 1.0f, face[one_ring[r]]);
+					}
+					edge[3 * size_t(k) + j] = n;
+				}
+			}
+		};
+		parallel_for_task(N_thread, [&](int64_t k, int) {
+			edge_normals(int(k * N_triangle / N_thread), int((k + 1) * N_triangle / N_thread));
+		}, N_thread);
+	}
+
+	vec3 const& mesh_pseudo_normal::normal(int k, uint3 const& f, triangle_feature feature) const
+	{
+		switch (feature)
+		{
+		case triangle_feature::vertex_a: return vertex[merged[f[0]]];
+		case triangle_feature::vertex_b: return vertex[merged[f[1]]];
+		case triangle_feature::vertex_c: return vertex[merged[f[2]]];
+		case triangle_feature::edge_ab: return edge[3 * size_t(k) + 0];
+		case triangle_feature::edge_bc: return edge[3 * size_t(k) + 1];
+		case triangle_feature::edge_ca: return edge[3 * size_t(k) + 2];
+		default: return face[k];
+		}
+	}
+
+	// Solution u of the discretized Eikonal equation sum_i ((u-a_i)/h_i)^2 = 1 using the upwind neighbors a_i (Zhao, A fast sweeping method for Eikonal equations, 2005)
+	static float eikonal_update(float a0, float a1, float a2, float h0, float h1, float h2)
+	{
+		// sort the neighbors by increasing values
+		if (a1 < a0) { std::swap(a0, a1); std::swap(h0, h1); }
+		if (a2 < a1) { std::swap(a1, a2); std::swap(h1, h2); }
+		if (a1 < a0) { std::swap(a0, a1); std::swap(h0, h1); }
+
+		float u = a0 + h0;
+		if (u <= a1)
+			return u;
+
+		float const w0 = 1.0f / (h0 * h0), w1 = 1.0f / (h1 * h1);
+		float A = w0 + w1;
+		float B = -2 * (a0 * w0 + a1 * w1);
+		float C = a0 * a0 * w0 + a1 * a1 * w1 - 1;
+		u = (-B + std::sqrt(std::max(B * B - 4 * A * C, 0.0f))) / (2 * A);
+		if (u <= a2)
+			return u;
+
+		float const w2 = 1.0f / (h2 * h2);
+		A += w2;
+		B += -2 * a2 * w2;
+		C += a2 * a2 * w2;
+		return (-B + std::sqrt(std::max(B * B - 4 * A * C, 0.0f))) / (2 * A);
+	}
+
+	// Extend the distance from the frozen values to the rest of the grid with the 8 sweeping orders. The sign is propagated from the upwind neighbor.
+	static void fast_sweeping(grid_3D<float>& sdf, std::vector<char> const& frozen, vec3 const& h, int sweep_iteration)
+	{
+		int3 const N = sdf.dimension;
+		size_t const N_slice = size_t(N.x) * N.y;
+		float* const value = sdf.data.data.data();
+		float const lower_step = std::min(h.x, std::min(h.y, h.z)) / std::sqrt(3.0f);
+
+		// Value of the neighbor with the smallest distance along one axis (a voxel on the border of the grid is its own neighbor, which never decreases its value)
+		auto upwind = [](float v_minus, float v_plus, float& a, float& sign) {
+			float const v = std::abs(v_minus) < std::abs(v_plus) ? v_minus : v_plus;
+			a = std::abs(v);
+			sign = v < 0 ? -1.0f : 1.0f;
+		};
+
+		for (int iteration = 0; iteration < sweep_iteration; ++iteration) {
+			for (int sweep = 0; sweep < 8; ++sweep) {
+				int const dx = (sweep & 1) ? -1 : 1;
+				int const dy = (sweep & 2) ? -1 : 1;
+				int const dz = (sweep & 4) ? -1 : 1;
+				for (int kz = dz > 0 ? 0 : N.z - 1; kz >= 0 && kz < N.z; kz += dz) {
+					for (int ky = dy > 0 ? 0 : N.y - 1; ky >= 0 && ky < N.y; ky += dy) {
+						size_t const row = N_slice * kz + size_t(N.x) * ky;
+						float const* const y_minus = value + (ky > 0 ? row - N.x : row);
+						float const* const y_plus = value + (ky < N.y - 1 ? row + N.x : row);
+						float const* const z_minus = value + (kz > 0 ? row - N_slice : row);
+						float const* const z_plus = value + (kz < N.z - 1 ? row + N_slice : row);
+						float* const v = value + row;
+						char const* const is_frozen = frozen.data() + row;
+						for (int kx = dx > 0 ? 0 : N.x - 1; kx >= 0 && kx < N.x; kx += dx) {
+							if (is_frozen[kx])
+								continue;
+
+							float ax, ay, az, sx, sy, sz;
+							upwind(v[kx > 0 ? kx - 1 : kx], v[kx < N.x - 1 ? kx + 1 : kx], ax, sx);
+							upwind(y_minus[kx], y_plus[kx], ay, sy);
+							upwind(z_minus[kx], z_plus[kx], az, sz);
+							// The solution is at least a_min + h_min/sqrt(3): most of the voxels are not modified by the last sweeps
+							float const a_min = std::min(ax, std::min(ay, az));
+							if (a_min + lower_step >= std::abs(v[kx]))
+								continue;
+
+							float const u = eikonal_update(ax, ay, az, h.x, h.y, h.z);
+							if (u < std::abs(v[kx]))
+								v[kx] = (a_min == ax ? sx : (a_min == ay ? sy : sz)) * u;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	void mesh_to_sdf(grid_3D<float>& sdf, mesh const& m, spatial_domain_grid_3D const& domain, mesh_to_sdf_parameters const& parameters)
+	{
+		assert_cgp(m.connectivity.size() > 0, "Cannot compute the signed distance of a mesh without triangles");
+		assert_cgp(parameters.narrow_band > 0, "The narrow band must be at least one voxel wide");
+		assert_cgp(domain.samples.x > 1 && domain.samples.y > 1 && domain.samples.z > 1, "The domain must have at least 2 samples in each direction");
+
+		int3 const N = domain.samples;
+		std::vector<vec3> const& position = m.position.data;
+		std::vector<uint3> const& triangle = m.connectivity.data;
+		int const N_triangle = int(triangle.size());
+		vec3 const corner = domain.corner_min();
+		vec3 const h = domain.voxel_length();
+		float const band = parameters.narrow_band * std::max(h.x, std::max(h.y, h.z));
+		float const infinity = std::numeric_limits<float>::infinity();
+
+		int const N_thread = std::min(parallel_thread_count(parameters.thread_count), N.z);
+
+		mesh_pseudo_normal pseudo_normal;
+		pseudo_normal.initialize(m, N_thread);
+
+		// Voxel index range covered by each triangle dilated by the band
+		std::vector<int3> triangle_min(N_triangle), triangle_max(N_triangle);
+		for (int k = 0; k < N_triangle; ++k) {
+			vec3 const& a = position[triangle[k].x];
+			vec3 const& b = position[triangle[k].y];
+			vec3 const& c = position[triangle[k].z];
+			vec3 const u_min = sub({ std::min(a.x, std::min(b.x, c.x)) - band, std::min(a.y, std::min(b.y, c.y)) - band, std::min(a.z, std::min(b.z, c.z)) - band }, corner);
+			vec3 const u_max = sub({ std::max(a.x, std::max(b.x, c.x)) + band, std::max(a.y, std::max(b.y, c.y)) + band, std::max(a.z, std::max(b.z, c.z)) + band }, corner);
+			triangle_min[k] = { std::max(int(std::ceil(u_min.x / h.x)), 0), std::max(int(std::ceil(u_min.y / h.y)), 0), std::max(int(std::ceil(u_min.z / h.z)), 0) };
+			triangle_max[k] = { std::min(int(std::floor(u_max.x / h.x)), N.x - 1), std::min(int(std::floor(u_max.y / h.y)), N.y - 1), std::min(int(std::floor(u_max.z / h.z)), N.z - 1) };
+		}
+
+		// Acceleration structure: the triangles are binned in z-slabs. Each slab is processed by a single thread which owns its voxels.
+		int const N_slab = std::min(N.z, 4 * N_thread);
+		int const slab_thickness = (N.z + N_slab - 1) / N_slab;
+		auto is_in_domain = [&](int k) { return triangle_min[k].x <= triangle_max[k].x && triangle_min[k].y <= triangle_max[k].y && triangle_min[k].z <= triangle_max[k].z; };
+		std::vector<int> slab_start(N_slab + 1, 0);
+		for (int k = 0; k < N_triangle; ++k)
+			if (is_in_domain(k))
+				for (int s = triangle_min[k].z / slab_thickness; s <= triangle_max[k].z / slab_thickness; ++s)
+					slab_start[s + 1]++;
+		for (int s = 0; s < N_slab; ++s)
+			slab_start[s + 1] += slab_start[s];
+		std::vector<int> slab_triangle(slab_start[N_slab]);
+		{
+			std::vector<int> fill = slab_start;
+			for (int k = 0; k < N_triangle; ++k)
+				if (is_in_domain(k))
+					for (int s = triangle_min[k].z / slab_thickness; s <= triangle_max[k].z / slab_thickness; ++s)
+						slab_triangle[fill[s]++] = k;
+		}
+
+		sdf.resize(N);
+		std::vector<char> frozen(sdf.data.size(), 0);
+		size_t const N_slice = size_t(N.x) * N.y;
+
+		// Exact distance in the narrow band, and sign from the pseudo-normals
+		auto process_slab = [&](int slab, std::vector<float>& distance2, std::vector<int>& closest) {
+			int const z_begin = slab * slab_thickness;
+			int const z_end = std::min(z_begin + slab_thickness, N.z);
+			size_t const N_voxel = N_slice * (z_end - z_begin);
+			distance2.assign(N_voxel, std::nextafter(band * band, infinity)); // voxels at a distance <= band
+			closest.assign(N_voxel, -1);
+
+			for (int r = slab_start[slab]; r < slab_start[slab + 1]; ++r) {
+				int const t = slab_triangle[r];
+				uint3 const& f = triangle[t];
+				vec3 const& a = position[f.x];
+				vec3 const& b = position[f.y];
+				vec3 const& c = position[f.z];
+				vec3 const& n = pseudo_normal.face[t];
+				int3 const& i_min = triangle_min[t];
+				int3 const& i_max = triangle_max[t];
+
+				// Bounding sphere of the triangle: only the voxels at a distance smaller than radius+band of its center are visited
+				vec3 const center = { (a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f, (a.z + b.z + c.z) / 3.0f };
+				float const radius = std::sqrt(std::max(dot3(sub(a, center), sub(a, center)), std::max(dot3(sub(b, center), sub(b, center)), dot3(sub(c, center), sub(c, center)))));
+				float const reach2 = (radius + band) * (radius + band);
+
+				for (int kz = std::max(i_min.z, z_begin); kz <= std::min(i_max.z, z_end - 1); ++kz) {
+					float const dz = corner.z + kz * h.z - center.z;
+					for (int ky = i_min.y; ky <= i_max.y; ++ky) {
+						float const dy = corner.y + ky * h.y - center.y;
+						float const half_chord2 = reach2 - dy * dy - dz * dz;
+						if (half_chord2 < 0)
+							continue;
+						float const half_chord = std::sqrt(half_chord2);
+						int const x_begin = std::max(i_min.x, int(std::ceil((center.x - half_chord - corner.x) / h.x)));
+						int const x_end = std::min(i_max.x, int(std::floor((center.x + half_chord - corner.x) / h.x)));
+
+						float* const d2_row = distance2.data() + N_slice * (kz - z_begin) + size_t(N.x) * ky;
+						int* const closest_row = closest.data() + N_slice * (kz - z_begin) + size_t(N.x) * ky;
+						for (int kx = x_begin; kx <= x_end; ++kx) {
+							vec3 const p = { corner.x + kx * h.x, corner.y + ky * h.y, corner.z + kz * h.z };
+
+							// Lower bounds of the distance to the triangle: distance to its bounding sphere, and to its plane
+							float const d_sphere = std::sqrt(dot3(sub(p, center), sub(p, center))) - radius;
+							if (d_sphere > 0 && d_sphere * d_sphere >= d2_row[kx])
+								continue;
+							float const d_plane = dot3(sub(p, a), n);
+							if (d_plane * d_plane >= d2_row[kx])
+								continue;
+
+							triangle_feature feature;
+							vec3 const q = closest_point_triangle(p, a, b, c, feature);
+							float const d2 = dot3(sub(p, q), sub(p, q));
+							if (d2 < d2_row[kx]) {
+								d2_row[kx] = d2;
+								closest_row[kx] = t;
+							}
+						}
+					}
+				}
+			}
+
+			float* const value = &sdf.data.data[N_slice * z_begin];
+			char* const is_frozen = &frozen[N_slice * z_begin];
+			for (size_t k = 0; k < N_voxel; ++k) {
+				int const t = closest[k];
+				if (t == -1) {
+					value[k] = infinity;
+					continue;
+				}
+				size_t const kxy = k % N_slice;
+				vec3 const p = { corner.x + int(kxy % N.x) * h.x, corner.y + int(kxy / N.x) * h.y, corner.z + int(z_begin + k / N_slice) * h.z };
+				uint3 const& f = triangle[t];
+				triangle_feature feature;
+				vec3 const q = closest_point_triangle(p, position[f.x], position[f.y], position[f.z], feature);
+				float const d = std::sqrt(distance2[k]);
+				value[k] = dot3(sub(p, q), pseudo_normal.normal(t, f, feature)) < 0 ? -d : d;
+				is_frozen[k] = 1;
+			}
+		};
+
+		// Scratch buffers of each thread
+		std::vector<std::vector<float>> distance2(N_thread);
+		std::vector<std::vector<int>> closest(N_thread);
+		parallel_for_task(N_slab, [&](int64_t s, int worker) {
+			process_slab(int(s), distance2[worker], closest[worker]);
+		}, N_thread);
+
+		if (std::find(frozen.begin(), frozen.end(), 1) == frozen.end()) {
+			warning_cgp("mesh_to_sdf: the mesh is not in the domain, the field is set to the maximal float value", "");
+			std::fill(sdf.data.data.begin(), sdf.data.data.end(), std::numeric_limits<float>::max());
+			return;
+		}
+
+		// Approximated distance outside of the band
+		fast_sweeping(sdf, frozen, h, parameters.sweep_iteration);
+	}
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "cgp/04_grid_container/grid/grid.hpp"
+#include "cgp/11_mesh/mesh.hpp"
+#include "cgp/12_shape/spatial_domain/spatial_domain.hpp"
+
+namespace cgp {
+
+	/** Parameters of mesh_to_sdf */
+	struct mesh_to_sdf_parameters {
+		int narrow_band = 2;      // Width (in voxels) of the band around the surface where the distance is exact
+		int sweep_iteration = 1;  // Number of rounds of the 8 fast sweeping passes computing the distance outside of the band
+		int thread_count = 0;     // Number of threads (0: global number of threads, see set_parallel_thread_count)
+	};
+
+	/** Fill the field with the signed distance to the triangle mesh at the grid points of the domain (negative inside).
+	 *  - In the narrow band around the surface, the distance to the closest triangle is exact. The triangles are binned into slabs along z processed in parallel.
+	 *  - The sign is given by the angle weighted pseudo-normal of the closest feature (face, edge or vertex) of the closest triangle. It is correct for closed and consistently oriented meshes. Vertices with identical positions (such as texture seams) are merged to find the adjacency.
+	 *  - Outside of the band, the distance is extended by fast sweeping (solution of |grad d|=1), which gives an approximation of the distance. */
+	void mesh_to_sdf(grid_3D<float>& sdf, mesh const& m, spatial_domain_grid_3D const& domain, mesh_to_sdf_parameters const& parameters = {});
+
+}
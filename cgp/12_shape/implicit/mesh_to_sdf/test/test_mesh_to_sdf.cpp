@@ -0,0 +1,54 @@
+#include "test_mesh_to_sdf.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "../mesh_to_sdf.hpp"
+#include "cgp/11_mesh/primitive/primitive.hpp"
+
+#include <functional>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	// Compare the signed distance field of a finely tessellated mesh with the analytic distance of the shape
+	//  - The sign is correct at every grid point farther than the tessellation error from the surface
+	//  - In the narrow band, the distance is exact up to the tessellation error
+	//  - Outside of the band, the fast sweeping approximation stays within a voxel and a half
+	static void check_sdf(mesh const& m, spatial_domain_grid_3D const& domain, std::function<float(vec3 const&)> const& distance, float tessellation_error)
+	{
+		mesh_to_sdf_parameters const parameters;
+		grid_3D<float> sdf;
+		mesh_to_sdf(sdf, m, domain, parameters);
+		assert_cgp_no_msg(is_equal(sdf.dimension, domain.samples));
+
+		float const voxel = domain.voxel_length().x;
+		int3 const& N = domain.samples;
+		for (int z = 0; z < N.z; ++z) {
+			for (int y = 0; y < N.y; ++y) {
+				for (int x = 0; x < N.x; ++x) {
+					float const d = distance(domain.position({ x,y,z }));
+					float const value = sdf(x, y, z);
+					if (std::abs(d) > tessellation_error)
+						assert_cgp_no_msg((value < 0) == (d < 0));
+					float const error_max = std::abs(d) < parameters.narrow_band * voxel ? tessellation_error : 1.5f * voxel;
+					assert_cgp_no_msg(std::abs(value - d) < error_max);
+				}
+			}
+		}
+	}
+
+	void test_mesh_to_sdf()
+	{
+		spatial_domain_grid_3D const domain = spatial_domain_grid_3D::from_center_length({ 0,0,0 }, { 3,3,3 }, { 40,40,40 });
+
+		check_sdf(mesh_primitive_sphere(1.0f, { 0,0,0 }, 160, 80), domain,
+			[](vec3 const& p) { return norm(p) - 1.0f; }, 2e-3f);
+
+		check_sdf(mesh_primitive_torus(1.0f, 0.3f, { 0,0,0 }, { 0,0,1 }, 320, 80), domain,
+			[](vec3 const& p) { return norm(vec2{ norm(vec2{ p.x,p.y }) - 1.0f, p.z }) - 0.3f; }, 5e-3f);
+	}
+}
@@ -0,0 +1,171 @@
+#include "minmax_block_pyramid.hpp"
+
+#include <algorithm>
+
+namespace cgp {
+
+	minmax_block_pyramid::minmax_block_pyramid()
+		:block_size(8), samples({ 0,0,0 }), level()
+	{}
+
+	minmax_block_pyramid::minmax_block_pyramid(grid_3D<float> const& field, int block_size_arg)
+		:minmax_block_pyramid()
+	{
+		build(field, block_size_arg);
+	}
+
+	static int block_count(int N_cell, int block_size)
+	{
+		return std::max(1, (N_cell + block_size - 1) / block_size);
+	}
+
+	void minmax_block_pyramid::build(grid_3D<float> const& field, int block_size_arg)
+	{
+		assert_cgp(block_size_arg > 0, "Block size of the pyramid must be strictly positive");
+		block_size = block_size_arg;
+		samples = field.dimension;
+		level.clear();
+
+		// Level 0: (min,max) of the grid points of each block
+		int3 dimension = { block_count(samples.x - 1, block_size), block_count(samples.y - 1, block_size), block_count(samples.z - 1, block_size) };
+		level.push_back(grid_3D<vec2>(dimension));
+		for (int bz = 0; bz < dimension.z; ++bz)
+			for (int by = 0; by < dimension.y; ++by)
+				for (int bx = 0; bx < dimension.x; ++bx)
+					update_block(field, { bx,by,bz });
+
+		// Upper levels: (min,max) of the 2x2x2 children
+		while (dimension.x > 1 || dimension.y > 1 || dimension.z > 1) {
+			dimension = { (dimension.x + 1) / 2, (dimension.y + 1) / 2, (dimension.z + 1) / 2 };
+			level.push_back(grid_3D<vec2>(dimension));
+			int const k_level = int(level.size()) - 2;
+			for (int bz = 0; bz < dimension.z; ++bz)
+				for (int by = 0; by < dimension.y; ++by)
+					for (int bx = 0; bx < dimension.x; ++bx)
+						update_parent(k_level, { 2 * bx, 2 * by, 2 * bz });
+		}
+	}
+
+	void minmax_block_pyramid::update(grid_3D<float> const& field, int3 const& index_min, int3 const& index_max)
+	{
+		assert_cgp(is_equal(field.dimension, samples), "The field has a different dimension than the pyramid");
+		if (level.empty())
+			return;
+
+		// A grid point on the boundary of a block also belongs to its neighbor
+		int3 const& dimension = level[0].dimension;
+		int3 b_min, b_max;
+		for (int k = 0; k < 3; ++k) {
+			int const p_min = std::max(0, index_min[k]);
+			int const p_max = std::min(samples[k] - 1, index_max[k]);
+			if (p_min > p_max)
+				return;
+			b_min[k] = p_min == 0 ? 0 : std::min((p_min - 1) / block_size, dimension[k] - 1);
+			b_max[k] = std::min(p_max / block_size, dimension[k] - 1);
+		}
+
+		for (int bz = b_min.z; bz <= b_max.z; ++bz)
+			for (int by = b_min.y; by <= b_max.y; ++by)
+				for (int bx = b_min.x; bx <= b_max.x; ++bx)
+					update_block(field, { bx,by,bz });
+
+		// Only the ancestors of the modified blocks are updated
+		for (int k_level = 0; k_level + 1 < int(level.size()); ++k_level) {
+			b_min = { b_min.x / 2, b_min.y / 2, b_min.z / 2 };
+			b_max = { b_max.x / 2, b_max.y / 2, b_max.z / 2 };
+			for (int bz = b_min.z; bz <= b_max.z; ++bz)
+				for (int by = b_min.y; by <= b_max.y; ++by)
+					for (int bx = b_min.x; bx <= b_max.x; ++bx)
+						update_parent(k_level, { 2 * bx, 2 * by, 2 * bz });
+		}
+	}
+
+	int3 minmax_block_pyramid::block_dimension() const
+	{
+		return level.empty() ? int3{ 0,0,0 } : level[0].dimension;
+	}
+
+	bool minmax_block_pyramid::straddle(vec2 const& minmax, float iso)
+	{
+		return minmax.x < iso && minmax.y >= iso;
+	}
+
+	bool minmax_block_pyramid::is_active(int3 const& block, float iso) const
+	{
+		return straddle(level[0](block), iso);
+	}
+
+	std::vector<int3> minmax_block_pyramid::active_blocks(float iso) const
+	{
+		std::vector<int3> active;
+		if (level.empty())
+			return active;
+
+		collect_active_blocks(int(level.size()) - 1, { 0,0,0 }, iso, active);
+		std::sort(active.begin(), active.end(), [](int3 const& a, int3 const& b) {
+			return a.z < b.z || (a.z == b.z && (a.y < b.y || (a.y == b.y && a.x < b.x)));
+		});
+		return active;
+	}
+
+	void minmax_block_pyramid::update_block(grid_3D<float> const& field, int3 const& block)
+	{
+		int3 p_min, p_max;
+		for (int k = 0; k < 3; ++k) {
+			p_min[k] = block[k] * block_size;
+			p_max[k] = std::min((block[k] + 1) * block_size, samples[k] - 1);
+		}
+
+		float v_min = field(p_min);
+		float v_max = v_min;
+		for (int kz = p_min.z; kz <= p_max.z; ++kz) {
+			for (int ky = p_min.y; ky <= p_max.y; ++ky) {
+				float const* row = &field.data.data[field.index_to_offset(p_min.x, ky, kz)];
+				int const N = p_max.x - p_min.x + 1;
+				for (int kx = 0; kx < N; ++kx) {
+					v_min = std::min(v_min, row[kx]);
+					v_max = std::max(v_max, row[kx]);
+				}
+			}
+		}
+		level[0](block) = { v_min, v_max };
+	}
+
+	void minmax_block_pyramid::update_parent(int k_level, int3 const& block)
+	{
+		grid_3D<vec2> const& child = level[k_level];
+		vec2 minmax = child(block);
+		for (int dz = 0; dz < 2; ++dz) {
+			for (int dy = 0; dy < 2; ++dy) {
+				for (int dx = 0; dx < 2; ++dx) {
+					int3 const b = { block.x + dx, block.y + dy, block.z + dz };
+					if (b.x < child.dimension.x && b.y < child.dimension.y && b.z < child.dimension.z) {
+						minmax.x = std::min(minmax.x, child(b).x);
+						minmax.y = std::max(minmax.y, child(b).y);
+					}
+				}
+			}
+		}
+		level[k_level + 1](block.x / 2, block.y / 2, block.z / 2) = minmax;
+	}
+
+	void minmax_block_pyramid::collect_active_blocks(int k_level, int3 const& block, float iso, std::vector<int3>& active) const
+	{
+		if (!straddle(level[k_level](block), iso))
+			return;
+		if (k_level == 0) {
+			active.push_back(block);
+			return;
+		}
+
+		int3 const& dimension = level[k_level - 1].dimension;
+		for (int dz = 0; dz < 2; ++dz)
+			for (int dy = 0; dy < 2; ++dy)
+				for (int dx = 0; dx < 2; ++dx) {
+					int3 const b = { 2 * block.x + dx, 2 * block.y + dy, 2 * block.z + dz };
+					if (b.x < dimension.x && b.y < dimension.y && b.z < dimension.z)
+						collect_active_blocks(k_level - 1, b, iso, active);
+				}
+	}
+
+}
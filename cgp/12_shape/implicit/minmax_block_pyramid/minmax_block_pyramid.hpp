@@ -0,0 +1,43 @@
+#pragma once
+
+#include "cgp/04_grid_container/grid/grid.hpp"
+#include "cgp/05_vec/vec.hpp"
+
+namespace cgp {
+
+	/** Hierarchy of (min,max) values of a scalar field stored in a grid_3D, used to skip the regions that cannot contain the iso-surface.
+	* - The cells of the grid are gathered in blocks of block_size^3 cells. level[0] stores the (min,max) of the field values at the grid points of each block (including its boundary points).
+	* - level[k+1] stores the (min,max) of the blocks 2x2x2 of level[k], up to a single block.
+	* - A block contains a part of the iso-surface only if min < iso <= max (same convention as the sign test of the marching cube).
+	* - The pyramid can be updated locally after an edit of a sub-region of the field. */
+	struct minmax_block_pyramid
+	{
+		int block_size;
+		int3 samples; // Dimension of the field
+		std::vector<grid_3D<vec2>> level; // (min,max) for each block at each level
+
+		minmax_block_pyramid();
+		minmax_block_pyramid(grid_3D<float> const& field, int block_size = 8);
+
+		/** Compute all the levels of the pyramid from the field */
+		void build(grid_3D<float> const& field, int block_size = 8);
+
+		/** Update the blocks containing the grid points index_min <= (kx,ky,kz) <= index_max (bounds included) after a modification of the field in this region */
+		void update(grid_3D<float> const& field, int3 const& index_min, int3 const& index_max);
+
+		/** Number of blocks of level 0 along each direction */
+		int3 block_dimension() const;
+		/** Check if the block of level 0 may contain the iso-surface */
+		bool is_active(int3 const& block, float iso) const;
+		/** Blocks of level 0 that may contain the iso-surface, sorted by (z,y,x) index */
+		std::vector<int3> active_blocks(float iso) const;
+
+		static bool straddle(vec2 const& minmax, float iso);
+
+	private:
+		void update_block(grid_3D<float> const& field, int3 const& block);
+		void update_parent(int k_level, int3 const& block);
+		void collect_active_blocks(int k_level, int3 const& block, float iso, std::vector<int3>& active) const;
+	};
+
+}
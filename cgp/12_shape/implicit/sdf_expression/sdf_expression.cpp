@@ -0,0 +1,399 @@
+#include "sdf_expression.hpp"
+
+#include "cgp/08_random_noise/noise/noise.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace cgp {
+
+	struct sdf_node {
+		sdf_node_type type;
+		vec3 p0;            // sphere/box: center, capsule: a, plane: normal, translation: translation
+		vec3 p1;            // box: half size, capsule: b
+		float s0 = 0;       // radius, major radius (torus), offset (plane), smoothness, scaling, amplitude
+		float s1 = 0;       // minor radius (torus), frequency
+		mat3 rotation;      // inverse rotation applied to the positions
+		int octave = 0;
+		float persistency = 0;
+		float frequency_gain = 0;
+		sdf_expression child[2];
+	};
+
+	// Number of positions evaluated together by each node
+	static constexpr size_t batch_size = 256;
+
+	static sdf_expression make_expression(sdf_node const& node)
+	{
+		return { std::make_shared<sdf_node const>(node) };
+	}
+
+	sdf_expression sdf_sphere(vec3 const& center, float radius)
+	{
+		sdf_node node; node.type = sdf_node_type::sphere;
+		node.p0 = center; node.s0 = radius;
+		return make_expression(node);
+	}
+	sdf_expression sdf_box(vec3 const& center, vec3 const& half_size)
+	{
+		sdf_node node; node.type = sdf_node_type::box;
+		node.p0 = center; node.p1 = half_size;
+		return make_expression(node);
+	}
+	sdf_expression sdf_torus(float major_radius, float minor_radius)
+	{
+		sdf_node node; node.type = sdf_node_type::torus;
+		node.s0 = major_radius; node.s1 = minor_radius;
+		return make_expression(node);
+	}
+	sdf_expression sdf_capsule(vec3 const& a, vec3 const& b, float radius)
+	{
+		sdf_node node; node.type = sdf_node_type::capsule;
+		node.p0 = a; node.p1 = b; node.s0 = radius;
+		return make_expression(node);
+	}
+	sdf_expression sdf_plane(vec3 const& normal, float offset)
+	{
+		sdf_node node; node.type = sdf_node_type::plane;
+		node.p0 = normalize(normal); node.s0 = offset;
+		return make_expression(node);
+	}
+
+	static sdf_expression make_binary(sdf_node_type type, sdf_expression const& a, sdf_expression const& b, float s0 = 0)
+	{
+		assert_cgp(a.node != nullptr && b.node != nullptr, "Cannot combine an empty sdf_expression");
+		sdf_node node; node.type = type;
+		node.child[0] = a; node.child[1] = b; node.s0 = s0;
+		return make_expression(node);
+	}
+	sdf_expression sdf_union(sdf_expression const& a, sdf_expression const& b) { return make_binary(sdf_node_type::union_, a, b); }
+	sdf_expression sdf_intersection(sdf_expression const& a, sdf_expression const& b) { return make_binary(sdf_node_type::intersection, a, b); }
+	sdf_expression sdf_difference(sdf_expression const& a, sdf_expression const& b) { return make_binary(sdf_node_type::difference, a, b); }
+	sdf_expression sdf_smooth_union(sdf_expression const& a, sdf_expression const& b, float smoothness)
+	{
+		assert_cgp(smoothness > 0, "Smoothness of sdf_smooth_union must be strictly positive");
+		return make_binary(sdf_node_type::smooth_union, a, b, smoothness);
+	}
+
+	sdf_expression sdf_translation(sdf_expression const& a, vec3 const& translation)
+	{
+		sdf_node node; node.type = sdf_node_type::translation;
+		node.child[0] = a; node.p0 = translation;
+		return make_expression(node);
+	}
+	sdf_expression sdf_rotation(sdf_expression const& a, rotation_transform const& rotation)
+	{
+		sdf_node node; node.type = sdf_node_type::rotation;
+		node.child[0] = a; node.rotation = inverse(rotation).matrix();
+		return make_expression(node);
+	}
+	sdf_expression sdf_scaling(sdf_expression const& a, float scaling)
+	{
+		assert_cgp(scaling > 0, "Scaling of sdf_scaling must be strictly positive");
+		sdf_node node; node.type = sdf_node_type::scaling;
+		node.child[0] = a; node.s0 = scaling;
+		return make_expression(node);
+	}
+	sdf_expression sdf_noise_displacement(sdf_expression const& a, float amplitude, float frequency, int octave, float persistency, float frequency_gain)
+	{
+		sdf_node node; node.type = sdf_node_type::noise_displacement;
+		node.child[0] = a; node.s0 = amplitude; node.s1 = frequency;
+		node.octave = octave; node.persistency = persistency; node.frequency_gain = frequency_gain;
+		return make_expression(node);
+	}
+
+
+	// Evaluation of a batch of N <= batch_size positions
+	//  The temporary batches are left uninitialized: only their N first values are written and read.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+	static void evaluate_batch(sdf_node const& node, float const* x, float const* y, float const* z, float* value, size_t N)
+	{
+		switch (node.type)
+		{
+		case sdf_node_type::sphere: {
+			vec3 const c = node.p0;
+			float const r = node.s0;
+			for (size_t k = 0; k < N; ++k) {
+				float const dx = x[k] - c.x, dy = y[k] - c.y, dz = z[k] - c.z;
+				value[k] = std::sqrt(dx * dx + dy * dy + dz * dz) - r;
+			}
+			break;
+		}
+		case sdf_node_type::box: {
+			vec3 const c = node.p0;
+			vec3 const h = node.p1;
+			for (size_t k = 0; k < N; ++k) {
+				float const qx = std::abs(x[k] - c.x) - h.x;
+				float const qy = std::abs(y[k] - c.y) - h.y;
+				float const qz = std::abs(z[k] - c.z) - h.z;
+				float const ox = std::max(qx, 0.0f), oy = std::max(qy, 0.0f), oz = std::max(qz, 0.0f);
+				value[k] = std::sqrt(ox * ox + oy * oy + oz * oz) + std::min(std::max(qx, std::max(qy, qz)), 0.0f);
+			}
+			break;
+		}
+		case sdf_node_type::torus: {
+			float const R = node.s0, r = node.s1;
+			for (size_t k = 0; k < N; ++k) {
+				float const qx = std::sqrt(x[k] * x[k] + y[k] * y[k]) - R;
+				value[k] = std::sqrt(qx * qx + z[k] * z[k]) - r;
+			}
+			break;
+		}
+		case sdf_node_type::capsule: {
+			vec3 const a = node.p0;
+			vec3 const ba = node.p1 - node.p0;
+			float const inv_ba2 = 1.0f / std::max(dot(ba, ba), 1e-20f);
+			float const r = node.s0;
+			for (size_t k = 0; k < N; ++k) {
+				float const px = x[k] - a.x, py = y[k] - a.y, pz = z[k] - a.z;
+				float const h = std::min(std::max((px * ba.x + py * ba.y + pz * ba.z) * inv_ba2, 0.0f), 1.0f);
+				float const dx = px - h * ba.x, dy = py - h * ba.y, dz = pz - h * ba.z;
+				value[k] = std::sqrt(dx * dx + dy * dy + dz * dz) - r;
+			}
+			break;
+		}
+		case sdf_node_type::plane: {
+			vec3 const n = node.p0;
+			float const offset = node.s0;
+			for (size_t k = 0; k < N; ++k)
+				value[k] = x[k] * n.x + y[k] * n.y + z[k] * n.z - offset;
+			break;
+		}
+		case sdf_node_type::union_:
+		case sdf_node_type::intersection:
+		case sdf_node_type::difference:
+		case sdf_node_type::smooth_union: {
+			float b[batch_size];
+			evaluate_batch(*node.child[0].node, x, y, z, value, N);
+			evaluate_batch(*node.child[1].node, x, y, z, b, N);
+			if (node.type == sdf_node_type::union_)
+				for (size_t k = 0; k < N; ++k) value[k] = std::min(value[k], b[k]);
+			else if (node.type == sdf_node_type::intersection)
+				for (size_t k = 0; k < N; ++k) value[k] = std::max(value[k], b[k]);
+			else if (node.type == sdf_node_type::difference)
+				for (size_t k = 0; k < N; ++k) value[k] = std::max(value[k], -b[k]);
+			else {
+				float const s = node.s0;
+				for (size_t k = 0; k < N; ++k) {
+					float const h = std::max(s - std::abs(value[k] - b[k]), 0.0f) / s;
+					value[k] = std::min(value[k], b[k]) - 0.25f * h * h * s;
+				}
+			}
+			break;
+		}
+		case sdf_node_type::translation: {
+			float tx[batch_size], ty[batch_size], tz[batch_size];
+			vec3 const t = node.p0;
+			for (size_t k = 0; k < N; ++k) {
+				tx[k] = x[k] - t.x;
+				ty[k] = y[k] - t.y;
+				tz[k] = z[k] - t.z;
+			}
+			evaluate_batch(*node.child[0].node, tx, ty, tz, value, N);
+			break;
+		}
+		case sdf_node_type::rotation: {
+			float tx[batch_size], ty[batch_size], tz[batch_size];
+			mat3 const& M = node.rotation;
+			for (size_t k = 0; k < N; ++k) {
+				tx[k] = M(0, 0) * x[k] + M(0, 1) * y[k] + M(0, 2) * z[k];
+				ty[k] = M(1, 0) * x[k] + M(1, 1) * y[k] + M(1, 2) * z[k];
+				tz[k] = M(2, 0) * x[k] + M(2, 1) * y[k] + M(2, 2) * z[k];
+			}
+			evaluate_batch(*node.child[0].node, tx, ty, tz, value, N);
+			break;
+		}
+		case sdf_node_type::scaling: {
+			float tx[batch_size], ty[batch_size], tz[batch_size];
+			float const s = node.s0, inv_s = 1.0f / node.s0;
+			for (size_t k = 0; k < N; ++k) {
+				tx[k] = x[k] * inv_s;
+				ty[k] = y[k] * inv_s;
+				tz[k] = z[k] * inv_s;
+			}
+			evaluate_batch(*node.child[0].node, tx, ty, tz, value, N);
+			for (size_t k = 0; k < N; ++k)
+				value[k] *= s;
+			break;
+		}
+		case sdf_node_type::noise_displacement: {
+			evaluate_batch(*node.child[0].node, x, y, z, value, N);
+			float const f = node.s1;
+			for (size_t k = 0; k < N; ++k)
+				value[k] += node.s0 * noise_perlin(vec3{ f * x[k], f * y[k], f * z[k] }, node.octave, node.persistency, node.frequency_gain);
+			break;
+		}
+		}
+	}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+	// Bound of the values on the box [center-half_size, center+half_size]
+	static sdf_interval evaluate_interval_node(sdf_node const& node, vec3 const& center, vec3 const& half_size)
+	{
+		switch (node.type)
+		{
+		case sdf_node_type::sphere:
+		case sdf_node_type::box:
+		case sdf_node_type::torus:
+		case sdf_node_type::capsule:
+		case sdf_node_type::plane: {
+			// Exact distances are 1-Lipschitz: the values differ at most by the half diagonal from the center of the box
+			float v;
+			evaluate_batch(node, &center.x, &center.y, &center.z, &v, 1);
+			float const r = norm(half_size);
+			return { v - r, v + r };
+		}
+		case sdf_node_type::union_:
+		case sdf_node_type::intersection:
+		case sdf_node_type::difference:
+		case sdf_node_type::smooth_union: {
+			sdf_interval const a = evaluate_interval_node(*node.child[0].node, center, half_size);
+			sdf_interval const b = evaluate_interval_node(*node.child[1].node, center, half_size);
+			if (node.type == sdf_node_type::union_)
+				return { std::min(a.min, b.min), std::min(a.max, b.max) };
+			if (node.type == sdf_node_type::intersection)
+				return { std::max(a.min, b.min), std::max(a.max, b.max) };
+			if (node.type == sdf_node_type::difference)
+				return { std::max(a.min, -b.max), std::max(a.max, -b.min) };
+			// The smooth minimum is in [min(a,b)-smoothness/4, min(a,b)]
+			return { std::min(a.min, b.min) - 0.25f * node.s0, std::min(a.max, b.max) };
+		}
+		case sdf_node_type::translation:
+			return evaluate_interval_node(*node.child[0].node, center - node.p0, half_size);
+		case sdf_node_type::rotation: {
+			// Axis aligned box containing the rotated box
+			mat3 const& M = node.rotation;
+			vec3 h;
+			for (int k = 0; k < 3; ++k)
+				h[k] = std::abs(M(k, 0)) * half_size.x + std::abs(M(k, 1)) * half_size.y + std::abs(M(k, 2)) * half_size.z;
+			return evaluate_interval_node(*node.child[0].node, M * center, h);
+		}
+		case sdf_node_type::scaling: {
+			sdf_interval const a = evaluate_interval_node(*node.child[0].node, center / node.s0, half_size / node.s0);
+			return { a.min * node.s0, a.max * node.s0 };
+		}
+		case sdf_node_type::noise_displacement: {
+			// Each octave of noise_perlin is in [0, magnitude] (with a small safety margin for the simplex noise)
+			float noise_max = 0, magnitude = 1;
+			for (int k = 0; k < node.octave; ++k, magnitude *= node.persistency)
+				noise_max += magnitude;
+			noise_max *= 1.05f;
+			sdf_interval const a = evaluate_interval_node(*node.child[0].node, center, half_size);
+			float const d0 = std::min(0.0f, node.s0 * noise_max), d1 = std::max(0.0f, node.s0 * noise_max);
+			return { a.min + d0 - 0.025f * std::abs(node.s0), a.max + d1 };
+		}
+		}
+		return { -std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+	}
+
+	float sdf_expression::operator()(vec3 const& p) const
+	{
+		float v;
+		evaluate_batch(*node, &p.x, &p.y, &p.z, &v, 1);
+		return v;
+	}
+
+	void sdf_expression::evaluate(float const* x, float const* y, float const* z, float* value, size_t N) const
+	{
+		assert_cgp(node != nullptr, "Cannot evaluate an empty sdf_expression");
+		for (size_t k = 0; k < N; k += batch_size)
+			evaluate_batch(*node, x + k, y + k, z + k, value + k, std::min(batch_size, N - k));
+	}
+
+	sdf_interval sdf_expression::evaluate_interval(vec3 const& p_min, vec3 const& p_max) const
+	{
+		assert_cgp(node != nullptr, "Cannot evaluate an empty sdf_expression");
+		return evaluate_interval_node(*node, (p_min + p_max) / 2.0f, (p_max - p_min) / 2.0f);
+	}
+
+
+	void sdf_evaluate(grid_3D<float>& field, sdf_expression const& expression, spatial_domain_grid_3D const& domain, sdf_evaluate_parameters const& parameters)
+	{
+		assert_cgp(expression.node != nullptr, "Cannot evaluate an empty sdf_expression");
+		assert_cgp(parameters.block_size > 0, "Block size must be strictly positive");
+
+		int3 const N = domain.samples;
+		field.resize(N);
+
+		// Coordinates of the grid points along each axis (same as domain.position)
+		std::vector<float> coordinate[3];
+		vec3 const corner = domain.corner_min();
+		for (int axis = 0; axis < 3; ++axis) {
+			coordinate[axis].resize(N[axis]);
+			for (int k = 0; k < N[axis]; ++k)
+				coordinate[axis][k] = corner[axis] + k / (N[axis] - 1.0f) * domain.length[axis];
+		}
+
+		int const B = parameters.block_size;
+		int3 const N_block = { (N.x + B - 1) / B, (N.y + B - 1) / B, (N.z + B - 1) / B };
+		size_t const N_block_total = size_t(N_block.x) * N_block.y * N_block.z;
+		int const halo = 2; // margin (in voxels) of the interval test
+
+		auto evaluate_block = [&](size_t k_block, std::vector<float>& x, std::vector<float>& y, std::vector<float>& z, std::vector<float>& value)
+		{
+			int3 const b = { int(k_block % N_block.x), int((k_block / N_block.x) % N_block.y), int(k_block / (size_t(N_block.x) * N_block.y)) };
+			int3 const i_min = B * b;
+			int3 const i_max = { std::min(i_min.x + B, N.x) - 1, std::min(i_min.y + B, N.y) - 1, std::min(i_min.z + B, N.z) - 1 };
+
+			if (parameters.pruning) {
+				vec3 p_min, p_max;
+				for (int axis = 0; axis < 3; ++axis) {
+					p_min[axis] = coordinate[axis][std::max(i_min[axis] - halo, 0)];
+					p_max[axis] = coordinate[axis][std::min(i_max[axis] + halo, N[axis] - 1)];
+				}
+				sdf_interval const interval = expression.evaluate_interval(p_min, p_max);
+				bool const outside = interval.min > parameters.iso;
+				bool const inside = interval.max < parameters.iso;
+				if (outside || inside) {
+					float const fill_value = outside ? interval.min : interval.max;
+					for (int kz = i_min.z; kz <= i_max.z; ++kz)
+						for (int ky = i_min.y; ky <= i_max.y; ++ky) {
+							float* row = &field.data.data[field.index_to_offset(i_min.x, ky, kz)];
+							std::fill(row, row + (i_max.x - i_min.x + 1), fill_value);
+						}
+					return;
+				}
+			}
+
+			// Evaluate the expression on all the grid points of the block
+			size_t counter = 0;
+			for (int kz = i_min.z; kz <= i_max.z; ++kz)
+				for (int ky = i_min.y; ky <= i_max.y; ++ky)
+					for (int kx = i_min.x; kx <= i_max.x; ++kx, ++counter) {
+						x[counter] = coordinate[0][kx];
+						y[counter] = coordinate[1][ky];
+						z[counter] = coordinate[2][kz];
+					}
+			expression.evaluate(x.data(), y.data(), z.data(), value.data(), counter);
+
+			counter = 0;
+			for (int kz = i_min.z; kz <= i_max.z; ++kz)
+				for (int ky = i_min.y; ky <= i_max.y; ++ky) {
+					float* row = &field.data.data[field.index_to_offset(i_min.x, ky, kz)];
+					for (int kx = i_min.x; kx <= i_max.x; ++kx, ++counter)
+						*(row++) = value[counter];
+				}
+		};
+
+		// Blocks are distributed dynamically between the threads (the cost of a block depends on its pruning)
+		int const thread_count = int(std::min(size_t(parallel_thread_count(parameters.thread_count)), N_block_total));
+
+		// Scratch buffers of each thread
+		size_t const block_points = size_t(B) * B * B;
+		std::vector<std::array<std::vector<float>, 4>> scratch(thread_count);
+		for (auto& buffer : scratch)
+			for (std::vector<float>& v : buffer)
+				v.resize(block_points);
+		parallel_for_task(int64_t(N_block_total), [&](int64_t k, int worker) {
+			std::array<std::vector<float>, 4>& buffer = scratch[worker];
+			evaluate_block(size_t(k), buffer[0], buffer[1], buffer[2], buffer[3]);
+		}, thread_count);
+	}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "cgp/04_grid_container/grid/grid.hpp"
+#include "cgp/09_geometric_transformation/rotation_transform/rotation_transform.hpp"
+#include "cgp/12_shape/spatial_domain/spatial_domain.hpp"
+
+#include <memory>
+
+namespace cgp {
+
+	/** Interval [min,max] bounding the values of a field over a region of space */
+	struct sdf_interval {
+		float min;
+		float max;
+	};
+
+	enum class sdf_node_type {
+		sphere, box, torus, capsule, plane,                         // primitives (exact signed distance)
+		union_, intersection, difference, smooth_union,             // operators combining two expressions
+		translation, rotation, scaling, noise_displacement          // operators modifying one expression
+	};
+
+	// Node of the expression tree (the parameters depend on the type of node, see the sdf_xxx functions)
+	struct sdf_node;
+
+	/** Signed distance field described as an expression tree of primitives and operators.
+	* The field is negative inside the shape and positive outside.
+	* Expressions are built with the functions sdf_xxx and can be shared between several trees (the nodes are immutable).
+	*
+	* Example:
+	*   sdf_expression f = sdf_smooth_union(sdf_sphere({0,0,0}, 0.5f), sdf_translation(sdf_torus(0.6f, 0.1f), {0,0,0.2f}), 0.1f);
+	*   float d = f({0.2f,0.1f,0.0f});
+	*   sdf_evaluate(field, f, domain); // fill a grid_3D<float> used by the marching cube
+	*/
+	struct sdf_expression {
+		std::shared_ptr<sdf_node const> node;
+
+		/** Value of the field at the position p */
+		float operator()(vec3 const& p) const;
+
+		/** Values of the field at N positions given as separated coordinates (x[k], y[k], z[k])
+		* The evaluation is performed node by node on batches of positions (the loops of each node are vectorized by the compiler) */
+		void evaluate(float const* x, float const* y, float const* z, float* value, size_t N) const;
+
+		/** Bound of the values of the field in the box p_min <= p <= p_max (interval arithmetic) */
+		sdf_interval evaluate_interval(vec3 const& p_min, vec3 const& p_max) const;
+	};
+
+	// Primitives
+	sdf_expression sdf_sphere(vec3 const& center, float radius);
+	sdf_expression sdf_box(vec3 const& center, vec3 const& half_size);
+	sdf_expression sdf_torus(float major_radius, float minor_radius); // centered at the origin, around the z axis
+	sdf_expression sdf_capsule(vec3 const& a, vec3 const& b, float radius);
+	sdf_expression sdf_plane(vec3 const& normal, float offset);       // dot(p,normal) - offset
+
+	// Operators combining two expressions
+	sdf_expression sdf_union(sdf_expression const& a, sdf_expression const& b);
+	sdf_expression sdf_intersection(sdf_expression const& a, sdf_expression const& b);
+	sdf_expression sdf_difference(sdf_expression const& a, sdf_expression const& b); // a minus b
+	sdf_expression sdf_smooth_union(sdf_expression const& a, sdf_expression const& b, float smoothness); // polynomial smooth minimum
+
+	// Operators modifying one expression
+	sdf_expression sdf_translation(sdf_expression const& a, vec3 const& translation);
+	sdf_expression sdf_rotation(sdf_expression const& a, rotation_transform const& rotation);
+	sdf_expression sdf_scaling(sdf_expression const& a, float scaling);
+	/** Add amplitude * noise_perlin(frequency * p, octave, persistency, frequency_gain) to the field (the result is not an exact distance anymore) */
+	sdf_expression sdf_noise_displacement(sdf_expression const& a, float amplitude, float frequency, int octave = 5, float persistency = 0.3f, float frequency_gain = 2.0f);
+
+
+	/** Parameters of sdf_evaluate */
+	struct sdf_evaluate_parameters {
+		int thread_count = 0;  // Number of threads (0: global number of threads, see set_parallel_thread_count)
+		int block_size = 8;    // The grid is evaluated by blocks of block_size^3 points
+
+		// Interval pruning: a block whose interval of values doesn't contain the iso-value (including a margin of 2 voxels around the block) is filled with the bound of the interval closest to the iso-value, instead of being evaluated.
+		//  The sign of the field is correct everywhere, and the values used by the marching cube (corners of the cells crossing the iso-surface, and their neighbors used for the gradient) are exact.
+		bool pruning = true;
+		float iso = 0.0f;
+	};
+
+	/** Fill the field with the values of the expression at the grid points of the domain */
+	void sdf_evaluate(grid_3D<float>& field, sdf_expression const& expression, spatial_domain_grid_3D const& domain, sdf_evaluate_parameters const& parameters = {});
+
+}
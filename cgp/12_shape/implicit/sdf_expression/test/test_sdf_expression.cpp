@@ -0,0 +1,97 @@
+#include "test_sdf_expression.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "../sdf_expression.hpp"
+#include "cgp/12_shape/implicit/marching_cube/marching_cube.hpp"
+
+#include <cstring>
+#include <vector>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	void test_sdf_expression()
+	{
+		// Composition of all the primitives and operators
+		sdf_expression sdf = sdf_smooth_union(
+			sdf_difference(sdf_box({ 0,0,0 }, { 0.6f,0.6f,0.6f }), sdf_sphere({ 0,0,0 }, 0.75f)),
+			sdf_rotation(sdf_translation(sdf_torus(0.9f, 0.15f), { 0,0,0.2f }), rotation_transform::from_axis_angle({ 1,0,0 }, 0.4f)), 0.1f);
+		sdf = sdf_union(sdf, sdf_intersection(sdf_capsule({ -1,-1,-1 }, { 1,-1,1 }, 0.1f), sdf_plane({ 0,0,1 }, 0.5f)));
+		sdf = sdf_union(sdf, sdf_scaling(sdf_sphere({ 1.5f,1.5f,0 }, 0.5f), 0.8f));
+
+		// Known values
+		assert_cgp_no_msg(is_equal(sdf_sphere({ 1,0,0 }, 0.5f)({ 3,0,0 }), 1.5f));
+		assert_cgp_no_msg(is_equal(sdf_translation(sdf_torus(1.0f, 0.25f), { 0,0,1 })({ 1,0,1 }), -0.25f));
+
+		// Batched evaluation = scalar evaluation
+		{
+			size_t const N = 1000;
+			std::vector<float> x(N), y(N), z(N), value(N);
+			for (size_t k = 0; k < N; ++k) {
+				x[k] = 1.5f * std::sin(0.7f * k);
+				y[k] = 1.5f * std::cos(1.3f * k);
+				z[k] = 1.5f * std::sin(2.1f * k + 0.5f);
+			}
+			sdf.evaluate(x.data(), y.data(), z.data(), value.data(), N);
+			for (size_t k = 0; k < N; ++k)
+				assert_cgp_no_msg(std::abs(value[k] - sdf({ x[k],y[k],z[k] })) < 1e-5f);
+		}
+
+		// The interval of a box bounds the values inside the box
+		{
+			vec3 const p_min = { -0.5f,-0.3f,0.1f }, p_max = { 0.2f,0.4f,0.6f };
+			sdf_interval const interval = sdf.evaluate_interval(p_min, p_max);
+			for (int kz = 0; kz <= 10; ++kz)
+				for (int ky = 0; ky <= 10; ++ky)
+					for (int kx = 0; kx <= 10; ++kx) {
+						vec3 const p = p_min + (p_max - p_min) * vec3{ kx / 10.0f, ky / 10.0f, kz / 10.0f };
+						float const v = sdf(p);
+						assert_cgp_no_msg(interval.min <= v + 1e-5f && v <= interval.max + 1e-5f);
+					}
+		}
+
+		// Grid evaluation with and without interval pruning
+		int const N = 64;
+		spatial_domain_grid_3D const domain = spatial_domain_grid_3D::from_center_length({ 0,0,0 }, { 4,4,4 }, { N,N,N });
+		sdf_evaluate_parameters parameters;
+		parameters.pruning = false;
+		grid_3D<float> reference;
+		sdf_evaluate(reference, sdf, domain, parameters);
+		for (int kz = 0; kz < N; kz += 7)
+			for (int ky = 0; ky < N; ky += 5)
+				for (int kx = 0; kx < N; kx += 3)
+					assert_cgp_no_msg(std::abs(reference(kx, ky, kz) - sdf(domain.position({ kx,ky,kz }))) < 1e-5f);
+
+		parameters.pruning = true;
+		for (int thread_count : { 1, 4 }) {
+			parameters.thread_count = thread_count;
+			grid_3D<float> pruned;
+			sdf_evaluate(pruned, sdf, domain, parameters);
+			assert_cgp_no_msg(is_equal(pruned.dimension, reference.dimension));
+
+			// Pruning never changes the sign, and only replaces values by bounds closer to the iso-value
+			int N_pruned = 0;
+			for (int k = 0; k < pruned.data.size(); ++k) {
+				float const v = reference.data.at(k), v_pruned = pruned.data.at(k);
+				assert_cgp_no_msg((v < 0) == (v_pruned < 0));
+				assert_cgp_no_msg(std::abs(v_pruned) <= std::abs(v) + 1e-5f);
+				if (v != v_pruned)
+					N_pruned++;
+			}
+			assert_cgp_no_msg(N_pruned > 0);
+
+			// The values used by the marching cube are exact: the mesh is identical
+			mesh const m_reference = marching_cube(reference, domain, 0.0f);
+			mesh const m_pruned = marching_cube(pruned, domain, 0.0f);
+			assert_cgp_no_msg(m_reference.connectivity.size() > 0);
+			assert_cgp_no_msg(m_pruned.position.size() == m_reference.position.size() && m_pruned.connectivity.size() == m_reference.connectivity.size());
+			assert_cgp_no_msg(std::memcmp(m_pruned.position.data.data(), m_reference.position.data.data(), m_reference.position.size() * sizeof(vec3)) == 0);
+			assert_cgp_no_msg(std::memcmp(m_pruned.connectivity.data.data(), m_reference.connectivity.data.data(), m_reference.connectivity.size() * sizeof(uint3)) == 0);
+		}
+	}
+}
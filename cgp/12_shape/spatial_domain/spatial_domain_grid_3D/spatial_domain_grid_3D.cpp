@@ -2,6 +2,9 @@
 
 #include "cgp/01_base/base.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 namespace cgp{
 
 	vec3 center;
@@ -38,6 +41,16 @@ namespace cgp{
 	{
 		return corner_min() + position_relative(index) * length;
 	}
+	int3 spatial_domain_grid_3D::index_nearest(vec3 const& p) const
+	{
+		vec3 const u = (p - corner_min()) / length;
+		int3 index;
+		for (int k = 0; k < 3; ++k) {
+			int const k_nearest = int(std::lround(u[k] * (samples[k] - 1.0f)));
+			index[k] = std::max(0, std::min(samples[k] - 1, k_nearest));
+		}
+		return index;
+	}
 
 	vec3 spatial_domain_grid_3D::corner_min() const
 	{
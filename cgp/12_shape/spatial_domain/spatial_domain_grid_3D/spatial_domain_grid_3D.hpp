@@ -22,6 +22,9 @@ namespace cgp {
 		/** The index (kx,ky,kz) is converted in normalized position \in [0,1] */
 		vec3 position_relative(int3 const& index) const;
 
+		/** Index [kx,ky,kz] of the grid point the closest to the position p (clamped to the grid) */
+		int3 index_nearest(vec3 const& p) const;
+
 		vec3 corner_min() const;
 		vec3 corner_max() const;
 		vec3 voxel_length() const;
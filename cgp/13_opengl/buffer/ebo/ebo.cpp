@@ -1,5 +1,6 @@
 #include "ebo.hpp"
 #include "../../debug/debug.hpp"
+#include "cgp/01_base/base.hpp"
 
 namespace cgp
 {
@@ -21,4 +22,15 @@ namespace cgp
 
 	}
 
+	void opengl_ebo_structure::update(numarray<uint3> const& data, int size_elements_update)
+	{
+		assert_cgp(size_elements_update <= data.size(), "Cannot update EBO with more elements than data");
+		int const N = size_elements_update == -1 ? data.size() : size_elements_update;
+		assert_cgp(N * sizeof(uint3) <= details.size_byte, "Cannot update EBO with more elements than its capacity");
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id); opengl_check;
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, N * sizeof(uint3), ptr(data));  opengl_check;
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); opengl_check;
+	}
+
 }
\ No newline at end of file
@@ -10,6 +10,12 @@ namespace cgp
 	struct opengl_ebo_structure : opengl_gpu_buffer
 	{
 		void initialize_data_on_gpu(numarray<uint3> const& data);
+
+		/** Re-write data on the EBO. (without re-allocation) in calling glBufferSubData
+		* - size_elements_update: 
+		*   number of elements to sent from data
+		*    -1: send all data (similar to data.size()) 	*/
+		void update(numarray<uint3> const& data, int size_elements_update = -1);
 	};
 
 
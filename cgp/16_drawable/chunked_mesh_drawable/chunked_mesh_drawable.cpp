@@ -0,0 +1,99 @@
+#include "chunked_mesh_drawable.hpp"
+
+#include "cgp/01_base/base.hpp"
+
+namespace cgp
+{
+	void chunked_mesh_drawable::initialize_data_on_gpu(int N_chunk, opengl_shader_structure const& shader_arg, opengl_texture_image_structure const& texture_arg)
+	{
+		clear();
+		chunk.resize(N_chunk);
+		shader = shader_arg;
+		texture = texture_arg;
+		model = affine();
+		material = material_mesh_drawable_phong();
+	}
+
+	void chunked_mesh_drawable::update_chunk(int k, mesh const& m)
+	{
+		assert_cgp(k >= 0 && k < int(chunk.size()), "Incorrect chunk index " + str(k));
+		mesh_drawable& drawable = chunk[k];
+
+		int const N_vertex = m.position.size();
+		int const N_triangle = m.connectivity.size();
+
+		// Empty chunk: the buffers are kept for the next updates, but nothing is drawn
+		if (N_vertex == 0 || N_triangle == 0) {
+			drawable.ebo_connectivity.size = 0;
+			return;
+		}
+
+		assert_cgp(m.normal.size() == N_vertex && m.color.size() == N_vertex && m.uv.size() == N_vertex, "The mesh of the chunk must have per-vertex normal, color, and uv");
+
+		int const capacity_vertex = int(drawable.vbo_position.details.size_byte / sizeof(vec3));
+		int const capacity_triangle = int(drawable.ebo_connectivity.details.size_byte / sizeof(uint3));
+		if (drawable.vao == 0 || N_vertex > capacity_vertex || N_triangle > capacity_triangle)
+		{
+			// Re-allocation with extra capacity: the unused part of the buffers is never drawn
+			mesh extended = m;
+			int const new_capacity_vertex = N_vertex + N_vertex / 2;
+			int const new_capacity_triangle = N_triangle + N_triangle / 2;
+			extended.position.resize(new_capacity_vertex);
+			extended.normal.resize(new_capacity_vertex);
+			extended.color.resize(new_capacity_vertex);
+			extended.uv.resize(new_capacity_vertex);
+			extended.connectivity.resize(new_capacity_triangle);
+
+			drawable.clear();
+			drawable.initialize_data_on_gpu(extended, shader, texture);
+		}
+		else
+		{
+			drawable.vbo_position.update(m.position);
+			drawable.vbo_normal.update(m.normal);
+			drawable.vbo_color.update(m.color);
+			drawable.vbo_uv.update(m.uv);
+			drawable.ebo_connectivity.update(m.connectivity);
+		}
+
+		// Only the valid part of the buffers is drawn
+		drawable.vbo_position.size = N_vertex;
+		drawable.ebo_connectivity.size = N_triangle;
+	}
+
+	void chunked_mesh_drawable::clear()
+	{
+		for (mesh_drawable& drawable : chunk)
+			drawable.clear();
+		chunk.clear();
+	}
+
+	// Temporary drawable using the buffers of the chunk k, and the shared parameters
+	static mesh_drawable chunk_proxy(chunked_mesh_drawable const& drawable, int k)
+	{
+		mesh_drawable proxy;
+		mesh_drawable const& c = drawable.chunk[k];
+		proxy.vao = c.vao;
+		proxy.vbo_position = c.vbo_position;
+		proxy.ebo_connectivity = c.ebo_connectivity;
+		proxy.shader = drawable.shader;
+		proxy.texture = drawable.texture;
+		proxy.model = drawable.model;
+		proxy.material = drawable.material;
+		return proxy;
+	}
+
+	void draw(chunked_mesh_drawable const& drawable, environment_generic_structure const& environment)
+	{
+		for (int k = 0; k < int(drawable.chunk.size()); ++k)
+			if (drawable.chunk[k].ebo_connectivity.size > 0)
+				draw(chunk_proxy(drawable, k), environment);
+	}
+
+	void draw_wireframe(chunked_mesh_drawable const& drawable, environment_generic_structure const& environment, vec3 const& color)
+	{
+		for (int k = 0; k < int(drawable.chunk.size()); ++k)
+			if (drawable.chunk[k].ebo_connectivity.size > 0)
+				draw_wireframe(chunk_proxy(drawable, k), environment, color);
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../mesh_drawable/mesh_drawable.hpp"
+
+namespace cgp
+{
+	/** Mesh split in independent chunks (such as the bricks of marching_cube_chunked), each chunk being stored in its own GPU buffers.
+	* Updating a chunk only sends its data to the GPU:
+	*  - If the new mesh fits in the current buffers, they are re-written in place (glBufferSubData), and only the valid part is drawn.
+	*  - Otherwise the buffers of the chunk are re-allocated with some extra capacity for the next updates.
+	* All the chunks share the same shader, texture, model and material. */
+	struct chunked_mesh_drawable
+	{
+		std::vector<mesh_drawable> chunk;
+
+		opengl_shader_structure shader;
+		opengl_texture_image_structure texture;
+		affine model;
+		material_mesh_drawable_phong material;
+
+		// Set the number of chunks (all empty)
+		void initialize_data_on_gpu(int N_chunk, opengl_shader_structure const& shader = mesh_drawable::default_shader, opengl_texture_image_structure const& texture = mesh_drawable::default_texture);
+
+		// Send the mesh of the chunk k to the GPU (the mesh must have per-vertex normal, color, and uv, see mesh::fill_empty_field)
+		void update_chunk(int k, mesh const& m);
+
+		// Clear the GPU memory of all the chunks
+		void clear();
+	};
+
+	void draw(chunked_mesh_drawable const& drawable, environment_generic_structure const& environment = environment_generic_structure());
+	void draw_wireframe(chunked_mesh_drawable const& drawable, environment_generic_structure const& environment = environment_generic_structure(), vec3 const& color = { 0,0,1 });
+}
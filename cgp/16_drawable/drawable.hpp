@@ -2,6 +2,7 @@
 
 #include "material/material.hpp"
 #include "mesh_drawable/mesh_drawable.hpp"
+#include "chunked_mesh_drawable/chunked_mesh_drawable.hpp"
 #include "triangles_drawable/triangles_drawable.hpp"
 #include "curve_drawable/curve_drawable.hpp"
 #include "curve_drawable_dynamic_extend/curve_drawable_dynamic_extend.hpp"
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <charconv>
+#include <cstdlib>
+#include <string>
+
+namespace cgp
+{
+namespace loader{
+
+// Helper functions to read text formats directly from a buffer in memory [it, end[ (such as a memory mapped file)
+//  Each function reads from the position it, and returns the position after the last character read.
+//  Numbers are converted with std::from_chars (locale independent, no allocation).
+namespace text_scanner {
+
+    inline bool is_blank(char c) { return c==' ' || c=='\t' || c=='\r'; }
+
+    inline char const* skip_blank(char const* it, char const* end)
+    {
+        while(it<end && is_blank(*it))
+            ++it;
+        return it;
+    }
+
+    inline char const* skip_line(char const* it, char const* end)
+    {
+        while(it<end && *it!='\n')
+            ++it;
+        return it<end ? it+1 : end;
+    }
+
+    // Read a float after optional blank characters. Set value to 0 if no number can be read.
+    inline char const* read_float(char const* it, char const* end, float& value)
+    {
+        it = skip_blank(it, end);
+        if(it<end && *it=='+') // from_chars doesn't accept explicit '+'
+            ++it;
+#ifdef __cpp_lib_to_chars
+        std::from_chars_result const r = std::from_chars(it, end, value);
+        if(r.ec==std::errc::invalid_argument) {
+            value = 0.0f;
+            return it;
+        }
+        return r.ptr;
+#else
+        // Fallback for standard libraries without floating point from_chars
+        char token[64];
+        size_t N = 0;
+        while(it+N<end && N<63 && !is_blank(it[N]) && it[N]!='\n')
+            token[N] = it[N], ++N;
+        token[N] = '\0';
+        char* token_end = nullptr;
+        value = std::strtof(token, &token_end);
+        return it + (token_end-token);
+#endif
+    }
+
+    inline char const* read_int(char const* it, char const* end, int& value)
+    {
+        if(it<end && *it=='+')
+            ++it;
+        std::from_chars_result const r = std::from_chars(it, end, value);
+        if(r.ec!=std::errc()) {
+            value = 0;
+            return it;
+        }
+        return r.ptr;
+    }
+
+    // Read a word (sequence of non blank characters) after optional blank characters
+    inline char const* read_word(char const* it, char const* end, std::string& word)
+    {
+        it = skip_blank(it, end);
+        char const* const word_begin = it;
+        while(it<end && !is_blank(*it) && *it!='\n')
+            ++it;
+        word.assign(word_begin, it);
+        return it;
+    }
+
+    // Return true if the buffer at position it starts with the given keyword
+    inline bool starts_with(char const* it, char const* end, std::string const& keyword)
+    {
+        return size_t(end-it)>=keyword.size() && keyword.compare(0, keyword.size(), it, keyword.size())==0;
+    }
+}
+
+}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+
+namespace cgp
+{
+namespace loader{
+
+// Helper functions to write text formats directly in a pre-allocated buffer
+//  Each function writes at the position it, and returns the position after the last character written.
+//  The caller ensures that the buffer is large enough (see max_float_size).
+//  Numbers are converted with std::to_chars (locale independent, no allocation).
+namespace text_writer {
+
+    // Maximal number of characters of a float written by write_float (such as -1.17549435e-38)
+    constexpr int max_float_size = 16;
+    // Maximal number of characters of a 32 bits integer
+    constexpr int max_int_size = 11;
+
+    inline char* write_char(char* it, char c)
+    {
+        *it = c;
+        return it+1;
+    }
+
+    inline char* write_string(char* it, char const* s)
+    {
+        size_t const N = std::strlen(s);
+        std::memcpy(it, s, N);
+        return it+N;
+    }
+
+    // Write the shortest representation of the float that is read back to the same value
+    inline char* write_float(char* it, float value)
+    {
+#ifdef __cpp_lib_to_chars
+        return std::to_chars(it, it+max_float_size, value).ptr;
+#else
+        // Fallback for standard libraries without floating point to_chars
+        char token[32];
+        int const N = std::snprintf(token, sizeof(token), "%.9g", double(value));
+        std::memcpy(it, token, N);
+        return it+N;
+#endif
+    }
+
+    inline char* write_int(char* it, long long value)
+    {
+        return std::to_chars(it, it+20, value).ptr;
+    }
+
+    // Write the float in a stream with the representation of write_float (operator<< keeps only 6 significant digits by default)
+    inline std::ostream& write_float(std::ostream& stream, float value)
+    {
+        char token[max_float_size];
+        return stream.write(token, write_float(token, value)-token);
+    }
+
+}
+
+}
+}
@@ -0,0 +1,60 @@
+#include "vertex_index_table.hpp"
+
+namespace cgp
+{
+namespace loader{
+
+    vertex_index_table::vertex_index_table(size_t expected_size)
+    {
+        allocate(expected_size);
+    }
+
+    void vertex_index_table::allocate(size_t expected_size)
+    {
+        size_t capacity = 16;
+        while(capacity < 2*expected_size)
+            capacity *= 2;
+        key.assign(capacity, int3{-1,-1,-1});
+        value.assign(capacity, -1);
+    }
+
+    size_t vertex_index_table::hash(int3 const& k)
+    {
+        uint64_t h = uint64_t(uint32_t(k.x)) * 0x9E3779B97F4A7C15ull;
+        h ^= uint64_t(uint32_t(k.y)) * 0xC2B2AE3D27D4EB4Full;
+        h ^= uint64_t(uint32_t(k.z)) * 0x165667B19E3779F9ull;
+        h ^= h >> 32;
+        return size_t(h);
+    }
+
+    int vertex_index_table::find_or_insert(int3 const& k, int new_value)
+    {
+        if(2*(counter+1) > value.size())
+            grow();
+
+        size_t const mask = value.size()-1;
+        for(size_t slot = hash(k) & mask; ; slot = (slot+1) & mask) {
+            if(value[slot]==-1) {
+                key[slot] = k;
+                value[slot] = new_value;
+                ++counter;
+                return -1;
+            }
+            if(key[slot].x==k.x && key[slot].y==k.y && key[slot].z==k.z)
+                return value[slot];
+        }
+    }
+
+    void vertex_index_table::grow()
+    {
+        std::vector<int3> const previous_key = std::move(key);
+        std::vector<int> const previous_value = std::move(value);
+        allocate(previous_value.size());
+        counter = 0;
+        for(size_t k=0; k<previous_value.size(); ++k)
+            if(previous_value[k]!=-1)
+                find_or_insert(previous_key[k], previous_value[k]);
+    }
+
+}
+}
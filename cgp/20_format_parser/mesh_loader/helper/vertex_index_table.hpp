@@ -0,0 +1,35 @@
+#pragma once
+
+#include "cgp/02_numarray/numarray_stack/numarray_stack.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace cgp
+{
+namespace loader{
+
+    /** Open-addressing hash table associating a triplet of integers to a vertex index
+    * Used by the loaders to merge vertices sharing the same attributes, such as the triplet (position, texture, normal) of obj files,
+    *  or the bit pattern of the coordinates of stl vertices.
+    * The table is allocated once with a capacity twice the expected number of distinct triplets (linear probing).
+    * It is only re-allocated if more distinct triplets than expected are inserted. */
+    struct vertex_index_table {
+        std::vector<int3> key;
+        std::vector<int> value; // -1 for empty slot
+        size_t counter = 0;
+
+        vertex_index_table(size_t expected_size);
+
+        /** Return the index associated to k if it already exists, otherwise insert k with the index new_value and return -1 */
+        int find_or_insert(int3 const& k, int new_value);
+
+        static size_t hash(int3 const& k);
+
+    private:
+        void allocate(size_t expected_size);
+        void grow();
+    };
+
+}
+}
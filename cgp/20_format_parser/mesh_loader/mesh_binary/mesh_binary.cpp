@@ -0,0 +1,233 @@
+#include "mesh_binary.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/03_files/files.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace cgp
+{
+namespace loader{
+
+    static char const mesh_binary_magic[8] = {'C','G','P','M','E','S','H','\0'};
+    static uint32_t const mesh_binary_version = 1;
+    static uint32_t const mesh_binary_endianness = 0x01020304;
+
+    uint64_t mesh_binary_hash(char const* buffer, size_t size, uint64_t seed)
+    {
+        uint64_t const prime = 0x9E3779B97F4A7C15ull;
+        uint64_t h = seed ^ (size * prime);
+
+        size_t const N_word = size/8;
+        for(size_t k=0; k<N_word; ++k) {
+            uint64_t w;
+            std::memcpy(&w, buffer+8*k, 8);
+            h = (h ^ w) * prime;
+            h ^= h >> 29;
+        }
+        for(size_t k=8*N_word; k<size; ++k)
+            h = (h ^ uint64_t(static_cast<unsigned char>(buffer[k]))) * prime;
+
+        h ^= h >> 32;
+        return h;
+    }
+
+    // Arrays of the mesh in the order they are stored in the file
+    template <typename F>
+    static void mesh_binary_for_each_array(mesh_binary_header const& header, F const& f)
+    {
+        f(header.N_position * sizeof(vec3));
+        f(header.N_normal * sizeof(vec3));
+        f(header.N_color * sizeof(vec3));
+        f(header.N_uv * sizeof(vec2));
+        f(header.N_connectivity * sizeof(uint3));
+        f(header.N_source_index * sizeof(int));
+    }
+
+    template <typename T>
+    static char const* to_octet(numarray<T> const& a)
+    {
+        return reinterpret_cast<char const*>(a.data.data());
+    }
+
+    bool mesh_save_file_binary(std::string const& filename, mesh const& m, mesh_binary_source const& source)
+    {
+        static_assert(sizeof(vec3)==3*sizeof(float) && sizeof(vec2)==2*sizeof(float) && sizeof(uint3)==3*sizeof(unsigned int), "Unexpected padding in vector types");
+
+        mesh_binary_header header;
+        std::memcpy(header.magic, mesh_binary_magic, 8);
+        header.version = mesh_binary_version;
+        header.endianness = mesh_binary_endianness;
+        header.N_position = m.position.size();
+        header.N_normal = m.normal.size();
+        header.N_color = m.color.size();
+        header.N_uv = m.uv.size();
+        header.N_connectivity = m.connectivity.size();
+        header.N_source_index = source.index.size();
+        header.N_source_vertex = source.N_vertex;
+        header.source_size = source.size;
+        header.source_time = source.time;
+
+        char const* arrays[6] = { to_octet(m.position), to_octet(m.normal), to_octet(m.color), to_octet(m.uv), to_octet(m.connectivity), to_octet(source.index) };
+
+        uint64_t hash = 0;
+        int k_array = 0;
+        mesh_binary_for_each_array(header, [&](uint64_t array_size) {
+            hash = mesh_binary_hash(arrays[k_array++], array_size, hash);
+        });
+        header.content_hash = hash;
+
+        // Write in a temporary file that is renamed once complete: a concurrent reader (or an interrupted write) never sees a partial file
+        std::string const filename_tmp = filename + ".tmp";
+        std::ofstream stream(filename_tmp, std::ios::out | std::ios::binary);
+        if(!stream.is_open())
+            return false;
+
+        stream.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        k_array = 0;
+        mesh_binary_for_each_array(header, [&](uint64_t array_size) {
+            stream.write(arrays[k_array++], std::streamsize(array_size));
+        });
+        stream.close();
+
+        bool success = !stream.fail();
+        if(success && std::rename(filename_tmp.c_str(), filename.c_str())!=0) {
+            // std::rename doesn't replace an existing file on Windows
+            std::remove(filename.c_str());
+            success = std::rename(filename_tmp.c_str(), filename.c_str())==0;
+        }
+        if(!success)
+            std::remove(filename_tmp.c_str());
+        return success;
+    }
+
+    // True if the arrays described by the header exactly fill the content_size bytes following the header
+    //  Each count is compared to the remaining size before being multiplied: a corrupted count cannot overflow the total size.
+    static bool mesh_binary_valid_content_size(mesh_binary_header const& header, uint64_t content_size)
+    {
+        uint64_t const count[6] = { header.N_position, header.N_normal, header.N_color, header.N_uv, header.N_connectivity, header.N_source_index };
+        uint64_t const element_size[6] = { sizeof(vec3), sizeof(vec3), sizeof(vec3), sizeof(vec2), sizeof(uint3), sizeof(int) };
+
+        uint64_t remaining = content_size;
+        for(int k=0; k<6; ++k) {
+            if(count[k] > remaining/element_size[k])
+                return false;
+            remaining -= count[k]*element_size[k];
+        }
+        return remaining==0;
+    }
+
+    static bool mesh_binary_valid_header(mesh_binary_header const& header, size_t file_size)
+    {
+        return file_size >= sizeof(header)
+            && std::memcmp(header.magic, mesh_binary_magic, 8)==0
+            && header.version==mesh_binary_version
+            && header.endianness==mesh_binary_endianness
+            && mesh_binary_valid_content_size(header, file_size - sizeof(header));
+    }
+
+    bool mesh_binary_read_header(std::string const& filename, mesh_binary_header& header)
+    {
+        if(!check_file_exist(filename))
+            return false;
+
+        std::ifstream stream(filename, std::ios::in | std::ios::binary);
+        stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if(!stream)
+            return false;
+        return mesh_binary_valid_header(header, file_get_size(filename));
+    }
+
+    template <typename T>
+    static char const* mesh_binary_copy_array(char const* it, uint64_t N, numarray<T>& a)
+    {
+        a.data.resize(N);
+        if(N>0)
+            std::memcpy(a.data.data(), it, N*sizeof(T));
+        return it + N*sizeof(T);
+    }
+
+    static uint64_t mesh_binary_content_hash(mesh_binary_header const& header, char const* content)
+    {
+        uint64_t hash = 0;
+        char const* it = content;
+        mesh_binary_for_each_array(header, [&](uint64_t array_size) {
+            hash = mesh_binary_hash(it, array_size, hash);
+            it += array_size;
+        });
+        return hash;
+    }
+
+    static mesh mesh_binary_copy_content(mesh_binary_header const& header, char const* content, mesh_binary_source& source)
+    {
+        mesh m;
+        char const* it = content;
+        it = mesh_binary_copy_array(it, header.N_position, m.position);
+        it = mesh_binary_copy_array(it, header.N_normal, m.normal);
+        it = mesh_binary_copy_array(it, header.N_color, m.color);
+        it = mesh_binary_copy_array(it, header.N_uv, m.uv);
+        it = mesh_binary_copy_array(it, header.N_connectivity, m.connectivity);
+        it = mesh_binary_copy_array(it, header.N_source_index, source.index);
+        source.N_vertex = header.N_source_vertex;
+        source.size = header.source_size;
+        source.time = header.source_time;
+
+        return m;
+    }
+
+    mesh mesh_load_file_binary(std::string const& filename, mesh_binary_source& source, bool check_content_hash)
+    {
+        file_memory_map const file(filename);
+
+        // These checks are kept without assertions: the counts of the header drive the copies of the arrays
+        mesh_binary_header header;
+        if(file.size()<sizeof(header))
+            error_cgp("File "+filename+" is not a binary mesh file");
+        std::memcpy(&header, file.data(), sizeof(header));
+        if(!mesh_binary_valid_header(header, file.size()))
+            error_cgp("File "+filename+" is not a valid binary mesh file (or has been written with a different version or endianness)");
+
+        char const* const content = file.data() + sizeof(header);
+        if(check_content_hash && mesh_binary_content_hash(header, content)!=header.content_hash)
+            error_cgp("File "+filename+" is corrupted (content hash doesn't match)");
+
+        return mesh_binary_copy_content(header, content, source);
+    }
+
+    bool mesh_try_load_file_binary(std::string const& filename, mesh& m, mesh_binary_source& source)
+    {
+        if(!check_file_exist(filename))
+            return false;
+
+        file_memory_map const file(filename);
+
+        mesh_binary_header header;
+        if(file.size()<sizeof(header))
+            return false;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if(!mesh_binary_valid_header(header, file.size()))
+            return false;
+
+        char const* const content = file.data() + sizeof(header);
+        if(mesh_binary_content_hash(header, content)!=header.content_hash)
+            return false;
+
+        m = mesh_binary_copy_content(header, content, source);
+        return true;
+    }
+}
+
+    void mesh_save_file_binary(std::string const& filename, mesh const& m)
+    {
+        if(!loader::mesh_save_file_binary(filename, m, loader::mesh_binary_source()))
+            error_cgp("Cannot write file " + str(filename));
+    }
+
+    mesh mesh_load_file_binary(std::string const& filename, bool check_content_hash)
+    {
+        loader::mesh_binary_source source;
+        return loader::mesh_load_file_binary(filename, source, check_content_hash);
+    }
+}
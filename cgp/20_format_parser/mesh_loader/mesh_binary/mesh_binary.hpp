@@ -0,0 +1,63 @@
+#pragma once
+
+#include "cgp/11_mesh/mesh.hpp"
+
+#include <cstdint>
+
+namespace cgp
+{
+    /** Save a mesh in a compact binary file (.cgpmesh)
+    * The file stores a header (counts and content hash) followed by the raw arrays position, normal, color, uv, and connectivity.
+    * The file is written in the endianness of the current machine. */
+    void mesh_save_file_binary(std::string const& filename, mesh const& m);
+
+    /** Load a mesh stored with mesh_save_file_binary
+    * The file is memory mapped and each array is copied in bulk into the mesh without any parsing.
+    * If check_content_hash is true, the content is verified against the hash stored in the header. */
+    mesh mesh_load_file_binary(std::string const& filename, bool check_content_hash = true);
+
+
+namespace loader{
+
+    /** Header of the binary mesh file */
+    struct mesh_binary_header {
+        char magic[8];             // "CGPMESH" followed by '\0'
+        uint32_t version;
+        uint32_t endianness;       // 0x01020304 written with the endianness of the machine saving the file
+        uint64_t N_position;
+        uint64_t N_normal;
+        uint64_t N_color;
+        uint64_t N_uv;
+        uint64_t N_connectivity;
+        uint64_t N_source_index;   // Optional index of each vertex in the source file the mesh has been generated from (0 if not stored)
+        uint64_t N_source_vertex;  // Number of vertices in the source file (0 if none)
+        uint64_t source_size;      // Size of the source file (0 if none)
+        int64_t  source_time;      // Last modification time of the source file (0 if none)
+        uint64_t content_hash;     // Hash of all the arrays stored after the header
+    };
+
+    /** Information on the source file a binary mesh has been generated from (used when the binary file is a cache of a slower format) */
+    struct mesh_binary_source {
+        numarray<int> index;      // Index of each vertex of the mesh in the source file
+        uint64_t N_vertex = 0;    // Number of vertices in the source file
+        uint64_t size = 0;        // Size of the source file
+        int64_t time = 0;         // Last modification time of the source file
+    };
+
+    /** Save a mesh in binary with information on its source file. Return false if the file cannot be written. */
+    bool mesh_save_file_binary(std::string const& filename, mesh const& m, mesh_binary_source const& source);
+
+    /** Read the header of a binary mesh file. Return false if the file doesn't exist or is not a valid binary mesh file for this machine. */
+    bool mesh_binary_read_header(std::string const& filename, mesh_binary_header& header);
+
+    /** Load a mesh stored in binary, as well as the information on its source file */
+    mesh mesh_load_file_binary(std::string const& filename, mesh_binary_source& source, bool check_content_hash = true);
+
+    /** Same as mesh_load_file_binary with the content hash verified, but return false instead of raising an error if the file is missing, invalid, or corrupted */
+    bool mesh_try_load_file_binary(std::string const& filename, mesh& m, mesh_binary_source& source);
+
+    /** Hash of a buffer of octets (non cryptographic, 8 octets processed at a time) */
+    uint64_t mesh_binary_hash(char const* buffer, size_t size, uint64_t seed = 0);
+}
+
+}
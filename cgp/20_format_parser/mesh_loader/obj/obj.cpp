@@ -6,111 +6,69 @@
 #endif
 
 #include "obj.hpp"
+#include "../mesh_binary/mesh_binary.hpp"
+#include "../helper/text_scanner.hpp"
+#include "../helper/text_writer.hpp"
+#include "../helper/vertex_index_table.hpp"
 
 #include "cgp/01_base/base.hpp"
 #include "cgp/03_files/files.hpp"
 
-#include <map>
+#include <algorithm>
+#include <cstdint>
 
 #include <fstream>
+#include <memory>
 #include <sstream>
 
 namespace cgp
 {
 
-    void mesh_save_file_obj(std::string const& filename, mesh const& m)
-    {
-        std::ofstream stream(filename, std::ofstream::out);
-        assert_cgp(stream.is_open(), "Cannot open file " + str(filename));
-
-        for (int k = 0; k < m.position.size(); ++k)
-            stream << "v " << m.position[k].x << " " << m.position[k].y <<" " << m.position[k].z << std::endl;
-        for (int k = 0; k < m.uv.size(); ++k)
-            stream << "vt " << m.uv[k].x <<" " << m.uv[k].y << std::endl;
-        for (int k = 0; k < m.normal.size(); ++k)
-            stream << "vn " << m.normal[k].x << " " << m.normal[k].y <<" " << m.normal[k].z << std::endl;
-
-        for (int k = 0; k < m.connectivity.size(); ++k) {
-            std::string const u0 = str(m.connectivity[k][0]+1);
-            std::string const u1 = str(m.connectivity[k][1]+1);
-            std::string const u2 = str(m.connectivity[k][2]+1);
-            std::string const f0 = u0 + "/" + u0 + "/" + u0;
-            std::string const f1 = u1 + "/" + u1 + "/" + u1;
-            std::string const f2 = u2 + "/" + u2 + "/" + u2;
-
-            stream << "f " << f0 << " " << f1 << " " << f2 << std::endl;
-        }
-
-        stream.close();
-    }
-
-    void mesh_save_file_obj(std::string const& filename, std::vector<vec3> const& position, std::vector<vec3> const& normal)
-    {
-        std::ofstream stream(filename, std::ofstream::out);
-        assert_cgp(stream.is_open(), "Cannot open file " + str(filename));
-
-        for (int k = 0; k < position.size(); ++k)
-            stream << "v " << position[k].x << " " << position[k].y <<" " << position[k].z << std::endl;
-        for (int k = 0; k < normal.size(); ++k)
-            stream << "vn " << normal[k].x << " " << normal[k].y <<" " << normal[k].z << std::endl;
-
-        for (int k = 0; k < position.size()/3; k++) {
-            std::string const u0 = str(3*k+1);
-            std::string const u1 = str(3*k+2);
-            std::string const u2 = str(3*k+3);
-            std::string const f0 = u0 + "//" + u0;
-            std::string const f1 = u1 + "//" + u1;
-            std::string const f2 = u2 + "//" + u2;
-
-            stream << "f " << f0 << " " << f1 << " " << f2 << std::endl;
-        }
-
-        stream.close();
-    }
-
-
-// Comparator of triplet of integer for std::map
-struct comparator_int3 {
-    long int N; // number of vertices
-
-    comparator_int3(int N_arg=0) :N(N_arg) {}
-
-    // compute a<b
-    bool operator()(int3 const& a, int3 const& b) const
-    {
-        long int const offset_a = long(a[0]) + N*(long(a[1]) + N*long(a[2]));
-        long int const offset_b = long(b[0]) + N*(long(b[1]) + N*long(b[2]));
-        return offset_a < offset_b;
-    }
-};
-
-
-static numarray<numarray_stack<int3,3>> triangulate_faces(numarray<numarray<int3>> faces);
-
-
-static std::pair<mesh, std::map<int3, int, comparator_int3>>
-    make_unique_parameter_per_value(numarray<vec3> const& positions,
+// Create the mesh with one vertex per distinct triplet (position, texture, normal) used in the faces
+//  vertex_key is filled with the triplet of indices of each vertex of the mesh.
+static mesh make_unique_parameter_per_value(numarray<vec3> const& positions,
                                     numarray<vec2> const& texture_uv,
                                     numarray<vec3> const& normals,
                                     numarray<numarray_stack<int3,3>> const& faces,
-                                    loader::obj_type const type);
+                                    loader::obj_type const type,
+                                    std::vector<int3>& vertex_key);
 
 
-mesh mesh_load_file_obj(const std::string& filename)
+mesh mesh_load_file_obj(const std::string& filename, mesh_load_file_obj_parameters const& parameters)
 {
     numarray<numarray<int>> vertex_correspondance;
-     mesh m = mesh_load_file_obj(filename, vertex_correspondance);
+     mesh m = mesh_load_file_obj(filename, vertex_correspondance, parameters);
      m.fill_empty_field();
      return m;
 }
-mesh mesh_load_file_obj(const std::string& filename, numarray<numarray<int> >& vertex_correspondance)
+mesh mesh_load_file_obj(const std::string& filename, numarray<numarray<int> >& vertex_correspondance, mesh_load_file_obj_parameters const& parameters)
 {
     assert_file_exist(filename);
 
-    // Load parameters
-    numarray<vec3> positions = loader::obj_read_positions(filename);
-    numarray<vec2> texture_uv = loader::obj_read_texture_uv(filename);
-    numarray<vec3> normals = loader::obj_read_normals(filename);
+    // Reuse the binary cache if it has been generated from the current version of the file (a corrupted cache is ignored and rewritten)
+    std::string const filename_cache = filename + ".cgpmesh";
+    loader::mesh_binary_source source;
+    if(parameters.use_binary_cache) {
+        source.size = file_get_size(filename);
+        source.time = file_get_modification_time(filename);
+
+        loader::mesh_binary_header header;
+        mesh m;
+        if(loader::mesh_binary_read_header(filename_cache, header) && header.source_size==source.size && header.source_time==source.time
+            && loader::mesh_try_load_file_binary(filename_cache, m, source))
+        {
+            vertex_correspondance.resize_clear(int(source.N_vertex));
+            for(int vertex_out=0; vertex_out<source.index.size(); ++vertex_out)
+                vertex_correspondance[source.index[vertex_out]].push_back(vertex_out);
+            return m;
+        }
+    }
+
+    // Load positions, uv, normals and triangulated faces in a single pass
+    loader::obj_content const content = loader::obj_read_content(filename, parameters.thread_count);
+    numarray<vec3> const& positions = content.position;
+    numarray<vec2> const& texture_uv = content.texture_uv;
+    numarray<vec3> const& normals = content.normal;
 
     assert_cgp(positions.size()>0, str("File ")+filename+" has 0 vertices");
 
@@ -123,60 +81,48 @@ mesh mesh_load_file_obj(const std::string& filename, numarray<numarray<int> >& v
     else if( normals.size()>0 )
         type = loader::obj_type::vertex_normal;
 
-    // Load connectivity and triangulate
-    numarray<numarray_stack<int3,3>> faces = triangulate_faces( loader::obj_read_faces(filename, type) );
-
     // Set unique per-vertex value for texture and normals (duplicate vertices if necessary)
-    mesh m;
-    std::map<int3, int, comparator_int3> connectivity_map;
-    std::tie(m,connectivity_map) = make_unique_parameter_per_value(positions, texture_uv, normals, faces, type);
+    std::vector<int3> vertex_key;
+    mesh m = make_unique_parameter_per_value(positions, texture_uv, normals, content.triangle, type, vertex_key);
 
-    // Retrieve correspondance between initial vertices in files and new ones
-    vertex_correspondance.resize(positions.size());
-    for(auto const& it : connectivity_map)
+    // Retrieve correspondance between initial vertices in files and new ones (in increasing order of the new vertices)
+    vertex_correspondance.resize_clear(positions.size());
+    int const N_vertex_out = int(vertex_key.size());
+    for(int vertex_out=0; vertex_out<N_vertex_out; ++vertex_out)
     {
-        int const vertex_in = it.first[0];
-        int const vertex_out = it.second;
-
+        int const vertex_in = vertex_key[vertex_out][0];
         vertex_correspondance[vertex_in].push_back(vertex_out);
     }
 
+    if(parameters.use_binary_cache) {
+        source.N_vertex = positions.size();
+        source.index.resize(N_vertex_out);
+        for(int vertex_out=0; vertex_out<N_vertex_out; ++vertex_out)
+            source.index[vertex_out] = vertex_key[vertex_out][0];
+        if(!loader::mesh_save_file_binary(filename_cache, m, source))
+            warning_cgp("Cannot write the binary cache of the obj file", filename_cache);
+    }
+
     return m;
 }
 
 
-numarray<numarray_stack<int3,3>> triangulate_faces(numarray<numarray<int3>> faces)
-{
-    numarray<numarray_stack<int3,3>> faces_triangulation;
-    size_t const N_face = faces.size();
-    for(size_t k_face=0; k_face<N_face; ++k_face)
-    {
-        numarray<int3> const& current_polygon = faces[k_face];
-        int const N_polygon = int(current_polygon.size());
-
-        for(int k=0; k<N_polygon-2; ++k) {
-            // triangulation
-            int3 const& f0 = current_polygon[0];
-            int3 const& f1 = current_polygon[k+1];
-            int3 const& f2 = current_polygon[k+2];
-
-            faces_triangulation.push_back({f0,f1,f2});
-        }
-    }
-    return faces_triangulation;
-}
-
-std::pair<mesh, std::map<int3, int, comparator_int3>>
-    make_unique_parameter_per_value(numarray<vec3> const& positions,
+mesh make_unique_parameter_per_value(numarray<vec3> const& positions,
                                     numarray<vec2> const& texture_uv,
                                     numarray<vec3> const& normals,
                                     numarray<numarray_stack<int3,3>> const& faces,
-                                    loader::obj_type const type)
+                                    loader::obj_type const type,
+                                    std::vector<int3>& vertex_key)
 {
     mesh m;
-    comparator_int3 comparator(int(positions.size()));
-    std::map<int3, int, comparator_int3> connectivity_map(comparator); // stores map between original face index and final offset
 
+    // Most vertices are shared between faces: the number of distinct triplets is expected to be close to the largest number of parameters
+    size_t const N_expected = std::min(3*size_t(faces.size()), size_t(std::max({positions.size(), texture_uv.size(), normals.size()})));
+    loader::vertex_index_table connectivity_map(N_expected); // stores map between original face index and final offset
+    vertex_key.clear();
+    vertex_key.reserve(N_expected);
+    m.position.data.reserve(N_expected);
+    m.connectivity.data.reserve(faces.size());
 
     size_t const N_triangle = faces.size();
     for(size_t k_triangle=0; k_triangle<N_triangle; ++k_triangle)
@@ -185,42 +131,255 @@ std::pair<mesh, std::map<int3, int, comparator_int3>>
         uint3 new_triangle_index;
         for(int k=0; k<3; ++k)
         {
-            int3 const& index = tri[k];
-            auto const it = connectivity_map.find( index );
-            if( it==connectivity_map.end() ) {
+            // Only the components used by the current type identify a vertex
+            int3 index = tri[k];
+            if(type==loader::obj_type::vertex || type==loader::obj_type::vertex_normal)
+                index[1] = -1;
+            if(type==loader::obj_type::vertex || type==loader::obj_type::vertex_texture)
+                index[2] = -1;
+
+            int const offset = m.position.size();
+            int const existing_offset = connectivity_map.find_or_insert(index, offset);
+            if( existing_offset==-1 ) {
 
-                size_t const offset = m.position.size();
-                connectivity_map[index] = int(offset);
-                new_triangle_index[k] = int(offset);
+                new_triangle_index[k] = offset;
+                vertex_key.push_back(index);
 
                 int const idx_position = index[0];
 
-                assert_cgp_no_msg( idx_position<int(positions.size()));
+                assert_cgp( idx_position>=0 && idx_position<int(positions.size()), "Face refers to an undefined vertex position" );
                 m.position.push_back( positions[idx_position] );
 
+                // Faces that do not refer to a uv/normal while the file defines some receive a default value
                 if(type==loader::obj_type::vertex_texture_normal || type==loader::obj_type::vertex_texture) {
                     int const idx_uv = index[1];
                     assert_cgp_no_msg( idx_uv<int(texture_uv.size()) );
-                    m.uv.push_back( texture_uv[ idx_uv ] );
+                    m.uv.push_back( idx_uv>=0 ? texture_uv[ idx_uv ] : vec2{0,0} );
                 }
                 if(type==loader::obj_type::vertex_texture_normal || type==loader::obj_type::vertex_normal) {
                     int const idx_normal = index[2];
                     assert_cgp_no_msg( idx_normal<int(normals.size()) );
-                    m.normal.push_back( normals[idx_normal] );
+                    m.normal.push_back( idx_normal>=0 ? normals[idx_normal] : vec3{0,0,1} );
                 }
 
             }
             else
-                new_triangle_index[k] = it->second;
+                new_triangle_index[k] = existing_offset;
         }
         m.connectivity.push_back(new_triangle_index);
     }
 
-    return {m, connectivity_map};
+    return m;
 }
 
 
 namespace loader{
+
+// Single-pass scanner of obj files
+//  The buffer is read once from begin to end without copy (see text_scanner).
+//  Each line is identified by its first keyword (v, vt, vn, f), other lines are skipped.
+namespace obj_scanner {
+
+    using namespace text_scanner;
+
+    inline bool is_end_of_line(char const* it, char const* end)
+    {
+        return it>=end || *it=='\n' || *it=='#';
+    }
+
+    // Convert an obj index (starting at 1, or negative for relative index) to an absolute index starting at 0. Return -1 if not defined.
+    inline int absolute_index(int idx, int N_defined)
+    {
+        if(idx>0)
+            return idx-1;
+        if(idx<0)
+            return N_defined+idx;
+        return -1;
+    }
+
+    // Read a face vertex of the form v, v/t, v//n, or v/t/n
+    //  The bits 0,1,2 of is_relative are set if the position/texture/normal index is relative (negative) in the file
+    inline char const* read_face_vertex(char const* it, char const* end, int3& index, int& is_relative, int N_position, int N_uv, int N_normal)
+    {
+        int v=0, t=0, n=0;
+        it = read_int(it, end, v);
+        if(it<end && *it=='/') {
+            ++it;
+            if(it<end && *it!='/')
+                it = read_int(it, end, t);
+            if(it<end && *it=='/') {
+                ++it;
+                it = read_int(it, end, n);
+            }
+        }
+        index = { absolute_index(v,N_position), absolute_index(t,N_uv), absolute_index(n,N_normal) };
+        is_relative = (v<0 ? 1 : 0) | (t<0 ? 2 : 0) | (n<0 ? 4 : 0);
+        return it;
+    }
+
+    // Store the position of a relative index in the triangle buffer as 9*triangle + 3*corner + component
+    inline void record_relative_index(std::vector<size_t>* relative_index, size_t triangle, int corner, int is_relative)
+    {
+        if(relative_index==nullptr || is_relative==0)
+            return;
+        for(int component=0; component<3; ++component)
+            if(is_relative & (1<<component))
+                relative_index->push_back(9*triangle + 3*corner + component);
+    }
+
+    // Read a face line after the keyword "f" and add its fan triangulation
+    //  Relative indices are resolved with respect to the elements already read in content.
+    //  If relative_index is not null, the location of these indices is recorded to be shifted later on (used when reading a chunk of the file).
+    inline char const* read_face(char const* it, char const* end, obj_content& content, std::vector<size_t>* relative_index)
+    {
+        int const N_position = content.position.size();
+        int const N_uv = content.texture_uv.size();
+        int const N_normal = content.normal.size();
+
+        int3 first, previous, current;
+        int first_relative = 0, previous_relative = 0, current_relative = 0;
+        int counter = 0;
+        it = skip_blank(it, end);
+        while(!is_end_of_line(it, end))
+        {
+            char const* const next = read_face_vertex(it, end, current, current_relative, N_position, N_uv, N_normal);
+            if(next==it) // not a valid face vertex: ignore the end of the line
+                break;
+            it = skip_blank(next, end);
+
+            if(counter==0) {
+                first = current;
+                first_relative = current_relative;
+            }
+            else if(counter>=2) {
+                size_t const triangle = content.triangle.data.size();
+                content.triangle.data.push_back({first, previous, current});
+                record_relative_index(relative_index, triangle, 0, first_relative);
+                record_relative_index(relative_index, triangle, 1, previous_relative);
+                record_relative_index(relative_index, triangle, 2, current_relative);
+            }
+            previous = current;
+            previous_relative = current_relative;
+            ++counter;
+        }
+        return it;
+    }
+
+    // Read all the lines of the buffer [begin, end[ and append their content
+    void read_lines(char const* begin, char const* end, obj_content& content, std::vector<size_t>* relative_index)
+    {
+        char const* it = begin;
+        while(it<end)
+        {
+            it = skip_blank(it, end);
+            if(it+1==end || (it+1<end && is_blank(it[1]))) {
+                // Single character keyword
+                if(*it=='v') {
+                    vec3 p;
+                    it = read_float(it+1, end, p.x);
+                    it = read_float(it, end, p.y);
+                    it = read_float(it, end, p.z);
+                    content.position.data.push_back(p);
+                }
+                else if(*it=='f')
+                    it = read_face(it+1, end, content, relative_index);
+            }
+            else if(it+2<end && it[0]=='v' && is_blank(it[2])) {
+                // Two characters keyword
+                if(it[1]=='t') {
+                    vec2 uv;
+                    it = read_float(it+2, end, uv.x);
+                    it = read_float(it, end, uv.y);
+                    content.texture_uv.data.push_back(uv);
+                }
+                else if(it[1]=='n') {
+                    vec3 n;
+                    it = read_float(it+2, end, n.x);
+                    it = read_float(it, end, n.y);
+                    it = read_float(it, end, n.z);
+                    content.normal.data.push_back(n);
+                }
+            }
+            it = skip_line(it, end);
+        }
+    }
+}
+
+int obj_thread_count(int thread_count, size_t buffer_size, size_t minimal_chunk_size)
+{
+    thread_count = parallel_thread_count(thread_count);
+    size_t const max_chunk = std::max(size_t(1), buffer_size/std::max(size_t(1), minimal_chunk_size));
+    return int(std::min(size_t(thread_count), max_chunk));
+}
+
+obj_content obj_read_content(std::string const& filename, int thread_count)
+{
+    file_memory_map const file(filename);
+    return obj_read_content(file.data(), file.data()+file.size(), thread_count);
+}
+
+obj_content obj_read_content(char const* begin, char const* end, int thread_count, size_t minimal_chunk_size)
+{
+    using namespace obj_scanner;
+
+    int const N_chunk = obj_thread_count(thread_count, size_t(end-begin), minimal_chunk_size);
+    if(N_chunk==1) {
+        obj_content content;
+        read_lines(begin, end, content, nullptr);
+        return content;
+    }
+
+    // Split the buffer in chunks of similar size starting at the beginning of a line
+    std::vector<char const*> chunk_begin(N_chunk+1);
+    chunk_begin[0] = begin;
+    chunk_begin[N_chunk] = end;
+    for(int k=1; k<N_chunk; ++k) {
+        char const* it = std::max(chunk_begin[k-1], begin + (end-begin)*k/N_chunk);
+        while(it<end && it[-1]!='\n')
+            ++it;
+        chunk_begin[k] = it;
+    }
+
+    // Read the chunks in parallel
+    //  Relative face indices are resolved with respect to the beginning of their chunk, and shifted during the merge
+    std::vector<obj_content> chunk(N_chunk);
+    std::vector<std::vector<size_t>> relative_index(N_chunk);
+    parallel_for_task(N_chunk, [&](int64_t k, int) {
+        read_lines(chunk_begin[k], chunk_begin[k+1], chunk[k], &relative_index[k]);
+    }, N_chunk);
+
+    // Offsets of each chunk in the merged buffers
+    std::vector<int3> offset(N_chunk+1, int3{0,0,0});
+    std::vector<size_t> offset_triangle(N_chunk+1, 0);
+    for(int k=0; k<N_chunk; ++k) {
+        offset[k+1] = offset[k] + int3{chunk[k].position.size(), chunk[k].texture_uv.size(), chunk[k].normal.size()};
+        offset_triangle[k+1] = offset_triangle[k] + chunk[k].triangle.data.size();
+    }
+
+    // Merge the chunks in order (the result is identical to a serial read)
+    obj_content content;
+    content.position.resize(offset[N_chunk].x);
+    content.texture_uv.resize(offset[N_chunk].y);
+    content.normal.resize(offset[N_chunk].z);
+    content.triangle.data.resize(offset_triangle[N_chunk]);
+    parallel_for_task(N_chunk, [&](int64_t k, int) {
+        obj_content const& c = chunk[k];
+        std::copy(c.position.data.begin(), c.position.data.end(), content.position.data.begin() + offset[k].x);
+        std::copy(c.texture_uv.data.begin(), c.texture_uv.data.end(), content.texture_uv.data.begin() + offset[k].y);
+        std::copy(c.normal.data.begin(), c.normal.data.end(), content.normal.data.begin() + offset[k].z);
+
+        auto const triangle_begin = content.triangle.data.begin() + offset_triangle[k];
+        std::copy(c.triangle.data.begin(), c.triangle.data.end(), triangle_begin);
+        for(size_t const idx : relative_index[k]) {
+            int const component = int(idx%3);
+            numarray_stack<int3,3>& tri = triangle_begin[idx/9];
+            tri.at_unsafe(int(idx/3)%3).at_unsafe(component) += offset[k].at_unsafe(component);
+        }
+    }, N_chunk);
+
+    return content;
+}
+
 std::vector<vec3> obj_read_positions(const std::string& filename)
 {
     assert_file_exist(filename);
@@ -419,6 +578,150 @@ numarray<numarray<int3>> obj_read_faces(const std::string& filename, obj_type co
 }
 
 
+// Buffered writer of obj files
+//  Lines are formatted with text_writer in large buffers (no per-line allocation nor flush).
+//  Sequences of lines are split in chunks formatted in parallel, and written to the file in order.
+namespace obj_writer {
+
+    using namespace text_writer;
+
+    // Upper bound of the number of characters of a line (the largest one is a face "f a/a/a b/b/b c/c/c")
+    constexpr size_t max_line_size = 2 + 3*(3*max_int_size+3);
+    // Number of lines formatted by a thread before being written
+    constexpr size_t lines_per_chunk = 1<<16;
+
+    // Write N_line lines, the line k being written by format_line(k, it) that returns the end of the line
+    template <typename F>
+    void write_lines(std::ofstream& stream, size_t N_line, int thread_count, F const& format_line)
+    {
+        if(N_line==0)
+            return;
+        int const N_thread = int(std::min(size_t(obj_thread_count(thread_count, N_line*max_line_size)), (N_line+lines_per_chunk-1)/lines_per_chunk));
+
+        // The buffers are sized for the lines actually written, and left uninitialized (only the formatted part is read)
+        size_t const buffer_capacity = std::min(N_line, lines_per_chunk)*max_line_size;
+        std::vector<std::unique_ptr<char[]>> buffer(N_thread);
+        for(auto& b : buffer)
+            b.reset(new char[buffer_capacity]);
+        std::vector<size_t> buffer_size(N_thread, 0);
+        for(size_t start=0; start<N_line; start+=N_thread*lines_per_chunk)
+        {
+            parallel_for_task(N_thread, [&](int64_t k, int) {
+                size_t const line_begin = std::min(N_line, start + k*lines_per_chunk);
+                size_t const line_end = std::min(N_line, line_begin + lines_per_chunk);
+                char* it = buffer[k].get();
+                for(size_t line=line_begin; line<line_end; ++line)
+                    it = format_line(line, it);
+                buffer_size[k] = size_t(it-buffer[k].get());
+            }, N_thread);
+            for(int k=0; k<N_thread; ++k)
+                stream.write(buffer[k].get(), std::streamsize(buffer_size[k]));
+        }
+    }
+
+    inline char* write_vec3(char* it, char const* keyword, vec3 const& p)
+    {
+        it = write_string(it, keyword);
+        it = write_float(it, p.x);
+        it = write_char(it, ' ');
+        it = write_float(it, p.y);
+        it = write_char(it, ' ');
+        it = write_float(it, p.z);
+        return write_char(it, '\n');
+    }
+
+    inline char* write_vec2(char* it, char const* keyword, vec2 const& p)
+    {
+        it = write_string(it, keyword);
+        it = write_float(it, p.x);
+        it = write_char(it, ' ');
+        it = write_float(it, p.y);
+        return write_char(it, '\n');
+    }
+
+    // Write a face where each vertex uses the same index for its position, and its optional texture and normal
+    inline char* write_face(char* it, long long i0, long long i1, long long i2, obj_type type)
+    {
+        it = write_char(it, 'f');
+        for(long long const i : {i0, i1, i2}) {
+            it = write_char(it, ' ');
+            it = write_int(it, i);
+            if(type==obj_type::vertex_texture || type==obj_type::vertex_texture_normal) {
+                it = write_char(it, '/');
+                it = write_int(it, i);
+            }
+            if(type==obj_type::vertex_normal)
+                it = write_char(it, '/');
+            if(type==obj_type::vertex_normal || type==obj_type::vertex_texture_normal) {
+                it = write_char(it, '/');
+                it = write_int(it, i);
+            }
+        }
+        return write_char(it, '\n');
+    }
+
+    inline obj_type face_type(bool has_uv, bool has_normal)
+    {
+        if(has_uv && has_normal) return obj_type::vertex_texture_normal;
+        if(has_uv) return obj_type::vertex_texture;
+        if(has_normal) return obj_type::vertex_normal;
+        return obj_type::vertex;
+    }
+}
+
+}
+
+
+void mesh_save_file_obj(std::string const& filename, mesh const& m, mesh_save_file_obj_parameters const& parameters)
+{
+    using namespace loader::obj_writer;
+
+    std::ofstream stream(filename, std::ofstream::out | std::ofstream::binary);
+    assert_cgp(stream.is_open(), "Cannot open file " + str(filename));
+
+    size_t const N = m.position.size();
+    bool const has_uv = m.uv.size()==N;
+    bool const has_normal = m.normal.size()==N;
+    loader::obj_type const type = face_type(has_uv, has_normal);
+    int const thread_count = parameters.thread_count;
+
+    write_lines(stream, N, thread_count, [&](size_t k, char* it) { return write_vec3(it, "v ", m.position[k]); });
+    if(has_uv)
+        write_lines(stream, N, thread_count, [&](size_t k, char* it) { return write_vec2(it, "vt ", m.uv[k]); });
+    if(has_normal)
+        write_lines(stream, N, thread_count, [&](size_t k, char* it) { return write_vec3(it, "vn ", m.normal[k]); });
+
+    write_lines(stream, m.connectivity.size(), thread_count, [&](size_t k, char* it) {
+        uint3 const& f = m.connectivity[k];
+        return write_face(it, f.x+1ll, f.y+1ll, f.z+1ll, type);
+    });
+
+    assert_cgp(stream.good(), "Cannot write file " + str(filename));
+    stream.close();
+}
+
+void mesh_save_file_obj(std::string const& filename, numarray_view<vec3 const> position, numarray_view<vec3 const> normal, mesh_save_file_obj_parameters const& parameters)
+{
+    using namespace loader::obj_writer;
+
+    std::ofstream stream(filename, std::ofstream::out | std::ofstream::binary);
+    assert_cgp(stream.is_open(), "Cannot open file " + str(filename));
+
+    bool const has_normal = normal.size()==position.size();
+    loader::obj_type const type = face_type(false, has_normal);
+    int const thread_count = parameters.thread_count;
+
+    write_lines(stream, position.size(), thread_count, [&](size_t k, char* it) { return write_vec3(it, "v ", position.at(k)); });
+    if(has_normal)
+        write_lines(stream, normal.size(), thread_count, [&](size_t k, char* it) { return write_vec3(it, "vn ", normal.at(k)); });
+
+    write_lines(stream, position.size()/3, thread_count, [&](size_t k, char* it) {
+        long long const i = 3ll*k;
+        return write_face(it, i+1, i+2, i+3, type);
+    });
+
+    assert_cgp(stream.good(), "Cannot write file " + str(filename));
+    stream.close();
 }
 
 }
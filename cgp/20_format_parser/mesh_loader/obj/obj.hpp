@@ -4,13 +4,30 @@
 
 namespace cgp
 {
+    /** Parameters of the obj writer */
+    struct mesh_save_file_obj_parameters {
+        int thread_count = 0; // Number of threads formatting the lines (0: number of threads of the parallel loops, see set_parallel_thread_count). Small meshes are written on a single thread.
+    };
+
     /** Save a mesh in .obj file
-    * Note that OBJ format doesn't stores per-vertex color */
-    void mesh_save_file_obj(std::string const& filename, mesh const& m);
+    * Notes:
+    *  - OBJ format doesn't stores per-vertex color
+    *  - uv and normals are written only if they are defined for every vertex
+    *  - Floats are written with the shortest representation that is read back exactly */
+    void mesh_save_file_obj(std::string const& filename, mesh const& m, mesh_save_file_obj_parameters const& parameters = {});
+
 
+    /** Minimalist export of triangle soup (3 consecutive positions per triangle, normals are optional) */
+    void mesh_save_file_obj(std::string const& filename, numarray_view<vec3 const> position, numarray_view<vec3 const> normal, mesh_save_file_obj_parameters const& parameters = {});
 
-    /** Minimalist export of triangle soup */
-    void mesh_save_file_obj(std::string const& filename, std::vector<vec3> const& position, std::vector<vec3> const& normal);
+    /** Parameters of the obj loader */
+    struct mesh_load_file_obj_parameters {
+        int thread_count = 0; // Number of threads reading the file (0: number of threads of the parallel loops, see set_parallel_thread_count). Files of a few MB are read on a single thread.
+
+        // Binary cache (opt-in): the loaded mesh is saved next to the source as filename+".cgpmesh" (see mesh_save_file_binary),
+        //  and is directly loaded in the next calls as long as the size and modification time of the source file are unchanged.
+        bool use_binary_cache = false;
+    };
 
     /** Load a mesh stored as .obj in the filename.
     * Notes: 
@@ -19,11 +36,11 @@ namespace cgp
     *  - Only one mesh is loaded - this parser cannot be used when multiple textures are associated to different objects
     *  - The mesh is triangulated if higher degree polygons are in the file
     */
-    mesh mesh_load_file_obj(std::string const& filename);
+    mesh mesh_load_file_obj(std::string const& filename, mesh_load_file_obj_parameters const& parameters = {});
 
     /** Load a mesh stored as .obj in the filename. 
     * Outputs the correspondance between the vertex index in the file, and the loaded one */
-    mesh mesh_load_file_obj(std::string const& filename, numarray<numarray<int>>& vertex_correspondance);
+    mesh mesh_load_file_obj(std::string const& filename, numarray<numarray<int>>& vertex_correspondance, mesh_load_file_obj_parameters const& parameters = {});
 
 
 
@@ -36,6 +53,32 @@ namespace loader{
         vertex_normal          // f %d//%d %d//%d %d//%d
     };
 
+    /** Content of an obj file read in a single pass
+     * Faces are triangulated and store the triplet (position, texture, normal) of indices for each vertex.
+     * Indices start at 0, and are set to -1 when they are not defined in the file. */
+    struct obj_content {
+        numarray<vec3> position;
+        numarray<vec2> texture_uv;
+        numarray<vec3> normal;
+        numarray<numarray_stack<int3,3>> triangle;
+    };
+
+    /** Read positions, uv, normals, and faces of an obj file in a single pass over the memory mapped file
+     * Polygons are triangulated, and relative (negative) indices are converted to absolute ones.
+     * The file is split in chunks of lines read in parallel by thread_count threads of the parallel loops (0: see set_parallel_thread_count),
+     *  the result is identical to a serial read. */
+    obj_content obj_read_content(std::string const& filename, int thread_count=0);
+
+    /** Chunks of the obj buffers smaller than this size (in bytes) are not worth an additional thread */
+    constexpr size_t obj_minimal_chunk_size = size_t(1)<<22;
+
+    /** Read the content of an obj file already stored in memory in the buffer [begin, end[
+     * Each chunk read in parallel has at least minimal_chunk_size bytes (smaller values split small buffers, ex. for testing) */
+    obj_content obj_read_content(char const* begin, char const* end, int thread_count=0, size_t minimal_chunk_size=obj_minimal_chunk_size);
+
+    /** Number of threads actually used to read a buffer of a given size (small buffers are read on a single thread) */
+    int obj_thread_count(int thread_count, size_t buffer_size, size_t minimal_chunk_size=obj_minimal_chunk_size);
+
     /** Simple file reader of the position connectivity assuming triangles (doesn't handle texture and normal connectivity) */
     std::vector<uint3> obj_read_connectivity(const std::string& filename);
 
@@ -0,0 +1,554 @@
+#include "ply.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/03_files/files.hpp"
+#include "../helper/text_scanner.hpp"
+#include "../helper/text_writer.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+
+namespace cgp
+{
+namespace loader{
+namespace ply_format {
+
+    enum class ply_type { int8, uint8, int16, uint16, int32, uint32, float32, float64, undefined };
+    enum class ply_encoding { ascii, binary_little_endian, binary_big_endian };
+
+    // Attribute of the mesh filled by a vertex property
+    enum class ply_target { none, position_x, position_y, position_z, normal_x, normal_y, normal_z, color_r, color_g, color_b, uv_u, uv_v };
+
+    struct ply_property {
+        std::string name;
+        ply_type type = ply_type::undefined;
+        bool is_list = false;
+        ply_type count_type = ply_type::undefined; // type of the number of elements of the list
+        ply_target target = ply_target::none;
+        size_t offset = 0;                         // offset in the binary record (if the element has a fixed size)
+    };
+
+    struct ply_element {
+        std::string name;
+        size_t count = 0;
+        std::vector<ply_property> property;
+        bool fixed_size = true; // true if there is no list property
+        size_t stride = 0;      // size of a binary record (if fixed_size)
+    };
+
+    struct ply_header {
+        ply_encoding encoding = ply_encoding::ascii;
+        std::vector<ply_element> element;
+        char const* data_begin = nullptr;
+    };
+
+    static size_t type_size(ply_type type)
+    {
+        switch(type) {
+            case ply_type::int8: case ply_type::uint8: return 1;
+            case ply_type::int16: case ply_type::uint16: return 2;
+            case ply_type::int32: case ply_type::uint32: case ply_type::float32: return 4;
+            case ply_type::float64: return 8;
+            default: return 0;
+        }
+    }
+
+    static ply_type type_from_string(std::string const& s)
+    {
+        if(s=="char" || s=="int8") return ply_type::int8;
+        if(s=="uchar" || s=="uint8") return ply_type::uint8;
+        if(s=="short" || s=="int16") return ply_type::int16;
+        if(s=="ushort" || s=="uint16") return ply_type::uint16;
+        if(s=="int" || s=="int32") return ply_type::int32;
+        if(s=="uint" || s=="uint32") return ply_type::uint32;
+        if(s=="float" || s=="float32") return ply_type::float32;
+        if(s=="double" || s=="float64") return ply_type::float64;
+        return ply_type::undefined;
+    }
+
+    static std::string type_to_string(ply_type type)
+    {
+        switch(type) {
+            case ply_type::int8: return "char";
+            case ply_type::uint8: return "uchar";
+            case ply_type::int16: return "short";
+            case ply_type::uint16: return "ushort";
+            case ply_type::int32: return "int";
+            case ply_type::uint32: return "uint";
+            case ply_type::float32: return "float";
+            case ply_type::float64: return "double";
+            default: return "undefined";
+        }
+    }
+
+    static ply_target vertex_target(std::string const& name)
+    {
+        if(name=="x") return ply_target::position_x;
+        if(name=="y") return ply_target::position_y;
+        if(name=="z") return ply_target::position_z;
+        if(name=="nx") return ply_target::normal_x;
+        if(name=="ny") return ply_target::normal_y;
+        if(name=="nz") return ply_target::normal_z;
+        if(name=="red") return ply_target::color_r;
+        if(name=="green") return ply_target::color_g;
+        if(name=="blue") return ply_target::color_b;
+        if(name=="u" || name=="s" || name=="texture_u" || name=="texture_s") return ply_target::uv_u;
+        if(name=="v" || name=="t" || name=="texture_v" || name=="texture_t") return ply_target::uv_v;
+        return ply_target::none;
+    }
+
+    static ply_header read_header(char const* begin, char const* end, std::string const& filename)
+    {
+        using namespace text_scanner;
+        ply_header header;
+
+        char const* it = begin;
+        assert_cgp(starts_with(it, end, "ply"), "File " + filename + " is not a ply file");
+        it = skip_line(it, end);
+
+        bool end_header = false;
+        std::string word;
+        while(it<end && !end_header)
+        {
+            it = read_word(it, end, word);
+            if(word=="format") {
+                it = read_word(it, end, word);
+                if(word=="ascii") header.encoding = ply_encoding::ascii;
+                else if(word=="binary_little_endian") header.encoding = ply_encoding::binary_little_endian;
+                else if(word=="binary_big_endian") header.encoding = ply_encoding::binary_big_endian;
+                else error_cgp("Unknown ply format " + word + " in file " + filename);
+            }
+            else if(word=="element") {
+                ply_element element;
+                it = read_word(it, end, element.name);
+                it = read_word(it, end, word);
+                // Each element uses at least one byte of the file: larger counts come from a corrupted header
+                char const* const word_end = word.data() + word.size();
+                auto const [count_end, error] = std::from_chars(word.data(), word_end, element.count);
+                if(error!=std::errc() || count_end!=word_end || element.count > size_t(end-begin))
+                    error_cgp("Invalid number of elements '" + word + "' for the element " + element.name + " in file " + filename);
+                header.element.push_back(element);
+            }
+            else if(word=="property") {
+                assert_cgp(!header.element.empty(), "Property defined before any element in file " + filename);
+                ply_element& element = header.element.back();
+                ply_property property;
+                it = read_word(it, end, word);
+                if(word=="list") {
+                    property.is_list = true;
+                    it = read_word(it, end, word);
+                    property.count_type = type_from_string(word);
+                    it = read_word(it, end, word);
+                    property.type = type_from_string(word);
+                    element.fixed_size = false;
+                }
+                else
+                    property.type = type_from_string(word);
+                it = read_word(it, end, property.name);
+                assert_cgp(property.type!=ply_type::undefined, "Unknown property type in file " + filename);
+
+                if(element.name=="vertex" && !property.is_list)
+                    property.target = vertex_target(property.name);
+                property.offset = element.stride;
+                element.stride += type_size(property.type);
+                element.property.push_back(property);
+            }
+            else if(word=="end_header")
+                end_header = true;
+            // comment, obj_info, and unknown lines are ignored
+
+            it = skip_line(it, end);
+        }
+        assert_cgp(end_header, "File " + filename + " has no end_header");
+        header.data_begin = it;
+
+        return header;
+    }
+
+    // Sequential reader of values in the ascii or binary data
+    struct ply_value_reader {
+        char const* it;
+        char const* end;
+        bool ascii;
+
+        double value(ply_type type)
+        {
+            if(ascii) {
+                it = text_scanner::skip_blank(it, end);
+                if(type==ply_type::float32 || type==ply_type::float64) {
+                    float v = 0.0f;
+                    it = text_scanner::read_float(it, end, v);
+                    return v;
+                }
+                return double(integer(type));
+            }
+
+            if(it + type_size(type) > end)
+                error_cgp("Unexpected end of ply file");
+            double v = 0;
+            switch(type) {
+                case ply_type::int8:    { int8_t x;   std::memcpy(&x, it, 1); v = x; break; }
+                case ply_type::uint8:   { uint8_t x;  std::memcpy(&x, it, 1); v = x; break; }
+                case ply_type::int16:   { int16_t x;  std::memcpy(&x, it, 2); v = x; break; }
+                case ply_type::uint16:  { uint16_t x; std::memcpy(&x, it, 2); v = x; break; }
+                case ply_type::int32:   { int32_t x;  std::memcpy(&x, it, 4); v = x; break; }
+                case ply_type::uint32:  { uint32_t x; std::memcpy(&x, it, 4); v = x; break; }
+                case ply_type::float32: { float x;    std::memcpy(&x, it, 4); v = x; break; }
+                case ply_type::float64: { double x;   std::memcpy(&x, it, 8); v = x; break; }
+                default: break;
+            }
+            it += type_size(type);
+            return v;
+        }
+
+        int64_t integer(ply_type type)
+        {
+            if(ascii) {
+                it = text_scanner::skip_blank(it, end);
+                if(type==ply_type::float32 || type==ply_type::float64)
+                    return int64_t(value(type));
+                int64_t v = 0;
+                std::from_chars_result const r = std::from_chars(it, end, v);
+                it = r.ptr;
+                return v;
+            }
+            return int64_t(value(type));
+        }
+
+        void end_of_record()
+        {
+            if(ascii)
+                it = text_scanner::skip_line(it, end);
+        }
+    };
+
+    static void set_target(mesh& m, size_t k, ply_target target, float value, ply_type type)
+    {
+        // Integer colors are stored in [0,255]
+        float const color = type==ply_type::uint8 ? value/255.0f : value;
+        switch(target) {
+            case ply_target::position_x: m.position.at(k).x = value; break;
+            case ply_target::position_y: m.position.at(k).y = value; break;
+            case ply_target::position_z: m.position.at(k).z = value; break;
+            case ply_target::normal_x: m.normal.at(k).x = value; break;
+            case ply_target::normal_y: m.normal.at(k).y = value; break;
+            case ply_target::normal_z: m.normal.at(k).z = value; break;
+            case ply_target::color_r: m.color.at(k).x = color; break;
+            case ply_target::color_g: m.color.at(k).y = color; break;
+            case ply_target::color_b: m.color.at(k).z = color; break;
+            case ply_target::uv_u: m.uv.at(k).x = value; break;
+            case ply_target::uv_v: m.uv.at(k).y = value; break;
+            default: break;
+        }
+    }
+
+    // Return the property storing 3 consecutive float32 targets t0,t0+1,t0+2 in a binary record, or nullptr
+    static ply_property const* find_float3(ply_element const& element, ply_target t0)
+    {
+        for(size_t k=0; k+2<element.property.size(); ++k) {
+            ply_property const* p = &element.property[k];
+            if(p[0].target==t0 && p[0].type==ply_type::float32
+                && int(p[1].target)==int(t0)+1 && p[1].type==ply_type::float32
+                && int(p[2].target)==int(t0)+2 && p[2].type==ply_type::float32)
+                return p;
+        }
+        return nullptr;
+    }
+
+    static void read_vertices(ply_element const& element, ply_value_reader& reader, mesh& m)
+    {
+        size_t const N = element.count;
+        bool has_normal = false, has_color = false, has_uv = false;
+        for(ply_property const& p : element.property) {
+            if(p.target==ply_target::normal_x) has_normal = true;
+            if(p.target==ply_target::color_r) has_color = true;
+            if(p.target==ply_target::uv_u) has_uv = true;
+        }
+
+        m.position.resize(int64_t(N));
+        if(has_normal) m.normal.resize(int64_t(N));
+        if(has_color) m.color.resize(int64_t(N));
+        if(has_uv) m.uv.resize(int64_t(N));
+
+        if(!reader.ascii && element.fixed_size)
+        {
+            // Binary records of fixed size: direct access to each property
+            size_t const stride = element.stride;
+            if(reader.it + N*stride > reader.end)
+                error_cgp("Unexpected end of ply file");
+
+            // Bulk copy of the positions (and normals) stored as float x,y,z
+            ply_property const* position = find_float3(element, ply_target::position_x);
+            ply_property const* normal = find_float3(element, ply_target::normal_x);
+            if(position!=nullptr && stride==sizeof(vec3))
+                std::memcpy(m.position.data.data(), reader.it, N*stride);
+            else if(position!=nullptr)
+                for(size_t k=0; k<N; ++k)
+                    std::memcpy(&m.position.at(k), reader.it + k*stride + position->offset, sizeof(vec3));
+            if(normal!=nullptr)
+                for(size_t k=0; k<N; ++k)
+                    std::memcpy(&m.normal.at(k), reader.it + k*stride + normal->offset, sizeof(vec3));
+
+            // Other properties
+            for(size_t kp=0; kp<element.property.size(); ++kp) {
+                ply_property const& p = element.property[kp];
+                bool const already_read = (position!=nullptr && &p>=position && &p<position+3) || (normal!=nullptr && &p>=normal && &p<normal+3);
+                if(p.target==ply_target::none || already_read)
+                    continue;
+                ply_value_reader r = reader;
+                for(size_t k=0; k<N; ++k) {
+                    r.it = reader.it + k*stride + p.offset;
+                    set_target(m, k, p.target, float(r.value(p.type)), p.type);
+                }
+            }
+            reader.it += N*stride;
+            return;
+        }
+
+        // Generic sequential reading
+        for(size_t k=0; k<N; ++k) {
+            for(ply_property const& p : element.property) {
+                if(p.is_list) {
+                    int64_t const N_list = reader.integer(p.count_type);
+                    for(int64_t j=0; j<N_list; ++j)
+                        reader.value(p.type);
+                }
+                else {
+                    float const value = float(reader.value(p.type));
+                    set_target(m, k, p.target, value, p.type);
+                }
+            }
+            reader.end_of_record();
+        }
+    }
+
+    static void read_faces(ply_element const& element, ply_value_reader& reader, mesh& m)
+    {
+        size_t const N = element.count;
+        m.connectivity.data.reserve(N);
+
+        int index_property = -1;
+        for(size_t kp=0; kp<element.property.size(); ++kp)
+            if(element.property[kp].is_list && (element.property[kp].name=="vertex_indices" || element.property[kp].name=="vertex_index"))
+                index_property = int(kp);
+
+        // Most common binary case: faces only store the list of indices as uchar count + int/uint indices
+        bool const direct = !reader.ascii && index_property==0 && element.property.size()==1
+            && element.property[0].count_type==ply_type::uint8
+            && (element.property[0].type==ply_type::int32 || element.property[0].type==ply_type::uint32);
+        if(direct)
+        {
+            char const* it = reader.it;
+            char const* const end = reader.end;
+            for(size_t k=0; k<N; ++k) {
+                if(it >= end)
+                    error_cgp("Unexpected end of ply file");
+                unsigned int const N_polygon = static_cast<unsigned char>(*it);
+                ++it;
+                if(it + 4*N_polygon > end)
+                    error_cgp("Unexpected end of ply file");
+                if(N_polygon==3) {
+                    uint3 tri;
+                    std::memcpy(&tri, it, sizeof(uint3));
+                    m.connectivity.data.push_back(tri);
+                }
+                else {
+                    unsigned int i0, i_previous, i_current;
+                    for(unsigned int j=0; j<N_polygon; ++j) {
+                        std::memcpy(&i_current, it + 4*j, 4);
+                        if(j==0) i0 = i_current;
+                        else if(j>=2) m.connectivity.data.push_back({i0, i_previous, i_current});
+                        i_previous = i_current;
+                    }
+                }
+                it += 4*N_polygon;
+            }
+            reader.it = it;
+            return;
+        }
+
+        // Generic sequential reading
+        for(size_t k=0; k<N; ++k) {
+            for(size_t kp=0; kp<element.property.size(); ++kp) {
+                ply_property const& p = element.property[kp];
+                if(p.is_list) {
+                    int64_t const N_list = reader.integer(p.count_type);
+                    unsigned int i0 = 0, i_previous = 0;
+                    for(int64_t j=0; j<N_list; ++j) {
+                        unsigned int const i_current = static_cast<unsigned int>(reader.integer(p.type));
+                        if(int(kp)==index_property) {
+                            if(j==0) i0 = i_current;
+                            else if(j>=2) m.connectivity.data.push_back({i0, i_previous, i_current});
+                            i_previous = i_current;
+                        }
+                    }
+                }
+                else
+                    reader.value(p.type);
+            }
+            reader.end_of_record();
+        }
+    }
+
+    static void skip_element(ply_element const& element, ply_value_reader& reader)
+    {
+        if(!reader.ascii && element.fixed_size) {
+            reader.it += element.count * element.stride;
+            return;
+        }
+        for(size_t k=0; k<element.count; ++k) {
+            if(reader.ascii) {
+                reader.end_of_record();
+                continue;
+            }
+            for(ply_property const& p : element.property) {
+                if(p.is_list) {
+                    int64_t const N_list = reader.integer(p.count_type);
+                    reader.it += N_list * type_size(p.type);
+                }
+                else
+                    reader.it += type_size(p.type);
+            }
+        }
+    }
+
+    static bool is_little_endian()
+    {
+        uint16_t const x = 1;
+        unsigned char c;
+        std::memcpy(&c, &x, 1);
+        return c==1;
+    }
+}
+}
+
+
+    mesh mesh_load_file_ply(std::string const& filename)
+    {
+        using namespace loader::ply_format;
+
+        file_memory_map const file(filename);
+        char const* const end = file.data() + file.size();
+        ply_header const header = read_header(file.data(), end, filename);
+
+        if(header.encoding==ply_encoding::binary_big_endian)
+            error_cgp("Binary big endian ply files are not supported (" + filename + ")");
+        if(header.encoding!=ply_encoding::ascii && !is_little_endian())
+            error_cgp("Binary ply files can only be read on little endian systems");
+
+        mesh m;
+        ply_value_reader reader = { header.data_begin, end, header.encoding==ply_encoding::ascii };
+        for(ply_element const& element : header.element) {
+            if(element.name=="vertex")
+                read_vertices(element, reader, m);
+            else if(element.name=="face")
+                read_faces(element, reader, m);
+            else
+                skip_element(element, reader);
+        }
+
+        assert_cgp(m.position.size()>0, str("File ")+filename+" has 0 vertices");
+        for(uint3 const& tri : m.connectivity)
+            if(tri.x>=unsigned(m.position.size()) || tri.y>=unsigned(m.position.size()) || tri.z>=unsigned(m.position.size()))
+                error_cgp("Face refers to an undefined vertex in file " + filename);
+
+        m.fill_empty_field();
+        return m;
+    }
+
+
+    void mesh_save_file_ply(std::string const& filename, mesh const& m, bool binary)
+    {
+        using namespace loader::ply_format;
+        if(binary && !is_little_endian())
+            error_cgp("Binary ply files can only be written on little endian systems");
+
+        size_t const N = m.position.size();
+        size_t const N_triangle = m.connectivity.size();
+        bool const has_normal = m.normal.size()==N;
+        bool const has_color = m.color.size()==N;
+        bool const has_uv = m.uv.size()==N;
+
+        std::ofstream stream(filename, std::ios::out | std::ios::binary);
+        assert_cgp(stream.is_open(), "Cannot open file " + str(filename));
+
+        // Header
+        stream << "ply\n";
+        stream << (binary ? "format binary_little_endian 1.0\n" : "format ascii 1.0\n");
+        stream << "comment generated by cgp\n";
+        stream << "element vertex " << N << "\n";
+        stream << "property float x\nproperty float y\nproperty float z\n";
+        if(has_normal) stream << "property float nx\nproperty float ny\nproperty float nz\n";
+        if(has_color) stream << "property uchar red\nproperty uchar green\nproperty uchar blue\n";
+        if(has_uv) stream << "property float u\nproperty float v\n";
+        stream << "element face " << N_triangle << "\n";
+        stream << "property list " << type_to_string(ply_type::uint8) << " " << type_to_string(ply_type::uint32) << " vertex_indices\n";
+        stream << "end_header\n";
+
+        auto color_to_uchar = [](float c) { return static_cast<unsigned char>(clamp(c, 0.0f, 1.0f)*255.0f + 0.5f); };
+
+        if(binary)
+        {
+            // Vertices and faces are written as a single buffer each
+            size_t const stride = sizeof(vec3) + (has_normal ? sizeof(vec3) : 0) + (has_color ? 3 : 0) + (has_uv ? sizeof(vec2) : 0);
+            std::vector<char> buffer(N*stride);
+            for(size_t k=0; k<N; ++k) {
+                char* it = buffer.data() + k*stride;
+                std::memcpy(it, &m.position.at(k), sizeof(vec3)); it += sizeof(vec3);
+                if(has_normal) { std::memcpy(it, &m.normal.at(k), sizeof(vec3)); it += sizeof(vec3); }
+                if(has_color) {
+                    vec3 const& c = m.color.at(k);
+                    it[0] = char(color_to_uchar(c.x)); it[1] = char(color_to_uchar(c.y)); it[2] = char(color_to_uchar(c.z));
+                    it += 3;
+                }
+                if(has_uv) { std::memcpy(it, &m.uv.at(k), sizeof(vec2)); it += sizeof(vec2); }
+            }
+            stream.write(buffer.data(), std::streamsize(buffer.size()));
+
+            size_t const face_stride = 1 + sizeof(uint3);
+            buffer.resize(N_triangle*face_stride);
+            for(size_t k=0; k<N_triangle; ++k) {
+                char* it = buffer.data() + k*face_stride;
+                it[0] = 3;
+                std::memcpy(it+1, &m.connectivity.at(k), sizeof(uint3));
+            }
+            stream.write(buffer.data(), std::streamsize(buffer.size()));
+        }
+        else
+        {
+            // The floats are written with enough digits to be read back to the same value
+            auto write_vec3 = [&stream](vec3 const& v) {
+                loader::text_writer::write_float(stream, v.x) << " ";
+                loader::text_writer::write_float(stream, v.y) << " ";
+                loader::text_writer::write_float(stream, v.z);
+            };
+            for(size_t k=0; k<N; ++k) {
+                write_vec3(m.position.at(k));
+                if(has_normal) {
+                    stream << " ";
+                    write_vec3(m.normal.at(k));
+                }
+                if(has_color) {
+                    vec3 const& c = m.color.at(k);
+                    stream << " " << int(color_to_uchar(c.x)) << " " << int(color_to_uchar(c.y)) << " " << int(color_to_uchar(c.z));
+                }
+                if(has_uv) {
+                    vec2 const& uv = m.uv.at(k);
+                    stream << " ";
+                    loader::text_writer::write_float(stream, uv.x) << " ";
+                    loader::text_writer::write_float(stream, uv.y);
+                }
+                stream << "\n";
+            }
+            for(size_t k=0; k<N_triangle; ++k) {
+                uint3 const& f = m.connectivity.at(k);
+                stream << "3 " << f.x << " " << f.y << " " << f.z << "\n";
+            }
+        }
+
+        assert_cgp(stream.good(), "Cannot write file " + str(filename));
+        stream.close();
+    }
+}
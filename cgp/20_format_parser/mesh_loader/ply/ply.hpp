@@ -0,0 +1,22 @@
+#pragma once
+
+#include "cgp/11_mesh/mesh.hpp"
+
+namespace cgp
+{
+    /** Save a mesh in .ply file
+    * - binary=true: binary little endian format, binary=false: ascii format
+    * - Per-vertex normal, color (stored as uchar red/green/blue), and uv (stored as u,v) are saved if they are defined for every vertex */
+    void mesh_save_file_ply(std::string const& filename, mesh const& m, bool binary = true);
+
+    /** Load a mesh stored as .ply in the filename (ascii or binary little endian)
+    * Notes:
+    *  - The vertex properties x,y,z (position), nx,ny,nz (normal), red,green,blue (color), and u,v / s,t / texture_u,texture_v (uv) are read
+    *  - Faces are read from the list vertex_indices (or vertex_index), polygons are triangulated
+    *  - Other elements and properties are skipped
+    *  - Binary data are read directly from the memory mapped file (without intermediate copy)
+    *  - Empty per-vertex fields are filled with default values (see mesh::fill_empty_field)
+    */
+    mesh mesh_load_file_ply(std::string const& filename);
+
+}
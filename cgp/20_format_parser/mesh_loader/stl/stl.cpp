@@ -0,0 +1,198 @@
+#include "stl.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/03_files/files.hpp"
+#include "../helper/text_scanner.hpp"
+#include "../helper/text_writer.hpp"
+#include "../helper/vertex_index_table.hpp"
+
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+
+namespace cgp
+{
+namespace loader{
+namespace stl_format {
+
+    size_t const header_size = 80;
+    size_t const triangle_size = 50; // normal (3 floats) + 3 vertices (9 floats) + attribute (uint16)
+
+    // Size of the binary file described by the triangle count stored after the header (0 if the file is too small)
+    static size_t binary_size(char const* begin, size_t size)
+    {
+        if(size < header_size+4)
+            return 0;
+        uint32_t N_triangle;
+        std::memcpy(&N_triangle, begin+header_size, 4);
+        return header_size + 4 + size_t(N_triangle)*triangle_size;
+    }
+
+    // Binary files may also start with "solid", and may have trailing bytes after the last triangle:
+    //  - a file whose size matches exactly the triangle count is binary
+    //  - otherwise a file starting with "solid" followed by a facet (or the end of the solid) on the next line is ascii
+    //  - otherwise a file large enough to store the triangle count is binary
+    static bool is_binary(char const* begin, size_t size)
+    {
+        using namespace text_scanner;
+        size_t const expected_size = binary_size(begin, size);
+        if(expected_size>0 && size==expected_size)
+            return true;
+
+        char const* const end = begin + size;
+        if(starts_with(begin, end, "solid")) {
+            char const* it = skip_line(begin, end);
+            while(it<end && (is_blank(*it) || *it=='\n'))
+                ++it;
+            if(starts_with(it, end, "facet") || starts_with(it, end, "endsolid"))
+                return false;
+        }
+        return expected_size>0 && size>=expected_size;
+    }
+
+    // Key of a vertex: bit pattern of its coordinates (-0 and +0 are identified)
+    static int3 vertex_key(vec3 const& p)
+    {
+        int3 key;
+        for(int k=0; k<3; ++k) {
+            float const x = p[k]==0.0f ? 0.0f : p[k];
+            std::memcpy(&key[k], &x, 4);
+        }
+        return key;
+    }
+
+    // Merge the vertices of the triangle soup with identical coordinates
+    static mesh weld_vertices(std::vector<vec3> const& soup)
+    {
+        mesh m;
+        size_t const N_triangle = soup.size()/3;
+        m.connectivity.resize(int(N_triangle));
+        m.position.data.reserve(N_triangle/2+3);
+
+        vertex_index_table table(N_triangle/2+3); // closed triangle meshes have about twice more triangles than vertices
+        for(size_t k=0; k<soup.size(); ++k) {
+            int const new_index = int(m.position.size());
+            int index = table.find_or_insert(vertex_key(soup[k]), new_index);
+            if(index==-1) {
+                m.position.push_back(soup[k]);
+                index = new_index;
+            }
+            m.connectivity[int(k/3)][int(k%3)] = unsigned(index);
+        }
+        return m;
+    }
+}
+}
+
+
+    mesh mesh_load_file_stl(std::string const& filename)
+    {
+        using namespace loader::stl_format;
+        using namespace loader::text_scanner;
+
+        file_memory_map const file(filename);
+        char const* const begin = file.data();
+        char const* const end = begin + file.size();
+
+        std::vector<vec3> soup;
+        if(is_binary(begin, file.size()))
+        {
+            uint32_t N_triangle;
+            std::memcpy(&N_triangle, begin+header_size, 4);
+            soup.resize(3*size_t(N_triangle));
+            char const* it = begin + header_size + 4;
+            for(size_t k=0; k<N_triangle; ++k, it+=triangle_size)
+                std::memcpy(&soup[3*k], it + sizeof(vec3), 3*sizeof(vec3)); // skip the face normal
+        }
+        else
+        {
+            assert_cgp(starts_with(begin, end, "solid"), "File " + filename + " is not a valid stl file");
+            soup.reserve(file.size()/80); // about 250 characters per ascii triangle
+            char const* it = begin;
+            while(it<end) {
+                it = skip_blank(it, end);
+                if(starts_with(it, end, "vertex")) {
+                    vec3 p;
+                    it += 6;
+                    it = read_float(it, end, p.x);
+                    it = read_float(it, end, p.y);
+                    it = read_float(it, end, p.z);
+                    soup.push_back(p);
+                }
+                it = skip_line(it, end);
+            }
+            assert_cgp(soup.size()%3==0, "Incomplete triangle in file " + filename);
+        }
+
+        assert_cgp(soup.size()>0, str("File ")+filename+" has 0 triangles");
+        mesh m = weld_vertices(soup);
+        m.fill_empty_field();
+        return m;
+    }
+
+
+    void mesh_save_file_stl(std::string const& filename, mesh const& m, bool binary)
+    {
+        using namespace loader::stl_format;
+        size_t const N_triangle = m.connectivity.size();
+
+        auto face_normal = [&m](uint3 const& f) {
+            vec3 const n = cross(m.position[f.y]-m.position[f.x], m.position[f.z]-m.position[f.x]);
+            float const L = norm(n);
+            return L>1e-12f ? n/L : vec3{0,0,0};
+        };
+
+        std::ofstream stream(filename, std::ios::out | std::ios::binary);
+        assert_cgp(stream.is_open(), "Cannot open file " + str(filename));
+
+        if(binary)
+        {
+            // The whole file is prepared in a single buffer
+            std::vector<char> buffer(header_size + 4 + N_triangle*triangle_size, 0);
+            std::string const header = "binary stl generated by cgp";
+            std::memcpy(buffer.data(), header.data(), header.size());
+            uint32_t const N = uint32_t(N_triangle);
+            std::memcpy(buffer.data()+header_size, &N, 4);
+
+            char* it = buffer.data() + header_size + 4;
+            for(size_t k=0; k<N_triangle; ++k, it+=triangle_size) {
+                uint3 const& f = m.connectivity[k];
+                vec3 const n = face_normal(f);
+                std::memcpy(it, &n, sizeof(vec3));
+                for(int j=0; j<3; ++j)
+                    std::memcpy(it + (j+1)*sizeof(vec3), &m.position[f[j]], sizeof(vec3));
+                // the 2-byte attribute stays at 0
+            }
+            stream.write(buffer.data(), std::streamsize(buffer.size()));
+        }
+        else
+        {
+            // The floats are written with enough digits to be read back to the same value
+            std::ostringstream s;
+            auto write_vec3 = [&s](vec3 const& v) {
+                loader::text_writer::write_float(s, v.x) << " ";
+                loader::text_writer::write_float(s, v.y) << " ";
+                loader::text_writer::write_float(s, v.z) << "\n";
+            };
+            s << "solid cgp\n";
+            for(size_t k=0; k<N_triangle; ++k) {
+                uint3 const& f = m.connectivity[k];
+                s << "facet normal ";
+                write_vec3(face_normal(f));
+                s << "  outer loop\n";
+                for(int j=0; j<3; ++j) {
+                    s << "    vertex ";
+                    write_vec3(m.position[f[j]]);
+                }
+                s << "  endloop\n";
+                s << "endfacet\n";
+            }
+            s << "endsolid cgp\n";
+            stream << s.str();
+        }
+
+        assert_cgp(stream.good(), "Cannot write file " + str(filename));
+        stream.close();
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "cgp/11_mesh/mesh.hpp"
+
+namespace cgp
+{
+    /** Save a mesh in .stl file (binary=true: binary format, binary=false: ascii format)
+    * STL only stores the triangle positions and their normal: vertices are duplicated for every triangle */
+    void mesh_save_file_stl(std::string const& filename, mesh const& m, bool binary = true);
+
+    /** Load a mesh stored as .stl in the filename (binary or ascii format)
+    * Notes:
+    *  - STL stores independent triangles: vertices with the same coordinates are merged (using a hash table on their coordinates) to get an indexed mesh
+    *  - The per-face normals of the file are not used: the per-vertex normals are computed from the welded mesh (see mesh::fill_empty_field)
+    */
+    mesh mesh_load_file_stl(std::string const& filename);
+
+}
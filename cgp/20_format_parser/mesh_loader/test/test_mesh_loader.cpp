@@ -0,0 +1,177 @@
+#include "test_mesh_loader.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "../mesh_loader.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+using namespace cgp;
+
+namespace cgp_test
+{
+	// Bitwise comparison of the positions of the corners of all the triangles (the loaders may renumber the vertices)
+	static bool same_triangle_positions(mesh const& a, mesh const& b)
+	{
+		if (a.connectivity.size() != b.connectivity.size())
+			return false;
+		for (int k = 0; k < a.connectivity.size(); ++k)
+			for (int j = 0; j < 3; ++j)
+				if (std::memcmp(&a.position[a.connectivity[k][j]], &b.position[b.connectivity[k][j]], sizeof(vec3)) != 0)
+					return false;
+		return true;
+	}
+
+	void test_mesh_loader()
+	{
+		std::string const directory = (std::filesystem::temp_directory_path() / "cgp_test_mesh_loader_").string();
+
+		// Mesh with coordinates that need 9 significant digits
+		mesh m;
+		m.position = { vec3{0.123456789f, 1.0f / 3.0f, -2.71828183f}, vec3{1e-7f, 12345.6789f, 0.1f}, vec3{-3.14159265f, 2.0f / 7.0f, 1e6f + 0.5f}, vec3{0.7f, -0.3f, 1.1f} };
+		m.connectivity = { uint3{0,1,2}, uint3{0,2,3} };
+		m.fill_empty_field();
+
+		// ASCII files are read back to the same values
+		{
+			std::string const filename = directory + "ascii.ply";
+			mesh_save_file_ply(filename, m, false);
+			mesh const loaded = mesh_load_file_ply(filename);
+			assert_cgp_no_msg(same_triangle_positions(m, loaded));
+			assert_cgp_no_msg(std::memcmp(loaded.normal.data.data(), m.normal.data.data(), m.normal.size() * sizeof(vec3)) == 0);
+			std::filesystem::remove(filename);
+		}
+#ifdef CGP_ERROR_EXCEPTION
+		// Invalid numbers of elements in the header of a ply file are reported as errors
+		for (std::string const count : { "3x", "-1", "", "1000000", "99999999999999999999999" }) {
+			std::string const filename = directory + "invalid_count.ply";
+			{
+				std::ofstream stream(filename, std::ios::binary);
+				stream << "ply\nformat ascii 1.0\nelement vertex " << count << "\nproperty float x\nproperty float y\nproperty float z\nend_header\n0 0 0\n1 0 0\n0 1 0\n";
+			}
+			bool error = false;
+			try { mesh_load_file_ply(filename); }
+			catch (std::exception const&) { error = true; }
+			assert_cgp_no_msg(error);
+			std::filesystem::remove(filename);
+		}
+#endif
+		{
+			std::string const filename = directory + "ascii.stl";
+			mesh_save_file_stl(filename, m, false);
+			mesh const loaded = mesh_load_file_stl(filename);
+			assert_cgp_no_msg(same_triangle_positions(m, loaded));
+			std::filesystem::remove(filename);
+		}
+
+		// Binary stl with a header starting with "solid" and trailing bytes after the triangles
+		{
+			std::string const filename = directory + "solid_header.stl";
+			std::string header = "solid exported as binary";
+			header.resize(80, ' ');
+			uint32_t const N_triangle = 1;
+			float triangle[12] = { 0,0,1,  0.1f,0.2f,0.3f,  1.5f,0.25f,0.125f,  -1.0f,2.0f,1.0f / 3.0f };
+			char const attribute[2] = { 0,0 };
+			char const trailing[7] = { 'e','x','t','r','a','\n','\n' };
+			{
+				std::ofstream stream(filename, std::ios::binary);
+				stream.write(header.data(), 80);
+				stream.write(reinterpret_cast<char const*>(&N_triangle), 4);
+				stream.write(reinterpret_cast<char const*>(triangle), sizeof(triangle));
+				stream.write(attribute, 2);
+				stream.write(trailing, sizeof(trailing));
+			}
+			mesh const loaded = mesh_load_file_stl(filename);
+			assert_cgp_no_msg(loaded.connectivity.size() == 1 && loaded.position.size() == 3);
+			for (int j = 0; j < 3; ++j)
+				assert_cgp_no_msg(std::memcmp(&loaded.position[loaded.connectivity[0][j]], triangle + 3 * (j + 1), sizeof(vec3)) == 0);
+			std::filesystem::remove(filename);
+		}
+
+		// Obj read in parallel in small chunks: relative indices and quads are resolved as in the serial read
+		{
+			std::string obj = "# quads with relative indices\n";
+			int const N_block = 20;
+			for (int k = 0; k < N_block; ++k) {
+				for (int j = 0; j < 4; ++j) {
+					obj += "v " + str(k + (j == 1 || j == 2)) + " " + str(j / 2) + " 0.5\n";
+					obj += "vt " + str(0.1f * j) + " 0.25\n";
+				}
+				obj += "vn 0 0 1\n";
+				obj += "f -4/-4/-1 -3/-3/-1 -2/-2/-1 -1/-1/-1\n";
+				if (k > 0)
+					obj += "f 1/1/1 -1/-1/-1 -5/-5/-2\n"; // absolute index, and a vertex of the previous block
+			}
+			char const* begin = obj.data();
+			char const* end = obj.data() + obj.size();
+
+			loader::obj_content const serial = loader::obj_read_content(begin, end, 1);
+			assert_cgp_no_msg(serial.position.size() == 4 * N_block && serial.texture_uv.size() == 4 * N_block && serial.normal.size() == N_block);
+			assert_cgp_no_msg(serial.triangle.size() == 3 * N_block - 1);
+			assert_cgp_no_msg(is_equal(serial.triangle[2], numarray_stack<int3, 3>{ int3{ 4,4,1 }, int3{ 5,5,1 }, int3{ 6,6,1 } }));
+			assert_cgp_no_msg(is_equal(serial.triangle[3], numarray_stack<int3, 3>{ int3{ 4,4,1 }, int3{ 6,6,1 }, int3{ 7,7,1 } }));
+			assert_cgp_no_msg(is_equal(serial.triangle[4], numarray_stack<int3, 3>{ int3{ 0,0,0 }, int3{ 7,7,1 }, int3{ 3,3,0 } }));
+
+			for (int thread_count : { 2, 3, 8 }) {
+				size_t const minimal_chunk_size = 64;
+				assert_cgp_no_msg(loader::obj_thread_count(thread_count, obj.size(), minimal_chunk_size) == thread_count);
+				loader::obj_content const parallel = loader::obj_read_content(begin, end, thread_count, minimal_chunk_size);
+				assert_cgp_no_msg(std::memcmp(parallel.position.data.data(), serial.position.data.data(), serial.position.size() * sizeof(vec3)) == 0);
+				assert_cgp_no_msg(std::memcmp(parallel.texture_uv.data.data(), serial.texture_uv.data.data(), serial.texture_uv.size() * sizeof(vec2)) == 0);
+				assert_cgp_no_msg(std::memcmp(parallel.normal.data.data(), serial.normal.data.data(), serial.normal.size() * sizeof(vec3)) == 0);
+				assert_cgp_no_msg(is_equal(parallel.triangle, serial.triangle));
+			}
+		}
+
+		// A corrupted obj cache is ignored: the obj file is parsed again and the cache rewritten
+		{
+			std::string const filename = directory + "cached.obj";
+			std::string const filename_cache = filename + ".cgpmesh";
+			{
+				std::ofstream stream(filename);
+				stream << "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\nf 1 2 3\nf 2 4 3\n";
+			}
+			mesh_load_file_obj_parameters parameters;
+			parameters.use_binary_cache = true;
+			mesh const reference = mesh_load_file_obj(filename, parameters);
+			assert_cgp_no_msg(std::filesystem::exists(filename_cache));
+			assert_cgp_no_msg(!std::filesystem::exists(filename_cache + ".tmp"));
+
+			// Overwrite the first position stored after the header (the file size, and the source size and time are unchanged)
+			{
+				std::fstream stream(filename_cache, std::ios::in | std::ios::out | std::ios::binary);
+				stream.seekp(sizeof(loader::mesh_binary_header));
+				float const garbage[3] = { 7.0f, 7.0f, 7.0f };
+				stream.write(reinterpret_cast<char const*>(garbage), sizeof(garbage));
+			}
+			mesh m_cache;
+			loader::mesh_binary_source source;
+			assert_cgp_no_msg(!loader::mesh_try_load_file_binary(filename_cache, m_cache, source));
+
+			mesh const loaded = mesh_load_file_obj(filename, parameters);
+			assert_cgp_no_msg(same_triangle_positions(reference, loaded));
+			assert_cgp_no_msg(loader::mesh_try_load_file_binary(filename_cache, m_cache, source));
+
+			// A count whose size in bytes wraps around 2^64 (12 * 2^62 = 3 * 2^64) doesn't match the file size
+			{
+				loader::mesh_binary_header header;
+				assert_cgp_no_msg(loader::mesh_binary_read_header(filename_cache, header));
+				header.N_normal += uint64_t(1) << 62;
+				std::fstream stream(filename_cache, std::ios::in | std::ios::out | std::ios::binary);
+				stream.write(reinterpret_cast<char const*>(&header), sizeof(header));
+			}
+			loader::mesh_binary_header header;
+			assert_cgp_no_msg(!loader::mesh_binary_read_header(filename_cache, header));
+			assert_cgp_no_msg(!loader::mesh_try_load_file_binary(filename_cache, m_cache, source));
+
+			std::filesystem::remove(filename);
+			std::filesystem::remove(filename_cache);
+		}
+	}
+}
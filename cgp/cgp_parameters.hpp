@@ -13,6 +13,16 @@
 
 
 
+// *************************************************************** //
+// CGP SIMD
+//
+// The mat4 products and transpose use SSE instructions when they are available at compile time (x86/x64 targets).
+// Uncomment the following definition to use the generic scalar code instead (the results are identical).
+// *************************************************************** //
+// #define CGP_NO_SIMD
+
+
+
 // *************************************************************** //
 // OpenGL Version
 // *************************************************************** //
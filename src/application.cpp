@@ -135,6 +135,9 @@ void application_structure::animation_loop()
 {
     auto& s = scene();
 
+    // Temporary data allocated in the frame arena during the previous frame are released
+    frame_arena::global().reset();
+
     emscripten_update_window_size(s.window.width, s.window.height);
 
     s.camera_projection.aspect_ratio = s.window.aspect_ratio();
@@ -210,6 +213,10 @@ void application_structure::display_gui_default()
         std::string window_size = "Window " + str(s.window.width) + "px x " + str(s.window.height) + "px";
         ImGui::Text("%s", window_size.c_str());
 
+        frame_arena::statistics_structure const& arena = frame_arena::global().last_frame;
+        std::string const arena_txt = "Frame arena: " + str(arena.allocation) + " allocations/frame (" + str(arena.heap_allocation) + " on heap)";
+        ImGui::Text("%s", arena_txt.c_str());
+
         ImGui::Unindent();
 
         ImGui::Spacing();